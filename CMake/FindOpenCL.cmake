@@ -128,7 +128,8 @@ endif()	# --------- WIN32
 
 
 
-if( LINUX )
+# LINUX is not defined by CMake itself, test for any non Apple unix (ICD loader from ocl-icd, POCL, vendor drivers).
+if( UNIX AND NOT APPLE )
      find_path(	OPENCL_INCLUDE_DIR
                 NAMES CL/cl.h OpenCL/cl.h
                 HINTS ENV OPENCL_DIR
@@ -145,7 +146,7 @@ if( LINUX )
 
      find_library(   OPENCL_LIBRARY
 
-                     NAMES OpenCL
+                     NAMES OpenCL libOpenCL.so.1
 
                      HINTS ENV OPENCL_DIR
 
@@ -153,6 +154,10 @@ if( LINUX )
 
                              /usr/lib
 
+                             /usr/lib64
+
+                             /usr/lib/x86_64-linux-gnu
+
                              /usr/local/lib
 
                              ~/lib )
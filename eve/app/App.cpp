@@ -42,6 +42,26 @@
 #include "eve/ogl/core/win32/Context.h"
 #endif
 
+#ifndef __EVE_OPENGL_CORE_PROGRAM_CACHE_H__
+#include "eve/ogl/core/ProgramCache.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_SHADER_RELOADER_H__
+#include "eve/ogl/core/ShaderReloader.h"
+#endif
+
+#ifndef __EVE_SCENE_MESH_CACHE_H__
+#include "eve/scene/MeshCache.h"
+#endif
+
+#ifndef __EVE_IO_IMAGE_SERVICE_H__
+#include "eve/io/ImageService.h"
+#endif
+
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#include "eve/thr/TaskPool.h"
+#endif
+
 #ifndef __EVE_THREADING_SEMAPHORE_H__
 #include "eve/thr/Semaphore.h"
 #endif
@@ -95,6 +115,8 @@ void eve::app::App::init(void)
 {
 	// Messaging server (log).
 	eve::mess::Server::create_instance();
+	// Tasks thread pool.
+	eve::thr::TaskPool::create_instance();
 
 	// OpenCL engine.
 #if defined(EVE_ENABLE_OPENCL)
@@ -102,6 +124,12 @@ void eve::app::App::init(void)
 #endif
 	// OpenGL master context.
 	eve::ogl::Context::create_instance();
+	// OpenGL shader programs cache.
+	eve::ogl::ProgramCache::create_instance();
+	// OpenGL shader sources hot reload.
+	eve::ogl::ShaderReloader::create_instance();
+	// Scene meshes cache.
+	eve::scene::MeshCache::create_instance();
 
 	// Win32 COM
 #if defined(EVE_OS_WIN)
@@ -115,6 +143,8 @@ void eve::app::App::init(void)
 #if defined(FREEIMAGE_LIB)
 	FreeImage_Initialise();
 #endif
+	// Image decoding service.
+	eve::io::ImageService::create_instance();
 
 	// View container.
 	m_pVecViews = new std::vector<eve::ui::View*>();
@@ -148,6 +178,8 @@ void eve::app::App::release(void)
 	// Fence.
 	EVE_RELEASE_PTR(m_pFence);
 
+	// Image decoding service.
+	eve::io::ImageService::release_instance();
 	// FreeImage.
 #if defined(FREEIMAGE_LIB)
 	FreeImage_DeInitialise();
@@ -158,6 +190,12 @@ void eve::app::App::release(void)
 	::CoUninitialize();
 #endif
 
+	// Scene meshes cache.
+	eve::scene::MeshCache::release_instance();
+	// OpenGL shader sources hot reload.
+	eve::ogl::ShaderReloader::release_instance();
+	// OpenGL shader programs cache.
+	eve::ogl::ProgramCache::release_instance();
 	// OpenGL master context.
 	eve::ogl::Context::release_instance();
 	// OpenCL engine.
@@ -165,6 +203,8 @@ void eve::app::App::release(void)
 	eve::ocl::Engine::release_instance();
 #endif
 
+	// Tasks thread pool.
+	eve::thr::TaskPool::release_instance();
 	// Messaging server (log).
 	eve::mess::Server::release_instance();
 }
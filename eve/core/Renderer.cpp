@@ -39,6 +39,7 @@ eve::core::Renderer::Renderer(void)
 	: eve::mem::Pointer()
 	// Members init.
 	, m_pFence(nullptr)
+	, m_slotDisplay(0)
 {}
 
 
@@ -57,6 +58,14 @@ void eve::core::Renderer::release(void)
 
 
 
+//=================================================================================================
+void eve::core::Renderer::cb_prepare(uint32_t)
+{
+	// Nothing to do for now.
+}
+
+
+
 //=================================================================================================
 void eve::core::Renderer::cb_beforeDisplay(void)
 {
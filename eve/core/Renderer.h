@@ -50,6 +50,12 @@
 #endif
 
 
+/** \def EVE_RENDERER_NUM_SLOTS
+* \brief Render state buffers amount, one is prepared while the other one is displayed.
+*/
+#define EVE_RENDERER_NUM_SLOTS		2
+
+
 namespace eve
 {
 	namespace core
@@ -58,6 +64,8 @@ namespace eve
 		* \class eve::core::Renderer
 		*
 		* \brief Abstract base render engine(s) class.
+		* Frame N+1 render state is prepared in slot getSlotPrepare() on worker threads while frame N is displayed from slot
+		* getSlotDisplay() on rendering thread, eve::sys::Render swaps slots at frame boundary (handover).
 		*
 		* \note extends eve::mem::Pointer
 		*/
@@ -71,6 +79,7 @@ namespace eve
 
 		protected:
 			eve::thr::Fence *		m_pFence;		// Specifies rendering and associated operation(s) memory fence.
+			uint32_t				m_slotDisplay;	// Specifies render state slot read by display callbacks.
 
 
 			//////////////////////////////////////
@@ -92,6 +101,13 @@ namespace eve
 			virtual void release(void);
 
 
+		public:
+			/**
+			* \brief Prepare render state slot \a p_slot for next frame (scene update, culling, commands generation).
+			* Called from worker threads while previous frame is displayed, no OpenGL call is allowed, MUST NOT touch slot getSlotDisplay().
+			*/
+			virtual void cb_prepare(uint32_t p_slot);
+
 		public:
 			/** \brief Before display callback. */
 			virtual void cb_beforeDisplay(void);
@@ -101,10 +117,33 @@ namespace eve
 			/** \brief Draw on screen callback. (pure virtual) */
 			virtual void cb_display(void) = 0;
 
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get render state slot read by display callbacks. */
+			const uint32_t getSlotDisplay(void) const;
+			/** \brief Get render state slot written by next cb_prepare() call. */
+			const uint32_t getSlotPrepare(void) const;
+			/** \brief Set render state slot read by display callbacks (frame handover only). */
+			void setSlotDisplay(uint32_t p_slot);
+
 		}; // class Renderer
 
 	} // namespace ogl
 
 } // namespace eve
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const uint32_t eve::core::Renderer::getSlotDisplay(void) const	{ return m_slotDisplay; }
+EVE_FORCE_INLINE const uint32_t eve::core::Renderer::getSlotPrepare(void) const	{ return (m_slotDisplay + 1) % EVE_RENDERER_NUM_SLOTS; }
+EVE_FORCE_INLINE void eve::core::Renderer::setSlotDisplay(uint32_t p_slot)		{ EVE_ASSERT(p_slot < EVE_RENDERER_NUM_SLOTS); m_slotDisplay = p_slot; }
+
 #endif // __EVE_CORE_RENDERER_H__
@@ -38,5 +38,9 @@
 #include "eve/files/Utils.h"
 #endif
 
+#ifndef __EVE_FILES_WATCHER_H__
+#include "eve/files/Watcher.h"
+#endif
+
 
 #endif // __EVE_FILES_INCLUDES_H__
@@ -0,0 +1,297 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/files/Watcher.h"
+
+#ifndef __EVE_MESSAGING_INCLUDES_H__
+#include "eve/mess/Includes.h"
+#endif
+
+#ifndef __EVE_STRING_UTILS_H__
+#include "eve/str/Utils.h"
+#endif
+
+#ifndef __EVE_TIME_UTILS_H__
+#include "eve/time/Utils.h"
+#endif
+
+#if defined(EVE_OS_LINUX)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+
+/**
+* \def EVE_FILES_WATCHER_BUFFER_SIZE
+* \brief Per directory events buffer size in bytes.
+*/
+#define EVE_FILES_WATCHER_BUFFER_SIZE		16384
+
+
+namespace eve
+{
+	namespace files
+	{
+		/**
+		* \struct eve::files::WatcherDirectory
+		* \brief Watched directory system handles.
+		*/
+		struct WatcherDirectory
+		{
+			std::string		path;											//!< Directory path, without trailing separator.
+#if defined(EVE_OS_WIN)
+			HANDLE			handle;											//!< Directory handle, opened for overlapped reads.
+			OVERLAPPED		overlapped;										//!< Pending read state.
+			DWORD			buffer[EVE_FILES_WATCHER_BUFFER_SIZE / 4];		//!< Events buffer (DWORD aligned).
+#elif defined(EVE_OS_LINUX)
+			int32_t			fd;												//!< Non blocking inotify instance.
+			int32_t			wd;												//!< Watch descriptor.
+			char			buffer[EVE_FILES_WATCHER_BUFFER_SIZE];			//!< Events buffer.
+#endif
+		};
+
+	} // namespace files
+
+} // namespace eve
+
+
+
+//=================================================================================================
+eve::files::Watcher * eve::files::Watcher::create_ptr(void)
+{
+	eve::files::Watcher * ptr = new eve::files::Watcher();
+	ptr->init();
+	return ptr;
+}
+
+
+
+//=================================================================================================
+eve::files::Watcher::Watcher(void)
+	// Inheritance
+	: eve::mem::Pointer()
+
+	// Members init
+	, m_pVecDirectories(nullptr)
+	, m_pMapPending(nullptr)
+	, m_delay(EVE_FILES_WATCHER_DELAY)
+{}
+
+
+
+//=================================================================================================
+void eve::files::Watcher::init(void)
+{
+	m_pVecDirectories	= new std::vector<eve::files::WatcherDirectory*>();
+	m_pMapPending		= new std::map<std::string, int64_t>();
+}
+
+//=================================================================================================
+void eve::files::Watcher::release(void)
+{
+	for (auto dir : (*m_pVecDirectories))
+	{
+#if defined(EVE_OS_WIN)
+		::CancelIo(dir->handle);
+		::CloseHandle(dir->overlapped.hEvent);
+		::CloseHandle(dir->handle);
+#elif defined(EVE_OS_LINUX)
+		::inotify_rm_watch(dir->fd, dir->wd);
+		::close(dir->fd);
+#endif
+		delete dir;
+	}
+	EVE_RELEASE_PTR_CPP(m_pVecDirectories);
+	EVE_RELEASE_PTR_CPP(m_pMapPending);
+}
+
+
+
+//=================================================================================================
+bool eve::files::Watcher::addDirectory(const std::string & p_path)
+{
+	std::string path(p_path);
+	while (!path.empty() && (path.back() == '/' || path.back() == '\\')) {
+		path.pop_back();
+	}
+
+	for (auto dir : (*m_pVecDirectories))
+	{
+		if (dir->path == path) return true;
+	}
+
+	eve::files::WatcherDirectory * dir = new eve::files::WatcherDirectory();
+	dir->path = path;
+
+#if defined(EVE_OS_WIN)
+	dir->handle = ::CreateFileA(path.c_str()
+							  , FILE_LIST_DIRECTORY
+							  , FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE
+							  , NULL
+							  , OPEN_EXISTING
+							  , FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED
+							  , NULL);
+	if (dir->handle == INVALID_HANDLE_VALUE)
+	{
+		EVE_LOG_ERROR("Unable to watch directory %s, CreateFile() failed %s", eve::str::to_wstring(path).c_str(), eve::mess::get_error_msg().c_str());
+		delete dir;
+		return false;
+	}
+
+	::ZeroMemory(&dir->overlapped, sizeof(OVERLAPPED));
+	dir->overlapped.hEvent = ::CreateEvent(NULL, TRUE, FALSE, NULL);
+
+	if (!this->request(dir))
+	{
+		::CloseHandle(dir->overlapped.hEvent);
+		::CloseHandle(dir->handle);
+		delete dir;
+		return false;
+	}
+
+#elif defined(EVE_OS_LINUX)
+	dir->fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	dir->wd = (dir->fd >= 0) ? ::inotify_add_watch(dir->fd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) : -1;
+	if (dir->wd < 0)
+	{
+		EVE_LOG_ERROR("Unable to watch directory %s, inotify_add_watch() failed.", eve::str::to_wstring(path).c_str());
+		if (dir->fd >= 0) ::close(dir->fd);
+		delete dir;
+		return false;
+	}
+#endif
+
+	m_pVecDirectories->push_back(dir);
+	return true;
+}
+
+
+
+//=================================================================================================
+bool eve::files::Watcher::request(eve::files::WatcherDirectory * p_pDir)
+{
+#if defined(EVE_OS_WIN)
+	::ResetEvent(p_pDir->overlapped.hEvent);
+	BOOL ret = ::ReadDirectoryChangesW(p_pDir->handle
+									 , p_pDir->buffer
+									 , sizeof(p_pDir->buffer)
+									 , FALSE
+									 , FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE
+									 , NULL
+									 , &p_pDir->overlapped
+									 , NULL);
+	if (ret == FALSE)
+	{
+		EVE_LOG_ERROR("Unable to read directory changes, ReadDirectoryChangesW() failed %s", eve::mess::get_error_msg().c_str());
+		return false;
+	}
+#endif
+	return true;
+}
+
+//=================================================================================================
+void eve::files::Watcher::read(eve::files::WatcherDirectory * p_pDir, int64_t p_time)
+{
+#if defined(EVE_OS_WIN)
+	DWORD bytes = 0;
+	if (::GetOverlappedResult(p_pDir->handle, &p_pDir->overlapped, &bytes, FALSE) == FALSE)
+	{
+		// Read still pending, nothing changed.
+		if (::GetLastError() != ERROR_IO_INCOMPLETE) {
+			this->request(p_pDir);
+		}
+		return;
+	}
+
+	// Zero bytes means buffer overflow, events are lost.
+	const uint8_t * data = reinterpret_cast<const uint8_t*>(p_pDir->buffer);
+	while (bytes > 0)
+	{
+		const FILE_NOTIFY_INFORMATION * info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(data);
+		if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+		{
+			std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+			(*m_pMapPending)[p_pDir->path + "/" + eve::str::to_string(name)] = p_time;
+		}
+
+		if (info->NextEntryOffset == 0) break;
+		data += info->NextEntryOffset;
+	}
+
+	this->request(p_pDir);
+
+#elif defined(EVE_OS_LINUX)
+	ssize_t bytes = 0;
+	while ((bytes = ::read(p_pDir->fd, p_pDir->buffer, sizeof(p_pDir->buffer))) > 0)
+	{
+		const char * data = p_pDir->buffer;
+		while (data < p_pDir->buffer + bytes)
+		{
+			const struct inotify_event * evt = reinterpret_cast<const struct inotify_event*>(data);
+			if (evt->len > 0 && (evt->mask & IN_ISDIR) == 0)
+			{
+				(*m_pMapPending)[p_pDir->path + "/" + evt->name] = p_time;
+			}
+			data += sizeof(struct inotify_event) + evt->len;
+		}
+	}
+#endif
+}
+
+//=================================================================================================
+bool eve::files::Watcher::poll(std::vector<std::string> & p_changed)
+{
+	const int64_t time = eve::time::current_time_micro();
+
+	for (auto dir : (*m_pVecDirectories))
+	{
+		this->read(dir, time);
+	}
+
+	bool ret = false;
+	auto itr = m_pMapPending->begin();
+	while (itr != m_pMapPending->end())
+	{
+		if (time - itr->second >= m_delay)
+		{
+			p_changed.push_back(itr->first);
+			itr = m_pMapPending->erase(itr);
+			ret = true;
+		}
+		else {
+			++itr;
+		}
+	}
+
+	return ret;
+}
@@ -0,0 +1,149 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_FILES_WATCHER_H__
+#define __EVE_FILES_WATCHER_H__
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MEMORY_INCLUDES_H__
+#include "eve/mem/Includes.h"
+#endif
+
+
+/**
+* \def EVE_FILES_WATCHER_DELAY
+* \brief Default delay (microseconds) without new event before a changed file is reported, editors write files in several steps.
+*/
+#define EVE_FILES_WATCHER_DELAY			100000
+
+
+namespace eve { namespace files { struct WatcherDirectory; } }
+
+
+namespace eve
+{
+	namespace files
+	{
+		/**
+		* \class eve::files::Watcher
+		*
+		* \brief Directories content change watcher.
+		* Uses ReadDirectoryChangesW() on Windows and inotify on Linux, is polled (non blocking) by its owner thread.
+		* Created, modified and renamed files are reported once no new event occurred for their path during delay.
+		*
+		* \note extends mem::Pointer
+		*/
+		class Watcher final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			std::vector<eve::files::WatcherDirectory*> *	m_pVecDirectories;		//!< Watched directories.
+			std::map<std::string, int64_t> *				m_pMapPending;			//!< Changed files not reported yet, with last event time.
+			int64_t											m_delay;				//!< Delay (microseconds) before reporting a changed file.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(Watcher);
+			EVE_PUBLIC_DESTRUCTOR(Watcher);
+
+		public:
+			/** \brief Create, init and return new pointer. */
+			static eve::files::Watcher * create_ptr(void);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit Watcher(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Watch directory \a p_path (not recursive), return false if it can not be watched. Already watched directory is skipped. */
+			bool addDirectory(const std::string & p_path);
+			/** \brief Collect pending events and append changed files full paths to \a p_changed, return false if no file changed. */
+			bool poll(std::vector<std::string> & p_changed);
+
+		private:
+			/** \brief Issue asynchronous read of directory \a p_pDir changes (Windows only). */
+			bool request(eve::files::WatcherDirectory * p_pDir);
+			/** \brief Read available events of directory \a p_pDir, register changed files at time \a p_time. */
+			void read(eve::files::WatcherDirectory * p_pDir, int64_t p_time);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get watched directories amount. */
+			size_t getNumDirectories(void) const;
+
+		public:
+			/** \brief Get delay (microseconds) before reporting a changed file. */
+			int64_t getDelay(void) const;
+			/** \brief Set delay (microseconds) before reporting a changed file. */
+			void setDelay(int64_t p_delay);
+
+		}; // class Watcher
+
+	} // namespace files
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE size_t		eve::files::Watcher::getNumDirectories(void) const	{ return m_pVecDirectories->size(); }
+EVE_FORCE_INLINE int64_t	eve::files::Watcher::getDelay(void) const			{ return m_delay;	}
+EVE_FORCE_INLINE void		eve::files::Watcher::setDelay(int64_t p_delay)		{ m_delay = p_delay; }
+
+#endif // __EVE_FILES_WATCHER_H__
@@ -42,6 +42,10 @@
 #include "eve/geom/Plane.h"
 #endif
 
+#ifndef __EVE_GEOMETRY_SIMPLIFY_H__
+#include "eve/geom/Simplify.h"
+#endif
+
 #ifndef __EVE_GEOMETRY_SPHERE_H__
 #include "eve/geom/Sphere.h"
 #endif
@@ -0,0 +1,565 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/geom/Simplify.h"
+
+#include <unordered_map>
+
+
+namespace eve
+{
+	namespace __geom_internal
+	{
+		/** \brief Boundary edges constraint planes weight, keeps open borders in place. */
+		static const double BOUNDARY_WEIGHT = 1000.0;
+
+
+		/** 
+		* \struct eve::__geom_internal::Quadric
+		* \brief Symmetric 4x4 error quadric stored as upper triangle, with accumulated planes weight.
+		*/
+		struct Quadric
+		{
+			double m[10];
+			double w;
+
+			Quadric(void) : w(0.0) { std::fill(m, m + 10, 0.0); }
+
+			void addPlane(double a, double b, double c, double d, double weight)
+			{
+				m[0] += weight*a*a;	m[1] += weight*a*b;	m[2] += weight*a*c;	m[3] += weight*a*d;
+									m[4] += weight*b*b;	m[5] += weight*b*c;	m[6] += weight*b*d;
+														m[7] += weight*c*c;	m[8] += weight*c*d;
+																			m[9] += weight*d*d;
+				w += weight;
+			}
+
+			void add(const Quadric & p_other)
+			{
+				for (size_t i = 0; i < 10; i++) { m[i] += p_other.m[i]; }
+				w += p_other.w;
+			}
+
+			double error(const double * p) const
+			{
+				const double x = p[0], y = p[1], z = p[2];
+				return m[0]*x*x + 2.0*m[1]*x*y + 2.0*m[2]*x*z + 2.0*m[3]*x
+					 + m[4]*y*y + 2.0*m[5]*y*z + 2.0*m[6]*y
+					 + m[7]*z*z + 2.0*m[8]*z
+					 + m[9];
+			}
+		};
+
+
+		/** 
+		* \struct eve::__geom_internal::Collapse
+		* \brief Edge collapse candidate, moves position \a from onto position \a to.
+		*/
+		struct Collapse
+		{
+			double		cost;
+			uint32_t	from;
+			uint32_t	to;
+			uint32_t	stampFrom;
+			uint32_t	stampTo;
+
+			bool operator > (const Collapse & p_other) const { return cost > p_other.cost; }
+		};
+
+
+		/** 
+		* \struct eve::__geom_internal::PositionKey
+		* \brief Bitwise vertex position, used to weld vertices sharing the same position.
+		*/
+		struct PositionKey
+		{
+			uint32_t x, y, z;
+			bool operator == (const PositionKey & p_other) const { return x == p_other.x && y == p_other.y && z == p_other.z; }
+		};
+
+		/** \brief PositionKey hash functor. */
+		struct PositionHash
+		{
+			size_t operator () (const PositionKey & p_key) const { return (p_key.x * 73856093u) ^ (p_key.y * 19349663u) ^ (p_key.z * 83492791u); }
+		};
+
+
+		EVE_FORCE_INLINE void sub(const double * a, const double * b, double * r) { r[0] = a[0] - b[0]; r[1] = a[1] - b[1]; r[2] = a[2] - b[2]; }
+		EVE_FORCE_INLINE void cross(const double * a, const double * b, double * r) { r[0] = a[1]*b[2] - a[2]*b[1]; r[1] = a[2]*b[0] - a[0]*b[2]; r[2] = a[0]*b[1] - a[1]*b[0]; }
+		EVE_FORCE_INLINE double dot(const double * a, const double * b) { return a[0]*b[0] + a[1]*b[1] + a[2]*b[2]; }
+		EVE_FORCE_INLINE uint64_t edge_key(uint32_t a, uint32_t b) { return (a < b) ? ((uint64_t(a) << 32) | b) : ((uint64_t(b) << 32) | a); }
+
+
+		/** 
+		* \class eve::__geom_internal::Simplifier
+		* \brief Quadric error metrics edge collapse simplifier working on welded positions.
+		*/
+		class Simplifier
+		{
+		private:
+			const eve::ogl::FormatVao &					m_format;
+			size_t										m_stride;			//!< Floats per vertex.
+
+			std::vector<GLuint>							m_indices;			//!< Working indices, 3 per triangle.
+			std::vector<bool>							m_triRemoved;		//!< Triangle removed state.
+			GLint										m_liveIndices;		//!< Live triangles indices amount.
+
+			std::vector<uint32_t>						m_vertexPos;		//!< Vertex to welded position ID.
+			std::vector<double>							m_positions;		//!< Welded positions, 3 per position.
+			std::vector<std::vector<uint32_t>>			m_wedges;			//!< Welded position to vertices.
+			std::vector<std::vector<uint32_t>>			m_faces;			//!< Welded position to triangles (may contain removed ones).
+			std::vector<Quadric>						m_quadrics;			//!< Welded position error quadric.
+			std::vector<uint32_t>						m_stamps;			//!< Welded position modification stamp.
+			std::vector<bool>							m_posRemoved;		//!< Welded position removed state.
+
+			std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> m_heap;
+
+			double										m_maxError;			//!< Max performed collapse error (squared distance).
+
+		public:
+			explicit Simplifier(const eve::ogl::FormatVao & p_format);
+
+		public:
+			/** \brief Collapse edges until live indices amount reaches p_target, return false when no collapse remains. */
+			bool run(GLint p_target);
+			/** \brief Build VAO format from live triangles. */
+			eve::ogl::FormatVao output(void) const;
+
+		public:
+			GLint getLiveIndices(void) const { return m_liveIndices; }
+			float getError(void) const { return static_cast<float>(eve::math::sqrt(m_maxError)); }
+
+		private:
+			uint32_t pos(uint32_t p_tri, uint32_t p_corner) const { return m_vertexPos[m_indices[p_tri * 3 + p_corner]]; }
+			const double * position(uint32_t p_pos) const { return &m_positions[p_pos * 3]; }
+
+			void pushEdge(uint32_t p_a, uint32_t p_b);
+			bool flips(uint32_t p_from, uint32_t p_to) const;
+			void collapse(uint32_t p_from, uint32_t p_to);
+			uint32_t closestWedge(uint32_t p_vertex, uint32_t p_pos) const;
+		};
+
+	} // namespace __geom_internal
+
+} // namespace eve
+
+
+
+//=================================================================================================
+eve::__geom_internal::Simplifier::Simplifier(const eve::ogl::FormatVao & p_format)
+	: m_format(p_format)
+	, m_stride(p_format.perVertexNumPosition + p_format.perVertexNumDiffuse + p_format.perVertexNumNormal)
+	, m_indices(p_format.indices.get(), p_format.indices.get() + p_format.numIndices)
+	, m_triRemoved(p_format.numIndices / 3, false)
+	, m_liveIndices(0)
+	, m_maxError(0.0)
+{
+	EVE_ASSERT(p_format.perVertexNumPosition == 3);
+
+	const float * verts	= p_format.vertices.get();
+	const uint32_t numTris = static_cast<uint32_t>(p_format.numIndices / 3);
+
+	// Weld vertices sharing the same position.
+	std::unordered_map<PositionKey, uint32_t, PositionHash> welded;
+	welded.reserve(p_format.numVertices);
+	m_vertexPos.resize(p_format.numVertices);
+
+	for (GLint i = 0; i < p_format.numVertices; i++)
+	{
+		const float * v = verts + i * m_stride;
+		// Adding 0.0f converts -0.0f to 0.0f so both weld together.
+		float p[3] = { v[0] + 0.0f, v[1] + 0.0f, v[2] + 0.0f };
+		PositionKey key;
+		std::memcpy(&key.x, &p[0], sizeof(uint32_t));
+		std::memcpy(&key.y, &p[1], sizeof(uint32_t));
+		std::memcpy(&key.z, &p[2], sizeof(uint32_t));
+
+		auto itr = welded.find(key);
+		if (itr == welded.end())
+		{
+			uint32_t id = static_cast<uint32_t>(m_wedges.size());
+			welded[key] = id;
+			m_positions.push_back(p[0]);
+			m_positions.push_back(p[1]);
+			m_positions.push_back(p[2]);
+			m_wedges.push_back(std::vector<uint32_t>());
+			m_vertexPos[i] = id;
+		}
+		else
+		{
+			m_vertexPos[i] = itr->second;
+		}
+		m_wedges[m_vertexPos[i]].push_back(static_cast<uint32_t>(i));
+	}
+
+	const size_t numPos = m_wedges.size();
+	m_faces.resize(numPos);
+	m_quadrics.resize(numPos);
+	m_stamps.resize(numPos, 0);
+	m_posRemoved.resize(numPos, false);
+
+	// Faces quadrics (area weighted) and adjacency.
+	struct EdgeUse { uint32_t count; uint32_t tri; };
+	std::unordered_map<uint64_t, EdgeUse> edges;
+	edges.reserve(p_format.numIndices);
+
+	double e1[3], e2[3], n[3];
+	for (uint32_t t = 0; t < numTris; t++)
+	{
+		uint32_t p0 = pos(t, 0), p1 = pos(t, 1), p2 = pos(t, 2);
+		if (p0 == p1 || p1 == p2 || p0 == p2)
+		{
+			m_triRemoved[t] = true;
+			continue;
+		}
+		m_liveIndices += 3;
+
+		sub(position(p1), position(p0), e1);
+		sub(position(p2), position(p0), e2);
+		cross(e1, e2, n);
+		double len = eve::math::sqrt(dot(n, n));
+		if (len > 0.0)
+		{
+			n[0] /= len; n[1] /= len; n[2] /= len;
+			double d = -dot(n, position(p0));
+			double area = len * 0.5;
+			m_quadrics[p0].addPlane(n[0], n[1], n[2], d, area);
+			m_quadrics[p1].addPlane(n[0], n[1], n[2], d, area);
+			m_quadrics[p2].addPlane(n[0], n[1], n[2], d, area);
+		}
+
+		m_faces[p0].push_back(t);
+		m_faces[p1].push_back(t);
+		m_faces[p2].push_back(t);
+
+		uint32_t ps[3] = { p0, p1, p2 };
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			EdgeUse & use = edges[edge_key(ps[k], ps[(k + 1) % 3])];
+			use.count++;
+			use.tri = t;
+		}
+	}
+
+	// Boundary edges constraint planes, perpendicular to their only face.
+	double e[3], bn[3];
+	for (auto && itr : edges)
+	{
+		uint32_t a = static_cast<uint32_t>(itr.first >> 32);
+		uint32_t b = static_cast<uint32_t>(itr.first & 0xFFFFFFFF);
+
+		if (itr.second.count == 1)
+		{
+			uint32_t t = itr.second.tri;
+			sub(position(pos(t, 1)), position(pos(t, 0)), e1);
+			sub(position(pos(t, 2)), position(pos(t, 0)), e2);
+			cross(e1, e2, n);
+
+			sub(position(b), position(a), e);
+			cross(e, n, bn);
+			double len = eve::math::sqrt(dot(bn, bn));
+			if (len > 0.0)
+			{
+				bn[0] /= len; bn[1] /= len; bn[2] /= len;
+				double d = -dot(bn, position(a));
+				double weight = BOUNDARY_WEIGHT * dot(e, e);
+				m_quadrics[a].addPlane(bn[0], bn[1], bn[2], d, weight);
+				m_quadrics[b].addPlane(bn[0], bn[1], bn[2], d, weight);
+			}
+		}
+	}
+
+	// Initial collapse candidates.
+	for (auto && itr : edges)
+	{
+		this->pushEdge(static_cast<uint32_t>(itr.first >> 32), static_cast<uint32_t>(itr.first & 0xFFFFFFFF));
+	}
+}
+
+
+
+//=================================================================================================
+void eve::__geom_internal::Simplifier::pushEdge(uint32_t p_a, uint32_t p_b)
+{
+	Quadric q = m_quadrics[p_a];
+	q.add(m_quadrics[p_b]);
+
+	// Endpoint placement keeps surviving vertices attributes valid.
+	double costAB = q.error(position(p_b));
+	double costBA = q.error(position(p_a));
+	double norm	  = (q.w > 0.0) ? q.w : 1.0;
+
+	Collapse c;
+	if (costAB <= costBA) { c.cost = costAB / norm; c.from = p_a; c.to = p_b; }
+	else				  { c.cost = costBA / norm; c.from = p_b; c.to = p_a; }
+	if (c.cost < 0.0) { c.cost = 0.0; }
+	c.stampFrom = m_stamps[c.from];
+	c.stampTo	= m_stamps[c.to];
+
+	m_heap.push(c);
+}
+
+//=================================================================================================
+bool eve::__geom_internal::Simplifier::flips(uint32_t p_from, uint32_t p_to) const
+{
+	double e1[3], e2[3], n0[3], n1[3];
+	const double * pt[3];
+
+	for (auto && t : m_faces[p_from])
+	{
+		if (m_triRemoved[t]) continue;
+
+		uint32_t p[3] = { pos(t, 0), pos(t, 1), pos(t, 2) };
+		if (p[0] == p_to || p[1] == p_to || p[2] == p_to) continue;
+
+		for (uint32_t k = 0; k < 3; k++) { pt[k] = position(p[k]); }
+		sub(pt[1], pt[0], e1);
+		sub(pt[2], pt[0], e2);
+		cross(e1, e2, n0);
+
+		for (uint32_t k = 0; k < 3; k++) { if (p[k] == p_from) pt[k] = position(p_to); }
+		sub(pt[1], pt[0], e1);
+		sub(pt[2], pt[0], e2);
+		cross(e1, e2, n1);
+
+		if (dot(n0, n1) <= 0.0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//=================================================================================================
+uint32_t eve::__geom_internal::Simplifier::closestWedge(uint32_t p_vertex, uint32_t p_pos) const
+{
+	const float * verts = m_format.vertices.get();
+	const float * src	= verts + p_vertex * m_stride;
+
+	uint32_t best	  = m_wedges[p_pos].front();
+	float	 bestDist = FLT_MAX;
+	for (auto && w : m_wedges[p_pos])
+	{
+		const float * dst = verts + w * m_stride;
+		float dist = 0.0f;
+		for (size_t i = 3; i < m_stride; i++)
+		{
+			float d = dst[i] - src[i];
+			dist += d * d;
+		}
+		if (dist < bestDist)
+		{
+			bestDist = dist;
+			best	 = w;
+		}
+	}
+
+	return best;
+}
+
+//=================================================================================================
+void eve::__geom_internal::Simplifier::collapse(uint32_t p_from, uint32_t p_to)
+{
+	for (auto && t : m_faces[p_from])
+	{
+		if (m_triRemoved[t]) continue;
+
+		uint32_t p[3] = { pos(t, 0), pos(t, 1), pos(t, 2) };
+		if (p[0] == p_to || p[1] == p_to || p[2] == p_to)
+		{
+			// Triangle holds the collapsed edge and becomes degenerate.
+			m_triRemoved[t] = true;
+			m_liveIndices  -= 3;
+		}
+		else
+		{
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				if (p[k] == p_from) {
+					m_indices[t * 3 + k] = this->closestWedge(m_indices[t * 3 + k], p_to);
+				}
+			}
+			m_faces[p_to].push_back(t);
+		}
+	}
+
+	m_faces[p_from].clear();
+	m_posRemoved[p_from] = true;
+	m_quadrics[p_to].add(m_quadrics[p_from]);
+	m_stamps[p_to]++;
+
+	// Compact target adjacency and refresh its collapse candidates.
+	std::vector<uint32_t> & faces = m_faces[p_to];
+	faces.erase(std::remove_if(faces.begin(), faces.end(), [this](uint32_t t) { return m_triRemoved[t]; }), faces.end());
+
+	std::vector<uint32_t> neighbors;
+	for (auto && t : faces)
+	{
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			uint32_t n = pos(t, k);
+			if (n != p_to) neighbors.push_back(n);
+		}
+	}
+	std::sort(neighbors.begin(), neighbors.end());
+	neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+	for (auto && n : neighbors)
+	{
+		this->pushEdge(p_to, n);
+	}
+}
+
+//=================================================================================================
+bool eve::__geom_internal::Simplifier::run(GLint p_target)
+{
+	while (m_liveIndices > p_target)
+	{
+		if (m_heap.empty()) {
+			return false;
+		}
+
+		Collapse c = m_heap.top();
+		m_heap.pop();
+
+		// Skip stale candidates.
+		if (m_posRemoved[c.from] || m_posRemoved[c.to]) continue;
+		if (m_stamps[c.from] != c.stampFrom || m_stamps[c.to] != c.stampTo) continue;
+		// Skip collapses folding triangles over.
+		if (this->flips(c.from, c.to)) continue;
+
+		this->collapse(c.from, c.to);
+		if (c.cost > m_maxError) {
+			m_maxError = c.cost;
+		}
+	}
+
+	return true;
+}
+
+//=================================================================================================
+eve::ogl::FormatVao eve::__geom_internal::Simplifier::output(void) const
+{
+	const float * verts = m_format.vertices.get();
+
+	std::vector<int32_t> remap(m_format.numVertices, -1);
+	GLint numVertices = 0;
+
+	GLuint * indices = (GLuint*)eve::mem::malloc(m_liveIndices * sizeof(GLuint));
+	GLuint * ind	 = indices - 1;
+	for (size_t t = 0; t < m_triRemoved.size(); t++)
+	{
+		if (m_triRemoved[t]) continue;
+
+		for (size_t k = 0; k < 3; k++)
+		{
+			GLuint v = m_indices[t * 3 + k];
+			if (remap[v] < 0) {
+				remap[v] = numVertices++;
+			}
+			*++ind = static_cast<GLuint>(remap[v]);
+		}
+	}
+
+	float * vertices = (float*)eve::mem::malloc(numVertices * m_stride * sizeof(float));
+	for (GLint v = 0; v < m_format.numVertices; v++)
+	{
+		if (remap[v] >= 0) {
+			eve::mem::memcpy(vertices + remap[v] * m_stride, verts + v * m_stride, m_stride * sizeof(float));
+		}
+	}
+
+	eve::ogl::FormatVao format;
+	format.numVertices			= numVertices;
+	format.numIndices			= m_liveIndices;
+	format.perVertexNumPosition = m_format.perVertexNumPosition;
+	format.perVertexNumDiffuse	= m_format.perVertexNumDiffuse;
+	format.perVertexNumNormal	= m_format.perVertexNumNormal;
+	format.vertices.reset(vertices, &eve::mem::free);
+	format.indices.reset(indices, &eve::mem::free);
+
+	return format;
+}
+
+
+
+//=================================================================================================
+eve::ogl::FormatVao eve::geom::simplify(const eve::ogl::FormatVao & p_format, GLint p_targetNumIndices, float * p_pError)
+{
+	eve::__geom_internal::Simplifier simplifier(p_format);
+	simplifier.run(p_targetNumIndices);
+
+	if (p_pError) {
+		*p_pError = simplifier.getError();
+	}
+	return simplifier.output();
+}
+
+//=================================================================================================
+std::vector<eve::ogl::FormatVao> eve::geom::create_lod_chain(const eve::ogl::FormatVao & p_format, size_t p_numLevels, float p_reduction, std::vector<float> * p_pErrors)
+{
+	EVE_ASSERT(p_reduction > 0.0f && p_reduction < 1.0f);
+
+	std::vector<eve::ogl::FormatVao> chain;
+	chain.push_back(p_format);
+	if (p_pErrors) {
+		p_pErrors->clear();
+		p_pErrors->push_back(0.0f);
+	}
+
+	eve::__geom_internal::Simplifier simplifier(p_format);
+
+	GLint  previous = simplifier.getLiveIndices();
+	double target	= static_cast<double>(previous);
+	for (size_t level = 1; level < p_numLevels; level++)
+	{
+		target *= p_reduction;
+		GLint targetIndices = static_cast<GLint>(target) - (static_cast<GLint>(target) % 3);
+		if (targetIndices < 3) break;
+
+		bool bComplete = simplifier.run(targetIndices);
+
+		// Do not store levels too close to the previous one.
+		GLint live = simplifier.getLiveIndices();
+		if (live > static_cast<GLint>(previous * 0.95f)) break;
+
+		chain.push_back(simplifier.output());
+		if (p_pErrors) {
+			p_pErrors->push_back(simplifier.getError());
+		}
+		previous = live;
+
+		if (!bComplete) break;
+	}
+
+	return chain;
+}
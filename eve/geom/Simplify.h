@@ -0,0 +1,73 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_GEOMETRY_SIMPLIFY_H__
+#define __EVE_GEOMETRY_SIMPLIFY_H__
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MATH_INCLUDES_H__
+#include "eve/math/Includes.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_VAO_H__
+#include "eve/ogl/core/Vao.h"
+#endif
+
+
+namespace eve
+{
+	namespace geom
+	{
+		/** 
+		* \brief Simplify VAO format data using quadric error metrics edge collapse.
+		* Collapse edges until indices amount reaches \a p_targetNumIndices or no valid collapse remains.
+		* Vertices sharing the same position are welded for topology, attributes (diffuse/normal) are kept from surviving vertices.
+		* \param p_pError receives simplified mesh geometric error (object space distance), may be nullptr.
+		*/
+		eve::ogl::FormatVao simplify(const eve::ogl::FormatVao & p_format, GLint p_targetNumIndices, float * p_pError = nullptr);
+
+		/** 
+		* \brief Create level of detail chain from VAO format data, in a single simplification pass.
+		* Level 0 is \a p_format, each next level holds \a p_reduction times previous level indices.
+		* Generation stops early when simplification cannot reduce mesh anymore.
+		* \param p_pErrors receives per level geometric error (object space distance), level 0 error is 0, may be nullptr.
+		*/
+		std::vector<eve::ogl::FormatVao> create_lod_chain(const eve::ogl::FormatVao & p_format, size_t p_numLevels, float p_reduction, std::vector<float> * p_pErrors = nullptr);
+
+	} // namespace geom
+
+} // namespace eve
+
+#endif  // __EVE_GEOMETRY_SIMPLIFY_H__ 
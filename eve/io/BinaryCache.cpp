@@ -0,0 +1,122 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/io/BinaryCache.h"
+
+#if !defined(EVE_OS_WIN)
+#include <sys/stat.h>
+#endif
+
+
+//=================================================================================================
+uint64_t eve::io::hash(const void * p_data, size_t p_size, uint64_t p_seed)
+{
+	const uint8_t * data = reinterpret_cast<const uint8_t*>(p_data);
+	uint64_t ret = p_seed;
+	for (size_t i = 0; i < p_size; i++)
+	{
+		ret ^= data[i];
+		ret *= 1099511628211ULL;
+	}
+	return ret;
+}
+
+//=================================================================================================
+void eve::io::create_cache_directory(const std::string & p_path)
+{
+#if defined(EVE_OS_WIN)
+	::CreateDirectoryA(p_path.c_str(), NULL);
+#else
+	::mkdir(p_path.c_str(), 0755);
+#endif
+}
+
+
+
+//=================================================================================================
+bool eve::io::read_binary(const std::string & p_file, eve::io::BinaryHeader * p_header, std::vector<uint8_t> * p_pData, bool * p_pExists)
+{
+	EVE_ASSERT(p_header);
+	EVE_ASSERT(p_pData);
+
+	FILE * pFile = nullptr;
+#if defined(EVE_OS_WIN)
+	if (fopen_s(&pFile, p_file.c_str(), "rb") != 0) pFile = nullptr;
+#else
+	pFile = fopen(p_file.c_str(), "rb");
+#endif
+	if (p_pExists) {
+		*p_pExists = (pFile != nullptr);
+	}
+	if (!pFile) return false;
+
+	eve::io::BinaryHeader header;
+	bool valid = (fread(&header, sizeof(eve::io::BinaryHeader), 1, pFile) == 1)
+			  && (header.magic	 == p_header->magic)
+			  && (header.version == p_header->version)
+			  && (header.key	 == p_header->key)
+			  && (header.tag	 == p_header->tag)
+			  && (header.length	  > 0);
+
+	if (valid)
+	{
+		p_pData->resize(static_cast<size_t>(header.length));
+		valid = (fread(p_pData->data(), 1, p_pData->size(), pFile) == p_pData->size());
+	}
+	fclose(pFile);
+
+	if (valid)
+	{
+		p_header->format = header.format;
+		p_header->length = header.length;
+	}
+	return valid;
+}
+
+//=================================================================================================
+bool eve::io::write_binary(const std::string & p_file, const eve::io::BinaryHeader & p_header, const void * p_pData)
+{
+	FILE * pFile = nullptr;
+#if defined(EVE_OS_WIN)
+	if (fopen_s(&pFile, p_file.c_str(), "wb") != 0) return false;
+#else
+	pFile = fopen(p_file.c_str(), "wb");
+	if (!pFile) return false;
+#endif
+
+	// Truncated writes are detected on load (length mismatch) and rejected.
+	fwrite(&p_header, sizeof(eve::io::BinaryHeader), 1, pFile);
+	fwrite(p_pData, 1, static_cast<size_t>(p_header.length), pFile);
+	fclose(pFile);
+
+	return true;
+}
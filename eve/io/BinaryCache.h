@@ -0,0 +1,84 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_IO_BINARY_CACHE_H__
+#define __EVE_IO_BINARY_CACHE_H__
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#include <vector>
+
+
+namespace eve
+{
+	namespace io
+	{
+		/**
+		* \struct eve::io::BinaryHeader
+		* \brief Cached binary file header, followed by binary data.
+		*/
+		struct BinaryHeader
+		{
+			uint32_t	magic;				//!< File type magic number.
+			uint32_t	version;			//!< Cache version, bumped when stored binaries layout changes.
+			uint64_t	key;				//!< Source hash, binary file is looked up from it.
+			uint64_t	tag;				//!< Producer (driver, device) hash, binaries of another producer are rejected.
+			uint32_t	format;				//!< Producer binary format.
+			uint32_t	reserved;			//!< Padding, always 0.
+			uint64_t	length;				//!< Binary data length in bytes.
+
+			BinaryHeader(void) : magic(0), version(0), key(0), tag(0), format(0), reserved(0), length(0) {}
+		};
+
+
+		/** \brief Compute 64 bits FNV-1a hash of \a p_size bytes of \a p_data, starting from \a p_seed. */
+		uint64_t hash(const void * p_data, size_t p_size, uint64_t p_seed = 14695981039346656037ULL);
+
+		/** \brief Create cache directory \a p_path, existing directory is not an error. */
+		void create_cache_directory(const std::string & p_path);
+
+		/**
+		* \brief Read binary file \a p_file into \a p_pData, return false if file is missing, truncated or its header does not match \a p_header.
+		* Magic, version, key and tag are compared, \a p_header format and length are filled from file.
+		* \a p_pExists (optional) is set to whether file could be opened, so stale files can be told from missing ones.
+		*/
+		bool read_binary(const std::string & p_file, eve::io::BinaryHeader * p_header, std::vector<uint8_t> * p_pData, bool * p_pExists = nullptr);
+		/** \brief Write \a p_header and its \a p_header.length bytes of \a p_pData to binary file \a p_file, return false on failure. */
+		bool write_binary(const std::string & p_file, const eve::io::BinaryHeader & p_header, const void * p_pData);
+
+	} // namespace io
+
+} // namespace eve
+
+#endif // __EVE_IO_BINARY_CACHE_H__
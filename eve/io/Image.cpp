@@ -42,6 +42,15 @@
 
 //=================================================================================================
 bool eve::io::load_image(const std::string & p_path, eve::ogl::FormatTex * p_pFormat)
+{
+	return eve::io::load_image(p_path, p_pFormat, [](size_t p_size)
+	{
+		return std::shared_ptr<void>(eve::mem::malloc(p_size), [](void * p_ptr) { eve::mem::free(p_ptr); });
+	});
+}
+
+//=================================================================================================
+bool eve::io::load_image(const std::string & p_path, eve::ogl::FormatTex * p_pFormat, const eve::io::ImageAllocator & p_allocator)
 {
 	bool bret = false;
 
@@ -61,63 +70,44 @@ bool eve::io::load_image(const std::string & p_path, eve::ogl::FormatTex * p_pFo
 		{
 			// Pointer to the image.
 			FIBITMAP * dib = FreeImage_Load(fif, p_path.c_str());
-			dib = FreeImage_ConvertTo32Bits(dib);
 
 			if (dib)
 			{
-				// Grab image format.
-				uint32_t channels(0);
-				switch (FreeImage_GetBPP(dib))
-				{
-				case 8:
-					p_pFormat->internalFormat = GL_LUMINANCE;
-					p_pFormat->format = GL_LUMINANCE;
-					channels = 1;
-					break;
-
-				case 32:
-					p_pFormat->internalFormat = GL_RGBA;
-#if (FREEIMAGE_COLORORDER == FREEIMAGE_COLORORDER_RGB)
-					p_pFormat->format = GL_RGBA;
-#else
-					p_pFormat->format = GL_BGRA;
-#endif
-					channels = 4;
-					break;
-
-				case 24:
-				default:
-					p_pFormat->internalFormat = GL_RGB;
+				// Pixels are always converted to 32 bits.
+				p_pFormat->internalFormat = GL_RGBA;
 #if (FREEIMAGE_COLORORDER == FREEIMAGE_COLORORDER_RGB)
-					p_pFormat->format = GL_RGB;
+				p_pFormat->format = GL_RGBA;
 #else
-					p_pFormat->format = GL_BGR;
+				p_pFormat->format = GL_BGRA;
 #endif
-					channels = 3;
-					break;
-				}
-
 				// FreeImage loads unsigned bytes.
 				p_pFormat->type   = GL_UNSIGNED_BYTE;
 				p_pFormat->width  = static_cast<GLsizei>(FreeImage_GetWidth(dib));
 				p_pFormat->height = static_cast<GLsizei>(FreeImage_GetHeight(dib));
 
-				// Allocate and copy pixels.
-				size_t size = channels * p_pFormat->width * p_pFormat->height * sizeof(GLubyte);
-				GLubyte * pixels = (GLubyte*)eve::mem::malloc(size);
-				GLubyte * fiPix  = FreeImage_GetBits(dib);
-				eve::mem::memcpy(pixels, fiPix, size);
-
-				p_pFormat->pixels.reset(pixels);
+				// Convert straight into target buffer, rows are kept bottom-up as in FreeImage_GetBits().
+				size_t pitch = 4 * p_pFormat->width * sizeof(GLubyte);
+				std::shared_ptr<void> pixels = p_allocator(pitch * p_pFormat->height);
+				if (pixels)
+				{
+					FreeImage_ConvertToRawBits(static_cast<BYTE*>(pixels.get())
+											 , dib
+											 , static_cast<int>(pitch)
+											 , 32
+											 , FI_RGBA_RED_MASK
+											 , FI_RGBA_GREEN_MASK
+											 , FI_RGBA_BLUE_MASK
+											 , FALSE);
+
+					p_pFormat->pixels = pixels;
+					bret = true;
+				}
 
 				// Free FreeImage's copy of the data.
 				FreeImage_Unload(dib);
-
-				bret = true;
 			}
 		}
 	}
 
 	return bret;
 }
-
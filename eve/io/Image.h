@@ -46,6 +46,9 @@
 #endif
 
 
+#include <functional>
+
+
 namespace eve { namespace ogl { class FormatTex; } }
 
 
@@ -53,8 +56,16 @@ namespace eve
 {
 	namespace io
 	{
+		/** \brief Pixels buffer allocator, returns an owning pointer to at least \a p_size bytes (nullptr on failure). */
+		typedef std::function<std::shared_ptr<void>(size_t p_size)>		ImageAllocator;
+
 		/** \brief Load an image from a path and fill an eve::ogl::FormatTex with data, returns false on failure. */
-		bool load_image(const std::string & p_path, eve::ogl::FormatTex * p_pFormat);		
+		bool load_image(const std::string & p_path, eve::ogl::FormatTex * p_pFormat);
+		/** 
+		* \brief Load an image from a path and fill an eve::ogl::FormatTex with data, returns false on failure.
+		* Pixels are converted to 32 bits straight into the buffer returned by \a p_allocator.
+		*/
+		bool load_image(const std::string & p_path, eve::ogl::FormatTex * p_pFormat, const eve::io::ImageAllocator & p_allocator);
 
 	} // namespace io
 
@@ -0,0 +1,320 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/io/ImageService.h"
+
+#ifndef __EVE_IO_IMAGE_H__
+#include "eve/io/Image.h"
+#endif
+
+#ifndef __EVE_SYSTEM_INFO_H__
+#include "eve/sys/win32/Info.h"
+#endif
+
+
+//=================================================================================================
+eve::io::ImageService * eve::io::ImageService::m_p_instance = nullptr;
+std::mutex eve::io::ImageService::m_s_instanceMutex;
+
+//=================================================================================================
+eve::io::ImageService * eve::io::ImageService::create_instance(size_t p_numThreads)
+{
+	EVE_ASSERT(!m_p_instance);
+
+	// Decoding is mostly I/O and memory bound, leave half the cores to compute tasks.
+	if (p_numThreads == 0)
+	{
+		uint32_t numProc = eve::sys::get_logical_processor_num();
+		p_numThreads = (numProc > 1) ? static_cast<size_t>(numProc / 2) : 1;
+	}
+
+	m_p_instance = new eve::io::ImageService(p_numThreads);
+	m_p_instance->init();
+	return m_p_instance;
+}
+
+//=================================================================================================
+eve::io::ImageService * eve::io::ImageService::get_instance(void)
+{
+	EVE_ASSERT(m_p_instance);
+	return m_p_instance;
+}
+
+//=================================================================================================
+void eve::io::ImageService::release_instance(void)
+{
+	EVE_ASSERT(m_p_instance);
+
+	// Buffers still owned by texture formats are freed by their deleter from now on,
+	// deleters running on other threads hold instance lock while recycling.
+	eve::io::ImageService * instance = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_s_instanceMutex);
+		instance	 = m_p_instance;
+		m_p_instance = nullptr;
+	}
+	EVE_RELEASE_PTR(instance);
+}
+
+
+
+//=================================================================================================
+eve::io::ImageService::ImageService(size_t p_numThreads)
+	// Inheritance
+	: eve::mem::Pointer()
+
+	// Members init
+	, m_numThreads(p_numThreads)
+	, m_pDecoders(nullptr)
+	, m_pending()
+	, m_pMapPending(nullptr)
+	, m_pMapBuffers(nullptr)
+	, m_poolSize(0)
+	, m_poolMaxSize(256 * 1024 * 1024)
+	, m_pFence(nullptr)
+{}
+
+
+
+//=================================================================================================
+void eve::io::ImageService::init(void)
+{
+	m_pMapPending = new std::map<std::string, eve::io::FutureTex>();
+	m_pMapBuffers = new std::multimap<size_t, void*>();
+	m_pFence	  = EVE_CREATE_PTR(eve::thr::SpinLock);
+
+	m_pDecoders	  = new eve::thr::TaskPool(m_numThreads);
+	m_pDecoders->init();
+}
+
+//=================================================================================================
+void eve::io::ImageService::release(void)
+{
+	// Let pending decodings complete.
+	m_pDecoders->wait(&m_pending);
+	EVE_RELEASE_PTR(m_pDecoders);
+
+	this->trim();
+
+	EVE_RELEASE_PTR_CPP(m_pMapBuffers);
+	EVE_RELEASE_PTR_CPP(m_pMapPending);
+	EVE_RELEASE_PTR(m_pFence);
+}
+
+
+
+//=================================================================================================
+eve::io::FutureTex eve::io::ImageService::request(const std::string & p_path, void * p_pBuffer, size_t p_bufferSize)
+{
+	eve::io::FutureTex ret;
+	m_pFence->lock();
+
+	auto itr = m_pMapPending->find(p_path);
+	if (itr != m_pMapPending->end())
+	{
+		ret = itr->second;
+		m_pFence->unlock();
+	}
+	else
+	{
+		std::shared_ptr<std::promise<eve::ogl::FormatTex>> promise = std::make_shared<std::promise<eve::ogl::FormatTex>>();
+		ret = promise->get_future().share();
+		(*m_pMapPending)[p_path] = ret;
+		m_pFence->unlock();
+
+		m_pDecoders->push([this, promise, p_path, p_pBuffer, p_bufferSize](void)
+		{
+			eve::ogl::FormatTex fmt = this->decode(p_path, p_pBuffer, p_bufferSize);
+
+			// Later requests decode the file again, it may have changed on disk.
+			m_pFence->lock();
+			m_pMapPending->erase(p_path);
+			m_pFence->unlock();
+
+			promise->set_value(fmt);
+		}, &m_pending);
+	}
+
+	return ret;
+}
+
+//=================================================================================================
+eve::io::FutureStream eve::io::ImageService::stream(const std::string & p_path, eve::ogl::Texture * p_pTexture)
+{
+	EVE_ASSERT(p_pTexture);
+
+	// Each texture owns its slot, concurrent requests for the same path are not shared.
+	std::shared_ptr<std::promise<bool>> promise = std::make_shared<std::promise<bool>>();
+	eve::io::FutureStream ret = promise->get_future().share();
+
+	m_pDecoders->push([this, promise, p_path, p_pTexture](void)
+	{
+		promise->set_value(this->decodeStream(p_path, p_pTexture));
+	}, &m_pending);
+
+	return ret;
+}
+
+//=================================================================================================
+eve::ogl::FormatTex eve::io::ImageService::decode(const std::string & p_path, void * p_pBuffer, size_t p_bufferSize)
+{
+	eve::ogl::FormatTex fmt;
+
+	bool bret = eve::io::load_image(p_path, &fmt, [this, p_pBuffer, p_bufferSize](size_t p_size)
+	{
+		// Caller buffer is not owned.
+		if (p_pBuffer && p_bufferSize >= p_size) {
+			return std::shared_ptr<void>(p_pBuffer, [](void *) {});
+		}
+		return this->acquire(p_size);
+	});
+
+	if (!bret)
+	{
+		EVE_LOG_ERROR("Unable to load file %s", eve::str::to_wstring(p_path).c_str());
+		fmt.pixels.reset();
+	}
+
+	return fmt;
+}
+
+//=================================================================================================
+bool eve::io::ImageService::decodeStream(const std::string & p_path, eve::ogl::Texture * p_pTexture)
+{
+	eve::ogl::FormatTex fmt;
+	int32_t slot = -1;
+
+	bool bret = eve::io::load_image(p_path, &fmt, [this, p_pTexture, &slot](size_t p_size)
+	{
+		// Slot memory is owned by PBO pool.
+		void * data = nullptr;
+		slot = p_pTexture->acquireStream(static_cast<GLsizeiptr>(p_size), &data);
+		if (slot >= 0) {
+			return std::shared_ptr<void>(data, [](void *) {});
+		}
+		return this->acquire(p_size);
+	});
+
+	if (!bret)
+	{
+		EVE_LOG_ERROR("Unable to load file %s", eve::str::to_wstring(p_path).c_str());
+		if (slot >= 0) {
+			p_pTexture->cancelStream(slot);
+		}
+		return false;
+	}
+
+	if (slot >= 0)
+	{
+		fmt.pixels.reset();
+		p_pTexture->submitStream(slot, fmt);
+	}
+	else
+	{
+		p_pTexture->stream(fmt);
+	}
+
+	return true;
+}
+
+
+
+//=================================================================================================
+std::shared_ptr<void> eve::io::ImageService::acquire(size_t p_size)
+{
+	void * buffer = nullptr;
+	size_t size   = p_size;
+
+	m_pFence->lock();
+	// Smallest free buffer large enough, wasting at most half of it.
+	auto itr = m_pMapBuffers->lower_bound(p_size);
+	if (itr != m_pMapBuffers->end() && itr->first <= p_size * 2)
+	{
+		size	= itr->first;
+		buffer	= itr->second;
+		m_poolSize -= size;
+		m_pMapBuffers->erase(itr);
+	}
+	m_pFence->unlock();
+
+	if (!buffer) {
+		buffer = eve::mem::malloc(size);
+	}
+
+	return std::shared_ptr<void>(buffer, [size](void * p_ptr) { eve::io::ImageService::recycle_buffer(p_ptr, size); });
+}
+
+//=================================================================================================
+void eve::io::ImageService::recycle(void * p_pBuffer, size_t p_size)
+{
+	bool bPooled = false;
+
+	m_pFence->lock();
+	if (m_poolSize + p_size <= m_poolMaxSize)
+	{
+		m_pMapBuffers->insert(std::make_pair(p_size, p_pBuffer));
+		m_poolSize += p_size;
+		bPooled = true;
+	}
+	m_pFence->unlock();
+
+	if (!bPooled) {
+		eve::mem::free(p_pBuffer);
+	}
+}
+
+//=================================================================================================
+void eve::io::ImageService::recycle_buffer(void * p_pBuffer, size_t p_size)
+{
+	std::unique_lock<std::mutex> lock(m_s_instanceMutex);
+	if (m_p_instance)
+	{
+		m_p_instance->recycle(p_pBuffer, p_size);
+		return;
+	}
+	lock.unlock();
+
+	eve::mem::free(p_pBuffer);
+}
+
+//=================================================================================================
+void eve::io::ImageService::trim(void)
+{
+	m_pFence->lock();
+	for (auto && itr : (*m_pMapBuffers))
+	{
+		eve::mem::free(itr.second);
+	}
+	m_pMapBuffers->clear();
+	m_poolSize = 0;
+	m_pFence->unlock();
+}
@@ -0,0 +1,190 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_IO_IMAGE_SERVICE_H__
+#define __EVE_IO_IMAGE_SERVICE_H__
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MEMORY_INCLUDES_H__
+#include "eve/mem/Includes.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_TEXTURE_H__
+#include "eve/ogl/core/Texture.h"
+#endif
+
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#include "eve/thr/TaskPool.h"
+#endif
+
+#include <future>
+#include <mutex>
+
+
+namespace eve { namespace app { class App; } }
+
+
+namespace eve
+{
+	namespace io
+	{
+		/** \brief Image decoding result, format pixels are nullptr on failure. */
+		typedef std::shared_future<eve::ogl::FormatTex>		FutureTex;
+		/** \brief Image streaming result, false on failure. */
+		typedef std::shared_future<bool>					FutureStream;
+
+
+		/**
+		* \class eve::io::ImageService
+		*
+		* \brief Asynchronous image decoding service, images are decoded by a dedicated pool of decoder threads.
+		* Concurrent requests for the same path share a single decoding.
+		* Pixels are decoded straight into the caller provided buffer when large enough, in a pooled buffer otherwise.
+		* Pooled buffers go back to the service once their last texture format owner releases them.
+		*
+		* \note extends mem::Pointer
+		*/
+		class ImageService final
+			: public eve::mem::Pointer
+		{
+			friend class eve::app::App;
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			static ImageService *								m_p_instance;		//!< Unique instance.
+			static std::mutex									m_s_instanceMutex;	//!< Unique instance release protection, held by buffers deleters.
+
+		private:
+			size_t												m_numThreads;		//!< Decoder threads amount.
+			eve::thr::TaskPool *								m_pDecoders;		//!< Decoder threads pool.
+			eve::thr::TaskCounter								m_pending;			//!< Pending decodings counter.
+
+		private:
+			std::map<std::string, eve::io::FutureTex> *			m_pMapPending;		//!< Pending decodings, keyed by path.
+			std::multimap<size_t, void*> *						m_pMapBuffers;		//!< Free pooled buffers, keyed by size.
+			size_t												m_poolSize;			//!< Free pooled buffers size in bytes.
+			size_t												m_poolMaxSize;		//!< Free pooled buffers max size in bytes, exceeding buffers are freed.
+			eve::thr::SpinLock *								m_pFence;			//!< Maps protection fence.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(ImageService)
+			EVE_PUBLIC_DESTRUCTOR(ImageService)
+
+		private:
+			/** \brief Create unique instance, \a p_numThreads 0 uses half logical processors amount (at least one). */
+			static ImageService * create_instance(size_t p_numThreads = 0);
+		public:
+			/** \brief Get unique instance. */
+			static ImageService * get_instance(void);
+		private:
+			/** \brief Release unique instance, waits for pending decodings. */
+			static void release_instance(void);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit ImageService(size_t p_numThreads);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** 
+			* \brief Queue \a p_path decoding and return its future.
+			* Pixels are decoded into \a p_pBuffer (not owned) when \a p_bufferSize is large enough, caller keeps buffer alive while result is used.
+			* A request for a path already being decoded returns the pending future, \a p_pBuffer is then left untouched.
+			*/
+			eve::io::FutureTex request(const std::string & p_path, void * p_pBuffer = nullptr, size_t p_bufferSize = 0);
+			/**
+			* \brief Queue \a p_path decoding straight into a renderer PBO pool slot, submitted as \a p_pTexture new content.
+			* Decodes into a pooled buffer streamed by eve::ogl::Texture::stream() when no slot is available.
+			* Texture MUST stay alive until returned future is ready.
+			*/
+			eve::io::FutureStream stream(const std::string & p_path, eve::ogl::Texture * p_pTexture);
+			/** \brief Free all pooled buffers. */
+			void trim(void);
+
+
+		private:
+			/** \brief Decode \a p_path, called on decoder threads. */
+			eve::ogl::FormatTex decode(const std::string & p_path, void * p_pBuffer, size_t p_bufferSize);
+			/** \brief Decode \a p_path into \a p_pTexture PBO pool slot and submit it, called on decoder threads. */
+			bool decodeStream(const std::string & p_path, eve::ogl::Texture * p_pTexture);
+			/** \brief Get pooled buffer of at least \a p_size bytes, allocate new one if none fits. */
+			std::shared_ptr<void> acquire(size_t p_size);
+			/** \brief Return \a p_pBuffer of \a p_size bytes to pool. */
+			void recycle(void * p_pBuffer, size_t p_size);
+			/** \brief Pooled buffer deleter, return buffer to service if alive, free it otherwise. Instance cannot be released meanwhile. */
+			static void recycle_buffer(void * p_pBuffer, size_t p_size);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get decoder threads amount. */
+			const size_t getNumThreads(void) const;
+			/** \brief Set free pooled buffers max size in bytes. */
+			void setPoolMaxSize(size_t p_size);
+
+		}; // class ImageService
+
+	} // namespace io
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const size_t eve::io::ImageService::getNumThreads(void) const	{ return m_numThreads;		}
+EVE_FORCE_INLINE void eve::io::ImageService::setPoolMaxSize(size_t p_size)		{ m_poolMaxSize = p_size;	}
+
+#endif // __EVE_IO_IMAGE_SERVICE_H__
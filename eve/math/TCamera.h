@@ -350,6 +350,11 @@ namespace eve
 		public:
 			/** \brief Get camera frustum coordinates. */
 			void getFrustum(T * p_pLeft, T * p_pTop, T * p_pRight, T * p_pBottom, T * p_pNear, T * p_pFar) const;
+			/** 
+			* \brief Get world space frustum planes extracted from model view projection matrix.
+			* Planes are ordered left, right, bottom, top, near, far, normalized, and ax + by + cz + d >= 0 inside.
+			*/
+			void getFrustumPlanes(eve::math::TVec4<T> * p_pPlanes) const;
 
 
 		public:
@@ -1199,6 +1204,29 @@ void eve::math::TCamera<T>::getFrustum(T * p_pLeft, T * p_pTop, T * p_pRight, T
 	*p_pFar		= m_farClip;
 }
 
+//=================================================================================================
+template <typename T>
+void eve::math::TCamera<T>::getFrustumPlanes(eve::math::TVec4<T> * p_pPlanes) const
+{
+	const eve::math::TMatrix44<T> & m = m_matrixModelViewProjection;
+
+	// Gribb/Hartmann extraction, combining matrix 4th row with each other row.
+	p_pPlanes[0].set(m.m30 + m.m00, m.m31 + m.m01, m.m32 + m.m02, m.m33 + m.m03);	// Left
+	p_pPlanes[1].set(m.m30 - m.m00, m.m31 - m.m01, m.m32 - m.m02, m.m33 - m.m03);	// Right
+	p_pPlanes[2].set(m.m30 + m.m10, m.m31 + m.m11, m.m32 + m.m12, m.m33 + m.m13);	// Bottom
+	p_pPlanes[3].set(m.m30 - m.m10, m.m31 - m.m11, m.m32 - m.m12, m.m33 - m.m13);	// Top
+	p_pPlanes[4].set(m.m30 + m.m20, m.m31 + m.m21, m.m32 + m.m22, m.m33 + m.m23);	// Near
+	p_pPlanes[5].set(m.m30 - m.m20, m.m31 - m.m21, m.m32 - m.m22, m.m33 - m.m23);	// Far
+
+	for (size_t i = 0; i < 6; i++)
+	{
+		T length = eve::math::sqrt(p_pPlanes[i].x * p_pPlanes[i].x + p_pPlanes[i].y * p_pPlanes[i].y + p_pPlanes[i].z * p_pPlanes[i].z);
+		if (length > static_cast<T>(0)) {
+			p_pPlanes[i] /= length;
+		}
+	}
+}
+
 
 
 //=================================================================================================
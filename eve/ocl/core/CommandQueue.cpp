@@ -39,12 +39,12 @@
 
 
 //=================================================================================================
-eve::ocl::CommandQueue * eve::ocl::CommandQueue::create_ptr(cl_context p_context, cl_device_id p_device)
+eve::ocl::CommandQueue * eve::ocl::CommandQueue::create_ptr(cl_context p_context, cl_device_id p_device, cl_command_queue_properties p_properties)
 {
 	EVE_ASSERT(p_context);
 	EVE_ASSERT(p_device);
 
-	eve::ocl::CommandQueue * ptr = new eve::ocl::CommandQueue(p_context, p_device);
+	eve::ocl::CommandQueue * ptr = new eve::ocl::CommandQueue(p_context, p_device, p_properties);
 	ptr->init();
 	return ptr;
 }
@@ -52,13 +52,14 @@ eve::ocl::CommandQueue * eve::ocl::CommandQueue::create_ptr(cl_context p_context
 
 
 //=================================================================================================
-eve::ocl::CommandQueue::CommandQueue(cl_context p_context, cl_device_id p_device)
+eve::ocl::CommandQueue::CommandQueue(cl_context p_context, cl_device_id p_device, cl_command_queue_properties p_properties)
 	// Inheritance
 	: eve::mem::Pointer()
 	// Members init
 	, m_context(p_context)
 	, m_device(p_device)
 	, m_queue(nullptr)
+	, m_properties(p_properties)
 
 	, m_err(CL_SUCCESS)
 {}
@@ -69,10 +70,16 @@ eve::ocl::CommandQueue::CommandQueue(cl_context p_context, cl_device_id p_device
 void eve::ocl::CommandQueue::init(void)
 {
 #if defined(EVE_OPENCL_ENABLE_BENCHMARK)
-	m_queue = clCreateCommandQueue(m_context, m_device, CL_QUEUE_PROFILING_ENABLE, &m_err);
-#else
-	m_queue = clCreateCommandQueue(m_context, m_device, 0, &m_err);
+	m_properties |= CL_QUEUE_PROFILING_ENABLE;
 #endif
+
+	// Keep supported properties only, out-of-order execution is optional (most CPU ICDs support it, many GPU drivers do not).
+	cl_command_queue_properties supported = 0;
+	m_err = clGetDeviceInfo(m_device, CL_DEVICE_QUEUE_PROPERTIES, sizeof(cl_command_queue_properties), &supported, NULL);
+	EVE_OCL_CHECK_DEVICE(m_err);
+	m_properties &= supported;
+
+	m_queue = clCreateCommandQueue(m_context, m_device, m_properties, &m_err);
 	EVE_OCL_CHECK_COMMAND_QUEUE(m_err);
 }
 
@@ -85,3 +92,19 @@ void eve::ocl::CommandQueue::release(void)
 		m_queue = nullptr;
 	}
 }
+
+
+
+//=================================================================================================
+void eve::ocl::CommandQueue::flush(void)
+{
+	m_err = clFlush(m_queue);
+	EVE_OCL_CHECK_COMMAND_QUEUE(m_err);
+}
+
+//=================================================================================================
+void eve::ocl::CommandQueue::finish(void)
+{
+	m_err = clFinish(m_queue);
+	EVE_OCL_CHECK_COMMAND_QUEUE(m_err);
+}
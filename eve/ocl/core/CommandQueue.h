@@ -49,6 +49,8 @@ namespace eve
 		* \class eve::ocl::CommandQueue
 		*
 		* \brief Create and maintain OpenCL command queue.
+		* Requested properties unsupported by device (out-of-order execution, profiling) are dropped,
+		* profiling is always enabled when EVE_OPENCL_ENABLE_BENCHMARK is defined.
 		*
 		* \note extends eve::mem::Pointer
 		*/
@@ -65,6 +67,7 @@ namespace eve
 			cl_device_id					m_device;				//!< Linked OpenCL device (read only).
 
 			cl_command_queue				m_queue;				//!< OpenCL command queue.
+			cl_command_queue_properties		m_properties;			//!< Command queue properties (supported subset of requested ones).
 
 
 		private:
@@ -79,13 +82,13 @@ namespace eve
 			EVE_PUBLIC_DESTRUCTOR(CommandQueue);
 
 		public:
-			/** \brief Create new pointer. */
-			static eve::ocl::CommandQueue * create_ptr(cl_context p_context, cl_device_id p_device);
+			/** \brief Create new pointer, requesting properties \a p_properties (CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, CL_QUEUE_PROFILING_ENABLE). */
+			static eve::ocl::CommandQueue * create_ptr(cl_context p_context, cl_device_id p_device, cl_command_queue_properties p_properties = 0);
 
 
 		public:
 			/** \brief Class constructor. */
-			explicit CommandQueue(cl_context p_context, cl_device_id p_device);
+			explicit CommandQueue(cl_context p_context, cl_device_id p_device, cl_command_queue_properties p_properties);
 
 
 		public:
@@ -94,10 +97,43 @@ namespace eve
 			/** \brief Release and delete class members. (pure virtual) */
 			virtual void release(void);
 
+
+		public:
+			/** \brief Issue queued commands to device, without waiting. */
+			void flush(void);
+			/** \brief Block until every queued command has completed. */
+			void finish(void);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get OpenCL command queue. */
+			cl_command_queue getQueue(void) const;
+			/** \brief Get command queue properties. */
+			cl_command_queue_properties getProperties(void) const;
+			/** \brief Get whether commands may execute out of order (dependencies MUST then be expressed with events). */
+			bool isOutOfOrder(void) const;
+			/** \brief Get whether commands profiling info is collected. */
+			bool isProfiling(void) const;
+
 		}; // class CommandQueue
 
 	} // namespace ocl
 
 } // namespace eve
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE cl_command_queue				eve::ocl::CommandQueue::getQueue(void) const		{ return m_queue;		}
+EVE_FORCE_INLINE cl_command_queue_properties	eve::ocl::CommandQueue::getProperties(void) const	{ return m_properties;	}
+EVE_FORCE_INLINE bool							eve::ocl::CommandQueue::isOutOfOrder(void) const	{ return (m_properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE) != 0; }
+EVE_FORCE_INLINE bool							eve::ocl::CommandQueue::isProfiling(void) const		{ return (m_properties & CL_QUEUE_PROFILING_ENABLE) != 0; }
+
 #endif // __EVE_OPENCL_CORE_COMMANDQUEUE_H__
@@ -90,7 +90,7 @@ void eve::ocl::Context::release(void)
 
 
 //=================================================================================================
-eve::ocl::Program * eve::ocl::Context::createProgram(const std::wstring & p_path)
+eve::ocl::Program * eve::ocl::Context::createProgram(const std::wstring & p_path, const std::string & p_preamble, const std::string & p_options, bool p_bAsync)
 {
-	return eve::ocl::Program::create_ptr(m_context, m_device, p_path);
+	return eve::ocl::Program::create_ptr(m_context, m_device, p_path, p_preamble, p_options, p_bAsync);
 }
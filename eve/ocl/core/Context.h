@@ -108,8 +108,26 @@ namespace eve
 
 
 		public:
-			/** \brief Create and return OpenCL program. */
-			eve::ocl::Program * createProgram(const std::wstring & p_path);
+			/** \brief Create and return OpenCL program, see eve::ocl::Program::create_ptr() for preamble, options and asynchronous build. */
+			eve::ocl::Program * createProgram(const std::wstring & p_path
+											, const std::string & p_preamble	= std::string()
+											, const std::string & p_options		= std::string()
+											, bool p_bAsync						= false);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get OpenCL context. */
+			cl_context getContext(void) const;
+			/** \brief Get linked OpenCL device. */
+			cl_device_id getDevice(void) const;
+			/** \brief Get data transfer command queue. */
+			eve::ocl::CommandQueue * getQueueTransfer(void) const;
+			/** \brief Get data process command queue. */
+			eve::ocl::CommandQueue * getQueueProcess(void) const;
 
 		}; // class Context
 
@@ -117,4 +135,15 @@ namespace eve
 
 } // namespace eve
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE cl_context					eve::ocl::Context::getContext(void) const		{ return m_context;			}
+EVE_FORCE_INLINE cl_device_id				eve::ocl::Context::getDevice(void) const		{ return m_device;			}
+EVE_FORCE_INLINE eve::ocl::CommandQueue *	eve::ocl::Context::getQueueTransfer(void) const	{ return m_pQueueTransfer;	}
+EVE_FORCE_INLINE eve::ocl::CommandQueue *	eve::ocl::Context::getQueueProcess(void) const	{ return m_pQueueProcess;	}
+
 #endif // __EVE_OPENCL_CORE_CONTEXT_H__
@@ -36,16 +36,85 @@
 #include "eve/str/Utils.h"
 #endif
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+
+//=================================================================================================
+namespace
+{
+	/** \brief Read device string info \a p_info. */
+	std::string device_string(cl_device_id p_device, cl_device_info p_info)
+	{
+		size_t size = 0;
+		if (clGetDeviceInfo(p_device, p_info, 0, NULL, &size) != CL_SUCCESS || size == 0) {
+			return std::string();
+		}
+		std::string ret(size, '\0');
+		if (clGetDeviceInfo(p_device, p_info, size, &ret[0], NULL) != CL_SUCCESS) {
+			return std::string();
+		}
+		ret.resize(::strlen(ret.c_str()));
+		return ret;
+	}
+
+	/** \brief Lower case copy of \a p_str. */
+	std::string to_lower(const std::string & p_str)
+	{
+		std::string ret(p_str);
+		std::transform(ret.begin(), ret.end(), ret.begin(), [](char c) { return static_cast<char>(::tolower(static_cast<unsigned char>(c))); });
+		return ret;
+	}
+
+	/** \brief Case insensitive substring test, empty \a p_sub always matches. */
+	bool contains(const std::string & p_str, const std::string & p_sub)
+	{
+		return p_sub.empty() || to_lower(p_str).find(to_lower(p_sub)) != std::string::npos;
+	}
+
+	/** \brief Read environment variable \a p_name, empty string when not set. */
+	std::string environment(const char * p_name)
+	{
+#if defined(EVE_OS_WIN)
+		char * buffer = nullptr;
+		size_t size = 0;
+		std::string ret;
+		if (_dupenv_s(&buffer, &size, p_name) == 0 && buffer) {
+			ret = buffer;
+		}
+		::free(buffer);
+		return ret;
+#else
+		const char * value = ::getenv(p_name);
+		return value ? std::string(value) : std::string();
+#endif
+	}
+
+	/** \brief Device type readable name. */
+	const wchar_t * device_type_name(cl_device_type p_type)
+	{
+		if (p_type & CL_DEVICE_TYPE_GPU)			return EVE_TXT("GPU");
+		if (p_type & CL_DEVICE_TYPE_CPU)			return EVE_TXT("CPU");
+		if (p_type & CL_DEVICE_TYPE_ACCELERATOR)	return EVE_TXT("Accelerator");
+		return EVE_TXT("Other");
+	}
+
+} // namespace
+
+
 
 //=================================================================================================
 eve::ocl::Engine * eve::ocl::Engine::m_p_instance = nullptr;
 
 //=================================================================================================
-eve::ocl::Engine * eve::ocl::Engine::create_instance(void)
+eve::ocl::Engine * eve::ocl::Engine::create_instance(const eve::ocl::DeviceSelection & p_selection)
 {
 	EVE_ASSERT(!m_p_instance);
 
-	m_p_instance = EVE_CREATE_PTR(eve::ocl::Engine);
+	m_p_instance = new eve::ocl::Engine(p_selection);
+	m_p_instance->init();
 	return m_p_instance;
 }
 
@@ -59,20 +128,24 @@ void eve::ocl::Engine::release_instance(void)
 
 
 //=================================================================================================
-eve::ocl::Engine::Engine(void)
+eve::ocl::Engine::Engine(const eve::ocl::DeviceSelection & p_selection)
 	// Inheritance
 	: eve::mem::Pointer()
 	// Members init
 	, m_numPlatforms(0)
 	, m_pPlatforms(nullptr)
+	, m_platformMaxFlops(nullptr)
 
 	, m_numDevices(0)
 	, m_pDevices(nullptr)
 
+	, m_selection(p_selection)
 	, m_deviceMaxFlops(nullptr)
+	, m_deviceType(CL_DEVICE_TYPE_DEFAULT)
 	, m_maxClockFrequency(0)
 	, m_maxComputeUnits(0)
 	, m_flops(0)
+	, m_bGLSharing(false)
 
 	, m_pContext(nullptr)
 	, m_pContextGL(nullptr)
@@ -83,128 +156,179 @@ eve::ocl::Engine::Engine(void)
 
 
 
+//=================================================================================================
+void eve::ocl::Engine::applyEnvironment(void)
+{
+	if (!m_selection.bEnvironment) return;
+
+	std::string type = to_lower(environment("EVE_OCL_DEVICE_TYPE"));
+	if (!type.empty())
+	{
+		cl_device_type mask = 0;
+		if		(type == "cpu")			mask = CL_DEVICE_TYPE_CPU;
+		else if (type == "gpu")			mask = CL_DEVICE_TYPE_GPU;
+		else if (type == "accelerator")	mask = CL_DEVICE_TYPE_ACCELERATOR;
+		else if (type == "all")			mask = CL_DEVICE_TYPE_ALL;
+
+		if (mask != 0)
+		{
+			m_selection.type		= mask;
+			m_selection.preferred	= mask;
+		}
+		else
+		{
+			EVE_LOG_WARNING("OpenCL: unknown EVE_OCL_DEVICE_TYPE %s, expected cpu, gpu, accelerator or all.", eve::str::to_wstring(type).c_str());
+		}
+	}
+}
+
+//=================================================================================================
+bool eve::ocl::Engine::matchDevice(cl_uint p_platformIndex, cl_uint p_deviceIndex, cl_device_id p_device) const
+{
+	// Environment device override, by "platform:device" indices or by vendor/name substring.
+	if (m_selection.bEnvironment)
+	{
+		std::string target = environment("EVE_OCL_DEVICE");
+		if (!target.empty())
+		{
+			unsigned int platformIndex = 0;
+			unsigned int deviceIndex   = 0;
+			char end = 0;
+#if defined(EVE_OS_WIN)
+			int parsed = sscanf_s(target.c_str(), "%u:%u%c", &platformIndex, &deviceIndex, &end, 1);
+#else
+			int parsed = sscanf(target.c_str(), "%u:%u%c", &platformIndex, &deviceIndex, &end);
+#endif
+			if (parsed == 2) {
+				return platformIndex == p_platformIndex && deviceIndex == p_deviceIndex;
+			}
+			if (!contains(device_string(p_device, CL_DEVICE_VENDOR) + " " + device_string(p_device, CL_DEVICE_NAME), target)) {
+				return false;
+			}
+		}
+	}
+
+	cl_device_type type = 0;
+	if (clGetDeviceInfo(p_device, CL_DEVICE_TYPE, sizeof(cl_device_type), &type, NULL) != CL_SUCCESS || (type & m_selection.type) == 0) {
+		return false;
+	}
+
+	cl_bool available = CL_FALSE;
+	if (clGetDeviceInfo(p_device, CL_DEVICE_AVAILABLE, sizeof(cl_bool), &available, NULL) != CL_SUCCESS || !available) {
+		return false;
+	}
+
+	if (m_selection.minGlobalMemory > 0)
+	{
+		cl_ulong memory = 0;
+		if (clGetDeviceInfo(p_device, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(cl_ulong), &memory, NULL) != CL_SUCCESS || memory < m_selection.minGlobalMemory) {
+			return false;
+		}
+	}
+
+	return contains(device_string(p_device, CL_DEVICE_VENDOR), m_selection.vendor)
+		&& contains(device_string(p_device, CL_DEVICE_NAME), m_selection.name);
+}
+
+
+
 //=================================================================================================
 void eve::ocl::Engine::init(void)
 {
 	m_pPlatforms	= new std::vector<cl_platform_id>();
 	m_pDevices		= new std::vector<cl_device_id>();
 
-	// Get available platforms number.
+	this->applyEnvironment();
+
+	// Get available platforms number, no installed ICD (CL_PLATFORM_NOT_FOUND_KHR) is not an error.
 	m_err = clGetPlatformIDs(0, NULL, &m_numPlatforms);
-	EVE_OCL_CHECK_PLATFORM(m_err);
+	if (m_err != CL_SUCCESS) {
+		m_numPlatforms = 0;
+	}
 
 	if (m_numPlatforms > 0)
 	{
 		// Get available platforms.
-		cl_platform_id * platforms = (cl_platform_id*)eve::mem::malloc(m_numPlatforms * sizeof(cl_platform_id));
-		m_err = clGetPlatformIDs(m_numPlatforms, platforms, NULL);
+		m_pPlatforms->resize(m_numPlatforms);
+		m_err = clGetPlatformIDs(m_numPlatforms, m_pPlatforms->data(), NULL);
 		EVE_OCL_CHECK_PLATFORM(m_err);
 
 		// Useful vars.
-		cl_platform_id	platform		= nullptr;
-		cl_device_id	device			= nullptr;
-		cl_int			computeUnits	= 0;
-		cl_int			clockFrequency	= 0;
-		cl_int			flops			= 0;
+		bool			bestPreferred	= false;
+		cl_ulong		bestScore		= 0;
 
 		// Run threw platforms.
 		for (cl_uint i = 0; i < m_numPlatforms; i++)
 		{
-			platform = platforms[i];
-			m_pPlatforms->push_back(platform);
+			cl_platform_id platform = (*m_pPlatforms)[i];
 
-			// Get per platform available device(s) number.
-			m_err = clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL, 0, NULL, &m_numDevices);
-			EVE_OCL_CHECK_DEVICE(m_err);
+			// Get per platform available device(s) number, platform without device (CL_DEVICE_NOT_FOUND) is skipped.
+			cl_uint numDevices = 0;
+			if (clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL, 0, NULL, &numDevices) != CL_SUCCESS || numDevices == 0) {
+				continue;
+			}
 
 			// Get per platform available device(s).
-			cl_device_id * devices = (cl_device_id*)eve::mem::malloc(m_numDevices * sizeof(cl_device_id));
-			m_err = clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL, m_numDevices, devices, NULL);
+			std::vector<cl_device_id> devices(numDevices);
+			m_err = clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL, numDevices, devices.data(), NULL);
 			EVE_OCL_CHECK_DEVICE(m_err);
+			if (m_err != CL_SUCCESS) continue;
 
 
 			// Run threw devices.
-			for (cl_uint j = 0; j < m_numDevices; j++)
+			for (cl_uint j = 0; j < numDevices; j++)
 			{
-				device = devices[j];
+				cl_device_id device = devices[j];
 				m_pDevices->push_back(device);
 
-				m_err = clGetDeviceInfo(device, CL_DEVICE_MAX_CLOCK_FREQUENCY, sizeof(cl_int), &clockFrequency, NULL);
-				EVE_OCL_CHECK_DEVICE(m_err);
+				if (!this->matchDevice(i, j, device)) continue;
 
-				m_err = clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(cl_int), &computeUnits, NULL);
-				EVE_OCL_CHECK_DEVICE(m_err);
+				cl_uint			clockFrequency	= 0;
+				cl_uint			computeUnits	= 0;
+				cl_device_type	type			= 0;
+				clGetDeviceInfo(device, CL_DEVICE_MAX_CLOCK_FREQUENCY, sizeof(cl_uint), &clockFrequency, NULL);
+				clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(cl_uint), &computeUnits, NULL);
+				clGetDeviceInfo(device, CL_DEVICE_TYPE, sizeof(cl_device_type), &type, NULL);
 
-				flops = computeUnits * clockFrequency;
+				// Some CPU ICDs (POCL) report a null clock frequency, rank them on compute units alone.
+				cl_ulong score		= cl_ulong(std::max(computeUnits, 1u)) * cl_ulong(std::max(clockFrequency, 1u));
+				bool	 preferred	= (type & m_selection.preferred) != 0;
 
-				if (flops > m_flops)
+				if (!m_deviceMaxFlops || (preferred && !bestPreferred) || (preferred == bestPreferred && score > bestScore))
 				{
-					m_platformMaxFlops  = platform;
+					bestPreferred		= preferred;
+					bestScore			= score;
 
-					m_maxClockFrequency = clockFrequency;
-					m_maxComputeUnits	= computeUnits;
-					m_flops				= flops;
+					m_platformMaxFlops	= platform;
 					m_deviceMaxFlops	= device;
+					m_deviceType		= type;
+					m_maxClockFrequency	= static_cast<cl_int>(clockFrequency);
+					m_maxComputeUnits	= static_cast<cl_int>(computeUnits);
+					m_flops				= static_cast<cl_int>(computeUnits * clockFrequency);
 				}
 			}
-			eve::mem::free(devices);
 		}
-		eve::mem::free(platforms);
 	}
+	m_numDevices = static_cast<cl_uint>(m_pDevices->size());
 
-	// Print selected device infos.
-#ifndef NDEBUG
-	if (m_deviceMaxFlops)
+	if (!m_deviceMaxFlops)
 	{
-		// Useful vars.
-		size_t paramValueSize;
-		char * txt = nullptr;
-		std::wstring mess;
-
-
-		// Device vendor.
-		m_err = clGetDeviceInfo(m_deviceMaxFlops, CL_DEVICE_VENDOR, 0, NULL, &paramValueSize);
-		EVE_OCL_CHECK_DEVICE(m_err);
-
-		txt = (char*)eve::mem::malloc(sizeof(char)* paramValueSize);
-		m_err = clGetDeviceInfo(m_deviceMaxFlops, CL_DEVICE_VENDOR, paramValueSize, txt, NULL);
-		EVE_OCL_CHECK_DEVICE(m_err);
-
-		mess = eve::str::to_wstring(txt);
-		eve::mem::free(txt);
-		EVE_LOG_INFO("OpenCL Device Vendor:          %s", mess.c_str());
-
-
-		// Device name.
-		m_err = clGetDeviceInfo(m_deviceMaxFlops, CL_DEVICE_NAME, 0, NULL, &paramValueSize);
-		EVE_OCL_CHECK_DEVICE(m_err);
-
-		txt = (char*)eve::mem::malloc(sizeof(char)* paramValueSize);
-		m_err = clGetDeviceInfo(m_deviceMaxFlops, CL_DEVICE_NAME, paramValueSize, txt, NULL);
-		EVE_OCL_CHECK_DEVICE(m_err);
-
-		mess = eve::str::to_wstring(txt);
-		eve::mem::free(txt);
-		EVE_LOG_INFO("OpenCL Device Name:            %s", mess.c_str());
-
-
-		// Device version.
-		m_err = clGetDeviceInfo(m_deviceMaxFlops, CL_DEVICE_VERSION, 0, NULL, &paramValueSize);
-		EVE_OCL_CHECK_DEVICE(m_err);
-
-		txt = (char*)eve::mem::malloc(sizeof(char)* paramValueSize);
-		m_err = clGetDeviceInfo(m_deviceMaxFlops, CL_DEVICE_VERSION, paramValueSize, txt, NULL);
-		EVE_OCL_CHECK_DEVICE(m_err);
-
-		mess = eve::str::to_wstring(txt);
-		eve::mem::free(txt);
-		EVE_LOG_INFO("OpenCL Device Version:         %s", mess.c_str());
+		EVE_LOG_WARNING("OpenCL: no device matches selection (%d platform(s), %d device(s)), OpenCL is disabled.", m_numPlatforms, m_numDevices);
+		return;
+	}
 
+	std::string extensions = device_string(m_deviceMaxFlops, CL_DEVICE_EXTENSIONS);
+	m_bGLSharing = extensions.find("cl_khr_gl_sharing") != std::string::npos || extensions.find("cl_APPLE_gl_sharing") != std::string::npos;
 
-		// Flops.
-		EVE_LOG_INFO("OpenCL Device Clock Frequency: %d", m_maxClockFrequency);
-		EVE_LOG_INFO("OpenCL Device Compute Units:   %d", m_maxComputeUnits);
-	}
+	// Print selected device infos.
+	EVE_LOG_INFO("OpenCL Device Vendor:          %s", eve::str::to_wstring(device_string(m_deviceMaxFlops, CL_DEVICE_VENDOR)).c_str());
+	EVE_LOG_INFO("OpenCL Device Name:            %s", eve::str::to_wstring(device_string(m_deviceMaxFlops, CL_DEVICE_NAME)).c_str());
+#ifndef NDEBUG
+	EVE_LOG_INFO("OpenCL Device Version:         %s", eve::str::to_wstring(device_string(m_deviceMaxFlops, CL_DEVICE_VERSION)).c_str());
+	EVE_LOG_INFO("OpenCL Device Type:            %s", device_type_name(m_deviceType));
+	EVE_LOG_INFO("OpenCL Device Clock Frequency: %d", m_maxClockFrequency);
+	EVE_LOG_INFO("OpenCL Device Compute Units:   %d", m_maxComputeUnits);
+	EVE_LOG_INFO("OpenCL Device GL Sharing:      %d", m_bGLSharing ? 1 : 0);
 #endif
 
 
@@ -216,6 +340,12 @@ void eve::ocl::Engine::init(void)
 	};
 	cl_context context = clCreateContext(props, 1, &m_deviceMaxFlops, NULL, NULL, &m_err);
 	EVE_OCL_CHECK_CONTEXT(m_err);
+	if (m_err != CL_SUCCESS)
+	{
+		EVE_LOG_WARNING("OpenCL: unable to create context on selected device, OpenCL is disabled.");
+		m_deviceMaxFlops = nullptr;
+		return;
+	}
 
 	m_pContext = eve::ocl::Context::create_ptr(context, m_deviceMaxFlops);
 }
@@ -234,29 +364,61 @@ void eve::ocl::Engine::release(void)
 
 
 //=================================================================================================
-eve::ocl::Context * eve::ocl::Engine::createContextOpenGL(HGLRC p_GLRC, HDC p_DC)
+eve::ocl::Context * eve::ocl::Engine::createContextOpenGL(cl_context_properties p_glContext, cl_context_properties p_display)
 {
 	EVE_ASSERT(!m_pContextGL);
 
+	if (!m_deviceMaxFlops) {
+		return nullptr;
+	}
+	if (!m_bGLSharing)
+	{
+		EVE_LOG_INFO("OpenCL: selected device does not support OpenGL sharing, using default context only.");
+		return nullptr;
+	}
+
+#if defined(EVE_OS_WIN)
+	const cl_context_properties displayKey = CL_WGL_HDC_KHR;
+#elif defined(EVE_OS_LINUX)
+	const cl_context_properties displayKey = CL_GLX_DISPLAY_KHR;
+#else
+	EVE_LOG_INFO("OpenCL: OpenGL sharing is not implemented on this platform.");
+	return nullptr;
+#endif
+
+#if defined(EVE_OS_WIN) || defined(EVE_OS_LINUX)
 	cl_context_properties props[] =
 	{
-		CL_GL_CONTEXT_KHR, (cl_context_properties)p_GLRC,
-		CL_WGL_HDC_KHR, (cl_context_properties)p_DC,
+		CL_GL_CONTEXT_KHR, p_glContext,
+		displayKey, p_display,
 		CL_CONTEXT_PLATFORM, (cl_context_properties)m_platformMaxFlops,
 		0
 	};
 	cl_int err;
 	cl_context context = clCreateContext(props, 1, &m_deviceMaxFlops, NULL, NULL, &err);
-	EVE_OCL_CHECK_CONTEXT(err);
+	if (err != CL_SUCCESS)
+	{
+		EVE_LOG_WARNING("OpenCL: unable to create OpenGL shared context (error %d), using default context only.", err);
+		return nullptr;
+	}
 
 	m_pContextGL = eve::ocl::Context::create_ptr(context, m_deviceMaxFlops);
 
 	return m_pContextGL;
+#endif
 }
 
 //=================================================================================================
-eve::ocl::Context * eve::ocl::Engine::create_context_OpenGL(HGLRC p_GLRC, HDC p_DC)
+eve::ocl::Context * eve::ocl::Engine::create_context_OpenGL(cl_context_properties p_glContext, cl_context_properties p_display)
 {
 	EVE_ASSERT(m_p_instance);
-	return m_p_instance->createContextOpenGL(p_GLRC, p_DC);
+	return m_p_instance->createContextOpenGL(p_glContext, p_display);
 }
+
+#if defined(EVE_OS_WIN)
+//=================================================================================================
+eve::ocl::Context * eve::ocl::Engine::create_context_OpenGL(HGLRC p_GLRC, HDC p_DC)
+{
+	return eve::ocl::Engine::create_context_OpenGL((cl_context_properties)p_GLRC, (cl_context_properties)p_DC);
+}
+#endif
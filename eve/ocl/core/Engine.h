@@ -50,10 +50,42 @@ namespace eve
 {
 	namespace ocl
 	{
+		/**
+		* \struct eve::ocl::DeviceSelection
+		*
+		* \brief OpenCL device selection policy.
+		* Devices passing every filter are ranked by preferred type first, then by flops (compute units * clock frequency).
+		* When \a bEnvironment is set, EVE_OCL_DEVICE_TYPE (cpu, gpu, accelerator, all) overrides \a type and \a preferred,
+		* EVE_OCL_DEVICE selects a device by "platform:device" indices or by vendor/name substring.
+		*/
+		struct DeviceSelection
+		{
+			cl_device_type		type;				//!< Accepted device types mask.
+			cl_device_type		preferred;			//!< Preferred device types mask, ranked before any other accepted device.
+			cl_ulong			minGlobalMemory;	//!< Minimum device global memory size (in bytes).
+			std::string			vendor;				//!< Device vendor substring (case insensitive), empty accepts any vendor.
+			std::string			name;				//!< Device name substring (case insensitive), empty accepts any device.
+			bool				bEnvironment;		//!< Specifies whether environment variables override this policy.
+
+			/** \brief Default policy: any device, GPU first, environment overrides enabled. */
+			DeviceSelection(void)
+				: type(CL_DEVICE_TYPE_ALL)
+				, preferred(CL_DEVICE_TYPE_GPU)
+				, minGlobalMemory(0)
+				, vendor()
+				, name()
+				, bEnvironment(true)
+			{}
+
+		}; // struct DeviceSelection
+
+
 		/** 
 		* \class eve::ocl::Engine
 		*
-		* \brief Detect and sort platform and device, depending on performances.
+		* \brief Detect platforms and devices, select compute device depending on selection policy.
+		* No context is created when no device matches (OpenCL is then unavailable, see is_available()),
+		* OpenGL sharing is optional and only enabled on devices exposing cl_khr_gl_sharing.
 		*
 		* \note extends eve::mem::Pointer
 		*/
@@ -72,17 +104,20 @@ namespace eve
 		private:
 			cl_uint							m_numPlatforms;			//!< Number of available OpenCL platforms.
 			std::vector<cl_platform_id> *	m_pPlatforms;			//!< Available OpenCL platforms.
-			cl_platform_id					m_platformMaxFlops;		//!< Platform containing max flops device (compute units * clock frequency).
+			cl_platform_id					m_platformMaxFlops;		//!< Platform containing selected device.
 
 
 		private:
 			cl_uint							m_numDevices;			//!< Number of available OpenCL devices.
 			std::vector<cl_device_id> *		m_pDevices;				//!< Available OpenCL devices.
 
-			cl_device_id					m_deviceMaxFlops;		//!< Max flops device (compute units * clock frequency).
-			cl_int							m_maxClockFrequency;	//!< Max flops device maximum clock frequency.
-			cl_int							m_maxComputeUnits;		//!< Max flops device compute units number.
-			cl_int							m_flops;				//!< Max flops device flops.
+			eve::ocl::DeviceSelection		m_selection;			//!< Device selection policy.
+			cl_device_id					m_deviceMaxFlops;		//!< Selected device, best ranked one (nullptr when no device matches).
+			cl_device_type					m_deviceType;			//!< Selected device type.
+			cl_int							m_maxClockFrequency;	//!< Selected device maximum clock frequency.
+			cl_int							m_maxComputeUnits;		//!< Selected device compute units number.
+			cl_int							m_flops;				//!< Selected device flops.
+			bool							m_bGLSharing;			//!< Selected device exposes OpenGL sharing extension.
 
 
 		private:
@@ -103,15 +138,15 @@ namespace eve
 			EVE_PUBLIC_DESTRUCTOR(Engine);
 
 		public:
-			/** \brief Create unique instance. */
-			static eve::ocl::Engine * create_instance(void);
+			/** \brief Create unique instance, selecting compute device with policy \a p_selection. */
+			static eve::ocl::Engine * create_instance(const eve::ocl::DeviceSelection & p_selection = eve::ocl::DeviceSelection());
 			/** \brief Release unique instance */
 			static void release_instance(void);
 
 
 		public:
 			/** \brief Class constructor. */
-			explicit Engine(void);
+			explicit Engine(const eve::ocl::DeviceSelection & p_selection);
 
 
 		public:
@@ -122,11 +157,25 @@ namespace eve
 
 
 		private:
-			/** \brief Create OpenCL context from OpenGL context (activated sharing). */
-			eve::ocl::Context * createContextOpenGL(HGLRC p_GLRC, HDC p_DC);
+			/** \brief Test whether device \a p_device matches selection policy. */
+			bool matchDevice(cl_uint p_platformIndex, cl_uint p_deviceIndex, cl_device_id p_device) const;
+			/** \brief Apply environment variables over selection policy. */
+			void applyEnvironment(void);
+
+
+		private:
+			/** \brief Create OpenCL context from OpenGL context \a p_glContext and display \a p_display (HDC on Windows, X11 Display on Linux). */
+			eve::ocl::Context * createContextOpenGL(cl_context_properties p_glContext, cl_context_properties p_display);
 		public:
-			/** \brief Create OpenCL context from OpenGL context (activated sharing). */
+			/**
+			* \brief Create OpenCL context from OpenGL context (activated sharing).
+			* Return nullptr when no device is selected or selected device does not support OpenGL sharing, default context remains usable.
+			*/
+			static eve::ocl::Context * create_context_OpenGL(cl_context_properties p_glContext, cl_context_properties p_display);
+#if defined(EVE_OS_WIN)
+			/** \brief Create OpenCL context from WGL context (activated sharing). */
 			static eve::ocl::Context * create_context_OpenGL(HGLRC p_GLRC, HDC p_DC);
+#endif
 
 
 			///////////////////////////////////////////////////////////////////////////////////////
@@ -148,20 +197,31 @@ namespace eve
 
 
 		public:
-			/** \brief Get maximum flops device (fastest one). */
+			/** \brief Get whether a device has been selected and default context created. */
+			static bool								is_available(void);
+			/** \brief Get device selection policy (environment overrides applied). */
+			static const eve::ocl::DeviceSelection & get_selection(void);
+
+
+		public:
+			/** \brief Get selected device (nullptr when none). */
 			static cl_device_id						get_max_flops_device(void);
-			/** \brief Get maximum flops device (fastest one) maximum compute units number. */
+			/** \brief Get selected device type. */
+			static cl_device_type					get_device_type(void);
+			/** \brief Get selected device maximum compute units number. */
 			static cl_int							get_max_compute_units(void);
-			/** \brief Get maximum flops device (fastest one) maximum clock frequency. */
+			/** \brief Get selected device maximum clock frequency. */
 			static cl_int							get_max_clock_frequency(void);
-			/** \brief Get maximum flops device (fastest one) flops. */
+			/** \brief Get selected device flops. */
 			static cl_int							get_flops(void);
+			/** \brief Get whether selected device supports OpenGL sharing. */
+			static bool								has_OpenGL_sharing(void);
 
 
 		public:
-			/** \brief Get default context (no sharing). */
+			/** \brief Get default context (no sharing, nullptr when no device is selected). */
 			static eve::ocl::Context *				get_context(void);
-			/** \brief Get linked to OpenGL context. */
+			/** \brief Get linked to OpenGL context (nullptr when sharing is unavailable). */
 			static eve::ocl::Context *				get_context_OpenGL(void);
 			/** \brief Get linked to DirectX context . */
 			static eve::ocl::Context *				get_context_DirectX(void);
@@ -183,16 +243,23 @@ EVE_FORCE_INLINE cl_uint						eve::ocl::Engine::get_devices_num(void)			{ EVE_AS
 EVE_FORCE_INLINE std::vector<cl_device_id> *	eve::ocl::Engine::get_devices(void)				{ EVE_ASSERT(m_p_instance); return m_p_instance->m_pDevices;				}
 
 
+//=================================================================================================
+EVE_FORCE_INLINE bool							eve::ocl::Engine::is_available(void)			{ return m_p_instance && m_p_instance->m_pContext;						}
+EVE_FORCE_INLINE const eve::ocl::DeviceSelection & eve::ocl::Engine::get_selection(void)		{ EVE_ASSERT(m_p_instance); return m_p_instance->m_selection;			}
+
+
 //=================================================================================================
 EVE_FORCE_INLINE cl_device_id					eve::ocl::Engine::get_max_flops_device(void)	{ EVE_ASSERT(m_p_instance); return m_p_instance->m_deviceMaxFlops;		}
+EVE_FORCE_INLINE cl_device_type					eve::ocl::Engine::get_device_type(void)			{ EVE_ASSERT(m_p_instance); return m_p_instance->m_deviceType;			}
 EVE_FORCE_INLINE cl_int							eve::ocl::Engine::get_max_compute_units(void)	{ EVE_ASSERT(m_p_instance); return m_p_instance->m_maxComputeUnits;		}
 EVE_FORCE_INLINE cl_int							eve::ocl::Engine::get_max_clock_frequency(void)	{ EVE_ASSERT(m_p_instance); return m_p_instance->m_maxClockFrequency;	}
 EVE_FORCE_INLINE cl_int							eve::ocl::Engine::get_flops(void)				{ EVE_ASSERT(m_p_instance); return m_p_instance->m_flops;				}
+EVE_FORCE_INLINE bool							eve::ocl::Engine::has_OpenGL_sharing(void)		{ EVE_ASSERT(m_p_instance); return m_p_instance->m_bGLSharing;			}
 
 
 //=================================================================================================
 EVE_FORCE_INLINE eve::ocl::Context *			eve::ocl::Engine::get_context(void)				{ EVE_ASSERT(m_p_instance); return m_p_instance->m_pContext;				}
-EVE_FORCE_INLINE eve::ocl::Context *			eve::ocl::Engine::get_context_OpenGL(void)		{ EVE_ASSERT(m_p_instance); EVE_ASSERT(m_p_instance->m_pContextGL); return m_p_instance->m_pContextGL; }
+EVE_FORCE_INLINE eve::ocl::Context *			eve::ocl::Engine::get_context_OpenGL(void)		{ EVE_ASSERT(m_p_instance); return m_p_instance->m_pContextGL;			}
 EVE_FORCE_INLINE eve::ocl::Context *			eve::ocl::Engine::get_context_DirectX(void)		{ EVE_ASSERT(m_p_instance); EVE_ASSERT(m_p_instance->m_pContextDX); return m_p_instance->m_pContextDX; }
 
 #endif // __EVE_OPENCL_CORE_ENGINE_H__
@@ -39,6 +39,15 @@
 #endif
 
 
+// Target OpenCL 1.2 whatever headers version (Khronos headers >= 2.2 warn and default to 3.0), CPU ICDs such as POCL expose 1.2 at least.
+#ifndef CL_TARGET_OPENCL_VERSION
+#define CL_TARGET_OPENCL_VERSION		120
+#endif
+#ifndef CL_USE_DEPRECATED_OPENCL_1_2_APIS
+#define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+#endif
+
+
 #if defined(EVE_OS_WIN) || defined(EVE_OS_LINUX)
 #include <CL/cl_platform.h>
 #include <CL/cl.h>
@@ -97,10 +97,30 @@ namespace eve
 			/** \brief Set argument. Arguments are indexed using declaration order in kernel method. */
 			void setArgument(cl_uint p_index, size_t p_size, void * p_arg);
 
+
+			///////////////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get OpenCL kernel. */
+			cl_kernel getKernel(void) const;
+			/** \brief Get kernel name. */
+			const std::string & getName(void) const;
+
 		}; // class Kernel
 
 	} // namespace ocl
 
 } // namespace eve
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE cl_kernel				eve::ocl::Kernel::getKernel(void) const		{ return m_kernel;	}
+EVE_FORCE_INLINE const std::string &	eve::ocl::Kernel::getName(void) const		{ return m_name;	}
+
 #endif // __EVE_OPENCL_CORE_KERNEL_H__
@@ -32,19 +32,56 @@
 // Main header.
 #include "eve/ocl/core/Program.h"
 
+#ifndef __EVE_IO_BINARY_CACHE_H__
+#include "eve/io/BinaryCache.h"
+#endif
+
 #ifndef __EVE_STRING_UTILS_H__
 #include "eve/str/Utils.h"
 #endif
 
+#include <sstream>
+
+
+/** \brief Program binary file magic number ("EVEC"). */
+#define EVE_OCL_PROGRAM_BINARY_MAGIC		0x43455645
 
 
+namespace
+{
+	/** \brief Hash device string info \a p_info into \a p_seed. */
+	uint64_t hash_device_info(cl_device_id p_device, cl_device_info p_info, uint64_t p_seed)
+	{
+		size_t size = 0;
+		if (clGetDeviceInfo(p_device, p_info, 0, NULL, &size) != CL_SUCCESS || size == 0) {
+			return p_seed;
+		}
+		std::vector<char> str(size);
+		if (clGetDeviceInfo(p_device, p_info, size, str.data(), NULL) != CL_SUCCESS) {
+			return p_seed;
+		}
+		return eve::io::hash(str.data(), size, p_seed);
+	}
+
+} // namespace
+
+
+
+//=================================================================================================
+std::string eve::ocl::Program::m_s_cachePath = std::string(EVE_RESOURCES_PATH) + "/cache";
+
 //=================================================================================================
-eve::ocl::Program * eve::ocl::Program::create_ptr(cl_context p_context, cl_device_id p_device, const std::wstring & p_path)
+eve::ocl::Program * eve::ocl::Program::create_ptr(cl_context p_context
+												, cl_device_id p_device
+												, const std::wstring & p_path
+												, const std::string & p_preamble
+												, const std::string & p_options
+												, bool p_bAsync)
 {
 	EVE_ASSERT(p_context);
 	EVE_ASSERT(!p_path.empty());
 
-	eve::ocl::Program * ptr = new eve::ocl::Program(p_context, p_device, p_path);
+	eve::ocl::Program * ptr = new eve::ocl::Program(p_context, p_device, p_path, p_preamble, p_options, p_bAsync);
 	ptr->init();
 	return ptr;
 }
@@ -52,14 +89,27 @@ eve::ocl::Program * eve::ocl::Program::create_ptr(cl_context p_context, cl_devic
 
 
 //=================================================================================================
-eve::ocl::Program::Program(cl_context p_context, cl_device_id p_device, const std::wstring & p_path)
+eve::ocl::Program::Program(cl_context p_context, cl_device_id p_device, const std::wstring & p_path, const std::string & p_preamble, const std::string & p_options, bool p_bAsync)
 	// Inheritance
 	: eve::mem::Pointer()
 	// Members init
 	, m_context(p_context)
 	, m_device(p_device)
+	, m_program(nullptr)
 	, m_path(p_path)
 	, m_pPrgmContent(nullptr)
+	, m_preamble(p_preamble)
+	, m_options(p_options)
+	, m_bAsync(p_bAsync)
+
+	, m_binaryFile()
+	, m_key(0)
+	, m_bFromBinary(false)
+
+	, m_status(eve::ocl::ProgramStatus_Building)
+	, m_pMutex(nullptr)
+	, m_pCondition(nullptr)
+
 	, m_pKernels(nullptr)
 
 	, m_err(CL_SUCCESS)
@@ -70,41 +120,44 @@ eve::ocl::Program::Program(cl_context p_context, cl_device_id p_device, const st
 //=================================================================================================
 void eve::ocl::Program::init(void)
 {
+	m_pMutex		= new std::mutex();
+	m_pCondition	= new std::condition_variable();
+	m_pKernels		= new std::vector<eve::ocl::Kernel*>();
+
 	std::string path	= eve::str::to_string(m_path);
 	size_t prgmLength	= 0;
 
-	m_pPrgmContent = this->load(path.c_str(), "", &prgmLength);
-	EVE_ASSERT(m_pPrgmContent);
-
-	m_program = clCreateProgramWithSource(m_context, 1, (const char **)&m_pPrgmContent, &prgmLength, &m_err);
-	EVE_OCL_CHECK_PROGRAM(m_err);
-
-	m_err = clBuildProgram(m_program, 1, &m_device, NULL, NULL, NULL);
-	if (m_err != CL_SUCCESS)
+	m_pPrgmContent = this->load(path.c_str(), m_preamble.c_str(), &prgmLength);
+	if (!m_pPrgmContent)
 	{
-		char * build_log;
-		size_t ret_val_size;
-		m_err = clGetProgramBuildInfo(m_program, m_device, CL_PROGRAM_BUILD_LOG, 0, NULL, &ret_val_size);
-		EVE_OCL_CHECK_PROGRAM(m_err);
-
-		build_log = (char *)eve::mem::malloc(ret_val_size + 1);
-		m_err = clGetProgramBuildInfo(m_program, m_device, CL_PROGRAM_BUILD_LOG, ret_val_size, build_log, NULL);
-		EVE_OCL_CHECK_PROGRAM(m_err);
-
-		// to be careful, terminate with \0, there's no information in the reference whether the string is 0 terminated or not.
-		build_log[ret_val_size] = '\0';
+		EVE_LOG_ERROR("Unable to load OpenCL program %s", m_path.c_str());
+		m_status = eve::ocl::ProgramStatus_Failed;
+		return;
+	}
 
-		std::wstring wLog = eve::str::to_wstring(std::string(build_log));
-		EVE_LOG_ERROR("OpenCL program build log: %s", wLog.c_str());
-		eve::mem::free(build_log);
+	// Binary file name from cache key, binaries of another device or driver never match.
+	m_key = this->computeKey(m_pPrgmContent, prgmLength);
+	if (!m_s_cachePath.empty())
+	{
+		std::ostringstream name;
+		name << m_s_cachePath << "/" << std::hex;
+		name.width(16);
+		name.fill('0');
+		name << m_key << ".clbin";
+		m_binaryFile = name.str();
 	}
 
-	m_pKernels = new std::vector<eve::ocl::Kernel*>();
+	if (!this->createFromBinary()) {
+		this->createFromSource(prgmLength);
+	}
 }
 
 //=================================================================================================
 void eve::ocl::Program::release(void)
 {
+	// Build callback references this program, never release under it.
+	this->wait();
+
 	while (!m_pKernels->empty())
 	{
 		eve::ocl::Kernel * tmp = m_pKernels->back();
@@ -120,6 +173,179 @@ void eve::ocl::Program::release(void)
 		m_program = nullptr;
 	}
 	EVE_RELEASE_PTR_C_SAFE(m_pPrgmContent);
+
+	EVE_RELEASE_PTR_CPP(m_pCondition);
+	EVE_RELEASE_PTR_CPP(m_pMutex);
+}
+
+
+
+//=================================================================================================
+uint64_t eve::ocl::Program::computeKey(const char * p_pSource, size_t p_length) const
+{
+	const uint32_t version = EVE_OCL_PROGRAM_CACHE_VERSION;
+
+	uint64_t ret = eve::io::hash(&version, sizeof(uint32_t));
+	ret = eve::io::hash(p_pSource, p_length, ret);
+	ret = eve::io::hash(m_options.c_str(), m_options.length() + 1, ret);
+
+	const cl_device_info infos[] = { CL_DEVICE_VENDOR, CL_DEVICE_NAME, CL_DEVICE_VERSION, CL_DRIVER_VERSION };
+	for (cl_device_info info : infos) {
+		ret = hash_device_info(m_device, info, ret);
+	}
+	return ret;
+}
+
+//=================================================================================================
+bool eve::ocl::Program::createFromBinary(void)
+{
+	if (m_binaryFile.empty()) return false;
+
+	// Device is part of key, header tag is unused.
+	eve::io::BinaryHeader header;
+	header.magic	= EVE_OCL_PROGRAM_BINARY_MAGIC;
+	header.version	= EVE_OCL_PROGRAM_CACHE_VERSION;
+	header.key		= m_key;
+
+	std::vector<uint8_t> data;
+	bool exists = false;
+	bool valid = eve::io::read_binary(m_binaryFile, &header, &data, &exists);
+	if (valid)
+	{
+		// Binaries build quickly (no front end), always done synchronously.
+		size_t length = data.size();
+		const unsigned char * pData = data.data();
+		cl_int binaryStatus = CL_SUCCESS;
+		m_program = clCreateProgramWithBinary(m_context, 1, &m_device, &length, &pData, &binaryStatus, &m_err);
+		valid = (m_err == CL_SUCCESS) && (binaryStatus == CL_SUCCESS)
+			 && (clBuildProgram(m_program, 1, &m_device, m_options.c_str(), NULL, NULL) == CL_SUCCESS);
+
+		if (!valid && m_program)
+		{
+			clReleaseProgram(m_program);
+			m_program = nullptr;
+		}
+	}
+
+	// Stale or truncated binary, removed and rewritten after source build.
+	if (!valid)
+	{
+		if (exists) {
+			remove(m_binaryFile.c_str());
+		}
+		return false;
+	}
+
+	m_bFromBinary = true;
+	this->onBuild();
+	return true;
+}
+
+//=================================================================================================
+void eve::ocl::Program::createFromSource(size_t p_length)
+{
+	m_program = clCreateProgramWithSource(m_context, 1, (const char **)&m_pPrgmContent, &p_length, &m_err);
+	EVE_OCL_CHECK_PROGRAM(m_err);
+	if (m_err != CL_SUCCESS)
+	{
+		m_status = eve::ocl::ProgramStatus_Failed;
+		return;
+	}
+
+	if (m_bAsync)
+	{
+		// Callback may run before clBuildProgram() returns, on its thread or on a driver thread.
+		m_err = clBuildProgram(m_program, 1, &m_device, m_options.c_str(), &eve::ocl::Program::cb_build, this);
+		// Invalid arguments are reported without callback.
+		if (m_err != CL_SUCCESS) {
+			this->onBuild();
+		}
+	}
+	else
+	{
+		m_err = clBuildProgram(m_program, 1, &m_device, m_options.c_str(), NULL, NULL);
+		this->onBuild();
+	}
+}
+
+//=================================================================================================
+void eve::ocl::Program::writeBinary(void)
+{
+	size_t length = 0;
+	if (clGetProgramInfo(m_program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t), &length, NULL) != CL_SUCCESS || length == 0) return;
+
+	std::vector<unsigned char> data(length);
+	unsigned char * pData = data.data();
+	if (clGetProgramInfo(m_program, CL_PROGRAM_BINARIES, sizeof(unsigned char*), &pData, NULL) != CL_SUCCESS) return;
+
+	eve::io::BinaryHeader header;
+	header.magic	= EVE_OCL_PROGRAM_BINARY_MAGIC;
+	header.version	= EVE_OCL_PROGRAM_CACHE_VERSION;
+	header.key		= m_key;
+	header.length	= static_cast<uint64_t>(length);
+
+	eve::io::create_cache_directory(m_s_cachePath);
+	if (!eve::io::write_binary(m_binaryFile, header, data.data())) {
+		EVE_LOG_WARNING("Unable to write OpenCL program binary %s", eve::str::to_wstring(m_binaryFile).c_str());
+	}
+}
+
+
+
+//=================================================================================================
+void CL_CALLBACK eve::ocl::Program::cb_build(cl_program, void * p_pUserData)
+{
+	reinterpret_cast<eve::ocl::Program*>(p_pUserData)->onBuild();
+}
+
+//=================================================================================================
+void eve::ocl::Program::onBuild(void)
+{
+	cl_build_status buildStatus = CL_BUILD_ERROR;
+	clGetProgramBuildInfo(m_program, m_device, CL_PROGRAM_BUILD_STATUS, sizeof(cl_build_status), &buildStatus, NULL);
+
+	eve::ocl::ProgramStatus status = (buildStatus == CL_BUILD_SUCCESS) ? eve::ocl::ProgramStatus_Ready : eve::ocl::ProgramStatus_Failed;
+	if (status == eve::ocl::ProgramStatus_Ready)
+	{
+		if (!m_bFromBinary && !m_binaryFile.empty()) {
+			this->writeBinary();
+		}
+	}
+	else
+	{
+		size_t size = 0;
+		clGetProgramBuildInfo(m_program, m_device, CL_PROGRAM_BUILD_LOG, 0, NULL, &size);
+		// to be careful, terminate with \0, there's no information in the reference whether the string is 0 terminated or not.
+		std::string log(size + 1, '\0');
+		clGetProgramBuildInfo(m_program, m_device, CL_PROGRAM_BUILD_LOG, size, &log[0], NULL);
+
+		EVE_LOG_ERROR("OpenCL program %s build log: %s", m_path.c_str(), eve::str::to_wstring(std::string(log.c_str())).c_str());
+	}
+
+	// Status is only left once, invalid build arguments may be reported twice.
+	std::lock_guard<std::mutex> lock(*m_pMutex);
+	if (m_status == eve::ocl::ProgramStatus_Building)
+	{
+		m_status = status;
+		m_pCondition->notify_all();
+	}
+}
+
+
+
+//=================================================================================================
+bool eve::ocl::Program::wait(void)
+{
+	std::unique_lock<std::mutex> lock(*m_pMutex);
+	m_pCondition->wait(lock, [this] { return m_status != eve::ocl::ProgramStatus_Building; });
+	return m_status == eve::ocl::ProgramStatus_Ready;
+}
+
+//=================================================================================================
+eve::ocl::ProgramStatus eve::ocl::Program::getStatus(void) const
+{
+	std::lock_guard<std::mutex> lock(*m_pMutex);
+	return m_status;
 }
 
 
@@ -177,6 +403,8 @@ char * eve::ocl::Program::load(const char * p_path, const char * p_preamble, siz
 //=================================================================================================
 eve::ocl::Kernel * eve::ocl::Program::createKernel(const std::string & p_name)
 {
+	if (!this->wait()) return nullptr;
+
 	eve::ocl::Kernel * ret = eve::ocl::Kernel::create_ptr(m_program, p_name);
 	m_pKernels->push_back(ret);
 	return ret;
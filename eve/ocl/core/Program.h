@@ -45,15 +45,45 @@
 #include "eve/ocl/core/Kernel.h"
 #endif
 
+#include <condition_variable>
+#include <mutex>
+
+
+/**
+* \def EVE_OCL_PROGRAM_CACHE_VERSION
+* \brief Program binary file layout version, bump it to invalidate every cached binary.
+*/
+#define EVE_OCL_PROGRAM_CACHE_VERSION		2
+
 
 namespace eve
 {
 	namespace ocl
 	{
+		/**
+		* \enum eve::ocl::ProgramStatus
+		* \brief Program build status.
+		*/
+		enum ProgramStatus
+		{
+			ProgramStatus_Building = 0,		//!< Build in progress (asynchronous build).
+			ProgramStatus_Ready,			//!< Program built, kernels can be created.
+			ProgramStatus_Failed,			//!< Source missing or build failed, build log has been reported.
+
+			//! This value is not used. It is just there to force the compiler to map this enum to a 32 Bit integer.
+			_ProgramStatus_Force32Bit = INT_MAX
+
+		}; // enum ProgramStatus
+
+
 		/** 
 		* \class eve::ocl::Program
 		*
 		* \brief Create and maintain OpenCL program and contained kernel(s).
+		* Built program binaries (CL_PROGRAM_BINARIES) are cached on disk, keyed by hash of source (preamble included),
+		* build options and device/driver strings, so unchanged programs skip compilation on next runs.
+		* Source builds may run asynchronously (clBuildProgram callback), several programs then build in parallel
+		* and wait() (implicitly called by createKernel()) blocks until build completion.
 		*
 		* \note extends eve::mem::Pointer
 		*/
@@ -65,6 +95,10 @@ namespace eve
 			//				DATA				//
 			//////////////////////////////////////
 
+		private:
+			static std::string					m_s_cachePath;			//!< Binaries directory path (empty disables disk cache).
+
+
 		private:
 			cl_context							m_context;				//!< OpenCL context (read only).
 			cl_device_id						m_device;				//!< Linked OpenCL device (read only).
@@ -72,6 +106,17 @@ namespace eve
 			cl_program							m_program;				//!< OpenCL program.
 			std::wstring						m_path;					//!< Program file path.
 			char *								m_pPrgmContent;			//!< Program content.
+			std::string							m_preamble;				//!< Source preamble (compile time defines), prepended to file content.
+			std::string							m_options;				//!< Build options.
+			bool								m_bAsync;				//!< Specifies whether source build is asynchronous.
+
+			std::string							m_binaryFile;			//!< Cached binary file path (empty when cache is disabled).
+			uint64_t							m_key;					//!< Source, options and device hash.
+			bool								m_bFromBinary;			//!< Specifies whether program has been created from cached binary.
+
+			eve::ocl::ProgramStatus				m_status;				//!< Build status.
+			std::mutex *						m_pMutex;				//!< Build status protection.
+			std::condition_variable *			m_pCondition;			//!< Build completion signal.
 
 			std::vector<eve::ocl::Kernel*> *	m_pKernels;				//!< Program kernel(s).
 
@@ -87,19 +132,29 @@ namespace eve
 			EVE_PUBLIC_DESTRUCTOR(Program);
 
 		public:
-			/** \brief Create new pointer. */
-			static eve::ocl::Program * create_ptr(cl_context p_context, cl_device_id p_device, const std::wstring & p_path);
+			/** 
+			* \brief Create new pointer.
+			* \param p_preamble source prepended to file content, used to inject compile time defines ("#define GROUP_SIZE 64\n").
+			* \param p_options clBuildProgram() options.
+			* \param p_bAsync build from source asynchronously, cached binaries are always loaded synchronously.
+			*/
+			static eve::ocl::Program * create_ptr(cl_context p_context
+												, cl_device_id p_device
+												, const std::wstring & p_path
+												, const std::string & p_preamble = std::string()
+												, const std::string & p_options	= std::string()
+												, bool p_bAsync					= false);
 
 
 		public:
 			/** \brief Class constructor. */
-			explicit Program(cl_context p_context, cl_device_id p_device, const std::wstring & p_path);
+			explicit Program(cl_context p_context, cl_device_id p_device, const std::wstring & p_path, const std::string & p_preamble, const std::string & p_options, bool p_bAsync);
 
 
 		public:
 			/** \brief Alloc and init class members. (pure virtual) */
 			virtual void init(void);
-			/** \brief Release and delete class members. (pure virtual) */
+			/** \brief Release and delete class members, waiting for pending build. (pure virtual) */
 			virtual void release(void);
 
 
@@ -110,16 +165,72 @@ namespace eve
 			*/
 			char * load(const char * p_path, const char * p_preamble, size_t * p_length);
 
+		private:
+			/** \brief Compute cache key from source \a p_pSource, build options and device strings. */
+			uint64_t computeKey(const char * p_pSource, size_t p_length) const;
+			/** \brief Create and build program from cached binary, return false if missing, mismatching or rejected. */
+			bool createFromBinary(void);
+			/** \brief Create program from source and start build. */
+			void createFromSource(size_t p_length);
+			/** \brief Write built program binary to cache file. */
+			void writeBinary(void);
+
+		private:
+			/** \brief clBuildProgram() completion callback, \a p_pUserData is the program. */
+			static void CL_CALLBACK cb_build(cl_program p_program, void * p_pUserData);
+			/** \brief Read build status, write binary or report build log, then signal waiting threads. */
+			void onBuild(void);
+
 
 		public:
-			/** \brief Create and return OpenCL kernel. Program has ownership of created kernels. */
+			/** \brief Block until build completion, return true if program is ready. */
+			bool wait(void);
+
+
+		public:
+			/** \brief Create and return OpenCL kernel, waiting for build completion. Program has ownership of created kernels. */
 			eve::ocl::Kernel * createKernel(const std::string & p_name);
 
 
+			///////////////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get binaries directory path. */
+			static const std::string & get_cache_path(void);
+			/** \brief Set binaries directory path, empty path disables disk cache. MUST be set before programs creation. */
+			static void set_cache_path(const std::string & p_path);
+
+		public:
+			/** \brief Get build status. */
+			eve::ocl::ProgramStatus getStatus(void) const;
+			/** \brief Get whether program has been created from cached binary. */
+			bool isFromBinary(void) const;
+			/** \brief Get OpenCL program. */
+			cl_program getProgram(void) const;
+			/** \brief Get source preamble. */
+			const std::string & getPreamble(void) const;
+			/** \brief Get build options. */
+			const std::string & getOptions(void) const;
+
 		}; // class Program
 
 	} // namespace ocl
 
 } // namespace eve
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const std::string &	eve::ocl::Program::get_cache_path(void)						{ return m_s_cachePath;			}
+EVE_FORCE_INLINE void					eve::ocl::Program::set_cache_path(const std::string & p_path) { m_s_cachePath = p_path;		}
+EVE_FORCE_INLINE bool					eve::ocl::Program::isFromBinary(void) const					{ return m_bFromBinary;			}
+EVE_FORCE_INLINE cl_program				eve::ocl::Program::getProgram(void) const					{ return m_program;				}
+EVE_FORCE_INLINE const std::string &	eve::ocl::Program::getPreamble(void) const					{ return m_preamble;			}
+EVE_FORCE_INLINE const std::string &	eve::ocl::Program::getOptions(void) const					{ return m_options;				}
+
 #endif // __EVE_OPENCL_CORE_PROGRAM_H__
@@ -0,0 +1,496 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/ocl/core/TaskGraph.h"
+
+#ifndef __EVE_STRING_UTILS_H__
+#include "eve/str/Utils.h"
+#endif
+
+#include <algorithm>
+
+
+//=================================================================================================
+eve::ocl::TaskGraphEventArgs::TaskGraphEventArgs(void)
+	: eve::evt::EventArgs()
+	, pGraph(nullptr)
+	, submission(0)
+	, status(CL_COMPLETE)
+	, timings()
+{}
+
+//=================================================================================================
+eve::ocl::TaskGraphEventArgs::TaskGraphEventArgs(const eve::ocl::TaskGraphEventArgs & p_other)
+	: eve::evt::EventArgs(p_other)
+	, pGraph(p_other.pGraph)
+	, submission(p_other.submission)
+	, status(p_other.status)
+	, timings(p_other.timings)
+{}
+
+//=================================================================================================
+eve::ocl::TaskGraphEventArgs & eve::ocl::TaskGraphEventArgs::operator = (const eve::ocl::TaskGraphEventArgs & p_other)
+{
+	this->time			= p_other.time;
+	this->pGraph		= p_other.pGraph;
+	this->submission	= p_other.submission;
+	this->status		= p_other.status;
+	this->timings		= p_other.timings;
+	return *this;
+}
+
+
+
+//=================================================================================================
+eve::ocl::TaskGraph * eve::ocl::TaskGraph::create_ptr(eve::ocl::Context * p_pContext, uint32_t p_numQueues, bool p_bProfiling)
+{
+	EVE_ASSERT(p_pContext);
+
+	eve::ocl::TaskGraph * ptr = new eve::ocl::TaskGraph(p_pContext, p_numQueues, p_bProfiling);
+	ptr->init();
+	return ptr;
+}
+
+
+
+//=================================================================================================
+eve::ocl::TaskGraph::TaskGraph(eve::ocl::Context * p_pContext, uint32_t p_numQueues, bool p_bProfiling)
+	// Inheritance
+	: eve::mem::Pointer()
+	// Members init
+	, m_pContext(p_pContext)
+	, m_numQueues(std::max(p_numQueues, 1u))
+	, m_bProfiling(p_bProfiling)
+
+	, m_pQueues(nullptr)
+	, m_nextQueue(0)
+	, m_pTasks(nullptr)
+	, m_pTimings(nullptr)
+
+	, m_pending(0)
+	, m_status(CL_COMPLETE)
+	, m_submission(0)
+	, m_bIdle(true)
+	, m_pMutex(nullptr)
+	, m_pCondition(nullptr)
+
+	, m_completed()
+
+	, m_err(CL_SUCCESS)
+{}
+
+
+
+//=================================================================================================
+void eve::ocl::TaskGraph::init(void)
+{
+	m_pMutex		= new std::mutex();
+	m_pCondition	= new std::condition_variable();
+	m_pTasks		= new std::vector<Task>();
+	m_pTimings		= new std::vector<eve::ocl::TaskTiming>();
+
+	// Out-of-order execution is dropped by queues when device does not support it, events keep ordering right either way.
+	cl_command_queue_properties properties = CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+	if (m_bProfiling) {
+		properties |= CL_QUEUE_PROFILING_ENABLE;
+	}
+
+	m_pQueues = new std::vector<eve::ocl::CommandQueue*>();
+	for (uint32_t i = 0; i < m_numQueues; i++) {
+		m_pQueues->push_back(eve::ocl::CommandQueue::create_ptr(m_pContext->getContext(), m_pContext->getDevice(), properties));
+	}
+}
+
+//=================================================================================================
+void eve::ocl::TaskGraph::release(void)
+{
+	this->clear();
+
+	while (!m_pQueues->empty())
+	{
+		eve::ocl::CommandQueue * tmp = m_pQueues->back();
+		m_pQueues->pop_back();
+		EVE_RELEASE_PTR(tmp);
+	}
+	EVE_RELEASE_PTR_CPP(m_pQueues);
+
+	EVE_RELEASE_PTR_CPP(m_pTimings);
+	EVE_RELEASE_PTR_CPP(m_pTasks);
+	EVE_RELEASE_PTR_CPP(m_pCondition);
+	EVE_RELEASE_PTR_CPP(m_pMutex);
+}
+
+
+
+//=================================================================================================
+uint32_t eve::ocl::TaskGraph::addTask(Task & p_task, const std::vector<uint32_t> & p_dependencies)
+{
+	uint32_t ret = static_cast<uint32_t>(m_pTasks->size());
+
+	// Dependencies on previous tasks only, recorded order is a valid submission order (no cycle possible).
+	for (uint32_t dep : p_dependencies) {
+		EVE_ASSERT(dep < ret);
+	}
+	p_task.dependencies = p_dependencies;
+	p_task.event		= nullptr;
+
+	m_pTasks->push_back(p_task);
+	return ret;
+}
+
+//=================================================================================================
+uint32_t eve::ocl::TaskGraph::addKernel(eve::ocl::Kernel * p_pKernel, cl_uint p_workDim, const size_t * p_pGlobal, const size_t * p_pLocal, const std::vector<uint32_t> & p_dependencies)
+{
+	EVE_ASSERT(p_pKernel);
+	EVE_ASSERT(p_workDim >= 1 && p_workDim <= 3);
+	EVE_ASSERT(p_pGlobal);
+
+	Task task	 = Task();
+	task.type	 = eve::ocl::TaskType_Kernel;
+	task.name	 = p_pKernel->getName();
+	task.pKernel = p_pKernel;
+	task.workDim = p_workDim;
+	for (cl_uint i = 0; i < p_workDim; i++)
+	{
+		task.global[i] = p_pGlobal[i];
+		task.local[i]  = p_pLocal ? p_pLocal[i] : 0;
+	}
+
+	// Kernels spread over queues following transfer queue, so independent kernels may run concurrently.
+	task.queue = (m_numQueues > 1) ? 1 + (m_nextQueue++ % (m_numQueues - 1)) : 0;
+
+	return this->addTask(task, p_dependencies);
+}
+
+//=================================================================================================
+uint32_t eve::ocl::TaskGraph::addWrite(cl_mem p_buffer, size_t p_offset, size_t p_size, const void * p_pHost, const std::vector<uint32_t> & p_dependencies)
+{
+	EVE_ASSERT(p_buffer);
+	EVE_ASSERT(p_pHost);
+
+	Task task		= Task();
+	task.type		= eve::ocl::TaskType_Write;
+	task.name		= "write";
+	task.queue		= 0;
+	task.dst		= p_buffer;
+	task.dstOffset	= p_offset;
+	task.size		= p_size;
+	task.pHost		= const_cast<void*>(p_pHost);
+
+	return this->addTask(task, p_dependencies);
+}
+
+//=================================================================================================
+uint32_t eve::ocl::TaskGraph::addRead(cl_mem p_buffer, size_t p_offset, size_t p_size, void * p_pHost, const std::vector<uint32_t> & p_dependencies)
+{
+	EVE_ASSERT(p_buffer);
+	EVE_ASSERT(p_pHost);
+
+	Task task		= Task();
+	task.type		= eve::ocl::TaskType_Read;
+	task.name		= "read";
+	task.queue		= 0;
+	task.src		= p_buffer;
+	task.srcOffset	= p_offset;
+	task.size		= p_size;
+	task.pHost		= p_pHost;
+
+	return this->addTask(task, p_dependencies);
+}
+
+//=================================================================================================
+uint32_t eve::ocl::TaskGraph::addCopy(cl_mem p_src, size_t p_srcOffset, cl_mem p_dst, size_t p_dstOffset, size_t p_size, const std::vector<uint32_t> & p_dependencies)
+{
+	EVE_ASSERT(p_src);
+	EVE_ASSERT(p_dst);
+
+	Task task		= Task();
+	task.type		= eve::ocl::TaskType_Copy;
+	task.name		= "copy";
+	task.queue		= 0;
+	task.src		= p_src;
+	task.srcOffset	= p_srcOffset;
+	task.dst		= p_dst;
+	task.dstOffset	= p_dstOffset;
+	task.size		= p_size;
+
+	return this->addTask(task, p_dependencies);
+}
+
+//=================================================================================================
+uint32_t eve::ocl::TaskGraph::addMarker(const std::vector<uint32_t> & p_dependencies)
+{
+	Task task	= Task();
+	task.type	= eve::ocl::TaskType_Marker;
+	task.name	= "marker";
+	task.queue	= 0;
+
+	return this->addTask(task, p_dependencies);
+}
+
+//=================================================================================================
+uint32_t eve::ocl::TaskGraph::addExternal(cl_event p_event)
+{
+	EVE_ASSERT(p_event);
+
+	Task task	= Task();
+	task.type	= eve::ocl::TaskType_External;
+	task.name	= "external";
+	task.queue	= 0;
+
+	uint32_t ret = this->addTask(task, std::vector<uint32_t>());
+
+	m_err = clRetainEvent(p_event);
+	EVE_OCL_CHECK_COMMAND_QUEUE(m_err);
+	(*m_pTasks)[ret].event = p_event;
+
+	return ret;
+}
+
+
+
+//=================================================================================================
+void eve::ocl::TaskGraph::releaseEvents(void)
+{
+	for (Task & task : *m_pTasks)
+	{
+		if (task.event && task.type != eve::ocl::TaskType_External)
+		{
+			clReleaseEvent(task.event);
+			task.event = nullptr;
+		}
+	}
+}
+
+//=================================================================================================
+void eve::ocl::TaskGraph::clear(void)
+{
+	this->wait();
+	this->releaseEvents();
+
+	for (Task & task : *m_pTasks)
+	{
+		if (task.event) {
+			clReleaseEvent(task.event);
+		}
+	}
+	m_pTasks->clear();
+	m_nextQueue = 0;
+}
+
+//=================================================================================================
+cl_int eve::ocl::TaskGraph::enqueue(Task & p_task, const std::vector<cl_event> & p_waitList)
+{
+	cl_command_queue queue		= (*m_pQueues)[p_task.queue]->getQueue();
+	cl_uint numWait				= static_cast<cl_uint>(p_waitList.size());
+	const cl_event * pWaitList	= p_waitList.empty() ? NULL : p_waitList.data();
+
+	switch (p_task.type)
+	{
+	case eve::ocl::TaskType_Kernel:
+		return clEnqueueNDRangeKernel(queue, p_task.pKernel->getKernel(), p_task.workDim, NULL, p_task.global, (p_task.local[0] != 0) ? p_task.local : NULL, numWait, pWaitList, &p_task.event);
+
+	case eve::ocl::TaskType_Write:
+		return clEnqueueWriteBuffer(queue, p_task.dst, CL_FALSE, p_task.dstOffset, p_task.size, p_task.pHost, numWait, pWaitList, &p_task.event);
+
+	case eve::ocl::TaskType_Read:
+		return clEnqueueReadBuffer(queue, p_task.src, CL_FALSE, p_task.srcOffset, p_task.size, p_task.pHost, numWait, pWaitList, &p_task.event);
+
+	case eve::ocl::TaskType_Copy:
+		return clEnqueueCopyBuffer(queue, p_task.src, p_task.dst, p_task.srcOffset, p_task.dstOffset, p_task.size, numWait, pWaitList, &p_task.event);
+
+	case eve::ocl::TaskType_Marker:
+		return clEnqueueMarkerWithWaitList(queue, numWait, pWaitList, &p_task.event);
+
+	default:
+		EVE_ASSERT_FAILURE;
+		return CL_INVALID_VALUE;
+	}
+}
+
+//=================================================================================================
+void eve::ocl::TaskGraph::submit(void)
+{
+	// Previous submission events are still referenced by runtime callbacks until completion.
+	this->wait();
+	this->releaseEvents();
+
+	uint32_t numCommands = 0;
+	for (const Task & task : *m_pTasks)
+	{
+		if (task.type != eve::ocl::TaskType_External) {
+			numCommands++;
+		}
+	}
+
+	m_submission++;
+	m_status.store(CL_COMPLETE);
+	if (numCommands == 0)
+	{
+		this->onComplete();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(*m_pMutex);
+		m_bIdle = false;
+	}
+	// Callbacks may fire while enqueuing, pending count is set first.
+	m_pending.store(numCommands);
+
+	std::vector<cl_event> waitList;
+	for (Task & task : *m_pTasks)
+	{
+		if (task.type == eve::ocl::TaskType_External) continue;
+
+		// A dependency which failed to enqueue has no event, its dependents are skipped.
+		waitList.clear();
+		m_err = CL_SUCCESS;
+		for (uint32_t dep : task.dependencies)
+		{
+			cl_event event = (*m_pTasks)[dep].event;
+			if (!event) {
+				m_err = CL_INVALID_EVENT_WAIT_LIST;
+				break;
+			}
+			waitList.push_back(event);
+		}
+
+		if (m_err == CL_SUCCESS) {
+			m_err = this->enqueue(task, waitList);
+		}
+		if (m_err == CL_SUCCESS) {
+			m_err = clSetEventCallback(task.event, CL_COMPLETE, &eve::ocl::TaskGraph::cb_complete, this);
+		}
+		if (m_err != CL_SUCCESS)
+		{
+			// Command without callback, account for it now.
+			EVE_LOG_ERROR("OpenCL task %s submission failed (error %d).", eve::str::to_wstring(task.name).c_str(), m_err);
+			if (task.event)
+			{
+				clReleaseEvent(task.event);
+				task.event = nullptr;
+			}
+			eve::ocl::TaskGraph::cb_complete(nullptr, m_err, this);
+		}
+	}
+
+	for (eve::ocl::CommandQueue * queue : *m_pQueues) {
+		queue->flush();
+	}
+}
+
+//=================================================================================================
+bool eve::ocl::TaskGraph::wait(void)
+{
+	std::unique_lock<std::mutex> lock(*m_pMutex);
+	m_pCondition->wait(lock, [this] { return m_bIdle; });
+	return m_status.load() == CL_COMPLETE;
+}
+
+
+
+//=================================================================================================
+void CL_CALLBACK eve::ocl::TaskGraph::cb_complete(cl_event, cl_int p_status, void * p_pUserData)
+{
+	eve::ocl::TaskGraph * pGraph = reinterpret_cast<eve::ocl::TaskGraph*>(p_pUserData);
+
+	// Keep first failure.
+	if (p_status < 0)
+	{
+		int32_t expected = CL_COMPLETE;
+		pGraph->m_status.compare_exchange_strong(expected, p_status);
+	}
+
+	if (pGraph->m_pending.fetch_sub(1) == 1) {
+		pGraph->onComplete();
+	}
+}
+
+//=================================================================================================
+void eve::ocl::TaskGraph::onComplete(void)
+{
+	// Every command is complete, profiling info is available.
+	m_pTimings->clear();
+	if (m_bProfiling)
+	{
+		for (const Task & task : *m_pTasks)
+		{
+			if (task.type == eve::ocl::TaskType_External || !task.event) continue;
+
+			eve::ocl::TaskTiming timing = eve::ocl::TaskTiming();
+			timing.name	 = task.name;
+			timing.type	 = task.type;
+			timing.queue = task.queue;
+			if ((*m_pQueues)[task.queue]->isProfiling())
+			{
+				clGetEventProfilingInfo(task.event, CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), &timing.queued, NULL);
+				clGetEventProfilingInfo(task.event, CL_PROFILING_COMMAND_SUBMIT, sizeof(cl_ulong), &timing.submit, NULL);
+				clGetEventProfilingInfo(task.event, CL_PROFILING_COMMAND_START,	 sizeof(cl_ulong), &timing.start,  NULL);
+				clGetEventProfilingInfo(task.event, CL_PROFILING_COMMAND_END,	 sizeof(cl_ulong), &timing.end,	   NULL);
+			}
+			m_pTimings->push_back(timing);
+		}
+	}
+
+	// Copied before turning idle, a waiting thread may resubmit right away.
+	eve::ocl::TaskGraphEventArgs args;
+	args.pGraph		= this;
+	args.submission	= m_submission;
+	args.status		= m_status.load();
+	args.timings	= *m_pTimings;
+
+	{
+		std::lock_guard<std::mutex> lock(*m_pMutex);
+		m_bIdle = true;
+		m_pCondition->notify_all();
+	}
+
+	// Graph is idle, listeners may resubmit it.
+	eve::evt::notify_event(m_completed, args);
+}
+
+
+
+//=================================================================================================
+cl_ulong eve::ocl::TaskGraph::getTimeSpan(void) const
+{
+	cl_ulong start	= 0;
+	cl_ulong end	= 0;
+	for (const eve::ocl::TaskTiming & timing : *m_pTimings)
+	{
+		if (timing.end == 0) continue;
+		if (start == 0 || timing.start < start) start = timing.start;
+		end = std::max(end, timing.end);
+	}
+	return end - start;
+}
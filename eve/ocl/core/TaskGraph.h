@@ -0,0 +1,342 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_OPENCL_CORE_TASK_GRAPH_H__
+#define __EVE_OPENCL_CORE_TASK_GRAPH_H__
+
+#ifndef __EVE_MEMORY_INCLUDES_H__
+#include "eve/mem/Includes.h"
+#endif
+
+#ifndef __EVE_EVT_INCLUDES_H__
+#include "eve/evt/Includes.h"
+#endif
+
+#ifndef __EVE_OPENCL_CORE_CONTEXT_H__
+#include "eve/ocl/core/Context.h"
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+
+/**
+* \def EVE_OCL_TASK_NONE
+* \brief Invalid task ID.
+*/
+#define EVE_OCL_TASK_NONE			0xFFFFFFFF
+
+
+namespace eve
+{
+	namespace ocl
+	{
+		/**
+		* \enum eve::ocl::TaskType
+		* \brief Task graph command types.
+		*/
+		enum TaskType
+		{
+			TaskType_Kernel = 0,			//!< NDRange kernel execution.
+			TaskType_Write,					//!< Host to buffer transfer.
+			TaskType_Read,					//!< Buffer to host transfer.
+			TaskType_Copy,					//!< Buffer to buffer copy.
+			TaskType_Marker,				//!< Dependencies join, no work.
+			TaskType_External,				//!< Event created outside of graph (user event, other API interop).
+
+			//! This value is not used. It is just there to force the compiler to map this enum to a 32 Bit integer.
+			_TaskType_Force32Bit = INT_MAX
+
+		}; // enum TaskType
+
+
+		/**
+		* \struct eve::ocl::TaskTiming
+		* \brief Task profiling info in device nanoseconds, zero when queue profiling is disabled.
+		*/
+		struct TaskTiming
+		{
+			std::string			name;				//!< Task name.
+			eve::ocl::TaskType	type;				//!< Task type.
+			uint32_t			queue;				//!< Submission queue index.
+			cl_ulong			queued;				//!< CL_PROFILING_COMMAND_QUEUED.
+			cl_ulong			submit;				//!< CL_PROFILING_COMMAND_SUBMIT.
+			cl_ulong			start;				//!< CL_PROFILING_COMMAND_START.
+			cl_ulong			end;				//!< CL_PROFILING_COMMAND_END.
+		};
+
+
+		class TaskGraph;
+
+		/**
+		* \class eve::ocl::TaskGraphEventArgs
+		* \brief Task graph completion event arguments.
+		* \note extends eve::evt::EventArgs.
+		*/
+		class TaskGraphEventArgs
+			: public eve::evt::EventArgs
+		{
+		public:
+			eve::ocl::TaskGraph *	pGraph;			//!< Completed graph.
+			uint64_t				submission;		//!< Completed submission index.
+			cl_int					status;			//!< CL_COMPLETE, or first negative command execution status.
+			std::vector<eve::ocl::TaskTiming>	timings;	//!< Completed submission timings (copy, empty while profiling is disabled).
+
+			/** \brief Default constructor. */
+			TaskGraphEventArgs(void);
+			/** \brief Copy constructor. */
+			TaskGraphEventArgs(const TaskGraphEventArgs & p_other);
+			/** \brief Assignment operator. */
+			TaskGraphEventArgs & operator = (const TaskGraphEventArgs & p_other);
+		};
+
+		/** \brief Task graph event type definition. */
+		typedef eve::evt::TEvent<eve::ocl::TaskGraphEventArgs> TaskGraphEvent;
+
+
+		/** 
+		* \class eve::ocl::TaskGraph
+		*
+		* \brief Event graph command submission.
+		* Kernels and buffer transfers are recorded as tasks declaring dependencies on previously added tasks, submit() enqueues
+		* them with cl_event wait lists over several command queues (out-of-order when supported by device), so independent
+		* transfers and kernels overlap without finishing queues. Transfers go to queue 0, kernels are spread over remaining queues.
+		* Completion is notified through eve::evt from OpenCL runtime callback thread, listeners MUST be thread safe.
+		* Listeners run once graph turned idle and get a copy of submission timings, so they may resubmit (submit(), wait(), clear())
+		* but MUST NOT release the graph.
+		* Kernel arguments are captured at submit() time, so graph can be resubmitted once previous submission completed.
+		*
+		* \note extends eve::mem::Pointer
+		*/
+		class TaskGraph final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			/** \brief Recorded task. */
+			struct Task
+			{
+				eve::ocl::TaskType		type;				//!< Task type.
+				std::string				name;				//!< Task name (profiling).
+				std::vector<uint32_t>	dependencies;		//!< Tasks to wait for.
+				uint32_t				queue;				//!< Submission queue index.
+
+				eve::ocl::Kernel *		pKernel;			//!< Kernel (kernel task).
+				cl_uint					workDim;			//!< Work dimensions (kernel task).
+				size_t					global[3];			//!< Global work size (kernel task).
+				size_t					local[3];			//!< Local work size, zero lets driver choose (kernel task).
+
+				cl_mem					src;				//!< Source buffer (read, copy tasks).
+				cl_mem					dst;				//!< Destination buffer (write, copy tasks).
+				size_t					srcOffset;			//!< Source offset in bytes.
+				size_t					dstOffset;			//!< Destination offset in bytes.
+				size_t					size;				//!< Transfer size in bytes.
+				void *					pHost;				//!< Host memory (write, read tasks).
+
+				cl_event				event;				//!< Last submission event (retained external event for external task).
+			};
+
+		private:
+			eve::ocl::Context *						m_pContext;			//!< OpenCL context (read only).
+			uint32_t								m_numQueues;		//!< Requested command queues amount.
+			bool									m_bProfiling;		//!< Specifies whether profiling is requested.
+
+			std::vector<eve::ocl::CommandQueue*> *	m_pQueues;			//!< Command queues.
+			uint32_t								m_nextQueue;		//!< Next kernel queue (round robin).
+			std::vector<Task> *						m_pTasks;			//!< Recorded tasks, in dependency order.
+			std::vector<eve::ocl::TaskTiming> *		m_pTimings;			//!< Last completed submission timings.
+
+			std::atomic<uint32_t>					m_pending;			//!< Pending tasks of current submission.
+			std::atomic<int32_t>					m_status;			//!< Current submission status.
+			uint64_t								m_submission;		//!< Submissions counter.
+			bool									m_bIdle;			//!< Specifies whether no submission is pending (completion notified).
+			std::mutex *							m_pMutex;			//!< Idle state protection.
+			std::condition_variable *				m_pCondition;		//!< Submission completion signal.
+
+			eve::ocl::TaskGraphEvent				m_completed;		//!< Submission completed event.
+
+		private:
+			cl_int									m_err;				//!< Error code.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(TaskGraph);
+			EVE_PUBLIC_DESTRUCTOR(TaskGraph);
+
+		public:
+			/** \brief Create new pointer, using \a p_numQueues command queues (at least 1) of context \a p_pContext. */
+			static eve::ocl::TaskGraph * create_ptr(eve::ocl::Context * p_pContext, uint32_t p_numQueues = 2, bool p_bProfiling = false);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit TaskGraph(eve::ocl::Context * p_pContext, uint32_t p_numQueues, bool p_bProfiling);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members, waiting for pending submission. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Add kernel \a p_pKernel execution over \a p_workDim dimensions, null \a p_pLocal lets driver choose work group size. */
+			uint32_t addKernel(eve::ocl::Kernel * p_pKernel, cl_uint p_workDim, const size_t * p_pGlobal, const size_t * p_pLocal, const std::vector<uint32_t> & p_dependencies = std::vector<uint32_t>());
+			/** \brief Add \a p_size bytes transfer from host \a p_pHost to buffer \a p_buffer at \a p_offset, host memory MUST stay valid until completion. */
+			uint32_t addWrite(cl_mem p_buffer, size_t p_offset, size_t p_size, const void * p_pHost, const std::vector<uint32_t> & p_dependencies = std::vector<uint32_t>());
+			/** \brief Add \a p_size bytes transfer from buffer \a p_buffer at \a p_offset to host \a p_pHost. */
+			uint32_t addRead(cl_mem p_buffer, size_t p_offset, size_t p_size, void * p_pHost, const std::vector<uint32_t> & p_dependencies = std::vector<uint32_t>());
+			/** \brief Add \a p_size bytes copy from buffer \a p_src to buffer \a p_dst. */
+			uint32_t addCopy(cl_mem p_src, size_t p_srcOffset, cl_mem p_dst, size_t p_dstOffset, size_t p_size, const std::vector<uint32_t> & p_dependencies = std::vector<uint32_t>());
+			/** \brief Add dependencies join point. */
+			uint32_t addMarker(const std::vector<uint32_t> & p_dependencies);
+			/** \brief Add event \a p_event created outside of graph (retained), following tasks may depend on it. */
+			uint32_t addExternal(cl_event p_event);
+
+		private:
+			/** \brief Append task \a p_task, checking dependencies refer to previous tasks. */
+			uint32_t addTask(Task & p_task, const std::vector<uint32_t> & p_dependencies);
+
+
+		public:
+			/** \brief Release every task (waiting for pending submission). */
+			void clear(void);
+			/** \brief Enqueue every task with its dependencies wait list and flush queues, previous submission MUST be complete. */
+			void submit(void);
+			/** \brief Block until current submission completion, return true if every command succeeded. */
+			bool wait(void);
+
+		private:
+			/** \brief Release previous submission events. */
+			void releaseEvents(void);
+			/** \brief Enqueue task \a p_task. */
+			cl_int enqueue(Task & p_task, const std::vector<cl_event> & p_waitList);
+
+
+		private:
+			/** \brief Command completion callback, \a p_pUserData is the graph. */
+			static void CL_CALLBACK cb_complete(cl_event p_event, cl_int p_status, void * p_pUserData);
+			/** \brief Collect profiling info, turn idle then notify completion listeners. */
+			void onComplete(void);
+
+
+		public:
+			/**
+			* \brief Register listener class to graph events.
+			* Listener class must provide graph event handler method using the following signature:
+			*		void cb_evtTaskGraphCompleted(eve::ocl::TaskGraphEventArgs & p_args)
+			*/
+			template<class ListenerClass>
+			void registerEvents(ListenerClass * p_pListener, int32_t p_prio = eve::evt::orderApp);
+			/**
+			* \brief Unregister listener class from graph events.
+			* Listener class must provide graph event handler method using the following signature:
+			*		void cb_evtTaskGraphCompleted(eve::ocl::TaskGraphEventArgs & p_args)
+			*/
+			template<class ListenerClass>
+			void unregisterEvents(ListenerClass * p_pListener, int32_t p_prio = eve::evt::orderApp);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get recorded tasks amount. */
+			uint32_t getNumTasks(void) const;
+			/** \brief Get task \a p_id last submission event (nullptr before submission). */
+			cl_event getEvent(uint32_t p_id) const;
+			/** \brief Set task \a p_id name, reported in profiling info. */
+			void setName(uint32_t p_id, const std::string & p_name);
+			/** \brief Set task \a p_id submission queue index. */
+			void setQueue(uint32_t p_id, uint32_t p_queue);
+
+		public:
+			/** \brief Get command queues amount. */
+			uint32_t getNumQueues(void) const;
+			/** \brief Get command queue \a p_index. */
+			eve::ocl::CommandQueue * getQueue(uint32_t p_index) const;
+
+		public:
+			/** \brief Get last completed submission per task profiling info (empty while profiling is disabled), valid until next submit(). */
+			const std::vector<eve::ocl::TaskTiming> & getTimings(void) const;
+			/** \brief Get last completed submission device time span (first command start to last command end) in nanoseconds. */
+			cl_ulong getTimeSpan(void) const;
+			/** \brief Get submissions amount. */
+			uint64_t getNumSubmissions(void) const;
+
+		}; // class TaskGraph
+
+	} // namespace ocl
+
+} // namespace eve
+
+
+//=================================================================================================
+template<class ListenerClass>
+void eve::ocl::TaskGraph::registerEvents(ListenerClass * p_pListener, int32_t p_prio)
+{
+	eve::evt::add_listener(m_completed, p_pListener, &ListenerClass::cb_evtTaskGraphCompleted, p_prio);
+}
+
+//=================================================================================================
+template<class ListenerClass>
+void eve::ocl::TaskGraph::unregisterEvents(ListenerClass * p_pListener, int32_t p_prio)
+{
+	eve::evt::remove_listener(m_completed, p_pListener, &ListenerClass::cb_evtTaskGraphCompleted, p_prio);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE uint32_t									eve::ocl::TaskGraph::getNumTasks(void) const				{ return static_cast<uint32_t>(m_pTasks->size());	}
+EVE_FORCE_INLINE cl_event									eve::ocl::TaskGraph::getEvent(uint32_t p_id) const			{ return (*m_pTasks)[p_id].event;					}
+EVE_FORCE_INLINE void										eve::ocl::TaskGraph::setName(uint32_t p_id, const std::string & p_name) { (*m_pTasks)[p_id].name = p_name;		}
+EVE_FORCE_INLINE void										eve::ocl::TaskGraph::setQueue(uint32_t p_id, uint32_t p_queue) { EVE_ASSERT(p_queue < m_pQueues->size()); (*m_pTasks)[p_id].queue = p_queue; }
+EVE_FORCE_INLINE uint32_t									eve::ocl::TaskGraph::getNumQueues(void) const				{ return static_cast<uint32_t>(m_pQueues->size());	}
+EVE_FORCE_INLINE eve::ocl::CommandQueue *					eve::ocl::TaskGraph::getQueue(uint32_t p_index) const		{ return (*m_pQueues)[p_index];						}
+EVE_FORCE_INLINE const std::vector<eve::ocl::TaskTiming> &	eve::ocl::TaskGraph::getTimings(void) const					{ return *m_pTimings;								}
+EVE_FORCE_INLINE uint64_t									eve::ocl::TaskGraph::getNumSubmissions(void) const			{ return m_submission;								}
+
+#endif // __EVE_OPENCL_CORE_TASK_GRAPH_H__
@@ -0,0 +1,537 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/ogl/core/Dispatch.h"
+
+#ifndef __EVE_MESSAGING_INCLUDES_H__
+#include "eve/mess/Includes.h"
+#endif
+
+
+eve::ogl::DispatchMode	eve::ogl::Dispatch::m_mode			= eve::ogl::DispatchMode_Native;
+std::atomic<bool>		eve::ogl::Dispatch::m_bLog(false);
+bool					eve::ogl::Dispatch::m_bInstalled	= false;
+
+
+namespace
+{
+	// Statistics counters, incremented by render threads and read by any thread.
+	struct Counters
+	{
+		std::atomic<uint64_t>	numCalls;
+		std::atomic<uint64_t>	numDraws;
+		std::atomic<uint64_t>	numDrawCommands;
+		std::atomic<uint64_t>	numBinds;
+		std::atomic<uint64_t>	numUploads;
+		std::atomic<uint64_t>	numUploadBytes;
+		std::atomic<uint64_t>	numSyncs;
+	};
+
+	Counters	s_total;	// Since last reset.
+	Counters	s_frame;	// Since last frame start.
+	Counters	s_last;		// Last complete frame.
+
+
+	//=============================================================================================
+	eve::ogl::DispatchStats snapshot(const Counters & p_counters)
+	{
+		eve::ogl::DispatchStats ret;
+		ret.numCalls		= p_counters.numCalls.load(std::memory_order_relaxed);
+		ret.numDraws		= p_counters.numDraws.load(std::memory_order_relaxed);
+		ret.numDrawCommands	= p_counters.numDrawCommands.load(std::memory_order_relaxed);
+		ret.numBinds		= p_counters.numBinds.load(std::memory_order_relaxed);
+		ret.numUploads		= p_counters.numUploads.load(std::memory_order_relaxed);
+		ret.numUploadBytes	= p_counters.numUploadBytes.load(std::memory_order_relaxed);
+		ret.numSyncs		= p_counters.numSyncs.load(std::memory_order_relaxed);
+		return ret;
+	}
+
+	//=============================================================================================
+	void reset(Counters & p_counters)
+	{
+		p_counters.numCalls.store(0, std::memory_order_relaxed);
+		p_counters.numDraws.store(0, std::memory_order_relaxed);
+		p_counters.numDrawCommands.store(0, std::memory_order_relaxed);
+		p_counters.numBinds.store(0, std::memory_order_relaxed);
+		p_counters.numUploads.store(0, std::memory_order_relaxed);
+		p_counters.numUploadBytes.store(0, std::memory_order_relaxed);
+		p_counters.numSyncs.store(0, std::memory_order_relaxed);
+	}
+
+	//=============================================================================================
+	void roll(std::atomic<uint64_t> & p_frame, std::atomic<uint64_t> & p_last)
+	{
+		p_last.store(p_frame.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+} // namespace
+
+
+/** \def EVE_OGL_DISPATCH_COUNT Add \a VALUE to counter \a FIELD of total and current frame statistics. */
+#define EVE_OGL_DISPATCH_COUNT(FIELD, VALUE)											\
+	s_total.FIELD.fetch_add(static_cast<uint64_t>(VALUE), std::memory_order_relaxed);	\
+	s_frame.FIELD.fetch_add(static_cast<uint64_t>(VALUE), std::memory_order_relaxed);
+
+
+namespace
+{
+	// Dispatch table, hooks forward to it.
+	struct Table
+	{
+		PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC				DrawElementsInstancedBaseVertex;
+		PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC	DrawElementsInstancedBaseVertexBaseInstance;
+		PFNGLMULTIDRAWELEMENTSINDIRECTPROC						MultiDrawElementsIndirect;
+		PFNGLCLEARBUFFERFVPROC									ClearBufferfv;
+		PFNGLUSEPROGRAMPROC										UseProgram;
+		PFNGLBINDPROGRAMPIPELINEPROC							BindProgramPipeline;
+		PFNGLBINDVERTEXARRAYPROC								BindVertexArray;
+		PFNGLBINDVERTEXBUFFERPROC								BindVertexBuffer;
+		PFNGLBINDBUFFERPROC										BindBuffer;
+		PFNGLBINDBUFFERBASEPROC									BindBufferBase;
+		PFNGLBINDBUFFERRANGEPROC								BindBufferRange;
+		PFNGLBINDFRAMEBUFFERPROC								BindFramebuffer;
+		PFNGLACTIVETEXTUREPROC									ActiveTexture;
+		PFNGLBUFFERDATAPROC										BufferData;
+		PFNGLBUFFERSUBDATAPROC									BufferSubData;
+		PFNGLBUFFERSTORAGEPROC									BufferStorage;
+		PFNGLMAPBUFFERRANGEPROC									MapBufferRange;
+		PFNGLGENERATEMIPMAPPROC									GenerateMipmap;
+		PFNGLFENCESYNCPROC										FenceSync;
+		PFNGLCLIENTWAITSYNCPROC									ClientWaitSync;
+		PFNGLDELETESYNCPROC										DeleteSync;
+	};
+
+	Table	s_driver	= {};	// Captured driver entry points.
+	Table	s_table		= {};	// Active dispatch table, driver or empty entry points.
+
+	int		s_nullSync	= 0;	// Dropped fence, its address is returned as sync object.
+
+	//=============================================================================================
+	GLsync null_sync(void) { return reinterpret_cast<GLsync>(&s_nullSync); }
+
+
+
+	//=============================================================================================
+	void GLAPIENTRY null_DrawElementsInstancedBaseVertex(GLenum, GLsizei, GLenum, const void *, GLsizei, GLint) {}
+
+	//=============================================================================================
+	void GLAPIENTRY null_DrawElementsInstancedBaseVertexBaseInstance(GLenum, GLsizei, GLenum, const void *, GLsizei, GLint, GLuint) {}
+
+	//=============================================================================================
+	void GLAPIENTRY null_MultiDrawElementsIndirect(GLenum, GLenum, const void *, GLsizei, GLsizei) {}
+
+	//=============================================================================================
+	void GLAPIENTRY null_ClearBufferfv(GLenum, GLint, const GLfloat *) {}
+
+	//=============================================================================================
+	void GLAPIENTRY null_BufferData(GLenum target, GLsizeiptr size, const void *, GLenum usage)
+	{
+		// Storage is still allocated so the buffer can be mapped, data copy is dropped.
+		s_driver.BufferData(target, size, nullptr, usage);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY null_BufferSubData(GLenum, GLintptr, GLsizeiptr, const void *) {}
+
+	//=============================================================================================
+	void GLAPIENTRY null_BufferStorage(GLenum target, GLsizeiptr size, const void *, GLbitfield flags)
+	{
+		// Storage is still allocated so the buffer can be mapped, data copy is dropped.
+		s_driver.BufferStorage(target, size, nullptr, flags);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY null_GenerateMipmap(GLenum) {}
+
+	//=============================================================================================
+	GLsync GLAPIENTRY null_FenceSync(GLenum, GLbitfield) { return null_sync(); }
+
+
+
+	//=============================================================================================
+	void fill_table(eve::ogl::DispatchMode p_mode)
+	{
+		s_table = s_driver;
+
+		if (p_mode == eve::ogl::DispatchMode_Record_No_Draw || p_mode == eve::ogl::DispatchMode_Record_No_Work)
+		{
+			s_table.DrawElementsInstancedBaseVertex				= null_DrawElementsInstancedBaseVertex;
+			s_table.DrawElementsInstancedBaseVertexBaseInstance	= null_DrawElementsInstancedBaseVertexBaseInstance;
+			s_table.MultiDrawElementsIndirect					= null_MultiDrawElementsIndirect;
+		}
+
+		if (p_mode == eve::ogl::DispatchMode_Record_No_Work)
+		{
+			s_table.ClearBufferfv	= null_ClearBufferfv;
+			s_table.BufferData		= null_BufferData;
+			s_table.BufferSubData	= null_BufferSubData;
+			s_table.BufferStorage	= null_BufferStorage;
+			s_table.GenerateMipmap	= null_GenerateMipmap;
+			s_table.FenceSync		= null_FenceSync;
+		}
+	}
+
+
+
+	//=============================================================================================
+	void GLAPIENTRY hook_DrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void * indices, GLsizei primcount, GLint basevertex)
+	{
+		eve::ogl::Dispatch::record("glDrawElementsInstancedBaseVertex");
+		EVE_OGL_DISPATCH_COUNT(numDraws, 1);
+		EVE_OGL_DISPATCH_COUNT(numDrawCommands, 1);
+		s_table.DrawElementsInstancedBaseVertex(mode, count, type, indices, primcount, basevertex);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_DrawElementsInstancedBaseVertexBaseInstance(GLenum mode, GLsizei count, GLenum type, const void * indices, GLsizei primcount, GLint basevertex, GLuint baseinstance)
+	{
+		eve::ogl::Dispatch::record("glDrawElementsInstancedBaseVertexBaseInstance");
+		EVE_OGL_DISPATCH_COUNT(numDraws, 1);
+		EVE_OGL_DISPATCH_COUNT(numDrawCommands, 1);
+		s_table.DrawElementsInstancedBaseVertexBaseInstance(mode, count, type, indices, primcount, basevertex, baseinstance);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_MultiDrawElementsIndirect(GLenum mode, GLenum type, const void * indirect, GLsizei primcount, GLsizei stride)
+	{
+		eve::ogl::Dispatch::record("glMultiDrawElementsIndirect");
+		EVE_OGL_DISPATCH_COUNT(numDraws, 1);
+		EVE_OGL_DISPATCH_COUNT(numDrawCommands, primcount);
+		s_table.MultiDrawElementsIndirect(mode, type, indirect, primcount, stride);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_ClearBufferfv(GLenum buffer, GLint drawBuffer, const GLfloat * value)
+	{
+		eve::ogl::Dispatch::record("glClearBufferfv");
+		s_table.ClearBufferfv(buffer, drawBuffer, value);
+	}
+
+
+
+	//=============================================================================================
+	void GLAPIENTRY hook_UseProgram(GLuint program)
+	{
+		eve::ogl::Dispatch::record("glUseProgram");
+		EVE_OGL_DISPATCH_COUNT(numBinds, 1);
+		s_table.UseProgram(program);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_BindProgramPipeline(GLuint pipeline)
+	{
+		eve::ogl::Dispatch::record("glBindProgramPipeline");
+		EVE_OGL_DISPATCH_COUNT(numBinds, 1);
+		s_table.BindProgramPipeline(pipeline);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_BindVertexArray(GLuint array)
+	{
+		eve::ogl::Dispatch::record("glBindVertexArray");
+		EVE_OGL_DISPATCH_COUNT(numBinds, 1);
+		s_table.BindVertexArray(array);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_BindVertexBuffer(GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride)
+	{
+		eve::ogl::Dispatch::record("glBindVertexBuffer");
+		EVE_OGL_DISPATCH_COUNT(numBinds, 1);
+		s_table.BindVertexBuffer(bindingindex, buffer, offset, stride);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_BindBuffer(GLenum target, GLuint buffer)
+	{
+		eve::ogl::Dispatch::record("glBindBuffer");
+		EVE_OGL_DISPATCH_COUNT(numBinds, 1);
+		s_table.BindBuffer(target, buffer);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+	{
+		eve::ogl::Dispatch::record("glBindBufferBase");
+		EVE_OGL_DISPATCH_COUNT(numBinds, 1);
+		s_table.BindBufferBase(target, index, buffer);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+	{
+		eve::ogl::Dispatch::record("glBindBufferRange");
+		EVE_OGL_DISPATCH_COUNT(numBinds, 1);
+		s_table.BindBufferRange(target, index, buffer, offset, size);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_BindFramebuffer(GLenum target, GLuint framebuffer)
+	{
+		eve::ogl::Dispatch::record("glBindFramebuffer");
+		EVE_OGL_DISPATCH_COUNT(numBinds, 1);
+		s_table.BindFramebuffer(target, framebuffer);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_ActiveTexture(GLenum texture)
+	{
+		eve::ogl::Dispatch::record("glActiveTexture");
+		EVE_OGL_DISPATCH_COUNT(numBinds, 1);
+		s_table.ActiveTexture(texture);
+	}
+
+
+
+	//=============================================================================================
+	void GLAPIENTRY hook_BufferData(GLenum target, GLsizeiptr size, const void * data, GLenum usage)
+	{
+		eve::ogl::Dispatch::record("glBufferData");
+		EVE_OGL_DISPATCH_COUNT(numUploads, 1);
+		EVE_OGL_DISPATCH_COUNT(numUploadBytes, size);
+		s_table.BufferData(target, size, data, usage);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void * data)
+	{
+		eve::ogl::Dispatch::record("glBufferSubData");
+		EVE_OGL_DISPATCH_COUNT(numUploads, 1);
+		EVE_OGL_DISPATCH_COUNT(numUploadBytes, size);
+		s_table.BufferSubData(target, offset, size, data);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_BufferStorage(GLenum target, GLsizeiptr size, const void * data, GLbitfield flags)
+	{
+		eve::ogl::Dispatch::record("glBufferStorage");
+		EVE_OGL_DISPATCH_COUNT(numUploads, 1);
+		EVE_OGL_DISPATCH_COUNT(numUploadBytes, size);
+		s_table.BufferStorage(target, size, data, flags);
+	}
+
+	//=============================================================================================
+	void * GLAPIENTRY hook_MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+	{
+		eve::ogl::Dispatch::record("glMapBufferRange");
+		// Persistent mappings are counted once, at map time.
+		if (access & GL_MAP_WRITE_BIT)
+		{
+			EVE_OGL_DISPATCH_COUNT(numUploads, 1);
+			EVE_OGL_DISPATCH_COUNT(numUploadBytes, length);
+		}
+		return s_table.MapBufferRange(target, offset, length, access);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_GenerateMipmap(GLenum target)
+	{
+		eve::ogl::Dispatch::record("glGenerateMipmap");
+		s_table.GenerateMipmap(target);
+	}
+
+
+
+	//=============================================================================================
+	GLsync GLAPIENTRY hook_FenceSync(GLenum condition, GLbitfield flags)
+	{
+		eve::ogl::Dispatch::record("glFenceSync");
+		EVE_OGL_DISPATCH_COUNT(numSyncs, 1);
+		return s_table.FenceSync(condition, flags);
+	}
+
+	//=============================================================================================
+	GLenum GLAPIENTRY hook_ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+	{
+		eve::ogl::Dispatch::record("glClientWaitSync");
+		EVE_OGL_DISPATCH_COUNT(numSyncs, 1);
+		// Dropped fences are always signaled, whatever the active mode.
+		if (sync == null_sync()) {
+			return GL_ALREADY_SIGNALED;
+		}
+		return s_table.ClientWaitSync(sync, flags, timeout);
+	}
+
+	//=============================================================================================
+	void GLAPIENTRY hook_DeleteSync(GLsync sync)
+	{
+		eve::ogl::Dispatch::record("glDeleteSync");
+		if (sync != null_sync()) {
+			s_table.DeleteSync(sync);
+		}
+	}
+
+} // namespace
+
+
+/** \def EVE_OGL_DISPATCH_HOOK Capture GLEW entry point \a NAME and replace it by its hook (unsupported entry points are left null). */
+#define EVE_OGL_DISPATCH_HOOK(NAME)											\
+	if (__glew##NAME && __glew##NAME != hook_##NAME) {						\
+		s_driver.NAME = __glew##NAME;										\
+		__glew##NAME  = hook_##NAME;											\
+	}
+
+/** \def EVE_OGL_DISPATCH_UNHOOK Restore captured GLEW entry point \a NAME. */
+#define EVE_OGL_DISPATCH_UNHOOK(NAME)										\
+	if (__glew##NAME == hook_##NAME) {										\
+		__glew##NAME = s_driver.NAME;										\
+	}
+
+
+
+//=================================================================================================
+void eve::ogl::Dispatch::install(void)
+{
+	if (m_mode == eve::ogl::DispatchMode_Native)
+	{
+		eve::ogl::Dispatch::uninstall();
+		return;
+	}
+
+	// GLEW initialization restores driver entry points, captures are refreshed each time.
+	EVE_OGL_DISPATCH_HOOK(DrawElementsInstancedBaseVertex);
+	EVE_OGL_DISPATCH_HOOK(DrawElementsInstancedBaseVertexBaseInstance);
+	EVE_OGL_DISPATCH_HOOK(MultiDrawElementsIndirect);
+	EVE_OGL_DISPATCH_HOOK(ClearBufferfv);
+	EVE_OGL_DISPATCH_HOOK(UseProgram);
+	EVE_OGL_DISPATCH_HOOK(BindProgramPipeline);
+	EVE_OGL_DISPATCH_HOOK(BindVertexArray);
+	EVE_OGL_DISPATCH_HOOK(BindVertexBuffer);
+	EVE_OGL_DISPATCH_HOOK(BindBuffer);
+	EVE_OGL_DISPATCH_HOOK(BindBufferBase);
+	EVE_OGL_DISPATCH_HOOK(BindBufferRange);
+	EVE_OGL_DISPATCH_HOOK(BindFramebuffer);
+	EVE_OGL_DISPATCH_HOOK(ActiveTexture);
+	EVE_OGL_DISPATCH_HOOK(BufferData);
+	EVE_OGL_DISPATCH_HOOK(BufferSubData);
+	EVE_OGL_DISPATCH_HOOK(BufferStorage);
+	EVE_OGL_DISPATCH_HOOK(MapBufferRange);
+	EVE_OGL_DISPATCH_HOOK(GenerateMipmap);
+	EVE_OGL_DISPATCH_HOOK(FenceSync);
+	EVE_OGL_DISPATCH_HOOK(ClientWaitSync);
+	EVE_OGL_DISPATCH_HOOK(DeleteSync);
+
+	// Hooks forward to driver or empty entry points depending on mode.
+	fill_table(m_mode);
+
+	m_bInstalled = true;
+}
+
+//=================================================================================================
+void eve::ogl::Dispatch::uninstall(void)
+{
+	if (!m_bInstalled) {
+		return;
+	}
+
+	EVE_OGL_DISPATCH_UNHOOK(DrawElementsInstancedBaseVertex);
+	EVE_OGL_DISPATCH_UNHOOK(DrawElementsInstancedBaseVertexBaseInstance);
+	EVE_OGL_DISPATCH_UNHOOK(MultiDrawElementsIndirect);
+	EVE_OGL_DISPATCH_UNHOOK(ClearBufferfv);
+	EVE_OGL_DISPATCH_UNHOOK(UseProgram);
+	EVE_OGL_DISPATCH_UNHOOK(BindProgramPipeline);
+	EVE_OGL_DISPATCH_UNHOOK(BindVertexArray);
+	EVE_OGL_DISPATCH_UNHOOK(BindVertexBuffer);
+	EVE_OGL_DISPATCH_UNHOOK(BindBuffer);
+	EVE_OGL_DISPATCH_UNHOOK(BindBufferBase);
+	EVE_OGL_DISPATCH_UNHOOK(BindBufferRange);
+	EVE_OGL_DISPATCH_UNHOOK(BindFramebuffer);
+	EVE_OGL_DISPATCH_UNHOOK(ActiveTexture);
+	EVE_OGL_DISPATCH_UNHOOK(BufferData);
+	EVE_OGL_DISPATCH_UNHOOK(BufferSubData);
+	EVE_OGL_DISPATCH_UNHOOK(BufferStorage);
+	EVE_OGL_DISPATCH_UNHOOK(MapBufferRange);
+	EVE_OGL_DISPATCH_UNHOOK(GenerateMipmap);
+	EVE_OGL_DISPATCH_UNHOOK(FenceSync);
+	EVE_OGL_DISPATCH_UNHOOK(ClientWaitSync);
+	EVE_OGL_DISPATCH_UNHOOK(DeleteSync);
+
+	m_bInstalled = false;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::Dispatch::begin_frame(void)
+{
+	roll(s_frame.numCalls,			s_last.numCalls);
+	roll(s_frame.numDraws,			s_last.numDraws);
+	roll(s_frame.numDrawCommands,	s_last.numDrawCommands);
+	roll(s_frame.numBinds,			s_last.numBinds);
+	roll(s_frame.numUploads,		s_last.numUploads);
+	roll(s_frame.numUploadBytes,	s_last.numUploadBytes);
+	roll(s_frame.numSyncs,			s_last.numSyncs);
+}
+
+//=================================================================================================
+void eve::ogl::Dispatch::reset_stats(void)
+{
+	reset(s_total);
+	reset(s_frame);
+	reset(s_last);
+}
+
+
+
+//=================================================================================================
+void eve::ogl::Dispatch::record(const char * p_name)
+{
+	EVE_OGL_DISPATCH_COUNT(numCalls, 1);
+
+	if (m_bLog) {
+		EVE_LOG_INFO("GL call %s", p_name);
+	}
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+void eve::ogl::Dispatch::set_mode(eve::ogl::DispatchMode p_mode)
+{
+	m_mode = p_mode;
+
+	// Entry points already loaded, swap them now.
+	if (__glewBindBuffer) {
+		eve::ogl::Dispatch::install();
+	}
+}
+
+
+
+//=================================================================================================
+eve::ogl::DispatchStats eve::ogl::Dispatch::get_stats(void)			{ return snapshot(s_total); }
+eve::ogl::DispatchStats eve::ogl::Dispatch::get_stats_current(void)	{ return snapshot(s_frame); }
+eve::ogl::DispatchStats eve::ogl::Dispatch::get_stats_frame(void)		{ return snapshot(s_last);	}
@@ -0,0 +1,195 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_OPENGL_CORE_DISPATCH_H__
+#define __EVE_OPENGL_CORE_DISPATCH_H__
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_EXTERNAL_H__
+#include "eve/ogl/core/External.h"
+#endif
+
+#include <atomic>
+
+
+namespace eve
+{
+	namespace ogl
+	{
+		/** 
+		* \enum eve::ogl::DispatchMode
+		* \brief OpenGL entry points dispatch modes.
+		*/
+		enum DispatchMode
+		{
+			DispatchMode_Native = 0,		//!< Entry points are called directly, nothing is recorded.
+			DispatchMode_Record,			//!< Hooked entry points are counted (and optionally logged) then forwarded.
+			DispatchMode_Record_No_Draw,	//!< As DispatchMode_Record but draw calls are not forwarded, isolates CPU submission cost.
+			DispatchMode_Record_No_Work,	//!< As DispatchMode_Record but draws, clears, uploads and syncs are dropped, a (software) context is still required.
+
+			//! This value is not used. It is just there to force the compiler to map this enum to a 32 Bit integer.
+			_DispatchMode_Force32Bit = INT_MAX
+
+		}; // enum DispatchMode
+
+
+		/**
+		* \struct eve::ogl::DispatchStats
+		* \brief Recorded OpenGL calls statistics (counters snapshot).
+		*/
+		struct DispatchStats
+		{
+			uint64_t		numCalls;			//!< Hooked calls amount.
+			uint64_t		numDraws;			//!< Draw calls amount (a multi draw indirect call counts once).
+			uint64_t		numDrawCommands;	//!< Draw commands amount (multi draw indirect commands counted one by one).
+			uint64_t		numBinds;			//!< Program, buffer, VAO, framebuffer and texture unit binds amount.
+			uint64_t		numUploads;			//!< Buffer data/storage specification and mapping amount.
+			uint64_t		numUploadBytes;		//!< Bytes specified or mapped for write by uploads.
+			uint64_t		numSyncs;			//!< Fences inserted and waited amount.
+
+			DispatchStats(void) : numCalls(0), numDraws(0), numDrawCommands(0), numBinds(0), numUploads(0), numUploadBytes(0), numSyncs(0) {}
+		};
+
+
+		/** 
+		* \class eve::ogl::Dispatch
+		*
+		* \brief OpenGL dispatch layer, pluggable recording backend over GLEW entry points.
+		* In recording modes GLEW function pointers of draw, bind, buffer upload and sync entry points are swapped for
+		* counting hooks forwarding to a dispatch table, so draw call counts and upload volumes can be measured without
+		* a profiler, frames being rendered on screen or on a headless context (see eve::ogl::SubContext).
+		* The dispatch table holds captured driver entry points, or empty entry points for work that must not reach the driver:
+		* draws in DispatchMode_Record_No_Draw, every draw, clear, mipmap generation, upload and sync in DispatchMode_Record_No_Work.
+		* DispatchMode_Record_No_Work is not a context free backend: object names, state and buffer storage (allocated without data
+		* so buffers can be mapped and written) still come from the driver, a current context is required. Use a software driver
+		* (e.g. Mesa llvmpipe) to run it without GPU. Dropped fences are always signaled.
+		* OpenGL 1.1 entry points are exported by the system library and are not hooked, their state changes are
+		* counted by eve::ogl::StateCache.
+		* Hooks are (re)installed by eve::ogl::Context::init_OpenGL() after each GLEW initialization, counters are
+		* updated while the (single, locked) master context is current and may be read from any thread.
+		*
+		* \note static class
+		*/
+		class Dispatch final
+		{
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			static eve::ogl::DispatchMode		m_mode;				//!< Specifies active dispatch mode.
+			static std::atomic<bool>			m_bLog;				//!< Specifies whether hooked calls are logged.
+			static bool							m_bInstalled;		//!< Specifies whether hooks are installed.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(Dispatch);
+
+		private:
+			/** \brief Class constructor (static class). */
+			Dispatch(void);
+
+
+		public:
+			/** \brief Install hooks and fill dispatch table if a recording mode is active, called after GLEW initialization (context current). */
+			static void install(void);
+			/** \brief Restore captured driver entry points. */
+			static void uninstall(void);
+
+
+		public:
+			/** \brief Start new frame counters, previous frame counters are kept (see get_stats_frame()). */
+			static void begin_frame(void);
+			/** \brief Reset every counter. */
+			static void reset_stats(void);
+
+
+		public:
+			/** \brief Record a hooked call of \a p_name, internal use by hooks. */
+			static void record(const char * p_name);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get active dispatch mode. */
+			static const eve::ogl::DispatchMode get_mode(void);
+			/** \brief Set dispatch mode, applied by next install() (or immediately when context is current and hooks are installed). */
+			static void set_mode(eve::ogl::DispatchMode p_mode);
+			/** \brief Get whether draw calls are forwarded to driver (false in DispatchMode_Record_No_Draw and DispatchMode_Record_No_Work). */
+			static const bool forward_draws(void);
+
+
+		public:
+			/** \brief Get whether hooked calls are logged. */
+			static const bool get_log(void);
+			/** \brief Set whether hooked calls are logged (verbose, one line per call). */
+			static void set_log(bool p_bLog);
+
+
+		public:
+			/** \brief Get counters since last reset. */
+			static eve::ogl::DispatchStats get_stats(void);
+			/** \brief Get current frame counters. */
+			static eve::ogl::DispatchStats get_stats_current(void);
+			/** \brief Get last complete frame counters. */
+			static eve::ogl::DispatchStats get_stats_frame(void);
+
+		}; // class Dispatch
+
+	} // namespace ogl
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const eve::ogl::DispatchMode eve::ogl::Dispatch::get_mode(void)		{ return m_mode; }
+EVE_FORCE_INLINE const bool eve::ogl::Dispatch::forward_draws(void)					{ return m_mode < eve::ogl::DispatchMode_Record_No_Draw; }
+
+//=================================================================================================
+EVE_FORCE_INLINE const bool eve::ogl::Dispatch::get_log(void)						{ return m_bLog;	}
+EVE_FORCE_INLINE void eve::ogl::Dispatch::set_log(bool p_bLog)						{ m_bLog = p_bLog;	}
+
+#endif // __EVE_OPENGL_CORE_DISPATCH_H__
@@ -32,6 +32,14 @@
 // Main header
 #include "eve/ogl/core/Fbo.h"
 
+#ifndef __EVE_OPENGL_CORE_CONTEXT_H__
+#include "eve/ogl/core/win32/Context.h"
+#endif
+
+#ifndef __EVE_TIME_UTILS_H__
+#include "eve/time/Utils.h"
+#endif
+
 
 //=================================================================================================
 eve::ogl::FormatFbo::FormatFbo(void)
@@ -96,6 +104,12 @@ eve::ogl::Fbo::Fbo(void)
 	, m_bHasDepth(false)
 	, m_black(0)
 	, m_layers(GL_COLOR)
+	, m_pReadbackSlots(nullptr)
+	, m_readbackCallback()
+	, m_readbackSize(0)
+	, m_readbackDepth(0)
+	, m_bReadbackPersistent(false)
+	, m_readbackStats()
 {}
 
 
@@ -133,6 +147,7 @@ void eve::ogl::Fbo::release(void)
 {
 	EVE_RELEASE_PTR_C(m_pSlotTextureIds);
 	EVE_RELEASE_PTR_C(m_black);
+	EVE_RELEASE_PTR_CPP_SAFE(m_pReadbackSlots);
 }
 
 
@@ -228,6 +243,10 @@ void eve::ogl::Fbo::oglUpdate(void)
 //=================================================================================================
 void eve::ogl::Fbo::oglRelease(void)
 {
+	if (m_pReadbackSlots) {
+		this->oglReleaseReadback();
+	}
+
 	glDeleteFramebuffers(1, &m_id);
 	m_id = 0;
 	EVE_OGL_CHECK_ERROR;
@@ -241,8 +260,8 @@ void eve::ogl::Fbo::oglRelease(void)
 //=================================================================================================
 void eve::ogl::Fbo::bind(void)
 {
-	glViewport(0, 0, m_width, m_height);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_id);
+	EveStateGL->viewport(0, 0, m_width, m_height);
+	EveStateGL->bindDrawFramebuffer(m_id);
 	glClearBufferfv(m_layers, 0, m_black);
 	EVE_OGL_CHECK_ERROR;
 }
@@ -250,7 +269,7 @@ void eve::ogl::Fbo::bind(void)
 //=================================================================================================
 void eve::ogl::Fbo::unbind(void)
 {
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	EveStateGL->bindDrawFramebuffer(0);
 	EVE_OGL_CHECK_ERROR;
 }
 
@@ -275,8 +294,8 @@ void eve::ogl::Fbo::write(GLenum p_slot)
 //=================================================================================================
 void eve::ogl::Fbo::bindAndWrite(GLsizei p_slotsAmount, GLenum * p_pTargetSlots)
 {
-	glViewport(0, 0, m_width, m_height);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_id);
+	EveStateGL->viewport(0, 0, m_width, m_height);
+	EveStateGL->bindDrawFramebuffer(m_id);
 	glClearBufferfv(m_layers, 0, m_black);
 	EVE_OGL_CHECK_ERROR;
 
@@ -287,8 +306,8 @@ void eve::ogl::Fbo::bindAndWrite(GLsizei p_slotsAmount, GLenum * p_pTargetSlots)
 //=================================================================================================
 void eve::ogl::Fbo::bindAndWrite(GLenum p_targetSlot)
 {
-	glViewport(0, 0, m_width, m_height);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_id);
+	EveStateGL->viewport(0, 0, m_width, m_height);
+	EveStateGL->bindDrawFramebuffer(m_id);
 	glClearBufferfv(m_layers, 0, m_black);
 	EVE_OGL_CHECK_ERROR;
 
@@ -301,8 +320,7 @@ void eve::ogl::Fbo::bindAndWrite(GLenum p_targetSlot)
 //=================================================================================================
 void eve::ogl::Fbo::bindTexture(GLenum p_activeIndex, GLuint p_targetSlot)
 {
-	glActiveTexture(GL_TEXTURE0 + p_activeIndex);
-	glBindTexture(GL_TEXTURE_2D, m_pSlotTextureIds[p_targetSlot]);
+	EveStateGL->bindTexture(p_activeIndex, m_pSlotTextureIds[p_targetSlot]);
 	//glActiveTexture(GL_TEXTURE0);
 	EVE_OGL_CHECK_ERROR;
 }
@@ -310,8 +328,7 @@ void eve::ogl::Fbo::bindTexture(GLenum p_activeIndex, GLuint p_targetSlot)
 //=================================================================================================
 void eve::ogl::Fbo::bindDepthTexture(void)
 {
-	glActiveTexture(GL_TEXTURE0 + 1);
-	glBindTexture(GL_TEXTURE_2D, m_pSlotTextureIds[m_texNum]);
+	EveStateGL->bindTexture(1, m_pSlotTextureIds[m_texNum]);
 	//glActiveTexture(GL_TEXTURE0);
 	EVE_OGL_CHECK_ERROR;
 }
@@ -319,17 +336,228 @@ void eve::ogl::Fbo::bindDepthTexture(void)
 //=================================================================================================
 void eve::ogl::Fbo::unbindTexture(GLenum p_activeIndex)
 {
-	glActiveTexture(GL_TEXTURE0 + p_activeIndex);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	EveStateGL->bindTexture(p_activeIndex, 0);
 	//glActiveTexture(GL_TEXTURE0);
 	EVE_OGL_CHECK_ERROR;
 }
 
 
+
+//=================================================================================================
+void eve::ogl::Fbo::startReadback(const eve::ogl::FboReadbackCallback & p_callback, size_t p_depth)
+{
+	EVE_ASSERT(p_callback);
+
+	if (m_pReadbackSlots) {
+		this->stopReadback();
+	}
+
+	m_readbackCallback	= p_callback;
+	m_readbackDepth		= std::max(p_depth, size_t(1));
+	m_readbackSize		= 0;
+	m_readbackStats		= eve::ogl::FboReadbackStats();
+	m_pReadbackSlots	= new std::vector<ReadbackSlot>();
+}
+
+//=================================================================================================
+void eve::ogl::Fbo::stopReadback(void)
+{
+	if (!m_pReadbackSlots) {
+		return;
+	}
+
+	this->resolveReadback(true);
+	this->oglReleaseReadback();
+
+	EVE_RELEASE_PTR_CPP(m_pReadbackSlots);
+	m_readbackCallback = nullptr;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::Fbo::oglInitReadback(void)
+{
+	m_readbackSize = this->getReadbackSize();
+
+	// Persistent mapping avoids map/unmap on each resolve.
+	m_bReadbackPersistent = (GLEW_ARB_buffer_storage != 0);
+	const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	m_pReadbackSlots->resize(m_readbackDepth);
+	for (auto && slot : (*m_pReadbackSlots))
+	{
+		glGenBuffers(1, &slot.id);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.id);
+		if (m_bReadbackPersistent)
+		{
+			glBufferStorage(GL_PIXEL_PACK_BUFFER, m_readbackSize, nullptr, flags);
+			slot.pMapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, m_readbackSize, flags);
+		}
+		else
+		{
+			glBufferData(GL_PIXEL_PACK_BUFFER, m_readbackSize, nullptr, GL_STREAM_READ);
+			slot.pMapped = nullptr;
+		}
+		slot.fence		= 0;
+		slot.issueMicro = 0;
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	EVE_OGL_CHECK_ERROR;
+}
+
+//=================================================================================================
+void eve::ogl::Fbo::oglReleaseReadback(void)
+{
+	for (auto && slot : (*m_pReadbackSlots))
+	{
+		// Pending readbacks are lost.
+		if (slot.fence)
+		{
+			glDeleteSync(slot.fence);
+			m_readbackStats.numLost++;
+		}
+		if (slot.pMapped)
+		{
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.id);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		glDeleteBuffers(1, &slot.id);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	EVE_OGL_CHECK_ERROR;
+
+	m_pReadbackSlots->clear();
+	m_readbackSize = 0;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::Fbo::readback(uint32_t p_slot)
+{
+	EVE_ASSERT(p_slot < m_texNum);
+
+	if (!m_pReadbackSlots) {
+		return;
+	}
+
+	// Buffers follow FBO size.
+	if (m_pReadbackSlots->empty() || m_readbackSize != this->getReadbackSize())
+	{
+		if (!m_pReadbackSlots->empty())
+		{
+			this->resolveReadback(true);
+			this->oglReleaseReadback();
+		}
+		this->oglInitReadback();
+	}
+
+	this->resolveReadback(false);
+
+	if (m_readbackStats.numIssued - m_readbackStats.numResolved >= m_readbackDepth)
+	{
+		m_readbackStats.numDropped++;
+		return;
+	}
+
+	ReadbackSlot & slot = (*m_pReadbackSlots)[m_readbackStats.numIssued % m_readbackDepth];
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_id);
+	glReadBuffer(GL_COLOR_ATTACHMENT0 + p_slot);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.id);
+	// Pixels pointer is an offset in bound pack buffer, call returns without waiting for transfer.
+	glReadPixels(0, 0, m_width, m_height, GL_RGBA, m_texDataType, nullptr);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	EVE_OGL_CHECK_ERROR;
+
+	slot.fence		= glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.issueMicro = eve::time::current_time_micro();
+	m_readbackStats.numIssued++;
+}
+
+//=================================================================================================
+void eve::ogl::Fbo::resolveReadback(bool p_bWait)
+{
+	if (!m_pReadbackSlots) {
+		return;
+	}
+
+	// Readbacks complete in issue order.
+	while (m_readbackStats.numResolved < m_readbackStats.numIssued)
+	{
+		ReadbackSlot & slot = (*m_pReadbackSlots)[m_readbackStats.numResolved % m_readbackDepth];
+
+		GLenum ret = glClientWaitSync(slot.fence, 0, 0);
+		if (ret == GL_TIMEOUT_EXPIRED)
+		{
+			if (!p_bWait) {
+				break;
+			}
+
+			m_readbackStats.numStalls++;
+			do {
+				ret = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			} while (ret == GL_TIMEOUT_EXPIRED);
+		}
+		glDeleteSync(slot.fence);
+		slot.fence = 0;
+
+		const void * pixels = slot.pMapped;
+		if (!m_bReadbackPersistent)
+		{
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.id);
+			pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, m_readbackSize, GL_MAP_READ_BIT);
+		}
+
+		eve::ogl::FboFrame frame;
+		frame.pixels		= pixels;
+		frame.width			= m_width;
+		frame.height		= m_height;
+		frame.size			= static_cast<size_t>(m_readbackSize);
+		frame.index			= m_readbackStats.numResolved;
+		frame.latencyMicro	= eve::time::current_time_micro() - slot.issueMicro;
+
+		if (pixels) {
+			m_readbackCallback(frame);
+		}
+
+		if (!m_bReadbackPersistent)
+		{
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		}
+		EVE_OGL_CHECK_ERROR;
+
+		m_readbackStats.numResolved++;
+		m_readbackStats.latencyMicro	= frame.latencyMicro;
+		m_readbackStats.latencyMaxMicro = std::max(m_readbackStats.latencyMaxMicro, frame.latencyMicro);
+	}
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //		GET / SET
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+//=================================================================================================
+const GLsizeiptr eve::ogl::Fbo::getReadbackSize(void) const
+{
+	GLsizeiptr channelSize = 1;
+	switch (m_texDataType)
+	{
+	case GL_FLOAT:
+	case GL_INT:
+	case GL_UNSIGNED_INT:	channelSize = 4; break;
+	case GL_HALF_FLOAT:
+	case GL_SHORT:
+	case GL_UNSIGNED_SHORT:	channelSize = 2; break;
+	default:				channelSize = 1; break;
+	}
+	return static_cast<GLsizeiptr>(m_width) * static_cast<GLsizeiptr>(m_height) * 4 * channelSize;
+}
+
 //=================================================================================================
 void eve::ogl::Fbo::setSize(uint32_t p_width, uint32_t p_height)
 {
@@ -37,6 +37,12 @@
 #include "eve/ogl/core/Object.h"
 #endif
 
+#include <functional>
+
+
+/** \def EVE_OGL_FBO_READBACK_DEPTH Default asynchronous readback buffers amount (frames resolved that many readbacks later). */
+#define EVE_OGL_FBO_READBACK_DEPTH		3
+
 
 namespace eve
 {
@@ -77,6 +83,41 @@ namespace eve
 		}; // class FormatFbo
 
 
+		/**
+		* \struct eve::ogl::FboFrame
+		* \brief Asynchronous readback completed frame, pixels are only valid during callback.
+		*/
+		struct FboFrame
+		{
+			const void *	pixels;				//!< Pixels (GL_RGBA, FBO texture data type), bottom-up rows, mapped device memory when possible.
+			uint32_t		width;				//!< Frame width.
+			uint32_t		height;				//!< Frame height.
+			size_t			size;				//!< Pixels size in bytes.
+			uint64_t		index;				//!< Readback index (issue order).
+			int64_t			latencyMicro;		//!< Time between issue and resolve in microseconds.
+		};
+
+		/** \brief Asynchronous readback completion callback, called from render thread. */
+		typedef std::function<void(const eve::ogl::FboFrame &)> FboReadbackCallback;
+
+		/**
+		* \struct eve::ogl::FboReadbackStats
+		* \brief Asynchronous readback statistics (accumulated since readback start).
+		*/
+		struct FboReadbackStats
+		{
+			uint64_t		numIssued;			//!< Readbacks issued.
+			uint64_t		numResolved;		//!< Readbacks resolved and handed to callback.
+			uint64_t		numDropped;			//!< Readbacks skipped because every buffer was in flight.
+			uint64_t		numLost;			//!< Readbacks issued but never resolved, buffers released while in flight (resize, release).
+			uint64_t		numStalls;			//!< Resolves which had to wait for GPU.
+			int64_t			latencyMicro;		//!< Last resolved readback latency in microseconds.
+			int64_t			latencyMaxMicro;	//!< Highest resolved readback latency in microseconds.
+
+			FboReadbackStats(void) : numIssued(0), numResolved(0), numDropped(0), numLost(0), numStalls(0), latencyMicro(0), latencyMaxMicro(0) {}
+		};
+
+
 		/** 
 		* \class eve::ogl::Fbo
 		*
@@ -125,6 +166,23 @@ namespace eve
 			float *					m_black;				//!< Black color (0, 0, 0, 0), used to clear buffer.
 			GLenum					m_layers;				//!< Layers to clean, can be GL_COLOR and/or GL_DEPTH 
 
+		private:
+			/** \brief Readback buffer. */
+			struct ReadbackSlot
+			{
+				GLuint				id;					//!< OpenGL pixel pack buffer ID.
+				GLsync				fence;				//!< Transfer completion fence.
+				void *				pMapped;			//!< Persistently mapped address (nullptr if mapped on resolve).
+				int64_t				issueMicro;			//!< Issue time stamp.
+			};
+
+			std::vector<ReadbackSlot> *		m_pReadbackSlots;		//!< Readback buffers ring, only used in render thread.
+			eve::ogl::FboReadbackCallback	m_readbackCallback;		//!< Completed frames callback.
+			GLsizeiptr						m_readbackSize;			//!< Readback buffers size in bytes.
+			size_t							m_readbackDepth;		//!< Readback buffers amount.
+			bool							m_bReadbackPersistent;	//!< Whether readback buffers are persistently mapped.
+			eve::ogl::FboReadbackStats		m_readbackStats;		//!< Readback statistics.
+
 
 			//////////////////////////////////////
 			//				METHOD				//
@@ -189,6 +247,30 @@ namespace eve
 			static void unbindTexture(GLenum p_activeIndex);
 
 
+		public:
+			/**
+			* \brief Enable asynchronous readback, completed frames are handed to \a p_callback from render thread.
+			* \param p_depth readback buffers amount, frames are resolved up to that many readbacks later.
+			*/
+			void startReadback(const eve::ogl::FboReadbackCallback & p_callback, size_t p_depth = EVE_OGL_FBO_READBACK_DEPTH);
+			/** \brief Resolve every pending readback (blocking) and release readback buffers. Render thread only. */
+			void stopReadback(void);
+			/** 
+			* \brief Issue asynchronous readback of color slot \a p_slot into next free buffer, frame is dropped if every buffer is in flight.
+			* Completed readbacks are resolved first. Render thread only, once frame content has been drawn.
+			*/
+			void readback(uint32_t p_slot = 0);
+			/** \brief Hand completed readbacks to callback, waits for every pending one if \a p_bWait is true. Render thread only. */
+			void resolveReadback(bool p_bWait = false);
+
+
+		private:
+			/** \brief Create readback buffers matching current size. */
+			void oglInitReadback(void);
+			/** \brief Delete readback buffers and fences. */
+			void oglReleaseReadback(void);
+
+
 			///////////////////////////////////////////////////////////////////////////////////////////////
 			//		GET / SET
 			///////////////////////////////////////////////////////////////////////////////////////////////
@@ -198,6 +280,10 @@ namespace eve
 			virtual const GLuint getId(void) const override;
 			/** \brief Get target slot OpenGL texture id. */
 			const GLuint getTextureId(uint32_t p_id);
+			/** \brief Get asynchronous readback statistics. */
+			const eve::ogl::FboReadbackStats & getReadbackStats(void) const;
+			/** \brief Get one frame readback size in bytes (GL_RGBA, texture data type). */
+			const GLsizeiptr getReadbackSize(void) const;
 
 
 		public:
@@ -229,6 +315,7 @@ namespace eve
 //=================================================================================================
 EVE_FORCE_INLINE const GLuint eve::ogl::Fbo::getId(void) const				{ return m_id; }
 EVE_FORCE_INLINE const GLuint eve::ogl::Fbo::getTextureId(uint32_t p_id)	{ return m_pSlotTextureIds[p_id]; }
+EVE_FORCE_INLINE const eve::ogl::FboReadbackStats & eve::ogl::Fbo::getReadbackStats(void) const { return m_readbackStats; }
 
 
 //=================================================================================================
@@ -47,6 +47,11 @@
 #define EVE_OGL_ATTRIBUTE_POSITION  0
 #define EVE_OGL_ATTRIBUTE_DIFFUSE   4
 #define EVE_OGL_ATTRIBUTE_NORMAL    7
+#define EVE_OGL_ATTRIBUTE_INSTANCE  8	// Per instance world matrix, mat4 uses locations 8 to 11.
+
+
+// Vertex buffer binding indices (separate attribute format, see glVertexAttribBinding).
+#define EVE_OGL_BINDING_INSTANCE	8
 
 
 // Uniform buffer indices.
@@ -43,6 +43,8 @@ eve::ogl::Object::Object(void)
 	: eve::mem::Pointer()
 	// members init
 	, m_pRenderer(nullptr)
+	, m_bQueuedUpdate(false)
+	, m_queueFlags(0)
 {}
 
 
@@ -76,3 +78,17 @@ void eve::ogl::Object::requestRelease(void)
 	EVE_ASSERT(m_pRenderer);
 	m_pRenderer->putInQueueRelease(this);
 }
+
+
+
+//=================================================================================================
+size_t eve::ogl::Object::getOglCost(void) const
+{
+	return 0;
+}
+
+//=================================================================================================
+bool eve::ogl::Object::isInitialized(void) const
+{
+	return (m_queueFlags & eve::ogl::Renderer::QueueFlag_Initialized) != 0;
+}
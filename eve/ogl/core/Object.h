@@ -50,6 +50,7 @@
 #endif
 
 
+namespace eve { namespace ogl { class PboPool; } }
 namespace eve { namespace ogl { class Renderer; } }
 
 
@@ -87,6 +88,7 @@ namespace eve
 		{
 
 			friend class eve::ogl::Renderer;
+			friend class eve::ogl::PboPool;
 
 			//////////////////////////////////////
 			//				DATA				//
@@ -95,6 +97,10 @@ namespace eve
 		protected:
 			eve::ogl::Renderer *		m_pRenderer;		//!< Parent renderer.
 
+		private:
+			bool						m_bQueuedUpdate;	//!< Specifies whether update is in renderer incoming queue (renderer queues fence protected).
+			uint32_t					m_queueFlags;		//!< Specifies renderer processing queues state (eve::ogl::Renderer::QueueFlag bits), only used in render thread.
+
 
 			//////////////////////////////////////
 			//				METHOD				//
@@ -160,6 +166,10 @@ namespace eve
 		public:
 			/** \brief Get OpenGL object-type unique id. (pure virtual) */
 			virtual const GLuint getId(void) const = 0;
+			/** \brief Get estimated bytes amount sent to device by init/update, used by renderer queues bytes budget. */
+			virtual size_t getOglCost(void) const;
+			/** \brief Get whether OpenGL init has been processed by renderer queues (budgeted, may take several frames). Render thread only. */
+			bool isInitialized(void) const;
 
 		}; // class Object
 
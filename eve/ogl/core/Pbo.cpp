@@ -125,7 +125,7 @@ void eve::ogl::Pbo::oglInit(void)
 	glGenBuffers(1, &m_id);
 	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_id);
 
-	glBufferData(GL_PIXEL_UNPACK_BUFFER, m_id, m_pPixels.get(), GL_STREAM_DRAW);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, m_size, m_pPixels.get(), GL_STREAM_DRAW);
 
 	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 	EVE_OGL_CHECK_ERROR;
@@ -136,6 +136,9 @@ void eve::ogl::Pbo::oglUpdate(void)
 {
 	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_id);
 
+	// Orphan previous storage (size may have changed), avoids waiting for pending transfers.
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, m_size, nullptr, GL_STREAM_DRAW);
+
 	m_pOglData = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT); // GL_WRITE_ONLY
 	eve::mem::memcpy(m_pOglData, m_pPixels.get(), m_size);
 
@@ -158,14 +161,14 @@ void eve::ogl::Pbo::oglRelease(void)
 //=================================================================================================
 void eve::ogl::Pbo::bind(void)
 {
-	glBindBuffer(GL_DRAW_FRAMEBUFFER, m_id);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_id);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Pbo::unbind(void)
 {
-	glBindBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 	EVE_OGL_CHECK_ERROR;
 }
 
@@ -153,6 +153,8 @@ namespace eve
 		public:
 			/** \brief Get OpenGL FBO unique id. */
 			virtual const GLuint getId(void) const override;
+			/** \brief Get estimated bytes amount sent to device by init/update. */
+			virtual size_t getOglCost(void) const override;
 
 
 		public:
@@ -188,6 +190,7 @@ namespace eve
 
 //=================================================================================================
 EVE_FORCE_INLINE const GLuint eve::ogl::Pbo::getId(void) const				{ return m_id; }
+EVE_FORCE_INLINE size_t eve::ogl::Pbo::getOglCost(void) const				{ return static_cast<size_t>(m_size); }
 
 
 //=================================================================================================
@@ -0,0 +1,301 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/ogl/core/PboPool.h"
+
+#ifndef __EVE_OPENGL_CORE_RENDER_H__
+#include "eve/ogl/core/Renderer.h"
+#endif
+
+#ifndef __EVE_THREADING_SPIN_LOCK_H__
+#include "eve/thr/SpinLock.h"
+#endif 
+
+
+//=================================================================================================
+eve::ogl::PboPool * eve::ogl::PboPool::create_ptr(uint32_t p_numSlots, GLsizeiptr p_slotSize)
+{
+	if (!GLEW_ARB_buffer_storage) {
+		return nullptr;
+	}
+
+	eve::ogl::PboPool * ptr = new eve::ogl::PboPool(p_numSlots, p_slotSize);
+	ptr->init();
+	return ptr;
+}
+
+
+
+//=================================================================================================
+eve::ogl::PboPool::PboPool(uint32_t p_numSlots, GLsizeiptr p_slotSize)
+	// Inheritance
+	: eve::mem::Pointer()
+	// Members init
+	, m_numSlots(std::max(p_numSlots, uint32_t(1)))
+	, m_slotSize(p_slotSize)
+	, m_pSlots(nullptr)
+	, m_pFree(nullptr)
+	, m_pSubmitted(nullptr)
+	, m_pFence(nullptr)
+	, m_pPending(nullptr)
+	, m_pInFlight(nullptr)
+	, m_pMipmaps(nullptr)
+{}
+
+
+
+//=================================================================================================
+void eve::ogl::PboPool::init(void)
+{
+	m_pSlots		= new std::vector<Slot>(m_numSlots);
+	m_pFree			= new std::deque<uint32_t>();
+	m_pSubmitted	= new std::deque<uint32_t>();
+	m_pFence		= EVE_CREATE_PTR(eve::thr::SpinLock);
+	m_pPending		= new std::deque<uint32_t>();
+	m_pInFlight		= new std::vector<uint32_t>();
+	m_pMipmaps		= new std::vector<eve::ogl::Texture*>();
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	for (uint32_t i = 0; i < m_numSlots; i++)
+	{
+		Slot & slot = (*m_pSlots)[i];
+
+		glGenBuffers(1, &slot.id);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.id);
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, m_slotSize, nullptr, flags);
+		slot.pMapped = reinterpret_cast<GLubyte*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_slotSize, flags));
+		EVE_ASSERT(slot.pMapped);
+
+		slot.fence			= 0;
+		slot.pTexture		= nullptr;
+		slot.internalFormat = GL_RGBA;
+		slot.format			= GL_RGBA;
+		slot.type			= GL_UNSIGNED_BYTE;
+		slot.width			= 0;
+		slot.height			= 0;
+
+		m_pFree->push_back(i);
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	EVE_OGL_CHECK_ERROR;
+}
+
+//=================================================================================================
+void eve::ogl::PboPool::release(void)
+{
+	for (auto && slot : (*m_pSlots))
+	{
+		if (slot.fence) {
+			glDeleteSync(slot.fence);
+		}
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.id);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glDeleteBuffers(1, &slot.id);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	EVE_OGL_CHECK_ERROR;
+
+	EVE_RELEASE_PTR_CPP(m_pSlots);
+	EVE_RELEASE_PTR_CPP(m_pFree);
+	EVE_RELEASE_PTR_CPP(m_pSubmitted);
+	EVE_RELEASE_PTR(m_pFence);
+	EVE_RELEASE_PTR_CPP(m_pPending);
+	EVE_RELEASE_PTR_CPP(m_pInFlight);
+	EVE_RELEASE_PTR_CPP(m_pMipmaps);
+}
+
+
+
+//=================================================================================================
+int32_t eve::ogl::PboPool::acquire(GLsizeiptr p_size, void ** p_ppData)
+{
+	EVE_ASSERT(p_ppData);
+
+	if (p_size > m_slotSize) {
+		return -1;
+	}
+
+	int32_t ret = -1;
+
+	m_pFence->lock();
+	if (!m_pFree->empty())
+	{
+		ret = static_cast<int32_t>(m_pFree->front());
+		m_pFree->pop_front();
+	}
+	m_pFence->unlock();
+
+	if (ret >= 0) {
+		*p_ppData = (*m_pSlots)[ret].pMapped;
+	}
+	return ret;
+}
+
+//=================================================================================================
+void eve::ogl::PboPool::submit(int32_t p_slot, eve::ogl::Texture * p_pTexture, const eve::ogl::FormatTex & p_format)
+{
+	EVE_ASSERT(p_slot >= 0 && p_slot < static_cast<int32_t>(m_numSlots));
+	EVE_ASSERT(p_pTexture);
+
+	// Slot is owned by caller until submitted, render thread reads it after fence.
+	Slot & slot = (*m_pSlots)[p_slot];
+	slot.pTexture		= p_pTexture;
+	slot.internalFormat = p_format.internalFormat;
+	slot.format			= p_format.format;
+	slot.type			= p_format.type;
+	slot.width			= p_format.width;
+	slot.height			= p_format.height;
+
+	m_pFence->lock();
+	m_pSubmitted->push_back(static_cast<uint32_t>(p_slot));
+	m_pFence->unlock();
+}
+
+//=================================================================================================
+void eve::ogl::PboPool::cancel(int32_t p_slot)
+{
+	EVE_ASSERT(p_slot >= 0 && p_slot < static_cast<int32_t>(m_numSlots));
+
+	m_pFence->lock();
+	m_pFree->push_back(static_cast<uint32_t>(p_slot));
+	m_pFence->unlock();
+}
+
+
+
+//=================================================================================================
+void eve::ogl::PboPool::process(const std::function<bool(void)> & p_exhausted, size_t & p_numProcessed, size_t & p_bytes)
+{
+	// Recycle slots whose upload completed, never blocks.
+	auto itr = m_pInFlight->begin();
+	while (itr != m_pInFlight->end())
+	{
+		Slot & slot = (*m_pSlots)[*itr];
+		if (glClientWaitSync(slot.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+		{
+			++itr;
+			continue;
+		}
+
+		glDeleteSync(slot.fence);
+		slot.fence = 0;
+
+		m_pFence->lock();
+		m_pFree->push_back(*itr);
+		m_pFence->unlock();
+
+		itr = m_pInFlight->erase(itr);
+	}
+
+	// Clears release delay once texture has no more streaming in progress.
+	auto finish = [](eve::ogl::Texture * p_pTex) -> bool
+	{
+		if (--p_pTex->m_numStreaming == 0)
+		{
+			p_pTex->m_queueFlags &= ~eve::ogl::Renderer::QueueFlag_Pending_Stream;
+			return true;
+		}
+		return false;
+	};
+
+	// Mipmaps of textures uploaded during previous pass, transfer had a frame to complete.
+	// Generated once per texture, after its last queued upload.
+	for (auto && tex : (*m_pMipmaps))
+	{
+		if (finish(tex) && (tex->m_queueFlags & eve::ogl::Renderer::QueueFlag_Pending_Release) == 0)
+		{
+			tex->oglGenerateMipmaps();
+			p_numProcessed++;
+		}
+	}
+	m_pMipmaps->clear();
+
+	// Move submitted slots to processing queue.
+	m_pFence->lock();
+	for (auto && idx : (*m_pSubmitted))
+	{
+		eve::ogl::Texture * tex = (*m_pSlots)[idx].pTexture;
+		tex->m_numStreaming++;
+		tex->m_queueFlags |= eve::ogl::Renderer::QueueFlag_Pending_Stream;
+		m_pPending->push_back(idx);
+	}
+	m_pSubmitted->clear();
+	m_pFence->unlock();
+
+	// Uploads, textures not yet initialized are kept for later frames.
+	size_t numPending = m_pPending->size();
+	while (numPending-- > 0 && !p_exhausted())
+	{
+		uint32_t idx = m_pPending->front();
+		m_pPending->pop_front();
+
+		Slot & slot = (*m_pSlots)[idx];
+		eve::ogl::Texture * tex = slot.pTexture;
+
+		if ((tex->m_queueFlags & eve::ogl::Renderer::QueueFlag_Pending_Release) != 0)
+		{
+			// Released anyway, drop upload.
+			slot.pTexture = nullptr;
+			finish(tex);
+
+			m_pFence->lock();
+			m_pFree->push_back(idx);
+			m_pFence->unlock();
+			continue;
+		}
+
+		if ((tex->m_queueFlags & eve::ogl::Renderer::QueueFlag_Initialized) == 0)
+		{
+			m_pPending->push_back(idx);
+			continue;
+		}
+
+		tex->oglStream(slot.id, slot.internalFormat, slot.format, slot.width, slot.height, slot.type);
+		slot.fence	  = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		slot.pTexture = nullptr;
+		m_pInFlight->push_back(idx);
+
+		// Release stays delayed until mipmaps are generated.
+		if (tex->hasMipmaps()) {
+			m_pMipmaps->push_back(tex);
+		}
+		else {
+			finish(tex);
+		}
+
+		p_bytes += static_cast<size_t>(slot.width) * static_cast<size_t>(slot.height) * eve::ogl::Texture::get_texel_size(slot.format, slot.type);
+		p_numProcessed++;
+	}
+}
@@ -0,0 +1,172 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_OPENGL_CORE_PBO_POOL_H__
+#define __EVE_OPENGL_CORE_PBO_POOL_H__
+
+#ifndef __EVE_OPENGL_CORE_OBJECT_H__
+#include "eve/ogl/core/Object.h"
+#endif
+
+#include <functional>
+
+
+namespace eve { namespace ogl { class FormatTex; } }
+namespace eve { namespace ogl { class Texture; } }
+namespace eve { namespace thr { class SpinLock; } }
+
+
+/** \def EVE_OGL_PBO_POOL_SLOTS Renderer texture streaming pool slots amount. */
+#define EVE_OGL_PBO_POOL_SLOTS		4
+/** \def EVE_OGL_PBO_POOL_SLOT_SIZE Renderer texture streaming pool slot size in bytes. */
+#define EVE_OGL_PBO_POOL_SLOT_SIZE	(16 * 1024 * 1024)
+
+
+namespace eve
+{
+	namespace ogl
+	{
+		/** 
+		* \class eve::ogl::PboPool
+		*
+		* \brief Pool of persistently mapped pixel unpack buffers used to stream texture data.
+		* Any thread acquires a slot, writes (decodes) pixels straight into its mapped memory and submits it for a texture.
+		* Render thread then only issues texture upload commands sourcing the slot, within renderer queues budget,
+		* and recycles the slot once its fence signals. Mipmaps generation is delayed to the next processing pass.
+		* Owned and driven by eve::ogl::Renderer.
+		*
+		* \note extends eve::mem::Pointer
+		*/
+		class PboPool final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			/** \brief Pool slot. */
+			struct Slot
+			{
+				GLuint					id;				//!< OpenGL buffer ID.
+				GLubyte *				pMapped;		//!< Persistently mapped address.
+				GLsync					fence;			//!< Upload completion fence.
+				eve::ogl::Texture *		pTexture;		//!< Target texture (shared pointer).
+				GLint					internalFormat;	//!< Pixels internal format.
+				GLenum					format;			//!< Pixels format.
+				GLenum					type;			//!< Pixels type.
+				GLsizei					width;			//!< Pixels width.
+				GLsizei					height;			//!< Pixels height.
+			};
+
+		private:
+			uint32_t							m_numSlots;			//!< Specifies slots amount.
+			GLsizeiptr							m_slotSize;			//!< Specifies slot size in bytes.
+			std::vector<Slot> *					m_pSlots;			//!< Specifies slots.
+
+			std::deque<uint32_t> *				m_pFree;			//!< Specifies free slots (fence protected).
+			std::deque<uint32_t> *				m_pSubmitted;		//!< Specifies submitted slots (fence protected).
+			eve::thr::SpinLock *				m_pFence;			//!< Specifies free/submitted queues fence.
+
+			std::deque<uint32_t> *				m_pPending;			//!< Specifies slots waiting for upload, render thread only.
+			std::vector<uint32_t> *				m_pInFlight;		//!< Specifies uploaded slots waiting for their fence, render thread only.
+			std::vector<eve::ogl::Texture*> *	m_pMipmaps;			//!< Specifies textures waiting for mipmaps generation, render thread only.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(PboPool);
+			EVE_PUBLIC_DESTRUCTOR(PboPool);
+
+		public:
+			/** \brief Create, init and return new pointer, returns nullptr if ARB_buffer_storage is not supported (needs OpenGL context). */
+			static eve::ogl::PboPool * create_ptr(uint32_t p_numSlots, GLsizeiptr p_slotSize);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit PboPool(uint32_t p_numSlots, GLsizeiptr p_slotSize);
+
+
+		public:
+			/** \brief Alloc and init class members, create and map buffers. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members, unmap and delete buffers. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Acquire a free slot of at least \a p_size bytes, write address in \a p_ppData. Returns slot index or -1 if none is available (thread safe). */
+			int32_t acquire(GLsizeiptr p_size, void ** p_ppData);
+			/** \brief Submit slot \a p_slot written pixels as \a p_pTexture new content, described by \a p_format (pixels member unused) (thread safe). */
+			void submit(int32_t p_slot, eve::ogl::Texture * p_pTexture, const eve::ogl::FormatTex & p_format);
+			/** \brief Give back acquired slot \a p_slot without submitting it (thread safe). */
+			void cancel(int32_t p_slot);
+
+
+		public:
+			/** 
+			* \brief Render thread processing pass: recycle completed slots, generate delayed mipmaps and upload submitted slots.
+			* Uploads stop once \a p_exhausted returns true, \a p_numProcessed and \a p_bytes are incremented per upload.
+			*/
+			void process(const std::function<bool(void)> & p_exhausted, size_t & p_numProcessed, size_t & p_bytes);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get uploads and mipmaps generations waiting for processing amount (render thread only). */
+			const size_t getNumPending(void) const;
+			/** \brief Get slot size in bytes. */
+			const GLsizeiptr getSlotSize(void) const;
+
+		}; // class PboPool
+
+	} // namespace ogl
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const size_t		eve::ogl::PboPool::getNumPending(void) const	{ return m_pPending->size() + m_pMipmaps->size(); }
+EVE_FORCE_INLINE const GLsizeiptr	eve::ogl::PboPool::getSlotSize(void) const		{ return m_slotSize;			}
+
+#endif // __EVE_OPENGL_CORE_PBO_POOL_H__
@@ -0,0 +1,402 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/ogl/core/ProgramCache.h"
+
+#ifndef __EVE_OPENGL_CORE_DEBUG_H__
+#include "eve/ogl/core/Debug.h"
+#endif
+
+#ifndef __EVE_IO_BINARY_CACHE_H__
+#include "eve/io/BinaryCache.h"
+#endif
+
+#ifndef __EVE_IO_UTILS_H__
+#include "eve/io/Utils.h"
+#endif
+
+#ifndef __EVE_MESSAGING_INCLUDES_H__
+#include "eve/mess/Includes.h"
+#endif
+
+#ifndef __EVE_STRING_UTILS_H__
+#include "eve/str/Utils.h"
+#endif
+
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#include "eve/thr/TaskPool.h"
+#endif
+
+#ifndef __EVE_TIME_UTILS_H__
+#include "eve/time/Utils.h"
+#endif
+
+
+/** \brief Program binary file magic number ("EVEP"). */
+#define EVE_OGL_PROGRAM_BINARY_MAGIC		0x50455645
+
+
+
+//=================================================================================================
+eve::ogl::ProgramCache * eve::ogl::ProgramCache::m_p_instance = nullptr;
+
+//=================================================================================================
+eve::ogl::ProgramCache * eve::ogl::ProgramCache::create_instance(void)
+{
+	EVE_ASSERT(!m_p_instance);
+	m_p_instance = EVE_CREATE_PTR(eve::ogl::ProgramCache);
+	return m_p_instance;
+}
+
+//=================================================================================================
+eve::ogl::ProgramCache * eve::ogl::ProgramCache::get_instance(void)
+{
+	EVE_ASSERT(m_p_instance);
+	return m_p_instance;
+}
+
+//=================================================================================================
+void eve::ogl::ProgramCache::release_instance(void)
+{
+	EVE_ASSERT(m_p_instance);
+	EVE_RELEASE_PTR(m_p_instance);
+}
+
+
+
+//=================================================================================================
+eve::ogl::ProgramCache::ProgramCache(void)
+	// Inheritance
+	: eve::mem::Pointer()
+
+	// Members init
+	, m_path()
+	, m_pMapSources(nullptr)
+	, m_pFence(nullptr)
+	, m_bDriver(false)
+	, m_bBinary(false)
+	, m_driverHash(0)
+	, m_stats()
+{}
+
+
+
+//=================================================================================================
+void eve::ogl::ProgramCache::init(void)
+{
+	m_path			= EVE_RESOURCES_PATH;
+	m_path		   += "/cache";
+
+	m_pMapSources	= new std::map<std::string, std::string>();
+	m_pFence		= EVE_CREATE_PTR(eve::thr::SpinLock);
+}
+
+//=================================================================================================
+void eve::ogl::ProgramCache::release(void)
+{
+	this->clear();
+
+	EVE_RELEASE_PTR_CPP(m_pMapSources);
+	EVE_RELEASE_PTR(m_pFence);
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ProgramCache::preload(const std::vector<std::string> & p_paths, const char * p_preamble)
+{
+	// Keep paths not loaded yet with this preamble.
+	const std::string preamble(p_preamble ? p_preamble : "");
+	std::vector<std::string> paths;
+	m_pFence->lock();
+	for (auto & path : p_paths)
+	{
+		if (m_pMapSources->find(preamble + path) == m_pMapSources->end()) {
+			paths.push_back(path);
+		}
+	}
+	m_pFence->unlock();
+
+	if (paths.empty()) return;
+
+	// One file per task, files being small disk access dominates.
+	std::vector<std::string> sources(paths.size());
+	eve::thr::TaskPool::get_instance()->parallel_for(0, paths.size(), 1, [&](size_t p_begin, size_t p_end)
+	{
+		for (size_t i = p_begin; i < p_end; i++)
+		{
+			sources[i] = eve::io::load_program(paths[i], p_preamble);
+		}
+	});
+
+	m_pFence->lock();
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		m_pMapSources->insert(std::make_pair(preamble + paths[i], sources[i]));
+	}
+	m_pFence->unlock();
+}
+
+//=================================================================================================
+std::string eve::ogl::ProgramCache::source(const std::string & p_path, const char * p_preamble)
+{
+	const std::string key = std::string(p_preamble ? p_preamble : "") + p_path;
+
+	m_pFence->lock();
+	auto itr = m_pMapSources->find(key);
+	if (itr != m_pMapSources->end())
+	{
+		std::string ret = itr->second;
+		m_pFence->unlock();
+		return ret;
+	}
+	m_pFence->unlock();
+
+	std::string ret = eve::io::load_program(p_path, p_preamble);
+
+	m_pFence->lock();
+	m_pMapSources->insert(std::make_pair(key, ret));
+	m_pFence->unlock();
+
+	return ret;
+}
+
+//=================================================================================================
+void eve::ogl::ProgramCache::clear(void)
+{
+	m_pFence->lock();
+	m_pMapSources->clear();
+	m_pFence->unlock();
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ProgramCache::queryDriver(void)
+{
+	m_bDriver	 = true;
+	m_driverHash = eve::io::hash(nullptr, 0);
+
+	const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+	for (GLenum name : names)
+	{
+		const char * str = reinterpret_cast<const char*>(glGetString(name));
+		if (str) {
+			m_driverHash = eve::io::hash(str, strlen(str), m_driverHash);
+		}
+	}
+
+	GLint numFormats = 0;
+	if (GLEW_ARB_get_program_binary) {
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+	}
+	m_bBinary = (numFormats > 0);
+
+	if (!m_bBinary) {
+		EVE_LOG_WARNING("Driver exposes no program binary format, shader programs are compiled from source.");
+	}
+
+	if (m_bBinary && !m_path.empty()) {
+		eve::io::create_cache_directory(m_path);
+	}
+}
+
+
+
+//=================================================================================================
+GLuint eve::ogl::ProgramCache::createProgram(GLenum p_type, const std::string & p_source)
+{
+	// Called from render and shader reload threads, driver query and statistics are fenced.
+	m_pFence->lock();
+	if (!m_bDriver) {
+		this->queryDriver();
+	}
+	m_pFence->unlock();
+
+	// Without binary support, let the driver do the whole job.
+	if (!m_bBinary || m_path.empty())
+	{
+		int64_t start = eve::time::current_time_micro();
+		const char * src = p_source.c_str();
+		GLuint ret = glCreateShaderProgramv(p_type, 1, &src);
+		m_pFence->lock();
+		m_stats.numMisses++;
+		m_stats.microCompile += eve::time::current_time_micro() - start;
+		m_pFence->unlock();
+		return ret;
+	}
+
+	uint64_t sourceHash = eve::io::hash(&p_type, sizeof(GLenum));
+	sourceHash			= eve::io::hash(p_source.c_str(), p_source.length(), sourceHash);
+
+	// File name from source only, binaries of another driver are rejected and replaced.
+	std::ostringstream name;
+	name << m_path << "/" << std::hex;
+	name.width(16);
+	name.fill('0');
+	name << sourceHash << ".bin";
+	std::string file = name.str();
+
+	int64_t start = eve::time::current_time_micro();
+	GLuint ret = this->loadBinary(file, sourceHash);
+	if (ret != 0)
+	{
+		m_pFence->lock();
+		m_stats.numHits++;
+		m_stats.microLoad += eve::time::current_time_micro() - start;
+		m_pFence->unlock();
+		return ret;
+	}
+
+	start = eve::time::current_time_micro();
+	ret = this->compileProgram(p_type, p_source);
+	m_pFence->lock();
+	m_stats.numMisses++;
+	m_stats.microCompile += eve::time::current_time_micro() - start;
+	m_pFence->unlock();
+
+	GLint linked = GL_FALSE;
+	glGetProgramiv(ret, GL_LINK_STATUS, &linked);
+	if (linked == GL_TRUE) {
+		this->writeBinary(file, sourceHash, ret);
+	}
+
+	return ret;
+}
+
+//=================================================================================================
+GLuint eve::ogl::ProgramCache::compileProgram(GLenum p_type, const std::string & p_source)
+{
+	const char * src = p_source.c_str();
+
+	GLuint shader = glCreateShader(p_type);
+	glShaderSource(shader, 1, &src, nullptr);
+	glCompileShader(shader);
+
+	GLuint ret = glCreateProgram();
+	glProgramParameteri(ret, GL_PROGRAM_SEPARABLE, GL_TRUE);
+	glProgramParameteri(ret, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+	GLint compiled = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+	if (compiled == GL_TRUE)
+	{
+		glAttachShader(ret, shader);
+		glLinkProgram(ret);
+		glDetachShader(ret, shader);
+	}
+	else
+	{
+		// Program is left unlinked, caller checks link status.
+		GLint length = 0;
+		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+		std::string log(static_cast<size_t>(length) + 1, '\0');
+		glGetShaderInfoLog(shader, length, nullptr, &log[0]);
+		EVE_LOG_ERROR("Shader compilation failed: %s", eve::str::to_wstring(log).c_str());
+	}
+	glDeleteShader(shader);
+	EVE_OGL_CHECK_ERROR;
+
+	return ret;
+}
+
+//=================================================================================================
+GLuint eve::ogl::ProgramCache::loadBinary(const std::string & p_file, uint64_t p_sourceHash)
+{
+	eve::io::BinaryHeader header;
+	header.magic	= EVE_OGL_PROGRAM_BINARY_MAGIC;
+	header.version	= EVE_OGL_PROGRAM_CACHE_VERSION;
+	header.key		= p_sourceHash;
+	header.tag		= m_driverHash;
+
+	std::vector<uint8_t> data;
+	bool exists = false;
+	GLuint ret = 0;
+	if (eve::io::read_binary(p_file, &header, &data, &exists))
+	{
+		ret = glCreateProgram();
+		glProgramParameteri(ret, GL_PROGRAM_SEPARABLE, GL_TRUE);
+		glProgramBinary(ret, header.format, data.data(), static_cast<GLsizei>(header.length));
+
+		GLint linked = GL_FALSE;
+		glGetProgramiv(ret, GL_LINK_STATUS, &linked);
+		if (linked != GL_TRUE)
+		{
+			glDeleteProgram(ret);
+			ret = 0;
+		}
+		// Clear error raised by rejected binary format.
+		glGetError();
+	}
+
+	// Stale or truncated binary, removed and rewritten after source compilation.
+	if (ret == 0 && exists)
+	{
+		m_pFence->lock();
+		m_stats.numRejected++;
+		m_pFence->unlock();
+		remove(p_file.c_str());
+	}
+
+	return ret;
+}
+
+//=================================================================================================
+void eve::ogl::ProgramCache::writeBinary(const std::string & p_file, uint64_t p_sourceHash, GLuint p_id)
+{
+	GLint length = 0;
+	glGetProgramiv(p_id, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) return;
+
+	std::vector<uint8_t> data(static_cast<size_t>(length));
+	GLenum format = 0;
+	glGetProgramBinary(p_id, length, &length, &format, data.data());
+	EVE_OGL_CHECK_ERROR;
+
+	eve::io::BinaryHeader header;
+	header.magic	= EVE_OGL_PROGRAM_BINARY_MAGIC;
+	header.version	= EVE_OGL_PROGRAM_CACHE_VERSION;
+	header.key		= p_sourceHash;
+	header.tag		= m_driverHash;
+	header.format	= format;
+	header.length	= static_cast<uint64_t>(length);
+
+	if (!eve::io::write_binary(p_file, header, data.data()))
+	{
+		EVE_LOG_WARNING("Unable to write program binary %s", eve::str::to_wstring(p_file).c_str());
+		return;
+	}
+
+	m_pFence->lock();
+	m_stats.numWrites++;
+	m_pFence->unlock();
+}
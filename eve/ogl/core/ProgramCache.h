@@ -0,0 +1,198 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_OPENGL_CORE_PROGRAM_CACHE_H__
+#define __EVE_OPENGL_CORE_PROGRAM_CACHE_H__
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_EXTERNAL_H__
+#include "eve/ogl/core/External.h"
+#endif
+
+#ifndef __EVE_THREADING_SPIN_LOCK_H__
+#include "eve/thr/SpinLock.h"
+#endif
+
+
+namespace eve { namespace app { class App; } }
+
+
+/**
+* \def EVE_OGL_PROGRAM_CACHE_VERSION
+* \brief Program binary file layout version, bump it to invalidate every cached binary.
+*/
+#define EVE_OGL_PROGRAM_CACHE_VERSION		2
+
+
+namespace eve
+{
+	namespace ogl
+	{
+		/**
+		* \struct eve::ogl::ProgramCacheStats
+		* \brief Program cache statistics.
+		*/
+		struct ProgramCacheStats
+		{
+			uint64_t		numHits;			//!< Programs created from a cached binary.
+			uint64_t		numMisses;			//!< Programs compiled from source (no binary found).
+			uint64_t		numRejected;		//!< Cached binaries rejected by the driver (stale), recompiled from source.
+			uint64_t		numWrites;			//!< Program binaries written to disk.
+			int64_t			microLoad;			//!< Time spent creating programs from binaries (microseconds).
+			int64_t			microCompile;		//!< Time spent compiling programs from source (microseconds).
+
+			ProgramCacheStats(void) : numHits(0), numMisses(0), numRejected(0), numWrites(0), microLoad(0), microCompile(0) {}
+		};
+
+
+		/**
+		* \class eve::ogl::ProgramCache
+		*
+		* \brief Separable shader programs cache.
+		* Linked program binaries (glGetProgramBinary) are stored on disk, keyed by a hash of stage type and source
+		* (preamble included) and tagged with driver vendor/renderer/version strings hash, so unchanged programs skip compilation
+		* on next runs. A binary rejected by the driver (update, other GPU) is deleted and program is compiled from source.
+		* GLSL sources can be preloaded in parallel on eve::thr::TaskPool worker threads before OpenGL initialization.
+		*
+		* \note extends mem::Pointer
+		*/
+		class ProgramCache final
+			: public eve::mem::Pointer
+		{
+			friend class eve::app::App;
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			static ProgramCache *							m_p_instance;		//!< Unique instance.
+
+		private:
+			std::string										m_path;				//!< Binaries directory path (empty disables disk cache).
+			std::map<std::string, std::string> *			m_pMapSources;		//!< Preloaded sources map, keyed by preamble + file path.
+			eve::thr::SpinLock *							m_pFence;			//!< Sources map, driver query and statistics protection fence.
+
+			bool											m_bDriver;			//!< Specifies whether driver has been queried.
+			bool											m_bBinary;			//!< Specifies whether driver supports program binaries.
+			uint64_t										m_driverHash;		//!< Driver vendor/renderer/version strings hash.
+			eve::ogl::ProgramCacheStats						m_stats;			//!< Statistics.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(ProgramCache)
+			EVE_PUBLIC_DESTRUCTOR(ProgramCache)
+
+		private:
+			/** \brief Create unique instance. */
+			static ProgramCache * create_instance(void);
+		public:
+			/** \brief Get unique instance. */
+			static ProgramCache * get_instance(void);
+		private:
+			/** \brief Release unique instance */
+			static void release_instance(void);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit ProgramCache(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Load program sources of \a p_paths in parallel, prepending \a p_preamble. Paths already loaded with the same preamble are skipped. */
+			void preload(const std::vector<std::string> & p_paths, const char * p_preamble = nullptr);
+			/** \brief Get source of \a p_path prepended with \a p_preamble, loaded now if not preloaded with this preamble. */
+			std::string source(const std::string & p_path, const char * p_preamble = nullptr);
+			/** \brief Release preloaded sources. */
+			void clear(void);
+
+
+		public:
+			/** \brief Create separable program of stage \a p_type from \a p_source, using cached binary when valid. A context (master or shared) MUST be current. */
+			GLuint createProgram(GLenum p_type, const std::string & p_source);
+
+		private:
+			/** \brief Query driver strings and program binary support. */
+			void queryDriver(void);
+			/** \brief Compile and link separable program of stage \a p_type from \a p_source. */
+			GLuint compileProgram(GLenum p_type, const std::string & p_source);
+			/** \brief Create program from binary file \a p_file, return 0 if missing, mismatching or rejected. */
+			GLuint loadBinary(const std::string & p_file, uint64_t p_sourceHash);
+			/** \brief Write program \a p_id binary to file \a p_file. */
+			void writeBinary(const std::string & p_file, uint64_t p_sourceHash, GLuint p_id);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get binaries directory path. */
+			const std::string & getPath(void) const;
+			/** \brief Set binaries directory path, empty path disables disk cache. */
+			void setPath(const std::string & p_path);
+
+		public:
+			/** \brief Get statistics. */
+			const eve::ogl::ProgramCacheStats & getStats(void) const;
+
+		}; // class ProgramCache
+
+	} // namespace ogl
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const std::string &					eve::ogl::ProgramCache::getPath(void) const		{ return m_path;	}
+EVE_FORCE_INLINE void									eve::ogl::ProgramCache::setPath(const std::string & p_path) { m_path = p_path; }
+EVE_FORCE_INLINE const eve::ogl::ProgramCacheStats &	eve::ogl::ProgramCache::getStats(void) const	{ return m_stats;	}
+
+#endif // __EVE_OPENGL_CORE_PROGRAM_CACHE_H__
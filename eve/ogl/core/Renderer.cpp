@@ -36,6 +36,10 @@
 #include "eve/thr/SpinLock.h"
 #endif 
 
+#ifndef __EVE_TIME_UTILS_H__
+#include "eve/time/Utils.h"
+#endif
+
 
 //=================================================================================================
 eve::ogl::Renderer::Renderer(void)
@@ -48,6 +52,17 @@ eve::ogl::Renderer::Renderer(void)
 	, m_pQueueUpdate(nullptr)
 	, m_pQueueRelease(nullptr)
 	, m_pQueueFence(nullptr)
+	, m_pPendingInit(nullptr)
+	, m_pPendingUpdate(nullptr)
+	, m_pPendingRelease(nullptr)
+	, m_queueBudgetMicro(4000)
+	, m_queueBudgetBytes(0)
+	, m_queueMerged(0)
+	, m_queueStats()
+	, m_pRingUniform(nullptr)
+	, m_pRingDraw(nullptr)
+	, m_pPboPool(nullptr)
+	, m_bRingInit(false)
 {}
 
 
@@ -62,13 +77,23 @@ void eve::ogl::Renderer::init(void)
 	m_pQueueUpdate		= new std::deque<eve::ogl::Object *>();
 	m_pQueueRelease		= new std::deque<eve::ogl::Object *>();
 	m_pQueueFence		= EVE_CREATE_PTR(eve::thr::SpinLock);
+
+	m_pPendingInit		= new std::deque<eve::ogl::Object *>();
+	m_pPendingUpdate	= new std::deque<eve::ogl::Object *>();
+	m_pPendingRelease	= new std::deque<eve::ogl::Object *>();
 }
 
 //=================================================================================================
 void eve::ogl::Renderer::release(void)
 {
 	// Process pending asynchronous operations.
-	this->processQueues();
+	this->processQueues(true);
+
+	// Streaming ring buffers and PBO pool.
+	EVE_RELEASE_PTR_SAFE(m_pRingUniform);
+	EVE_RELEASE_PTR_SAFE(m_pRingDraw);
+	EVE_RELEASE_PTR_SAFE(m_pPboPool);
+	m_bRingInit = false;
 
 	// Empty and release queues
 	m_pQueueInit->clear();
@@ -78,6 +103,10 @@ void eve::ogl::Renderer::release(void)
 	m_pQueueRelease->clear();
 	EVE_RELEASE_PTR_CPP(m_pQueueRelease);
 
+	EVE_RELEASE_PTR_CPP(m_pPendingInit);
+	EVE_RELEASE_PTR_CPP(m_pPendingUpdate);
+	EVE_RELEASE_PTR_CPP(m_pPendingRelease);
+
 	// Release fence.
 	EVE_RELEASE_PTR(m_pQueueFence);
 
@@ -103,7 +132,16 @@ void eve::ogl::Renderer::putInQueueUpdate(eve::ogl::Object * p_pObject)
 	EVE_ASSERT(p_pObject);
 
 	m_pQueueFence->lock();
-	m_pQueueUpdate->push_back(p_pObject);
+	// Update reads object state when processed, one queued entry is enough.
+	if (!p_pObject->m_bQueuedUpdate)
+	{
+		p_pObject->m_bQueuedUpdate = true;
+		m_pQueueUpdate->push_back(p_pObject);
+	}
+	else
+	{
+		m_queueMerged++;
+	}
 	m_pQueueFence->unlock();
 }
 
@@ -120,29 +158,147 @@ void eve::ogl::Renderer::putInQueueRelease(eve::ogl::Object * p_pObject)
 
 
 //=================================================================================================
-void eve::ogl::Renderer::processQueues(void)
+void eve::ogl::Renderer::processQueues(bool p_bFlush)
 {
+	// Move incoming operations to processing queues, fence is not held while executing.
 	m_pQueueFence->lock();
 
-	while (!m_pQueueInit->empty())
+	for (auto && itr : (*m_pQueueInit))
 	{
-		m_pQueueInit->front()->oglInit();
-		m_pQueueInit->pop_front();
+		itr->m_queueFlags |= QueueFlag_Pending_Init;
+		m_pPendingInit->push_back(itr);
 	}
-	while (!m_pQueueUpdate->empty())
+	for (auto && itr : (*m_pQueueUpdate))
 	{
-		m_pQueueUpdate->front()->oglUpdate();
-		m_pQueueUpdate->pop_front();
+		itr->m_bQueuedUpdate = false;
+		// Already pending from a previous frame.
+		if ((itr->m_queueFlags & QueueFlag_Pending_Update) == 0)
+		{
+			itr->m_queueFlags |= QueueFlag_Pending_Update;
+			m_pPendingUpdate->push_back(itr);
+		}
 	}
-	while (!m_pQueueRelease->empty())
+	for (auto && itr : (*m_pQueueRelease))
 	{
-		eve::ogl::Object * obj = m_pQueueRelease->front();
-		m_pQueueRelease->pop_front();
-		obj->oglRelease();
-		EVE_RELEASE_PTR(obj);
+		itr->m_queueFlags |= QueueFlag_Pending_Release;
+		m_pPendingRelease->push_back(itr);
 	}
 
+	m_pQueueInit->clear();
+	m_pQueueUpdate->clear();
+	m_pQueueRelease->clear();
+
+	size_t numMerged = m_queueMerged;
+	m_queueMerged	 = 0;
+
 	m_pQueueFence->unlock();
+
+
+	const int64_t	start		 = eve::time::current_time_micro();
+	const int64_t	budgetMicro	 = p_bFlush ? 0 : m_queueBudgetMicro;
+	const size_t	budgetBytes	 = p_bFlush ? 0 : m_queueBudgetBytes;
+	size_t			numProcessed = 0;
+	size_t			bytes		 = 0;
+
+	// Returns true once budget is spent, at least one operation is always processed.
+	auto exhausted = [&](void) -> bool
+	{
+		if (numProcessed == 0) return false;
+		if (budgetBytes != 0 && bytes >= budgetBytes) return true;
+		if (budgetMicro != 0 && (eve::time::current_time_micro() - start) >= budgetMicro) return true;
+		return false;
+	};
+
+	// Initializations.
+	while (!m_pPendingInit->empty() && !exhausted())
+	{
+		eve::ogl::Object * obj = m_pPendingInit->front();
+		m_pPendingInit->pop_front();
+
+		obj->oglInit();
+		obj->m_queueFlags &= ~QueueFlag_Pending_Init;
+		obj->m_queueFlags |= QueueFlag_Initialized;
+
+		bytes += obj->getOglCost();
+		numProcessed++;
+	}
+
+	// Texture streaming uploads, sourced from PBO pool slots.
+	if (m_pPboPool) {
+		m_pPboPool->process(exhausted, numProcessed, bytes);
+	}
+
+	// Updates, objects not yet initialized are kept for later frames.
+	size_t numUpdates = m_pPendingUpdate->size();
+	while (numUpdates-- > 0 && !exhausted())
+	{
+		eve::ogl::Object * obj = m_pPendingUpdate->front();
+		m_pPendingUpdate->pop_front();
+
+		if ((obj->m_queueFlags & QueueFlag_Pending_Release) != 0)
+		{
+			// Released anyway, drop update.
+			obj->m_queueFlags &= ~QueueFlag_Pending_Update;
+		}
+		else if ((obj->m_queueFlags & QueueFlag_Initialized) == 0)
+		{
+			m_pPendingUpdate->push_back(obj);
+		}
+		else
+		{
+			obj->m_queueFlags &= ~QueueFlag_Pending_Update;
+			obj->oglUpdate();
+
+			bytes += obj->getOglCost();
+			numProcessed++;
+		}
+	}
+
+	// Releases are cheap and not budgeted, objects waiting for initialization or update are kept for later frames.
+	size_t numReleases = m_pPendingRelease->size();
+	while (numReleases-- > 0)
+	{
+		eve::ogl::Object * obj = m_pPendingRelease->front();
+		m_pPendingRelease->pop_front();
+
+		if ((obj->m_queueFlags & (QueueFlag_Pending_Init | QueueFlag_Pending_Update | QueueFlag_Pending_Stream)) != 0)
+		{
+			m_pPendingRelease->push_back(obj);
+		}
+		else
+		{
+			obj->oglRelease();
+			EVE_RELEASE_PTR(obj);
+			numProcessed++;
+		}
+	}
+
+	// Objects init/update/release bind and delete names directly.
+	if (numProcessed > 0) {
+		EveStateGL->invalidate();
+	}
+
+	// Statistics.
+	int64_t elapsed = eve::time::current_time_micro() - start;
+	bool bOverrun	= (budgetMicro != 0 && elapsed > budgetMicro) || (budgetBytes != 0 && bytes > budgetBytes);
+
+	m_queueStats.depthInit		= m_pPendingInit->size();
+	m_queueStats.depthUpdate	= m_pPendingUpdate->size();
+	m_queueStats.depthRelease	= m_pPendingRelease->size();
+	m_queueStats.depthStream	= m_pPboPool ? m_pPboPool->getNumPending() : 0;
+	m_queueStats.numProcessed	= numProcessed;
+	m_queueStats.numMerged		= numMerged;
+	m_queueStats.bytes			= bytes;
+	m_queueStats.timeMicro		= elapsed;
+	if (bOverrun) {
+		m_queueStats.numOverruns++;
+	}
+
+	// Flush until every queue is empty (or no progress can be made).
+	if (p_bFlush && numProcessed > 0 && (!m_pPendingInit->empty() || !m_pPendingUpdate->empty() || !m_pPendingRelease->empty() || m_queueStats.depthStream > 0))
+	{
+		this->processQueues(true);
+	}
 }
 
 
@@ -153,7 +309,26 @@ void eve::ogl::Renderer::cb_beforeDisplay(void)
 	// Call parent class.
 	eve::core::Renderer::cb_beforeDisplay();
 
+	// Streaming ring buffers and PBO pool are created once renderer context is current.
+	if (!m_bRingInit)
+	{
+		GLint alignment = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		m_pRingUniform = eve::ogl::RingBuffer::create_ptr(GL_UNIFORM_BUFFER, EVE_OGL_RING_UNIFORM_SIZE, alignment);
+		// Instance matrices slices, indirect commands only need 4 bytes alignment.
+		m_pRingDraw	   = eve::ogl::RingBuffer::create_ptr(GL_ARRAY_BUFFER, EVE_OGL_RING_DRAW_SIZE, 64);
+		m_pPboPool	   = eve::ogl::PboPool::create_ptr(EVE_OGL_PBO_POOL_SLOTS, EVE_OGL_PBO_POOL_SLOT_SIZE);
+		m_bRingInit	   = true;
+	}
+
 	this->processQueues();
+
+	if (m_pRingUniform) {
+		m_pRingUniform->beginFrame();
+	}
+	if (m_pRingDraw) {
+		m_pRingDraw->beginFrame();
+	}
 }
 
 //=================================================================================================
@@ -161,6 +336,13 @@ void eve::ogl::Renderer::cb_afterDisplay(void)
 {
 	// Call parent class.
 	eve::core::Renderer::cb_afterDisplay();
+
+	if (m_pRingUniform) {
+		m_pRingUniform->endFrame();
+	}
+	if (m_pRingDraw) {
+		m_pRingDraw->endFrame();
+	}
 }
 
 
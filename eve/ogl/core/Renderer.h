@@ -53,6 +53,14 @@
 #include "eve/ogl/core/Pbo.h"
 #endif
 
+#ifndef __EVE_OPENGL_CORE_PBO_POOL_H__
+#include "eve/ogl/core/PboPool.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_RING_BUFFER_H__
+#include "eve/ogl/core/RingBuffer.h"
+#endif
+
 #ifndef __EVE_OPENGL_CORE_TEXTURE_H__
 #include "eve/ogl/core/Texture.h"
 #endif
@@ -81,6 +89,26 @@ namespace eve
 {
 	namespace ogl
 	{
+		/**
+		* \struct eve::ogl::QueueStats
+		* \brief Renderer queues statistics, last processing pass.
+		*/
+		struct QueueStats
+		{
+			size_t			depthInit;			//!< Pending initializations after pass.
+			size_t			depthUpdate;		//!< Pending updates after pass.
+			size_t			depthRelease;		//!< Pending releases after pass.
+			size_t			depthStream;		//!< Pending texture streaming uploads and mipmaps generations after pass.
+			size_t			numProcessed;		//!< Processed operations amount.
+			size_t			numMerged;			//!< Update requests merged into an already queued update.
+			size_t			bytes;				//!< Estimated bytes sent to device.
+			int64_t			timeMicro;			//!< Processing time in microseconds.
+			uint64_t		numOverruns;		//!< Passes exceeding budget since renderer creation (accumulated).
+
+			QueueStats(void) : depthInit(0), depthUpdate(0), depthRelease(0), depthStream(0), numProcessed(0), numMerged(0), bytes(0), timeMicro(0), numOverruns(0) {}
+		};
+
+
 		/**
 		* \class eve::ogl::Renderer
 		*
@@ -98,11 +126,39 @@ namespace eve
 			//				DATA				//
 			//////////////////////////////////////
 
+		public:
+			/** \brief Object processing queues state flags. */
+			enum QueueFlag
+			{
+				QueueFlag_Pending_Init		= 0x01,		//!< Initialization is in processing queue.
+				QueueFlag_Pending_Update	= 0x02,		//!< Update is in processing queue.
+				QueueFlag_Pending_Release	= 0x04,		//!< Release is in processing queue.
+				QueueFlag_Initialized		= 0x08,		//!< Initialization has been processed.
+				QueueFlag_Pending_Stream	= 0x10		//!< Texture streaming upload (or its mipmaps generation) is in PBO pool.
+			};
+
 		protected:				
-			std::deque<eve::ogl::Object *> *            m_pQueueInit;			//<! OpenGL objects initialization queue.
-			std::deque<eve::ogl::Object *> *            m_pQueueUpdate;			//<! OpenGL objects update queue.
-			std::deque<eve::ogl::Object *> *            m_pQueueRelease;		//<! OpenGL objects release queue.
-			eve::thr::SpinLock *						m_pQueueFence;			//!< Init/Update/Release queues fence.
+			std::deque<eve::ogl::Object *> *            m_pQueueInit;			//<! OpenGL objects initialization incoming queue.
+			std::deque<eve::ogl::Object *> *            m_pQueueUpdate;			//<! OpenGL objects update incoming queue (one entry per object).
+			std::deque<eve::ogl::Object *> *            m_pQueueRelease;		//<! OpenGL objects release incoming queue.
+			eve::thr::SpinLock *						m_pQueueFence;			//!< Init/Update/Release incoming queues fence.
+			size_t										m_queueMerged;			//!< Update requests merged since last processing pass (fence protected).
+
+		protected:
+			std::deque<eve::ogl::Object *> *            m_pPendingInit;			//<! OpenGL objects initialization processing queue, only used in render thread.
+			std::deque<eve::ogl::Object *> *            m_pPendingUpdate;		//<! OpenGL objects update processing queue, only used in render thread.
+			std::deque<eve::ogl::Object *> *            m_pPendingRelease;		//<! OpenGL objects release processing queue, only used in render thread.
+
+		protected:
+			int64_t										m_queueBudgetMicro;		//!< Per frame queues processing time budget in microseconds (0 for unlimited).
+			size_t										m_queueBudgetBytes;		//!< Per frame queues processing bytes budget (0 for unlimited).
+			eve::ogl::QueueStats						m_queueStats;			//!< Last processing pass statistics.
+
+		protected:
+			eve::ogl::RingBuffer *						m_pRingUniform;			//!< Uniform blocks streaming ring buffer (nullptr if unsupported).
+			eve::ogl::RingBuffer *						m_pRingDraw;			//!< Instance attributes and indirect commands streaming ring buffer (nullptr if unsupported).
+			eve::ogl::PboPool *							m_pPboPool;				//!< Texture streaming pixel unpack buffers pool (nullptr if unsupported).
+			bool										m_bRingInit;			//!< Specifies whether ring buffers and PBO pool creation has been attempted.
 
 
 			//////////////////////////////////////
@@ -134,8 +190,12 @@ namespace eve
 
 
 		public:
-			/** \brief Process queued operations. */
-			void processQueues(void);
+			/** 
+			* \brief Process queued operations within per frame budget, remaining ones are kept for next frames.
+			* Initializations run first, then texture streaming uploads, updates of not yet initialized objects and releases of not yet initialized objects are delayed.
+			* \param p_bFlush process all operations ignoring budget.
+			*/
+			void processQueues(bool p_bFlush = false);
 
 
 		public:
@@ -165,10 +225,50 @@ namespace eve
 			/** \brief Create and return new eve::ogl::Vao pointer based on eve::ogl::FormatVao. */
 			eve::ogl::Vao *		create(eve::ogl::FormatVao & p_format);
 
+
+			///////////////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get uniform blocks streaming ring buffer, nullptr if ARB_buffer_storage is not supported (render thread only). */
+			eve::ogl::RingBuffer * getRingUniform(void) const;
+			/** \brief Get instance attributes and indirect commands streaming ring buffer, nullptr if ARB_buffer_storage is not supported (render thread only). */
+			eve::ogl::RingBuffer * getRingDraw(void) const;
+			/** \brief Get texture streaming PBO pool, nullptr if ARB_buffer_storage is not supported or before first frame. */
+			eve::ogl::PboPool * getPboPool(void) const;
+
+
+		public:
+			/** \brief Get last queues processing pass statistics. */
+			const eve::ogl::QueueStats & getQueueStats(void) const;
+			/** \brief Get per frame queues processing time budget in microseconds (0 for unlimited). */
+			const int64_t getQueueBudgetMicro(void) const;
+			/** \brief Get per frame queues processing bytes budget (0 for unlimited). */
+			const size_t getQueueBudgetBytes(void) const;
+			/** \brief Set per frame queues processing budgets, time in microseconds and bytes (0 for unlimited). At least one operation is processed per frame. */
+			void setQueueBudget(int64_t p_micro, size_t p_bytes);
+
 		}; // class Renderer
 
 	} // namespace core
 
 } // namespace eve
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE eve::ogl::RingBuffer * eve::ogl::Renderer::getRingUniform(void) const			{ return m_pRingUniform;		}
+EVE_FORCE_INLINE eve::ogl::RingBuffer * eve::ogl::Renderer::getRingDraw(void) const			{ return m_pRingDraw;			}
+EVE_FORCE_INLINE eve::ogl::PboPool * eve::ogl::Renderer::getPboPool(void) const				{ return m_pPboPool;			}
+
+//=================================================================================================
+EVE_FORCE_INLINE const eve::ogl::QueueStats & eve::ogl::Renderer::getQueueStats(void) const	{ return m_queueStats;			}
+EVE_FORCE_INLINE const int64_t eve::ogl::Renderer::getQueueBudgetMicro(void) const			{ return m_queueBudgetMicro;	}
+EVE_FORCE_INLINE const size_t eve::ogl::Renderer::getQueueBudgetBytes(void) const			{ return m_queueBudgetBytes;	}
+EVE_FORCE_INLINE void eve::ogl::Renderer::setQueueBudget(int64_t p_micro, size_t p_bytes)	{ m_queueBudgetMicro = p_micro; m_queueBudgetBytes = p_bytes; }
+
 #endif // __EVE_OPENGL_CORE_RENDER_H__
@@ -0,0 +1,186 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/ogl/core/RingBuffer.h"
+
+
+//=================================================================================================
+eve::ogl::RingBuffer * eve::ogl::RingBuffer::create_ptr(GLenum p_target, GLsizeiptr p_regionSize, GLintptr p_alignment)
+{
+	if (!GLEW_ARB_buffer_storage) {
+		return nullptr;
+	}
+
+	eve::ogl::RingBuffer * ptr = new eve::ogl::RingBuffer(p_target, p_regionSize, p_alignment);
+	ptr->init();
+	return ptr;
+}
+
+
+
+//=================================================================================================
+eve::ogl::RingBuffer::RingBuffer(GLenum p_target, GLsizeiptr p_regionSize, GLintptr p_alignment)
+	// Inheritance
+	: eve::mem::Pointer()
+	// Members init
+	, m_target(p_target)
+	, m_id(0)
+	, m_regionSize(0)
+	, m_alignment(std::max(p_alignment, GLintptr(16)))
+	, m_pMapped(nullptr)
+	, m_region(0)
+	, m_head(0)
+	, m_end(0)
+	, m_numWaits(0)
+	, m_numOverflows(0)
+{
+	// Regions start on aligned offsets.
+	m_regionSize = ((p_regionSize + m_alignment - 1) / m_alignment) * m_alignment;
+
+	for (uint32_t i = 0; i < EVE_OGL_RING_FRAMES; i++) {
+		m_fences[i] = 0;
+	}
+}
+
+
+
+//=================================================================================================
+void eve::ogl::RingBuffer::init(void)
+{
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	const GLsizeiptr size  = m_regionSize * EVE_OGL_RING_FRAMES;
+
+	glGenBuffers(1, &m_id);
+	glBindBuffer(m_target, m_id);
+	glBufferStorage(m_target, size, nullptr, flags);
+	m_pMapped = reinterpret_cast<GLubyte*>(glMapBufferRange(m_target, 0, size, flags));
+	glBindBuffer(m_target, 0);
+	EVE_OGL_CHECK_ERROR;
+
+	EVE_ASSERT(m_pMapped);
+
+	// First beginFrame() moves to region 0.
+	m_region = EVE_OGL_RING_FRAMES - 1;
+	m_head	 = 0;
+	m_end	 = 0;
+}
+
+//=================================================================================================
+void eve::ogl::RingBuffer::release(void)
+{
+	for (uint32_t i = 0; i < EVE_OGL_RING_FRAMES; i++)
+	{
+		if (m_fences[i])
+		{
+			glDeleteSync(m_fences[i]);
+			m_fences[i] = 0;
+		}
+	}
+
+	glBindBuffer(m_target, m_id);
+	glUnmapBuffer(m_target);
+	glBindBuffer(m_target, 0);
+	glDeleteBuffers(1, &m_id);
+	EVE_OGL_CHECK_ERROR;
+
+	m_pMapped = nullptr;
+	m_id	  = 0;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::RingBuffer::beginFrame(void)
+{
+	m_region = (m_region + 1) % EVE_OGL_RING_FRAMES;
+
+	// Wait for GPU to be done with region previous content.
+	GLsync & fence = m_fences[m_region];
+	if (fence)
+	{
+		GLenum ret = glClientWaitSync(fence, 0, 0);
+		if (ret == GL_TIMEOUT_EXPIRED)
+		{
+			m_numWaits++;
+			do {
+				ret = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			} while (ret == GL_TIMEOUT_EXPIRED);
+		}
+
+		glDeleteSync(fence);
+		fence = 0;
+	}
+
+	m_head = m_regionSize * m_region;
+	m_end  = m_head + m_regionSize;
+}
+
+//=================================================================================================
+void eve::ogl::RingBuffer::endFrame(void)
+{
+	GLsync & fence = m_fences[m_region];
+	if (fence) {
+		glDeleteSync(fence);
+	}
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+
+
+//=================================================================================================
+GLintptr eve::ogl::RingBuffer::allocate(GLsizeiptr p_size, void ** p_ppData)
+{
+	EVE_ASSERT(p_ppData);
+
+	if (m_head + p_size > m_end)
+	{
+		m_numOverflows++;
+		return -1;
+	}
+
+	GLintptr offset = m_head;
+	*p_ppData = m_pMapped + offset;
+	m_head	  = ((offset + p_size + m_alignment - 1) / m_alignment) * m_alignment;
+
+	return offset;
+}
+
+//=================================================================================================
+GLintptr eve::ogl::RingBuffer::push(const void * p_pData, GLsizeiptr p_size)
+{
+	void *	 dst	= nullptr;
+	GLintptr offset = this->allocate(p_size, &dst);
+	if (offset >= 0) {
+		eve::mem::memcpy(dst, p_pData, p_size);
+	}
+	return offset;
+}
@@ -0,0 +1,162 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_OPENGL_CORE_RING_BUFFER_H__
+#define __EVE_OPENGL_CORE_RING_BUFFER_H__
+
+#ifndef __EVE_OPENGL_CORE_OBJECT_H__
+#include "eve/ogl/core/Object.h"
+#endif
+
+
+/** \def EVE_OGL_RING_FRAMES Frames in flight amount of ring buffers (triple buffering). */
+#define EVE_OGL_RING_FRAMES		3
+/** \def EVE_OGL_RING_UNIFORM_SIZE Renderer uniform ring buffer per frame region size in bytes. */
+#define EVE_OGL_RING_UNIFORM_SIZE	(4 * 1024 * 1024)
+/** \def EVE_OGL_RING_DRAW_SIZE Renderer draw ring buffer (instance attributes and indirect commands) per frame region size in bytes. */
+#define EVE_OGL_RING_DRAW_SIZE		(4 * 1024 * 1024)
+
+
+namespace eve
+{
+	namespace ogl
+	{
+		/** 
+		* \class eve::ogl::RingBuffer
+		*
+		* \brief Persistently mapped streaming buffer (ARB_buffer_storage), split in EVE_OGL_RING_FRAMES regions.
+		* Each frame writes in its own region, a fence is inserted at frame end and waited before the region is reused.
+		* Slices are sub-allocated with target offset alignment and written straight into mapped memory, no map/unmap per update.
+		* Owned and driven by eve::ogl::Renderer, every method needs the renderer OpenGL context.
+		*
+		* \note extends eve::mem::Pointer
+		*/
+		class RingBuffer final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			GLenum						m_target;								//!< Specifies buffer binding target.
+			GLuint						m_id;									//!< Specifies OpenGL unique buffer ID.
+			GLsizeiptr					m_regionSize;							//!< Specifies per frame region size in bytes.
+			GLintptr					m_alignment;							//!< Specifies slices offset alignment in bytes.
+			GLubyte *					m_pMapped;								//!< Specifies persistently mapped buffer address.
+
+			GLsync						m_fences[EVE_OGL_RING_FRAMES];			//!< Specifies per region fence.
+			uint32_t					m_region;								//!< Specifies current region.
+			GLintptr					m_head;									//!< Specifies current region next free offset (absolute).
+			GLintptr					m_end;									//!< Specifies current region end offset (absolute).
+
+			size_t						m_numWaits;								//!< Specifies CPU waits on fences amount (GPU lagging behind).
+			size_t						m_numOverflows;							//!< Specifies rejected allocations amount (region full).
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(RingBuffer);
+			EVE_PUBLIC_DESTRUCTOR(RingBuffer);
+
+		public:
+			/** \brief Create, init and return new pointer, returns nullptr if ARB_buffer_storage is not supported. */
+			static eve::ogl::RingBuffer * create_ptr(GLenum p_target, GLsizeiptr p_regionSize, GLintptr p_alignment);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit RingBuffer(GLenum p_target, GLsizeiptr p_regionSize, GLintptr p_alignment);
+
+
+		public:
+			/** \brief Alloc and init class members, create and map buffer storage. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members, unmap and delete buffer storage. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Move to next region, wait for its previous use completion on GPU. */
+			void beginFrame(void);
+			/** \brief Insert current region fence, call once frame commands using the region are issued. */
+			void endFrame(void);
+
+
+		public:
+			/** 
+			* \brief Allocate \a p_size bytes in current region, return slice offset in buffer and write address in \a p_ppData.
+			* Returns -1 when current region is full, caller should then use its fallback path.
+			*/
+			GLintptr allocate(GLsizeiptr p_size, void ** p_ppData);
+			/** \brief Allocate a slice, copy \a p_size bytes from \a p_pData in it and return slice offset (-1 when region is full). */
+			GLintptr push(const void * p_pData, GLsizeiptr p_size);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get OpenGL buffer unique ID. */
+			const GLuint getId(void) const;
+			/** \brief Get buffer binding target. */
+			const GLenum getTarget(void) const;
+			/** \brief Get per frame region size in bytes. */
+			const GLsizeiptr getRegionSize(void) const;
+			/** \brief Get CPU waits on fences amount. */
+			const size_t getNumWaits(void) const;
+			/** \brief Get rejected allocations amount. */
+			const size_t getNumOverflows(void) const;
+
+		}; // class RingBuffer
+
+	} // namespace ogl
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const GLuint		eve::ogl::RingBuffer::getId(void) const				{ return m_id;				}
+EVE_FORCE_INLINE const GLenum		eve::ogl::RingBuffer::getTarget(void) const			{ return m_target;			}
+EVE_FORCE_INLINE const GLsizeiptr	eve::ogl::RingBuffer::getRegionSize(void) const		{ return m_regionSize;		}
+EVE_FORCE_INLINE const size_t		eve::ogl::RingBuffer::getNumWaits(void) const		{ return m_numWaits;		}
+EVE_FORCE_INLINE const size_t		eve::ogl::RingBuffer::getNumOverflows(void) const	{ return m_numOverflows;	}
+
+#endif // __EVE_OPENGL_CORE_RING_BUFFER_H__
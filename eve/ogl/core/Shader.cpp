@@ -32,6 +32,18 @@
 // Main header
 #include "eve/ogl/core/Shader.h"
 
+#ifndef __EVE_OPENGL_CORE_PROGRAM_CACHE_H__
+#include "eve/ogl/core/ProgramCache.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_SHADER_RELOADER_H__
+#include "eve/ogl/core/ShaderReloader.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_CONTEXT_H__
+#include "eve/ogl/core/win32/Context.h"
+#endif
+
 
 //=================================================================================================
 eve::ogl::FormatShader::FormatShader(void)
@@ -89,6 +101,7 @@ eve::ogl::Shader::Shader(void)
 	, m_eval()
 	, m_geom()
 	, m_frag()
+	, m_dirty(0)
 {}
 
 
@@ -129,55 +142,25 @@ void eve::ogl::Shader::oglInit(void)
 	EVE_OGL_CHECK_ERROR;
 
 
-	char const * src = nullptr;
-
-	if (m_vert.length() > 1)
-	{
-		src = m_vert.c_str();
-		m_prgmId[prgm_Vertex] = glCreateShaderProgramv(GL_VERTEX_SHADER, 1, &src);
-		EVE_OGL_CHECK_SHADER(m_prgmId[eve::ogl::prgm_Vertex]);
-
-		glUseProgramStages(m_id, GL_VERTEX_SHADER_BIT, m_prgmId[eve::ogl::prgm_Vertex]);
-		EVE_OGL_CHECK_ERROR;
-	}
-
-	if (m_cont.length() > 1)
+	for (uint32_t i = 0; i < eve::ogl::prgm_Max; i++)
 	{
-		src = m_cont.c_str();
-		m_prgmId[prgm_Control] = glCreateShaderProgramv(GL_TESS_CONTROL_SHADER, 1, &src);
-		EVE_OGL_CHECK_SHADER(m_prgmId[eve::ogl::prgm_Control]);
-
-		glUseProgramStages(m_id, GL_TESS_CONTROL_SHADER_BIT, m_prgmId[eve::ogl::prgm_Control]);
-		EVE_OGL_CHECK_ERROR;
+		this->oglInitStage(static_cast<eve::ogl::ProgramType>(i));
 	}
 
-	if (m_eval.length() > 1)
-	{
-		src = m_eval.c_str();
-		m_prgmId[prgm_Evaluation] = glCreateShaderProgramv(GL_TESS_EVALUATION_SHADER, 1, &src);
-		EVE_OGL_CHECK_SHADER(m_prgmId[eve::ogl::prgm_Evaluation]);
-
-		glUseProgramStages(m_id, GL_TESS_EVALUATION_SHADER_BIT, m_prgmId[eve::ogl::prgm_Evaluation]);
-		EVE_OGL_CHECK_ERROR;
-	}
-
-	if (m_geom.length() > 1)
-	{
-		src = m_geom.c_str();
-		m_prgmId[prgm_Geometry] = glCreateShaderProgramv(GL_GEOMETRY_SHADER, 1, &src);
-		EVE_OGL_CHECK_SHADER(m_prgmId[eve::ogl::prgm_Geometry]);
+	m_dirty = 0;
+}
 
-		glUseProgramStages(m_id, GL_GEOMETRY_SHADER_BIT, m_prgmId[eve::ogl::prgm_Geometry]);
-		EVE_OGL_CHECK_ERROR;
-	}
+//=================================================================================================
+void eve::ogl::Shader::oglInitStage(eve::ogl::ProgramType p_type)
+{
+	const std::string & source = this->getSource(p_type);
 
-	if (m_frag.length() > 1)
+	if (source.length() > 1)
 	{
-		src = m_frag.c_str();
-		m_prgmId[prgm_Fragment] = glCreateShaderProgramv(GL_FRAGMENT_SHADER, 1, &src);
-		EVE_OGL_CHECK_SHADER(m_prgmId[eve::ogl::prgm_Fragment]);
+		m_prgmId[p_type] = eve::ogl::ProgramCache::get_instance()->createProgram(get_stage_type(p_type), source);
+		EVE_OGL_CHECK_SHADER(m_prgmId[p_type]);
 
-		glUseProgramStages(m_id, GL_FRAGMENT_SHADER_BIT, m_prgmId[eve::ogl::prgm_Fragment]);
+		glUseProgramStages(m_id, get_stage_bit(p_type), m_prgmId[p_type]);
 		EVE_OGL_CHECK_ERROR;
 	}
 }
@@ -185,13 +168,42 @@ void eve::ogl::Shader::oglInit(void)
 //=================================================================================================
 void eve::ogl::Shader::oglUpdate(void)
 {
-	this->oglRelease();
-	this->oglInit();
+	// Only reloaded stages are recreated, pipeline and other stages programs are kept.
+	for (uint32_t i = 0; i < eve::ogl::prgm_Max; i++)
+	{
+		if ((m_dirty & (1 << i)) == 0) continue;
+
+		eve::ogl::ProgramType type = static_cast<eve::ogl::ProgramType>(i);
+		if (m_prgmId[i] == 0)
+		{
+			this->oglInitStage(type);
+			continue;
+		}
+
+		// Stage failing to compile or link keeps its previous program.
+		GLuint id	 = eve::ogl::ProgramCache::get_instance()->createProgram(get_stage_type(type), this->getSource(type));
+		GLint linked = GL_FALSE;
+		glGetProgramiv(id, GL_LINK_STATUS, &linked);
+		if (linked == GL_TRUE)
+		{
+			this->swapProgram(type, id, this->getSource(type));
+		}
+		else
+		{
+			EVE_OGL_CHECK_SHADER(id);
+			glDeleteProgram(id);
+		}
+	}
+
+	m_dirty = 0;
 }
 
 //=================================================================================================
 void eve::ogl::Shader::oglRelease(void)
 {
+	// Drop hot reload watches and queued programs.
+	eve::ogl::ShaderReloader::get_instance()->unwatch(this);
+
 	glDeleteProgram(m_prgmId[eve::ogl::prgm_Vertex]);
 	glDeleteProgram(m_prgmId[eve::ogl::prgm_Control]);
 	glDeleteProgram(m_prgmId[eve::ogl::prgm_Evaluation]);
@@ -208,15 +220,37 @@ void eve::ogl::Shader::oglRelease(void)
 //=================================================================================================
 void eve::ogl::Shader::bind(void)
 {
-	glBindProgramPipeline(m_id);
+	EveStateGL->bindProgramPipeline(m_id);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Shader::unbind(void)
 {
-	glBindProgramPipeline(0);
+	EveStateGL->bindProgramPipeline(0);
+	EVE_OGL_CHECK_ERROR;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::Shader::swapProgram(eve::ogl::ProgramType p_type, GLuint p_id, const std::string & p_source)
+{
+	glUseProgramStages(m_id, get_stage_bit(p_type), p_id);
 	EVE_OGL_CHECK_ERROR;
+
+	glDeleteProgram(m_prgmId[p_type]);
+	m_prgmId[p_type] = p_id;
+
+	switch (p_type)
+	{
+	case eve::ogl::prgm_Vertex:		m_vert = p_source; break;
+	case eve::ogl::prgm_Control:	m_cont = p_source; break;
+	case eve::ogl::prgm_Evaluation:	m_eval = p_source; break;
+	case eve::ogl::prgm_Geometry:	m_geom = p_source; break;
+	case eve::ogl::prgm_Fragment:	m_frag = p_source; break;
+	default: EVE_ASSERT_FAILURE;	break;
+	}
 }
 
 
@@ -227,6 +261,7 @@ void eve::ogl::Shader::reloadShaderVertex(const std::string & p_vert)
 	EVE_ASSERT(p_vert.length() > 1);
 
 	m_vert = std::string(p_vert);
+	m_dirty |= 1 << eve::ogl::prgm_Vertex;
 	this->requestOglUpdate();
 }
 
@@ -236,6 +271,7 @@ void eve::ogl::Shader::reloadShaderControl(const std::string & p_cont)
 	EVE_ASSERT(p_cont.length() > 1);
 
 	m_cont = std::string(p_cont);
+	m_dirty |= 1 << eve::ogl::prgm_Control;
 	this->requestOglUpdate();
 }
 
@@ -245,6 +281,7 @@ void eve::ogl::Shader::reloadShaderEvaluation(const std::string & p_eval)
 	EVE_ASSERT(p_eval.length() > 1);
 
 	m_eval = std::string(p_eval);
+	m_dirty |= 1 << eve::ogl::prgm_Evaluation;
 	this->requestOglUpdate();
 }
 
@@ -254,6 +291,7 @@ void eve::ogl::Shader::reloadShaderGeometry(const std::string & p_geom)
 	EVE_ASSERT(p_geom.length() > 1);
 
 	m_geom = std::string(p_geom);
+	m_dirty |= 1 << eve::ogl::prgm_Geometry;
 	this->requestOglUpdate();
 }
 
@@ -263,6 +301,7 @@ void eve::ogl::Shader::reloadShaderFragment(const std::string & p_frag)
 	EVE_ASSERT(p_frag.length() > 1);
 
 	m_frag = std::string(p_frag);
+	m_dirty |= 1 << eve::ogl::prgm_Fragment;
 	this->requestOglUpdate();
 }
 
@@ -276,6 +315,7 @@ void eve::ogl::Shader::reloadShader(const std::string & p_vert, const std::strin
 
 	m_vert = std::string(p_vert);
 	m_frag = std::string(p_frag);
+	m_dirty |= (1 << eve::ogl::prgm_Vertex) | (1 << eve::ogl::prgm_Fragment);
 	this->requestOglUpdate();
 }
 
@@ -289,6 +329,7 @@ void eve::ogl::Shader::reloadShader(const std::string & p_vert, const std::strin
 	m_vert = std::string(p_vert);
 	m_geom = std::string(p_geom);
 	m_frag = std::string(p_frag);
+	m_dirty |= (1 << eve::ogl::prgm_Vertex) | (1 << eve::ogl::prgm_Geometry) | (1 << eve::ogl::prgm_Fragment);
 	this->requestOglUpdate();
 }
 
@@ -306,5 +347,42 @@ void eve::ogl::Shader::reloadShader(const std::string & p_vert, const std::strin
 	m_eval = std::string(p_eval);
 	m_geom = std::string(p_geom);
 	m_frag = std::string(p_frag);
+	m_dirty |= (1 << eve::ogl::prgm_Vertex) | (1 << eve::ogl::prgm_Control) | (1 << eve::ogl::prgm_Evaluation) | (1 << eve::ogl::prgm_Geometry) | (1 << eve::ogl::prgm_Fragment);
 	this->requestOglUpdate();
 }
+
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+const std::string & eve::ogl::Shader::getSource(eve::ogl::ProgramType p_type) const
+{
+	switch (p_type)
+	{
+	case eve::ogl::prgm_Control:	return m_cont;
+	case eve::ogl::prgm_Evaluation:	return m_eval;
+	case eve::ogl::prgm_Geometry:	return m_geom;
+	case eve::ogl::prgm_Fragment:	return m_frag;
+	case eve::ogl::prgm_Vertex:
+	default:						return m_vert;
+	}
+}
+
+//=================================================================================================
+GLenum eve::ogl::Shader::get_stage_type(eve::ogl::ProgramType p_type)
+{
+	static const GLenum types[eve::ogl::prgm_Max] = { GL_VERTEX_SHADER, GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER };
+	EVE_ASSERT(p_type < eve::ogl::prgm_Max);
+	return types[p_type];
+}
+
+//=================================================================================================
+GLbitfield eve::ogl::Shader::get_stage_bit(eve::ogl::ProgramType p_type)
+{
+	static const GLbitfield bits[eve::ogl::prgm_Max] = { GL_VERTEX_SHADER_BIT, GL_TESS_CONTROL_SHADER_BIT, GL_TESS_EVALUATION_SHADER_BIT, GL_GEOMETRY_SHADER_BIT, GL_FRAGMENT_SHADER_BIT };
+	EVE_ASSERT(p_type < eve::ogl::prgm_Max);
+	return bits[p_type];
+}
@@ -141,6 +141,7 @@ namespace eve
 			std::string					m_eval;					//!< Evaluation shader program source.
 			std::string					m_geom;					//!< Geometry shader program source.
 			std::string					m_frag;					//!< Fragment shader program source.
+			uint32_t					m_dirty;				//!< Stages to recompile on next update (bit 1 << eve::ogl::ProgramType).
 
 
 			//////////////////////////////////////
@@ -178,6 +179,10 @@ namespace eve
 			/** \brief Deallocate and release OpenGL components. */
 			virtual void oglRelease(void);
 
+		private:
+			/** \brief Create stage \a p_type program from its source through eve::ogl::ProgramCache and attach it to pipeline. */
+			void oglInitStage(eve::ogl::ProgramType p_type);
+
 
 		public:
 			/** \brief Bind (activate). */
@@ -186,6 +191,11 @@ namespace eve
 			static void unbind(void);
 
 
+		public:
+			/** \brief Replace stage \a p_type program by linked separable program \a p_id compiled from \a p_source, previous program is deleted. */
+			void swapProgram(eve::ogl::ProgramType p_type, GLuint p_id, const std::string & p_source);
+
+
 		public:
 			/** \brief Reload vertex shader program from source. */
 			void reloadShaderVertex(const std::string & p_vert);
@@ -217,6 +227,13 @@ namespace eve
 
 			/** \brief Get OpenGL program id depending on target type. */
 			const GLuint getProgramId(eve::ogl::ProgramType p_type) const;
+			/** \brief Get program source depending on target type. */
+			const std::string & getSource(eve::ogl::ProgramType p_type) const;
+
+			/** \brief Get OpenGL shader type (GL_VERTEX_SHADER...) of program type \a p_type. */
+			static GLenum get_stage_type(eve::ogl::ProgramType p_type);
+			/** \brief Get OpenGL pipeline stage bit (GL_VERTEX_SHADER_BIT...) of program type \a p_type. */
+			static GLbitfield get_stage_bit(eve::ogl::ProgramType p_type);
 			
 		}; // class Fbo
 
@@ -32,6 +32,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Main header
 #include "eve/ogl/core/ShaderManager.h"
 
+#ifndef __EVE_OPENGL_CORE_CONTEXT_H__
+#include "eve/ogl/core/win32/Context.h"
+#endif
+
 
 eve::ogl::ShaderBaseModel::ShaderBaseModel()
 	: m_shader(std::map<std::string, GLuint>())
@@ -183,7 +187,7 @@ void eve::ogl::ShaderManager::oglInit(void)
 {
 
 	glGenVertexArrays(1, &m_VertexArrayID);
-	glBindVertexArray(m_VertexArrayID);
+	EveStateGL->bindVertexArray(m_VertexArrayID);
 
 	//Initiliaze shader and shader program
 
@@ -314,7 +318,7 @@ void eve::ogl::ShaderManager::detachShader(const std::string& shaderKey, const s
 }
 
 void eve::ogl::ShaderManager::resetProgram(){
-	glUseProgram(0);
+	EveStateGL->useProgram(0);
 }
 
 void eve::ogl::ShaderManager::createProgram(const std::string& shaderProgramKey){
@@ -343,7 +347,7 @@ void eve::ogl::ShaderManager::useProgram(const std::string& shaderProgramKey){
 	GLuint shaderProgramID = m_shaderData.getShaderProgramID(shaderProgramKey);
 
 	if (shaderProgramID != 0){
-		glUseProgram(shaderProgramID);
+		EveStateGL->useProgram(shaderProgramID);
 	}
 	else {
 		throw std::runtime_error("ERROR: No shader-program with associated key does exist!");
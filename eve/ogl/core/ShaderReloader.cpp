@@ -0,0 +1,346 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/ogl/core/ShaderReloader.h"
+
+#ifndef __EVE_FILES_WATCHER_H__
+#include "eve/files/Watcher.h"
+#endif
+
+#ifndef __EVE_FILES_UTILS_H__
+#include "eve/files/Utils.h"
+#endif
+
+#ifndef __EVE_IO_UTILS_H__
+#include "eve/io/Utils.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_PROGRAM_CACHE_H__
+#include "eve/ogl/core/ProgramCache.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_CONTEXT_H__
+#include "eve/ogl/core/win32/Context.h"
+#endif
+
+#ifndef __EVE_STRING_UTILS_H__
+#include "eve/str/Utils.h"
+#endif
+
+#ifndef __EVE_THREADING_SPIN_LOCK_H__
+#include "eve/thr/SpinLock.h"
+#endif
+
+
+namespace
+{
+	/** \brief Use '/' separators so watched and reported paths compare equal. */
+	std::string normalize_separators(const std::string & p_path)
+	{
+		std::string ret(p_path);
+		std::replace(ret.begin(), ret.end(), '\\', '/');
+		return ret;
+	}
+
+} // namespace
+
+
+
+//=================================================================================================
+eve::ogl::ShaderReloader * eve::ogl::ShaderReloader::m_p_instance = nullptr;
+
+//=================================================================================================
+eve::ogl::ShaderReloader * eve::ogl::ShaderReloader::create_instance(void)
+{
+	EVE_ASSERT(!m_p_instance);
+	m_p_instance = EVE_CREATE_PTR(eve::ogl::ShaderReloader);
+	m_p_instance->start();
+	return m_p_instance;
+}
+
+//=================================================================================================
+eve::ogl::ShaderReloader * eve::ogl::ShaderReloader::get_instance(void)
+{
+	EVE_ASSERT(m_p_instance);
+	return m_p_instance;
+}
+
+//=================================================================================================
+void eve::ogl::ShaderReloader::release_instance(void)
+{
+	EVE_ASSERT(m_p_instance);
+	EVE_RELEASE_PTR(m_p_instance);
+}
+
+
+
+//=================================================================================================
+eve::ogl::ShaderReloader::ShaderReloader(void)
+	// Inheritance
+	: eve::thr::Thread()
+
+	// Members init
+	, m_pWatcher(nullptr)
+	, m_pContext(nullptr)
+	, m_pVecWatches(nullptr)
+	, m_pVecSwaps(nullptr)
+	, m_numReloads(0)
+	, m_numFailures(0)
+{}
+
+
+
+//=================================================================================================
+void eve::ogl::ShaderReloader::init(void)
+{
+	// Call parent class.
+	eve::thr::Thread::init();
+	m_runWait = EVE_OGL_SHADER_RELOAD_WAIT;
+
+	m_pWatcher		= eve::files::Watcher::create_ptr();
+	m_pVecWatches	= new std::vector<eve::ogl::ShaderWatch>();
+	m_pVecSwaps		= new std::vector<eve::ogl::ShaderSwap>();
+}
+
+//=================================================================================================
+void eve::ogl::ShaderReloader::release(void)
+{
+	// Stop thread first, run loop uses members.
+	this->stop();
+
+	// Shaders unwatch on release, queued programs left belong to leaked shaders.
+	EVE_ASSERT(m_pVecSwaps->empty());
+
+	EVE_RELEASE_PTR(m_pWatcher);
+	EVE_RELEASE_PTR_CPP(m_pVecWatches);
+	EVE_RELEASE_PTR_CPP(m_pVecSwaps);
+
+	// Call parent class.
+	eve::thr::Thread::release();
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ShaderReloader::initThreadedData(void)
+{
+	// Shared context is created on first change, nothing to pay until a source file is edited.
+}
+
+//=================================================================================================
+void eve::ogl::ShaderReloader::releaseThreadedData(void)
+{
+	EVE_RELEASE_PTR_SAFE(m_pContext);
+}
+
+//=================================================================================================
+void eve::ogl::ShaderReloader::run(void)
+{
+	std::vector<std::string> changed;
+
+	do
+	{
+		m_pFence->lock();
+		m_pWatcher->poll(changed);
+		m_pFence->unlock();
+
+		if (!changed.empty())
+		{
+			this->compile(changed);
+			changed.clear();
+		}
+
+	} while (this->running());
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ShaderReloader::compile(const std::vector<std::string> & p_changed)
+{
+	// Snapshot stages watching changed files, watches may change while compiling.
+	std::vector<eve::ogl::ShaderWatch> targets;
+	m_pFence->lock();
+	for (auto & watch : (*m_pVecWatches))
+	{
+		if (std::find(p_changed.begin(), p_changed.end(), watch.path) != p_changed.end()) {
+			targets.push_back(watch);
+		}
+	}
+	m_pFence->unlock();
+
+	if (targets.empty()) return;
+
+	if (!m_pContext) {
+		m_pContext = eve::ogl::SharedContext::create_ptr();
+	}
+	m_pContext->makeCurrent();
+
+	std::vector<eve::ogl::ShaderSwap> swaps;
+	std::map<std::string, std::string> sources;
+	for (auto & target : targets)
+	{
+		// Several stages may share a source file and preamble, read it once.
+		const std::string key = target.preamble + target.path;
+		auto itr = sources.find(key);
+		if (itr == sources.end()) {
+			const char * preamble = target.preamble.empty() ? nullptr : target.preamble.c_str();
+			itr = sources.insert(std::make_pair(key, eve::io::load_program(target.path, preamble))).first;
+		}
+
+		eve::ogl::ShaderSwap swap;
+		swap.pShader = target.pShader;
+		swap.type	 = target.type;
+		swap.source	 = itr->second;
+		swap.id		 = eve::ogl::ProgramCache::get_instance()->createProgram(eve::ogl::Shader::get_stage_type(target.type), swap.source);
+
+		GLint linked = GL_FALSE;
+		glGetProgramiv(swap.id, GL_LINK_STATUS, &linked);
+		if (linked == GL_TRUE)
+		{
+			swaps.push_back(swap);
+		}
+		else
+		{
+			GLint length = 0;
+			glGetProgramiv(swap.id, GL_INFO_LOG_LENGTH, &length);
+			std::string log(static_cast<size_t>(length) + 1, '\0');
+			glGetProgramInfoLog(swap.id, length, nullptr, &log[0]);
+			EVE_LOG_ERROR("Shader reload failed, previous program is kept. %s: %s", eve::str::to_wstring(target.path).c_str(), eve::str::to_wstring(log).c_str());
+
+			glDeleteProgram(swap.id);
+			m_numFailures++;
+		}
+	}
+
+	// Programs are complete before render context uses them.
+	glFinish();
+
+	m_pFence->lock();
+	for (auto & swap : swaps)
+	{
+		// Shader may have been released while compiling.
+		bool watched = false;
+		for (auto & watch : (*m_pVecWatches))
+		{
+			if (watch.pShader == swap.pShader && watch.type == swap.type) { watched = true; break; }
+		}
+		if (!watched)
+		{
+			glDeleteProgram(swap.id);
+			continue;
+		}
+
+		// Newer program replaces one still queued for same stage.
+		for (auto itr = m_pVecSwaps->begin(); itr != m_pVecSwaps->end(); ++itr)
+		{
+			if (itr->pShader == swap.pShader && itr->type == swap.type)
+			{
+				glDeleteProgram(itr->id);
+				m_pVecSwaps->erase(itr);
+				break;
+			}
+		}
+		m_pVecSwaps->push_back(swap);
+		m_numReloads++;
+	}
+	m_pFence->unlock();
+
+	m_pContext->doneCurrent();
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ShaderReloader::watch(eve::ogl::Shader * p_pShader, eve::ogl::ProgramType p_type, const std::string & p_path, const char * p_preamble)
+{
+	EVE_ASSERT(p_pShader);
+
+	eve::ogl::ShaderWatch watch;
+	watch.pShader	= p_pShader;
+	watch.type		= p_type;
+	watch.path		= normalize_separators(p_path);
+	watch.preamble	= p_preamble ? p_preamble : "";
+
+	m_pFence->lock();
+	m_pWatcher->addDirectory(eve::files::remove_file_name(watch.path));
+	m_pVecWatches->push_back(watch);
+	m_pFence->unlock();
+}
+
+//=================================================================================================
+void eve::ogl::ShaderReloader::unwatch(eve::ogl::Shader * p_pShader)
+{
+	m_pFence->lock();
+
+	auto itr = m_pVecWatches->begin();
+	while (itr != m_pVecWatches->end())
+	{
+		if (itr->pShader == p_pShader) itr = m_pVecWatches->erase(itr);
+		else ++itr;
+	}
+
+	auto itrSwap = m_pVecSwaps->begin();
+	while (itrSwap != m_pVecSwaps->end())
+	{
+		if (itrSwap->pShader == p_pShader)
+		{
+			glDeleteProgram(itrSwap->id);
+			itrSwap = m_pVecSwaps->erase(itrSwap);
+		}
+		else {
+			++itrSwap;
+		}
+	}
+
+	m_pFence->unlock();
+}
+
+//=================================================================================================
+void eve::ogl::ShaderReloader::apply(void)
+{
+	m_pFence->lock();
+	if (m_pVecSwaps->empty())
+	{
+		m_pFence->unlock();
+		return;
+	}
+	std::vector<eve::ogl::ShaderSwap> swaps;
+	swaps.swap(*m_pVecSwaps);
+	m_pFence->unlock();
+
+	// Render threads share master context lock, unwatch() can not run concurrently.
+	for (auto & swap : swaps)
+	{
+		swap.pShader->swapProgram(swap.type, swap.id, swap.source);
+	}
+}
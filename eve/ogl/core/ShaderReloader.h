@@ -0,0 +1,198 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_OPENGL_CORE_SHADER_RELOADER_H__
+#define __EVE_OPENGL_CORE_SHADER_RELOADER_H__
+
+#ifndef __EVE_OPENGL_CORE_SHADER_H__
+#include "eve/ogl/core/Shader.h"
+#endif
+
+#ifndef __EVE_THREADING_THREAD_H__
+#include "eve/thr/Thread.h"
+#endif
+
+
+namespace eve { namespace app { class App; } }
+namespace eve { namespace files { class Watcher; } }
+namespace eve { namespace ogl { class SharedContext; } }
+
+
+/**
+* \def EVE_OGL_SHADER_RELOAD_WAIT
+* \brief Source directories polling period in milliseconds.
+*/
+#define EVE_OGL_SHADER_RELOAD_WAIT		50
+
+
+namespace eve
+{
+	namespace ogl
+	{
+		/**
+		* \struct eve::ogl::ShaderWatch
+		* \brief Shader stage linked to a source file.
+		*/
+		struct ShaderWatch
+		{
+			eve::ogl::Shader *			pShader;		//!< Target shader.
+			eve::ogl::ProgramType		type;			//!< Target stage.
+			std::string					path;			//!< Source file path ('/' separated).
+			std::string					preamble;		//!< Text prepended to source (version, defines), as given at creation.
+		};
+
+		/**
+		* \struct eve::ogl::ShaderSwap
+		* \brief Compiled stage program waiting for frame boundary.
+		*/
+		struct ShaderSwap
+		{
+			eve::ogl::Shader *			pShader;		//!< Target shader.
+			eve::ogl::ProgramType		type;			//!< Target stage.
+			GLuint						id;				//!< Linked program id (created on shared context).
+			std::string					source;			//!< Program source.
+		};
+
+
+		/**
+		* \class eve::ogl::ShaderReloader
+		*
+		* \brief Shader sources hot reload service.
+		* Watched source files directories are polled by an eve::files::Watcher, changed stages are compiled through
+		* eve::ogl::ProgramCache on a background eve::ogl::SharedContext (created on first change), and programs are
+		* swapped in shader pipelines by apply(), called by render loops at frame start. Stage failing to compile or
+		* link keeps its previous program.
+		*
+		* \note extends eve::thr::Thread
+		*/
+		class ShaderReloader final
+			: public eve::thr::Thread
+		{
+			friend class eve::app::App;
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			static ShaderReloader *							m_p_instance;		//!< Unique instance.
+
+		private:
+			eve::files::Watcher *							m_pWatcher;			//!< Source directories watcher.
+			eve::ogl::SharedContext *						m_pContext;			//!< Compilation context (threaded data).
+			std::vector<eve::ogl::ShaderWatch> *			m_pVecWatches;		//!< Watched shader stages.
+			std::vector<eve::ogl::ShaderSwap> *				m_pVecSwaps;		//!< Compiled programs waiting for frame boundary.
+
+			uint64_t										m_numReloads;		//!< Reloaded stages amount.
+			uint64_t										m_numFailures;		//!< Reloads failing to compile or link.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(ShaderReloader)
+			EVE_PUBLIC_DESTRUCTOR(ShaderReloader)
+
+		private:
+			/** \brief Create unique instance and start its thread. */
+			static ShaderReloader * create_instance(void);
+		public:
+			/** \brief Get unique instance. */
+			static ShaderReloader * get_instance(void);
+		private:
+			/** \brief Release unique instance */
+			static void release_instance(void);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit ShaderReloader(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		protected:
+			/** \brief Alloc and init threaded data. (pure virtual) */
+			virtual void initThreadedData(void) override;
+			/** \brief Release and delete threaded data. (pure virtual) */
+			virtual void releaseThreadedData(void) override;
+			/** \brief Poll watched directories and compile changed stages. (pure virtual) */
+			virtual void run(void) override;
+
+
+		private:
+			/** \brief Compile stages watching \a p_changed files on shared context, queue linked programs. */
+			void compile(const std::vector<std::string> & p_changed);
+
+
+		public:
+			/** \brief Reload stage \a p_type of \a p_pShader each time file \a p_path changes, prepending \a p_preamble (MUST match the one used to create the stage). */
+			void watch(eve::ogl::Shader * p_pShader, eve::ogl::ProgramType p_type, const std::string & p_path, const char * p_preamble = nullptr);
+			/** \brief Stop watching \a p_pShader files, drop its queued programs. Rendering context MUST be current. */
+			void unwatch(eve::ogl::Shader * p_pShader);
+
+			/** \brief Swap queued programs in shader pipelines. Called at frame start, rendering context MUST be current. */
+			void apply(void);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get reloaded stages amount. */
+			uint64_t getNumReloads(void) const;
+			/** \brief Get reloads failing to compile or link amount. */
+			uint64_t getNumFailures(void) const;
+
+		}; // class ShaderReloader
+
+	} // namespace ogl
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE uint64_t eve::ogl::ShaderReloader::getNumReloads(void) const	{ return m_numReloads;	}
+EVE_FORCE_INLINE uint64_t eve::ogl::ShaderReloader::getNumFailures(void) const	{ return m_numFailures; }
+
+#endif // __EVE_OPENGL_CORE_SHADER_RELOADER_H__
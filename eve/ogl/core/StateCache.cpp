@@ -0,0 +1,418 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/ogl/core/StateCache.h"
+
+
+//=================================================================================================
+eve::ogl::StateCache::StateCache(void)
+	// Inheritance
+	: eve::mem::Pointer()
+	// Members init
+	, m_program(EVE_OGL_STATE_UNKNOWN)
+	, m_pipeline(EVE_OGL_STATE_UNKNOWN)
+	, m_vertexArray(EVE_OGL_STATE_UNKNOWN)
+	, m_arrayBuffer(EVE_OGL_STATE_UNKNOWN)
+	, m_uniformBuffer(EVE_OGL_STATE_UNKNOWN)
+	, m_activeUnit(EVE_OGL_STATE_UNKNOWN)
+	, m_drawFramebuffer(EVE_OGL_STATE_UNKNOWN)
+	, m_depthMask(EVE_OGL_STATE_UNKNOWN)
+	, m_depthFunc(EVE_OGL_STATE_UNKNOWN)
+	, m_cullFace(EVE_OGL_STATE_UNKNOWN)
+	, m_blendSrc(EVE_OGL_STATE_UNKNOWN)
+	, m_blendDst(EVE_OGL_STATE_UNKNOWN)
+	, m_stats()
+	, m_statsFrame()
+{}
+
+
+
+//=================================================================================================
+void eve::ogl::StateCache::init(void)
+{
+	this->invalidate();
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::release(void)
+{
+	// Nothing to do for now.
+}
+
+
+
+//=================================================================================================
+void eve::ogl::StateCache::invalidate(void)
+{
+	m_program			= EVE_OGL_STATE_UNKNOWN;
+	m_pipeline			= EVE_OGL_STATE_UNKNOWN;
+	m_vertexArray		= EVE_OGL_STATE_UNKNOWN;
+	m_arrayBuffer		= EVE_OGL_STATE_UNKNOWN;
+	m_uniformBuffer		= EVE_OGL_STATE_UNKNOWN;
+	m_activeUnit		= EVE_OGL_STATE_UNKNOWN;
+	m_drawFramebuffer	= EVE_OGL_STATE_UNKNOWN;
+	m_depthMask			= EVE_OGL_STATE_UNKNOWN;
+	m_depthFunc			= EVE_OGL_STATE_UNKNOWN;
+	m_cullFace			= EVE_OGL_STATE_UNKNOWN;
+	m_blendSrc			= EVE_OGL_STATE_UNKNOWN;
+	m_blendDst			= EVE_OGL_STATE_UNKNOWN;
+
+	for (uint32_t i = 0; i < EVE_OGL_STATE_MAX_BINDINGS; i++)
+	{
+		m_uniformBindings[i].id		= EVE_OGL_STATE_UNKNOWN;
+		m_uniformBindings[i].offset = 0;
+		m_uniformBindings[i].size	= 0;
+	}
+	for (uint32_t i = 0; i < EVE_OGL_STATE_MAX_UNITS; i++) {
+		m_textures[i] = EVE_OGL_STATE_UNKNOWN;
+	}
+	for (uint32_t i = 0; i < 4; i++) {
+		m_viewport[i] = -1;
+	}
+	for (uint32_t i = 0; i < Capability_Count; i++) {
+		m_caps[i] = EVE_OGL_STATE_UNKNOWN;
+	}
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::beginFrame(void)
+{
+	m_statsFrame = m_stats;
+	m_stats		 = eve::ogl::StateCacheStats();
+}
+
+
+
+//=================================================================================================
+void eve::ogl::StateCache::useProgram(GLuint p_id)
+{
+	if (m_program == p_id)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glUseProgram(p_id);
+	m_program = p_id;
+	m_stats.numIssued++;
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::bindProgramPipeline(GLuint p_id)
+{
+	if (m_pipeline == p_id)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glBindProgramPipeline(p_id);
+	m_pipeline = p_id;
+	m_stats.numIssued++;
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::bindVertexArray(GLuint p_id)
+{
+	if (m_vertexArray == p_id)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glBindVertexArray(p_id);
+	m_vertexArray = p_id;
+	m_stats.numIssued++;
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::bindBuffer(GLenum p_target, GLuint p_id)
+{
+	GLuint * shadow = nullptr;
+	switch (p_target)
+	{
+	case GL_ARRAY_BUFFER:	shadow = &m_arrayBuffer;	break;
+	case GL_UNIFORM_BUFFER:	shadow = &m_uniformBuffer;	break;
+	default:				break;
+	}
+
+	if (shadow && *shadow == p_id)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glBindBuffer(p_target, p_id);
+	if (shadow) {
+		*shadow = p_id;
+	}
+	m_stats.numIssued++;
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::bindBufferBase(GLenum p_target, GLuint p_index, GLuint p_id)
+{
+	if (p_target != GL_UNIFORM_BUFFER || p_index >= EVE_OGL_STATE_MAX_BINDINGS)
+	{
+		glBindBufferBase(p_target, p_index, p_id);
+		m_stats.numIssued++;
+		return;
+	}
+
+	Binding & binding = m_uniformBindings[p_index];
+	if (binding.id == p_id && binding.size == 0)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glBindBufferBase(p_target, p_index, p_id);
+	binding.id		= p_id;
+	binding.offset	= 0;
+	binding.size	= 0;
+	// Indexed binding also sets generic binding.
+	m_uniformBuffer = p_id;
+	m_stats.numIssued++;
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::bindBufferRange(GLenum p_target, GLuint p_index, GLuint p_id, GLintptr p_offset, GLsizeiptr p_size)
+{
+	if (p_target != GL_UNIFORM_BUFFER || p_index >= EVE_OGL_STATE_MAX_BINDINGS)
+	{
+		glBindBufferRange(p_target, p_index, p_id, p_offset, p_size);
+		m_stats.numIssued++;
+		return;
+	}
+
+	Binding & binding = m_uniformBindings[p_index];
+	if (binding.id == p_id && binding.offset == p_offset && binding.size == p_size)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glBindBufferRange(p_target, p_index, p_id, p_offset, p_size);
+	binding.id		= p_id;
+	binding.offset	= p_offset;
+	binding.size	= p_size;
+	m_uniformBuffer = p_id;
+	m_stats.numIssued++;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::StateCache::activeTexture(GLuint p_unit)
+{
+	if (m_activeUnit == p_unit)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glActiveTexture(GL_TEXTURE0 + p_unit);
+	m_activeUnit = p_unit;
+	m_stats.numIssued++;
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::bindTexture(GLuint p_unit, GLuint p_id)
+{
+	if (p_unit < EVE_OGL_STATE_MAX_UNITS && m_textures[p_unit] == p_id)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	this->activeTexture(p_unit);
+	this->bindTexture(p_id);
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::bindTexture(GLuint p_id)
+{
+	const bool bShadowed = (m_activeUnit < EVE_OGL_STATE_MAX_UNITS);
+	if (bShadowed && m_textures[m_activeUnit] == p_id)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, p_id);
+	if (bShadowed) {
+		m_textures[m_activeUnit] = p_id;
+	}
+	m_stats.numIssued++;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::StateCache::bindDrawFramebuffer(GLuint p_id)
+{
+	if (m_drawFramebuffer == p_id)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, p_id);
+	m_drawFramebuffer = p_id;
+	m_stats.numIssued++;
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::viewport(GLint p_x, GLint p_y, GLsizei p_width, GLsizei p_height)
+{
+	if (m_viewport[0] == p_x && m_viewport[1] == p_y && m_viewport[2] == p_width && m_viewport[3] == p_height)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glViewport(p_x, p_y, p_width, p_height);
+	m_viewport[0] = p_x;
+	m_viewport[1] = p_y;
+	m_viewport[2] = p_width;
+	m_viewport[3] = p_height;
+	m_stats.numIssued++;
+}
+
+
+
+//=================================================================================================
+eve::ogl::StateCache::Capability eve::ogl::StateCache::capability_index(GLenum p_cap)
+{
+	switch (p_cap)
+	{
+	case GL_DEPTH_TEST:		return Capability_Depth_Test;
+	case GL_CULL_FACE:		return Capability_Cull_Face;
+	case GL_BLEND:			return Capability_Blend;
+	case GL_SCISSOR_TEST:	return Capability_Scissor_Test;
+	case GL_STENCIL_TEST:	return Capability_Stencil_Test;
+	case GL_MULTISAMPLE:	return Capability_Multisample;
+	default:				return Capability_Count;
+	}
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::setCapability(GLenum p_cap, GLuint p_state)
+{
+	Capability idx = eve::ogl::StateCache::capability_index(p_cap);
+	if (idx != Capability_Count && m_caps[idx] == p_state)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	if (p_state) {
+		glEnable(p_cap);
+	}
+	else {
+		glDisable(p_cap);
+	}
+	if (idx != Capability_Count) {
+		m_caps[idx] = p_state;
+	}
+	m_stats.numIssued++;
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::enable(GLenum p_cap)
+{
+	this->setCapability(p_cap, 1);
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::disable(GLenum p_cap)
+{
+	this->setCapability(p_cap, 0);
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::depthMask(GLboolean p_flag)
+{
+	const GLuint flag = p_flag ? 1 : 0;
+	if (m_depthMask == flag)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glDepthMask(p_flag);
+	m_depthMask = flag;
+	m_stats.numIssued++;
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::depthFunc(GLenum p_func)
+{
+	if (m_depthFunc == p_func)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glDepthFunc(p_func);
+	m_depthFunc = p_func;
+	m_stats.numIssued++;
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::cullFace(GLenum p_mode)
+{
+	if (m_cullFace == p_mode)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glCullFace(p_mode);
+	m_cullFace = p_mode;
+	m_stats.numIssued++;
+}
+
+//=================================================================================================
+void eve::ogl::StateCache::blendFunc(GLenum p_src, GLenum p_dst)
+{
+	if (m_blendSrc == p_src && m_blendDst == p_dst)
+	{
+		m_stats.numElided++;
+		return;
+	}
+
+	glBlendFunc(p_src, p_dst);
+	m_blendSrc = p_src;
+	m_blendDst = p_dst;
+	m_stats.numIssued++;
+}
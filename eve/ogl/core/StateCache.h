@@ -0,0 +1,234 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_OPENGL_CORE_STATE_CACHE_H__
+#define __EVE_OPENGL_CORE_STATE_CACHE_H__
+
+#ifndef __EVE_OPENGL_CORE_OBJECT_H__
+#include "eve/ogl/core/Object.h"
+#endif
+
+
+/** \def EVE_OGL_STATE_UNKNOWN Shadowed state value forcing next call to be issued. */
+#define EVE_OGL_STATE_UNKNOWN			0xFFFFFFFF
+/** \def EVE_OGL_STATE_MAX_UNITS Shadowed texture units amount. */
+#define EVE_OGL_STATE_MAX_UNITS			32
+/** \def EVE_OGL_STATE_MAX_BINDINGS Shadowed uniform buffer binding points amount. */
+#define EVE_OGL_STATE_MAX_BINDINGS		16
+
+
+namespace eve
+{
+	namespace ogl
+	{
+		/**
+		* \struct eve::ogl::StateCacheStats
+		* \brief State cache calls statistics.
+		*/
+		struct StateCacheStats
+		{
+			uint64_t		numIssued;			//!< Calls forwarded to OpenGL.
+			uint64_t		numElided;			//!< Redundant calls skipped.
+
+			StateCacheStats(void) : numIssued(0), numElided(0) {}
+		};
+
+
+		/** 
+		* \class eve::ogl::StateCache
+		*
+		* \brief Shadow of OpenGL context bindings and capabilities, redundant state calls are skipped.
+		* Shadows programs, program pipelines, VAOs, array/uniform buffers, uniform binding points, 2D textures per unit,
+		* draw framebuffer, viewport, depth/cull/blend states and capabilities.
+		* Owned by eve::ogl::Context, only used while context is current.
+		* Any OpenGL call made outside this class on a shadowed state must be followed by invalidate().
+		*
+		* \note extends eve::mem::Pointer
+		*/
+		class StateCache final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			/** \brief Shadowed capabilities. */
+			enum Capability
+			{
+				Capability_Depth_Test = 0,
+				Capability_Cull_Face,
+				Capability_Blend,
+				Capability_Scissor_Test,
+				Capability_Stencil_Test,
+				Capability_Multisample,
+
+				Capability_Count
+			};
+
+			/** \brief Shadowed indexed uniform buffer binding. */
+			struct Binding
+			{
+				GLuint			id;
+				GLintptr		offset;
+				GLsizeiptr		size;
+			};
+
+		private:
+			GLuint						m_program;								//!< Bound program.
+			GLuint						m_pipeline;								//!< Bound program pipeline.
+			GLuint						m_vertexArray;							//!< Bound VAO.
+			GLuint						m_arrayBuffer;							//!< Bound GL_ARRAY_BUFFER.
+			GLuint						m_uniformBuffer;						//!< Bound GL_UNIFORM_BUFFER (generic binding).
+			Binding						m_uniformBindings[EVE_OGL_STATE_MAX_BINDINGS];	//!< Uniform buffer binding points.
+			GLuint						m_activeUnit;							//!< Active texture unit.
+			GLuint						m_textures[EVE_OGL_STATE_MAX_UNITS];	//!< GL_TEXTURE_2D per unit.
+			GLuint						m_drawFramebuffer;						//!< Bound draw framebuffer.
+			GLint						m_viewport[4];							//!< Viewport.
+			GLuint						m_caps[Capability_Count];				//!< Capabilities (0, 1 or unknown).
+			GLuint						m_depthMask;							//!< Depth write mask.
+			GLuint						m_depthFunc;							//!< Depth function.
+			GLuint						m_cullFace;								//!< Culled faces.
+			GLuint						m_blendSrc;								//!< Blend source factor.
+			GLuint						m_blendDst;								//!< Blend destination factor.
+
+		private:
+			eve::ogl::StateCacheStats	m_stats;								//!< Current frame statistics.
+			eve::ogl::StateCacheStats	m_statsFrame;							//!< Last frame statistics.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(StateCache);
+			EVE_PUBLIC_DESTRUCTOR(StateCache);
+
+		public:
+			/** \brief Class constructor. */
+			explicit StateCache(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Forget every shadowed value, next calls are issued. */
+			void invalidate(void);
+			/** \brief Store current frame statistics as last frame ones and reset them. */
+			void beginFrame(void);
+
+
+		public:
+			/** \brief glUseProgram() */
+			void useProgram(GLuint p_id);
+			/** \brief glBindProgramPipeline() */
+			void bindProgramPipeline(GLuint p_id);
+			/** \brief glBindVertexArray() */
+			void bindVertexArray(GLuint p_id);
+			/** \brief glBindBuffer(), GL_ARRAY_BUFFER and GL_UNIFORM_BUFFER are shadowed, other targets are forwarded. */
+			void bindBuffer(GLenum p_target, GLuint p_id);
+			/** \brief glBindBufferBase(), GL_UNIFORM_BUFFER binding points are shadowed, other targets are forwarded. */
+			void bindBufferBase(GLenum p_target, GLuint p_index, GLuint p_id);
+			/** \brief glBindBufferRange(), GL_UNIFORM_BUFFER binding points are shadowed, other targets are forwarded. */
+			void bindBufferRange(GLenum p_target, GLuint p_index, GLuint p_id, GLintptr p_offset, GLsizeiptr p_size);
+
+
+		public:
+			/** \brief glActiveTexture(GL_TEXTURE0 + \a p_unit) */
+			void activeTexture(GLuint p_unit);
+			/** \brief Bind GL_TEXTURE_2D \a p_id on texture unit \a p_unit. */
+			void bindTexture(GLuint p_unit, GLuint p_id);
+			/** \brief Bind GL_TEXTURE_2D \a p_id on active texture unit. */
+			void bindTexture(GLuint p_id);
+
+
+		public:
+			/** \brief glBindFramebuffer(GL_DRAW_FRAMEBUFFER) */
+			void bindDrawFramebuffer(GLuint p_id);
+			/** \brief glViewport() */
+			void viewport(GLint p_x, GLint p_y, GLsizei p_width, GLsizei p_height);
+
+
+		public:
+			/** \brief glEnable() */
+			void enable(GLenum p_cap);
+			/** \brief glDisable() */
+			void disable(GLenum p_cap);
+			/** \brief glDepthMask() */
+			void depthMask(GLboolean p_flag);
+			/** \brief glDepthFunc() */
+			void depthFunc(GLenum p_func);
+			/** \brief glCullFace() */
+			void cullFace(GLenum p_mode);
+			/** \brief glBlendFunc() */
+			void blendFunc(GLenum p_src, GLenum p_dst);
+
+
+		private:
+			/** \brief Get shadowed capability index, Capability_Count if not shadowed. */
+			static Capability capability_index(GLenum p_cap);
+			/** \brief Set capability state. */
+			void setCapability(GLenum p_cap, GLuint p_state);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get last frame statistics. */
+			const eve::ogl::StateCacheStats & getStatsFrame(void) const;
+			/** \brief Get current frame statistics. */
+			const eve::ogl::StateCacheStats & getStats(void) const;
+
+		}; // class StateCache
+
+	} // namespace ogl
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const eve::ogl::StateCacheStats & eve::ogl::StateCache::getStatsFrame(void) const	{ return m_statsFrame;	}
+EVE_FORCE_INLINE const eve::ogl::StateCacheStats & eve::ogl::StateCache::getStats(void) const		{ return m_stats;		}
+
+#endif // __EVE_OPENGL_CORE_STATE_CACHE_H__
@@ -32,6 +32,10 @@
 // Main header
 #include "eve/ogl/core/Texture.h"
 
+#ifndef __EVE_OPENGL_CORE_RENDER_H__
+#include "eve/ogl/core/Renderer.h"
+#endif
+
 
 //=================================================================================================
 eve::ogl::FormatTex::FormatTex(void)
@@ -101,6 +105,7 @@ eve::ogl::Texture::Texture(void)
 	, m_filter(GL_LINEAR)
 	, m_wrap(GL_CLAMP_TO_EDGE)
 	, m_bSubUpdate(false)
+	, m_numStreaming(0)
 {}
 
 
@@ -154,13 +159,22 @@ void eve::ogl::Texture::oglInit(void)
 	glBindTexture(GL_TEXTURE_2D, m_id);
 	EVE_OGL_CHECK_ERROR;
 
+	// Magnification does not sample mipmaps.
+	GLint magFilter = m_filter;
+	if (this->hasMipmaps()) {
+		magFilter = (m_filter == GL_NEAREST_MIPMAP_NEAREST || m_filter == GL_NEAREST_MIPMAP_LINEAR) ? GL_NEAREST : GL_LINEAR;
+	}
+
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_filter);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_wrap);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_wrap);
 	EVE_OGL_CHECK_ERROR;
 
 	glTexImage2D(GL_TEXTURE_2D, 0, m_internalFormat, m_width, m_height, 0, m_format, m_type, m_pPixels.get());
+	if (m_pPixels && this->hasMipmaps()) {
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
 	EVE_OGL_CHECK_ERROR;
 
 	glBindTexture( GL_TEXTURE_2D, 0 );
@@ -170,69 +184,157 @@ void eve::ogl::Texture::oglInit(void)
 //=================================================================================================
 void eve::ogl::Texture::oglUpdate(void)
 {
-	if (m_bSubUpdate)
-	{
 	glBindTexture(GL_TEXTURE_2D, m_id);
-	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, m_format, m_type, m_pPixels.get());
+	if (m_bSubUpdate) {
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, m_format, m_type, m_pPixels.get());
+	}
+	else {
+		glTexImage2D(GL_TEXTURE_2D, 0, m_internalFormat, m_width, m_height, 0, m_format, m_type, m_pPixels.get());
+	}
+	if (m_pPixels && this->hasMipmaps()) {
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
 	glBindTexture(GL_TEXTURE_2D, 0);
 	EVE_OGL_CHECK_ERROR;
 }
+
+//=================================================================================================
+void eve::ogl::Texture::oglRelease(void)
+{
+	glDeleteTextures(1, &m_id);
+	m_id = 0;
+	EVE_OGL_CHECK_ERROR;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::Texture::oglStream(GLuint p_buffer, GLint p_internalFormat, GLenum p_format, GLsizei p_width, GLsizei p_height, GLenum p_type)
+{
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, p_buffer);
+	glBindTexture(GL_TEXTURE_2D, m_id);
+
+	// Pixels pointer is an offset in bound unpack buffer.
+	if (p_width == m_width && p_height == m_height && p_internalFormat == m_internalFormat)
+	{
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, p_width, p_height, p_format, p_type, nullptr);
+	}
 	else
 	{
-		glBindTexture(GL_TEXTURE_2D, m_id);
-		glTexImage2D(GL_TEXTURE_2D, 0, m_internalFormat, m_width, m_height, 0, m_format, m_type, m_pPixels.get());
-		glBindTexture(GL_TEXTURE_2D, 0);
-		EVE_OGL_CHECK_ERROR;
+		glTexImage2D(GL_TEXTURE_2D, 0, p_internalFormat, p_width, p_height, 0, p_format, p_type, nullptr);
+		// Previous mipmaps are invalid, sample level 0 only until delayed generation.
+		if (this->hasMipmaps()) {
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+		}
+		m_internalFormat = p_internalFormat;
+		m_width			 = p_width;
+		m_height		 = p_height;
 	}
+	m_format = p_format;
+	m_type	 = p_type;
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	EVE_OGL_CHECK_ERROR;
+
+	// Host copy no longer matches device content.
+	m_pPixels.reset();
 }
 
 //=================================================================================================
-void eve::ogl::Texture::oglRelease(void)
+void eve::ogl::Texture::oglGenerateMipmaps(void)
 {
-	glDeleteTextures(1, &m_id);
-	m_id = 0;
+	glBindTexture(GL_TEXTURE_2D, m_id);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+	glBindTexture(GL_TEXTURE_2D, 0);
 	EVE_OGL_CHECK_ERROR;
 }
 
 
 
+//=================================================================================================
+void eve::ogl::Texture::stream(const eve::ogl::FormatTex & p_format)
+{
+	EVE_ASSERT(p_format.pixels.get());
+
+	// Rows are read tightly packed from slot, default unpack alignment requires 4 bytes aligned rows.
+	const size_t	 texel = eve::ogl::Texture::get_texel_size(p_format.format, p_format.type);
+	const GLsizeiptr pitch = static_cast<GLsizeiptr>(p_format.width) * static_cast<GLsizeiptr>(texel);
+	EVE_ASSERT(texel != 0);
+
+	if (texel != 0 && (pitch % 4) == 0)
+	{
+		const GLsizeiptr size = pitch * static_cast<GLsizeiptr>(p_format.height);
+
+		void *	data = nullptr;
+		int32_t slot = this->acquireStream(size, &data);
+		if (slot >= 0)
+		{
+			eve::mem::memcpy(data, p_format.pixels.get(), size);
+			this->submitStream(slot, p_format);
+			return;
+		}
+	}
+
+	eve::ogl::FormatTex format(p_format);
+	this->updateAttributes(&format);
+}
+
+//=================================================================================================
+int32_t eve::ogl::Texture::acquireStream(GLsizeiptr p_size, void ** p_ppData)
+{
+	eve::ogl::PboPool * pool = m_pRenderer->getPboPool();
+	return pool ? pool->acquire(p_size, p_ppData) : -1;
+}
+
+//=================================================================================================
+void eve::ogl::Texture::submitStream(int32_t p_slot, const eve::ogl::FormatTex & p_format)
+{
+	EVE_ASSERT(eve::ogl::Texture::get_texel_size(p_format.format, p_format.type) != 0);
+	m_pRenderer->getPboPool()->submit(p_slot, this, p_format);
+}
+
+//=================================================================================================
+void eve::ogl::Texture::cancelStream(int32_t p_slot)
+{
+	m_pRenderer->getPboPool()->cancel(p_slot);
+}
+
+
+
 //=================================================================================================
 void eve::ogl::Texture::bind(GLenum p_index)
 {
-	glActiveTexture(GL_TEXTURE0 + p_index);
-	glBindTexture(GL_TEXTURE_2D, m_id);
+	EveStateGL->bindTexture(p_index, m_id);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Texture::bindDiffuse(void)
 {
-	glActiveTexture(GL_TEXTURE0 + EVE_OGL_SAMPLER_DIFFUSE);
-	glBindTexture(GL_TEXTURE_2D, m_id);
+	EveStateGL->bindTexture(EVE_OGL_SAMPLER_DIFFUSE, m_id);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Texture::bindNormal(void)
 {
-	glActiveTexture(GL_TEXTURE0 + EVE_OGL_SAMPLER_NORMAL);
-	glBindTexture(GL_TEXTURE_2D, m_id);
+	EveStateGL->bindTexture(EVE_OGL_SAMPLER_NORMAL, m_id);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Texture::bindEmissive(void)
 {
-	glActiveTexture(GL_TEXTURE0 + EVE_OGL_SAMPLER_EMISSIVE);
-	glBindTexture(GL_TEXTURE_2D, m_id);
+	EveStateGL->bindTexture(EVE_OGL_SAMPLER_EMISSIVE, m_id);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Texture::bindOpacity(void)
 {
-	glActiveTexture(GL_TEXTURE0 + EVE_OGL_SAMPLER_OPACITY);
-	glBindTexture(GL_TEXTURE_2D, m_id);
+	EveStateGL->bindTexture(EVE_OGL_SAMPLER_OPACITY, m_id);
 	EVE_OGL_CHECK_ERROR;
 }
 
@@ -241,40 +343,35 @@ void eve::ogl::Texture::bindOpacity(void)
 //=================================================================================================
 void eve::ogl::Texture::unbind(GLenum p_index)
 {
-	glActiveTexture(GL_TEXTURE0 + p_index);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	EveStateGL->bindTexture(p_index, 0);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Texture::unbind_diffuse(void)
 {
-	glActiveTexture(GL_TEXTURE0 + EVE_OGL_SAMPLER_DIFFUSE);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	EveStateGL->bindTexture(EVE_OGL_SAMPLER_DIFFUSE, 0);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Texture::unbind_normal(void)
 {
-	glActiveTexture(GL_TEXTURE0 + EVE_OGL_SAMPLER_NORMAL);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	EveStateGL->bindTexture(EVE_OGL_SAMPLER_NORMAL, 0);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Texture::unbind_emissive(void)
 {
-	glActiveTexture(GL_TEXTURE0 + EVE_OGL_SAMPLER_EMISSIVE);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	EveStateGL->bindTexture(EVE_OGL_SAMPLER_EMISSIVE, 0);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Texture::unbind_opacity(void)
 {
-	glActiveTexture(GL_TEXTURE0 + EVE_OGL_SAMPLER_OPACITY);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	EveStateGL->bindTexture(EVE_OGL_SAMPLER_OPACITY, 0);
 	EVE_OGL_CHECK_ERROR;
 }
 
@@ -297,3 +394,38 @@ void eve::ogl::Texture::setPixels(const std::shared_ptr<GLvoid> && p_pPixels)
 
 	this->requestOglUpdate();
 }
+
+
+
+//=================================================================================================
+size_t eve::ogl::Texture::get_texel_size(GLenum p_format, GLenum p_type)
+{
+	size_t components = 0;
+	switch (p_format)
+	{
+	case GL_RED:
+	case GL_ALPHA:
+	case GL_LUMINANCE:
+	case GL_DEPTH_COMPONENT:	components = 1; break;
+	case GL_RG:
+	case GL_LUMINANCE_ALPHA:	components = 2; break;
+	case GL_RGB:
+	case GL_BGR:				components = 3; break;
+	case GL_RGBA:
+	case GL_BGRA:				components = 4; break;
+	default:					return 0;
+	}
+
+	switch (p_type)
+	{
+	case GL_BYTE:
+	case GL_UNSIGNED_BYTE:		return components;
+	case GL_SHORT:
+	case GL_UNSIGNED_SHORT:
+	case GL_HALF_FLOAT:			return components * 2;
+	case GL_INT:
+	case GL_UNSIGNED_INT:
+	case GL_FLOAT:				return components * 4;
+	default:					return 0;
+	}
+}
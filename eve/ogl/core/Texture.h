@@ -102,6 +102,7 @@ namespace eve
 
 			friend class eve::ogl::Renderer;
 			friend class eve::ogl::Object;
+			friend class eve::ogl::PboPool;
 
 			//////////////////////////////////////
 			//				DATA				//
@@ -121,6 +122,7 @@ namespace eve
 			GLint						m_wrap;					//!< Specifies texture wrap mode.
 
 			bool						m_bSubUpdate;			//!< Specifies whether sub update is required.
+			uint32_t					m_numStreaming;			//!< Specifies PBO pool uploads in progress amount, only used in render thread.
 
 
 			//////////////////////////////////////
@@ -162,6 +164,29 @@ namespace eve
 			virtual void oglRelease(void);
 
 
+		private:
+			/** \brief Upload texture content from pixel unpack buffer \a p_buffer (PBO pool slot), storage is reallocated if size or format changed. */
+			void oglStream(GLuint p_buffer, GLint p_internalFormat, GLenum p_format, GLsizei p_width, GLsizei p_height, GLenum p_type);
+			/** \brief Generate mipmaps chain from level 0. */
+			void oglGenerateMipmaps(void);
+
+
+		public:
+			/** 
+			* \brief Stream new texture content \a p_format through renderer PBO pool (thread safe).
+			* Pixels are copied into a pool slot and uploaded by render thread within queues budget, mipmaps are generated a frame later.
+			* Falls back to updateAttributes() when pool is unavailable or full, slot is too small or pixels layout is not supported.
+			* Workers decoding images should rather decode straight into a slot (see acquireStream(), eve::io::ImageService::stream()).
+			*/
+			void stream(const eve::ogl::FormatTex & p_format);
+			/** \brief Acquire a renderer PBO pool slot of at least \a p_size bytes, write its mapped address in \a p_ppData. Returns slot index or -1 if none is available (thread safe). */
+			int32_t acquireStream(GLsizeiptr p_size, void ** p_ppData);
+			/** \brief Submit acquired slot \a p_slot written pixels as new content described by \a p_format (pixels member unused) (thread safe). */
+			void submitStream(int32_t p_slot, const eve::ogl::FormatTex & p_format);
+			/** \brief Give back acquired slot \a p_slot without submitting it (thread safe). */
+			void cancelStream(int32_t p_slot);
+
+
 		public:
 			/** \brief Bind (activate) texture. */
 			void bind(GLenum p_index);
@@ -198,9 +223,18 @@ namespace eve
 			void setPixels(const std::shared_ptr<GLvoid> && p_pPixels);
 
 
+		public:
+			/** \brief Get tightly packed texel size in bytes of pixels \a p_format and \a p_type, 0 if not supported. */
+			static size_t get_texel_size(GLenum p_format, GLenum p_type);
+
+
 		public:
 			/** \brief Get OpenGL texture unique id. (pure virtual) */
 			virtual const GLuint getId(void) const override;
+			/** \brief Get estimated bytes amount sent to device by init/update. */
+			virtual size_t getOglCost(void) const override;
+			/** \brief Get whether texture filter samples mipmaps. */
+			const bool hasMipmaps(void) const;
 
 
 		public:
@@ -224,6 +258,12 @@ namespace eve
 
 //=================================================================================================
 EVE_FORCE_INLINE const GLuint eve::ogl::Texture::getId(void) const	{ return m_id; }
+EVE_FORCE_INLINE size_t eve::ogl::Texture::getOglCost(void) const	{ return static_cast<size_t>(m_width) * static_cast<size_t>(m_height) * eve::ogl::Texture::get_texel_size(m_format, m_type); }
+EVE_FORCE_INLINE const bool eve::ogl::Texture::hasMipmaps(void) const
+{
+	return m_filter == GL_NEAREST_MIPMAP_NEAREST || m_filter == GL_LINEAR_MIPMAP_NEAREST
+		|| m_filter == GL_NEAREST_MIPMAP_LINEAR  || m_filter == GL_LINEAR_MIPMAP_LINEAR;
+}
 
 
 //=================================================================================================
@@ -32,6 +32,10 @@
 // Main header
 #include "eve/ogl/core/Uniform.h"
 
+#ifndef __EVE_OPENGL_CORE_RENDER_H__
+#include "eve/ogl/core/Renderer.h"
+#endif
+
 
 //=================================================================================================
 eve::ogl::FormatUniform::FormatUniform(void)
@@ -40,6 +44,7 @@ eve::ogl::FormatUniform::FormatUniform(void)
 	// Members init
 	, blockSize(0)
 	, dynamic(false)
+	, streamed(false)
 {}
 
 //=================================================================================================
@@ -53,6 +58,7 @@ eve::ogl::FormatUniform::FormatUniform(const eve::ogl::FormatUniform & p_other)
 	// Members init
 	, blockSize(p_other.blockSize)
 	, dynamic(p_other.dynamic)
+	, streamed(p_other.streamed)
 {}
 
 //=================================================================================================
@@ -62,6 +68,7 @@ const eve::ogl::FormatUniform & eve::ogl::FormatUniform::operator = (const eve::
 	{
 		this->blockSize = p_other.blockSize;
 		this->dynamic	= p_other.dynamic;
+		this->streamed	= p_other.streamed;
 	}
 	return *this;
 }
@@ -89,6 +96,7 @@ eve::ogl::Uniform::Uniform(void)
 	, m_blockSize(0)
 	, m_usage(0)
 	, m_bDynamic(false)
+	, m_bStreamed(false)
 	, m_pData(nullptr)
 	, m_pOglData(nullptr)
 {}
@@ -102,6 +110,7 @@ void eve::ogl::Uniform::setAttributes(eve::ogl::Format * p_format)
 
 	m_blockSize = format->blockSize;
 	m_bDynamic	= format->dynamic;
+	m_bStreamed	= format->streamed;
 
 	EVE_ASSERT(m_blockSize);
 }
@@ -149,6 +158,11 @@ void eve::ogl::Uniform::oglInit(void)
 		gb_init = false;
 	}
 
+	// No ring buffer available, use own buffer object only.
+	if (m_bStreamed && !m_pRenderer->getRingUniform()) {
+		m_bStreamed = false;
+	}
+
 	// Initialize buffer.
 	glGenBuffers(1, &m_id);
 	EVE_OGL_CHECK_ERROR;
@@ -166,17 +180,46 @@ void eve::ogl::Uniform::oglInit(void)
 //=================================================================================================
 void eve::ogl::Uniform::oglUpdate(void)
 {
-	glBindBuffer(GL_UNIFORM_BUFFER, m_id);
+	// Streamed data is written at bind time.
+	if (!m_bStreamed) {
+		this->oglUpload();
+	}
+}
+
+//=================================================================================================
+void eve::ogl::Uniform::oglUpload(void)
+{
+	EveStateGL->bindBuffer(GL_UNIFORM_BUFFER, m_id);
 
 	m_pOglData = reinterpret_cast<float*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, m_blockSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
 	eve::mem::memcpy(m_pOglData, m_pData, m_blockSize);
 
 	glUnmapBuffer(GL_UNIFORM_BUFFER); 
-	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	EveStateGL->bindBuffer(GL_UNIFORM_BUFFER, 0);
 
 	EVE_OGL_CHECK_ERROR;
 }
 
+//=================================================================================================
+void eve::ogl::Uniform::oglBind(GLuint p_binding)
+{
+	if (m_bStreamed)
+	{
+		eve::ogl::RingBuffer * ring = m_pRenderer->getRingUniform();
+		GLintptr offset = ring->push(m_pData, m_blockSize);
+		if (offset >= 0)
+		{
+			EveStateGL->bindBufferRange(GL_UNIFORM_BUFFER, p_binding, ring->getId(), offset, m_blockSize);
+			return;
+		}
+
+		// Ring region full this frame, fall back to own buffer object.
+		this->oglUpload();
+	}
+
+	EveStateGL->bindBufferBase(GL_UNIFORM_BUFFER, p_binding, m_id);
+}
+
 //=================================================================================================
 void eve::ogl::Uniform::oglRelease(void)
 {
@@ -207,7 +250,9 @@ void eve::ogl::Uniform::oglUpdateData(float * p_data)
 void eve::ogl::Uniform::pushData(float * p_data, size_t p_num, size_t p_padding)
 {
 	eve::mem::copy(m_pData + p_padding, p_data, p_num);
-	this->requestOglUpdate();
+	if (!m_bStreamed) {
+		this->requestOglUpdate();
+	}
 }
 
 
@@ -216,21 +261,27 @@ void eve::ogl::Uniform::pushData(float * p_data, size_t p_num, size_t p_padding)
 void eve::ogl::Uniform::pushData(const eve::math::TVec2<float> & p_data, size_t p_padding)
 {
 	eve::mem::copy(m_pData + p_padding, p_data.ptr(), EVE_OGL_PADDING_VEC2);
-	this->requestOglUpdate();
+	if (!m_bStreamed) {
+		this->requestOglUpdate();
+	}
 }
 
 //=================================================================================================
 void eve::ogl::Uniform::pushData(const eve::math::TVec3<float> & p_data, size_t p_padding)
 {
 	eve::mem::copy(m_pData + p_padding, p_data.ptr(), EVE_OGL_PADDING_VEC3);
-	this->requestOglUpdate();
+	if (!m_bStreamed) {
+		this->requestOglUpdate();
+	}
 }
 
 //=================================================================================================
 void eve::ogl::Uniform::pushData(const eve::math::TVec4<float> & p_data, size_t p_padding)
 {
 	eve::mem::copy(m_pData + p_padding, p_data.ptr(), EVE_OGL_PADDING_VEC4);
-	this->requestOglUpdate();
+	if (!m_bStreamed) {
+		this->requestOglUpdate();
+	}
 }
 
 
@@ -239,21 +290,27 @@ void eve::ogl::Uniform::pushData(const eve::math::TVec4<float> & p_data, size_t
 void eve::ogl::Uniform::pushData(const eve::math::TMatrix22<float> & p_data, size_t p_padding)
 {
 	eve::mem::copy(m_pData + p_padding, p_data.ptr(), EVE_OGL_PADDING_MAT2);
-	this->requestOglUpdate();
+	if (!m_bStreamed) {
+		this->requestOglUpdate();
+	}
 }
 
 //=================================================================================================
 void eve::ogl::Uniform::pushData(const eve::math::TMatrix33<float> & p_data, size_t p_padding)
 {
 	eve::mem::copy(m_pData + p_padding, p_data.ptr(), EVE_OGL_PADDING_MAT3);
-	this->requestOglUpdate();
+	if (!m_bStreamed) {
+		this->requestOglUpdate();
+	}
 }
 
 //=================================================================================================
 void eve::ogl::Uniform::pushData(const eve::math::TMatrix44<float> & p_data, size_t p_padding)
 {
 	eve::mem::copy(m_pData + p_padding, p_data.ptr(), EVE_OGL_PADDING_MAT4);
-	this->requestOglUpdate();
+	if (!m_bStreamed) {
+		this->requestOglUpdate();
+	}
 }
 
 
@@ -261,28 +318,28 @@ void eve::ogl::Uniform::pushData(const eve::math::TMatrix44<float> & p_data, siz
 //=================================================================================================
 void eve::ogl::Uniform::bind(GLuint p_binding)
 {
-	glBindBufferBase(GL_UNIFORM_BUFFER, p_binding, m_id);
+	this->oglBind(p_binding);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Uniform::bindCamera(void)
 {
-	glBindBufferBase(GL_UNIFORM_BUFFER, EVE_OGL_TRANSFORM_CAMERA, m_id);
+	this->oglBind(EVE_OGL_TRANSFORM_CAMERA);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Uniform::bindModel(void)
 {
-	glBindBufferBase(GL_UNIFORM_BUFFER, EVE_OGL_TRANSFORM_MODEL, m_id);
+	this->oglBind(EVE_OGL_TRANSFORM_MODEL);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Uniform::bindSkeleton(void)
 {
-	glBindBufferBase(GL_UNIFORM_BUFFER, EVE_OGL_TRANSFORM_SKELETON, m_id);
+	this->oglBind(EVE_OGL_TRANSFORM_SKELETON);
 	EVE_OGL_CHECK_ERROR;
 }
 
@@ -291,27 +348,27 @@ void eve::ogl::Uniform::bindSkeleton(void)
 //=================================================================================================
 void eve::ogl::Uniform::unbind(GLuint p_binding)
 {
-	glBindBufferBase(GL_UNIFORM_BUFFER, p_binding, 0);
+	EveStateGL->bindBufferBase(GL_UNIFORM_BUFFER, p_binding, 0);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Uniform::unbind_camera(void)
 {
-	glBindBufferBase(GL_UNIFORM_BUFFER, EVE_OGL_TRANSFORM_CAMERA, 0);
+	EveStateGL->bindBufferBase(GL_UNIFORM_BUFFER, EVE_OGL_TRANSFORM_CAMERA, 0);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Uniform::unbind_model(void)
 {
-	glBindBufferBase(GL_UNIFORM_BUFFER, EVE_OGL_TRANSFORM_MODEL, 0);
+	EveStateGL->bindBufferBase(GL_UNIFORM_BUFFER, EVE_OGL_TRANSFORM_MODEL, 0);
 	EVE_OGL_CHECK_ERROR;
 }
 
 //=================================================================================================
 void eve::ogl::Uniform::unbind_skeleton(void)
 {
-	glBindBufferBase(GL_UNIFORM_BUFFER, EVE_OGL_TRANSFORM_SKELETON, 0);
+	EveStateGL->bindBufferBase(GL_UNIFORM_BUFFER, EVE_OGL_TRANSFORM_SKELETON, 0);
 	EVE_OGL_CHECK_ERROR;
 }
@@ -64,6 +64,7 @@ namespace eve
 		public:
 			GLint					blockSize;			//!< Specifies uniform block size.
 			bool					dynamic;			//!< Specifies whether the buffer use dynamic draw (per draw call update).
+			bool					streamed;			//!< Specifies whether data is streamed through renderer ring buffer at bind time (no per update map/unmap).
 
 		public:
 			/** \brief Class constructor. */
@@ -103,6 +104,7 @@ namespace eve
 			GLint						m_blockSize;			//!< Specifies uniform block size.
 			GLenum						m_usage;				//!< Specifies whether the buffer use GL_STATIC_DRAW or GL_DYNAMIC_DRAW.
 			bool						m_bDynamic;				//!< Specifies whether the buffer use dynamic draw (per draw call update).
+			bool						m_bStreamed;			//!< Specifies whether data is streamed through renderer ring buffer at bind time.
 
 			float *						m_pData;				//!< Specifies host data to send to buffer.
 			float *						m_pOglData;				//!< Specifies device buffer data address.
@@ -170,6 +172,12 @@ namespace eve
 			/** \brief Deallocate and release OpenGL components. */
 			virtual void oglRelease(void);
 
+		private:
+			/** \brief Copy host data to own buffer object. */
+			void oglUpload(void);
+			/** \brief Bind to \a p_binding point, streamed data is written to renderer ring buffer and bound as range. */
+			void oglBind(GLuint p_binding);
+
 
 		public:
 			/** \brief Set buffer data immediately (needs active OpenGL context). */
@@ -245,6 +253,8 @@ namespace eve
 		public:
 			/** \brief Get OpenGL texture unique id. (pure virtual) */
 			virtual const GLuint getId(void) const override;
+			/** \brief Get estimated bytes amount sent to device by init/update. */
+			virtual size_t getOglCost(void) const override;
 			
 		}; // class Fbo
 
@@ -357,5 +367,6 @@ EVE_FORCE_INLINE const int32_t eve::ogl::Uniform::get_uniform_buffer_offset_alig
 
 //=================================================================================================
 EVE_FORCE_INLINE const GLuint eve::ogl::Uniform::getId(void) const	{ return m_id; }
+EVE_FORCE_INLINE size_t eve::ogl::Uniform::getOglCost(void) const	{ return static_cast<size_t>(m_blockSize); }
 
 #endif // __EVE_OPENGL_CORE_UNIFORM_H__
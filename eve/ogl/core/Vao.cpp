@@ -32,6 +32,10 @@
 // Main header
 #include "eve/ogl/core/Vao.h"
 
+#ifndef __EVE_OPENGL_CORE_CONTEXT_H__
+#include "eve/ogl/core/win32/Context.h"
+#endif
+
 
 //=================================================================================================
 eve::ogl::FormatVao::FormatVao(void)
@@ -109,6 +113,9 @@ eve::ogl::Vao::Vao(void)
 	, m_verticesStride(0)
 	, m_verticesSize(0)
 	, m_indicesSize(0)
+	, m_bInstanced(false)
+	, m_instanceBuffer(0)
+	, m_instanceOffset(0)
 {}
 
 
@@ -159,6 +166,9 @@ void eve::ogl::Vao::release(void)
 //=================================================================================================
 void eve::ogl::Vao::oglInit(void)
 {
+	// Draws leave their VAO bound, element buffer binding must not alter it.
+	EveStateGL->bindVertexArray(0);
+
 	glGenBuffers(1, &m_elementBufferId);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementBufferId);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indicesSize, m_pIndices.get(), GL_STATIC_DRAW);
@@ -176,6 +186,8 @@ void eve::ogl::Vao::oglInit(void)
 	glGenVertexArrays(1, &m_id);
 	glBindVertexArray(m_id);
 	glBindBuffer(GL_ARRAY_BUFFER, m_arrayBufferId);
+	// Element buffer is part of VAO state, draw only binds VAO.
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementBufferId);
 
 	glVertexAttribPointer(EVE_OGL_ATTRIBUTE_POSITION, m_perVertexNumPosition, GL_FLOAT, GL_FALSE, m_verticesStride, EVE_OGL_BUFFER_OFFSET(m_offsetPosition));
 	glEnableVertexAttribArray(EVE_OGL_ATTRIBUTE_POSITION);
@@ -188,8 +200,9 @@ void eve::ogl::Vao::oglInit(void)
 		glEnableVertexAttribArray(EVE_OGL_ATTRIBUTE_NORMAL);
 	}
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	EVE_OGL_CHECK_ERROR;
 
 // 	// Vertex attrib binding -> to bench
@@ -221,6 +234,8 @@ void eve::ogl::Vao::oglInit(void)
 //=================================================================================================
 void eve::ogl::Vao::oglUpdate(void)
 {
+	EveStateGL->bindVertexArray(0);
+
 	if (m_bUpdateVertices)
 	{
 		glBindBuffer(GL_ARRAY_BUFFER, m_arrayBufferId);
@@ -253,6 +268,10 @@ void eve::ogl::Vao::oglUpdate(void)
 //=================================================================================================
 void eve::ogl::Vao::oglRelease(void)
 {
+	m_bInstanced	 = false;
+	m_instanceBuffer = 0;
+	m_instanceOffset = 0;
+
 	glDeleteVertexArrays(1, &m_id);
 	EVE_OGL_CHECK_ERROR;
 
@@ -263,16 +282,31 @@ void eve::ogl::Vao::oglRelease(void)
 
 
 
+//=================================================================================================
+void eve::ogl::Vao::oglReleaseStorage(void)
+{
+	if (m_id == 0) {
+		return;
+	}
+
+	// Deleting bound VAO would leave state cache shadow stale.
+	EveStateGL->bindVertexArray(0);
+	this->oglRelease();
+
+	m_id			  = 0;
+	m_arrayBufferId	  = 0;
+	m_elementBufferId = 0;
+}
+
+
+
 //=================================================================================================
 void eve::ogl::Vao::draw(void)
 {
-	glBindVertexArray(m_id);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementBufferId);
+	// VAO stays bound, next draw of the same VAO skips binding.
+	EveStateGL->bindVertexArray(m_id);
 
 	glDrawElementsInstancedBaseVertex(GL_TRIANGLES, m_numIndices, GL_UNSIGNED_INT, NULL, 1, 0);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
 	EVE_OGL_CHECK_ERROR;
 
 
@@ -286,6 +320,93 @@ void eve::ogl::Vao::draw(void)
 // 	EVE_OGL_CHECK_ERROR;
 }
 
+//=================================================================================================
+void eve::ogl::Vao::drawInstanced(GLsizei p_numInstances, GLuint p_baseInstance)
+{
+	EveStateGL->bindVertexArray(m_id);
+
+	glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, m_numIndices, GL_UNSIGNED_INT, NULL, p_numInstances, 0, p_baseInstance);
+	EVE_OGL_CHECK_ERROR;
+}
+
+//=================================================================================================
+void eve::ogl::Vao::drawCommand(const eve::ogl::DrawElementsCommand & p_command)
+{
+	EveStateGL->bindVertexArray(m_id);
+
+	glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES
+												, p_command.count
+												, GL_UNSIGNED_INT
+												, EVE_OGL_BUFFER_OFFSET(p_command.firstIndex * sizeof(GLuint))
+												, p_command.instanceCount
+												, p_command.baseVertex
+												, p_command.baseInstance);
+	EVE_OGL_CHECK_ERROR;
+}
+
+//=================================================================================================
+void eve::ogl::Vao::drawIndirect(GLintptr p_offset, GLsizei p_numCommands)
+{
+	EveStateGL->bindVertexArray(m_id);
+
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, EVE_OGL_BUFFER_OFFSET(p_offset), p_numCommands, 0);
+	EVE_OGL_CHECK_ERROR;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::Vao::bindInstances(GLuint p_buffer, GLintptr p_offset)
+{
+	EveStateGL->bindVertexArray(m_id);
+
+	// Per instance format is VAO state, set once.
+	if (!m_bInstanced)
+	{
+		for (GLuint c = 0; c < 4; c++)
+		{
+			glVertexAttribFormat(EVE_OGL_ATTRIBUTE_INSTANCE + c, 4, GL_FLOAT, GL_FALSE, c * 4 * sizeof(float));
+			glVertexAttribBinding(EVE_OGL_ATTRIBUTE_INSTANCE + c, EVE_OGL_BINDING_INSTANCE);
+			glEnableVertexAttribArray(EVE_OGL_ATTRIBUTE_INSTANCE + c);
+		}
+		glVertexBindingDivisor(EVE_OGL_BINDING_INSTANCE, 1);
+
+		m_bInstanced	 = true;
+		m_instanceBuffer = 0;
+	}
+
+	if (p_buffer != m_instanceBuffer || p_offset != m_instanceOffset)
+	{
+		glBindVertexBuffer(EVE_OGL_BINDING_INSTANCE, p_buffer, p_offset, 16 * sizeof(float));
+		m_instanceBuffer = p_buffer;
+		m_instanceOffset = p_offset;
+	}
+	EVE_OGL_CHECK_ERROR;
+}
+
+//=================================================================================================
+void eve::ogl::Vao::unbindInstances(void)
+{
+	EveStateGL->bindVertexArray(m_id);
+
+	if (m_bInstanced)
+	{
+		for (GLuint c = 0; c < 4; c++) {
+			glDisableVertexAttribArray(EVE_OGL_ATTRIBUTE_INSTANCE + c);
+		}
+		m_bInstanced = false;
+		EVE_OGL_CHECK_ERROR;
+	}
+}
+
+//=================================================================================================
+void eve::ogl::Vao::set_instance(const float * p_matrix)
+{
+	for (GLuint c = 0; c < 4; c++) {
+		glVertexAttrib4fv(EVE_OGL_ATTRIBUTE_INSTANCE + c, p_matrix + c * 4);
+	}
+}
+
 
 
 //=================================================================================================
@@ -42,6 +42,20 @@ namespace eve
 {
 	namespace ogl
 	{
+		/**
+		* \struct eve::ogl::DrawElementsCommand
+		* \brief Indexed indirect draw command, memory layout matches OpenGL DrawElementsIndirectCommand.
+		*/
+		struct DrawElementsCommand
+		{
+			GLuint						count;						//!< Indices amount.
+			GLuint						instanceCount;				//!< Instances amount.
+			GLuint						firstIndex;					//!< First index in element buffer.
+			GLint						baseVertex;					//!< Value added to each index.
+			GLuint						baseInstance;				//!< First instance attributes element.
+		};
+
+
 		/**
 		* \class eve::ogl::FormatVao
 		*
@@ -128,6 +142,11 @@ namespace eve
 
 			GLsizeiptr					m_indicesSize;				//<! Specifies indices array size in memory.
 
+		private:
+			bool						m_bInstanced;				//!< Specifies whether per instance matrix arrays are enabled in VAO state.
+			GLuint						m_instanceBuffer;			//!< Specifies buffer currently sourcing per instance matrices.
+			GLintptr					m_instanceOffset;			//!< Specifies per instance matrices offset in m_instanceBuffer.
+
 
 			//////////////////////////////////////
 			//				METHOD				//
@@ -168,6 +187,29 @@ namespace eve
 		public:
 			/** \brief Draw VAO content. */
 			void draw(void);
+			/** \brief Draw \a p_numInstances instances of VAO content, first instance reads matrix \a p_baseInstance of bound instance buffer. */
+			void drawInstanced(GLsizei p_numInstances, GLuint p_baseInstance);
+			/** \brief Draw sub range described by \a p_command. */
+			void drawCommand(const eve::ogl::DrawElementsCommand & p_command);
+			/** \brief Draw \a p_numCommands commands read from bound GL_DRAW_INDIRECT_BUFFER at \a p_offset (ARB_multi_draw_indirect). */
+			void drawIndirect(GLintptr p_offset, GLsizei p_numCommands);
+
+
+		public:
+			/** \brief Delete OpenGL buffers and vertex array keeping CPU data, once geometry is drawn from a merged VAO (render thread, context current). */
+			void oglReleaseStorage(void);
+
+
+		public:
+			/** 
+			* \brief Bind VAO and source per instance world matrices (EVE_OGL_ATTRIBUTE_INSTANCE) from \a p_buffer at \a p_offset.
+			* Matrices are tightly packed column major 4x4 floats, requires ARB_vertex_attrib_binding.
+			*/
+			void bindInstances(GLuint p_buffer, GLintptr p_offset);
+			/** \brief Bind VAO and disable per instance arrays, matrix is then read from current attribute value (see set_instance()). */
+			void unbindInstances(void);
+			/** \brief Set current per instance matrix attribute value, used by draws with per instance arrays disabled. */
+			static void set_instance(const float * p_matrix);
 
 
 		public:
@@ -184,6 +226,8 @@ namespace eve
 		public:
 			/** \brief Get OpenGL texture unique id. (pure virtual) */
 			virtual const GLuint getId(void) const override;
+			/** \brief Get estimated bytes amount sent to device by init/update. */
+			virtual size_t getOglCost(void) const override;
 
 
 		public:
@@ -233,6 +277,7 @@ namespace eve
 
 //=================================================================================================
 EVE_FORCE_INLINE const GLuint eve::ogl::Vao::getId(void) const	{ return m_id; }
+EVE_FORCE_INLINE size_t eve::ogl::Vao::getOglCost(void) const	{ return static_cast<size_t>(m_verticesSize + m_indicesSize); }
 
 
 
@@ -36,6 +36,10 @@
 #include "eve/ogl/core/Debug.h"
 #endif
 
+#ifndef __EVE_OPENGL_CORE_DISPATCH_H__
+#include "eve/ogl/core/Dispatch.h"
+#endif
+
 #if defined(EVE_ENABLE_OPENCL)
 #ifndef __EVE_OPENCL_CORE_ENGINE_H__
 #include "eve/ocl/core/Engine.h"
@@ -93,6 +97,7 @@ eve::ogl::Context::Context(void)
 	, m_pixelFormatDecriptor()
 	, m_pixelFormatId(0)
 	, m_pContextOpenCL(nullptr)
+	, m_pStateCache(nullptr)
 {}
 
 
@@ -151,6 +156,9 @@ void eve::ogl::Context::init(void)
 	// Stock DC auto updated format.
 	this->updateFormatVersion();
 
+	// Every sub context shares this rendering context, hence its state.
+	m_pStateCache = EVE_CREATE_PTR(eve::ogl::StateCache);
+
 	// Init shared OpenCL context.
 #if defined(EVE_ENABLE_OPENCL)
 	m_pContextOpenCL = eve::ocl::Engine::create_context_OpenGL(m_hGLRC, m_hDC);
@@ -170,6 +178,8 @@ void eve::ogl::Context::init(void)
 //=================================================================================================
 void eve::ogl::Context::release(void)
 {
+	EVE_RELEASE_PTR_SAFE(m_pStateCache);
+
 	// Rendering context handle.
 	if (m_hGLRC)
 	{
@@ -192,6 +202,8 @@ void eve::ogl::Context::release(void)
 void eve::ogl::Context::init_OpenGL(void)
 {
 	glewInit();
+	// GLEW initialization reloads entry points, recording hooks have to be installed again.
+	eve::ogl::Dispatch::install();
 
 	static bool firstLaunch = true;
 	if (firstLaunch)
@@ -318,6 +330,7 @@ eve::ogl::SubContext::SubContext(HWND p_hWnd)
 	// Members init
 	: m_hDC(0)
 	, m_hWnd(p_hWnd)
+	, m_pWindowHeadless(nullptr)
 {}
 
 
@@ -327,6 +340,13 @@ void eve::ogl::SubContext::init(void)
 {
 	eve::ogl::Context::lock();
 
+	// Headless context, hidden window only provides a DC matching master pixel format.
+	if (!m_hWnd)
+	{
+		m_pWindowHeadless = eve::sys::Window::create_ptr(0, 0, 1, 1, eve::sys::WindowType_Output);
+		m_hWnd			  = m_pWindowHeadless->getHandle();
+	}
+
 	// Get DC from window handle.
 	m_hDC = ::GetDC(m_hWnd);
 	if (m_hDC == 0)
@@ -372,6 +392,7 @@ void eve::ogl::SubContext::release(void)
 		m_hDC	= 0;
 		m_hWnd	= 0;
 	}
+	EVE_RELEASE_PTR_SAFE(m_pWindowHeadless);
 
 	eve::ogl::Context::unlock();
 }
@@ -437,8 +458,13 @@ bool eve::ogl::SubContext::doneCurrent(void)
 //=================================================================================================
 void eve::ogl::SubContext::swapBuffers(void)
 {
+	// Nothing is presented, submit commands only.
+	if (m_pWindowHeadless)
+	{
+		glFlush();
+	}
 	// Multiple rendering buffers.
-	if (eve::ogl::Context::get_pixel_format().doubleBuffer())
+	else if (eve::ogl::Context::get_pixel_format().doubleBuffer())
 	{
 		if (!eve::ogl::Context::get_pixel_format().plane())
 		{
@@ -464,3 +490,104 @@ void eve::ogl::SubContext::swapBuffers(void)
 		glFinish();
 	}
 }
+
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+eve::ogl::SharedContext * eve::ogl::SharedContext::create_ptr(void)
+{
+	eve::ogl::SharedContext * ptr = new eve::ogl::SharedContext();
+	ptr->init();
+	return ptr;
+}
+
+
+
+//=================================================================================================
+eve::ogl::SharedContext::SharedContext(void)
+	// Members init
+	: m_hGLRC(0)
+	, m_hDC(0)
+	, m_pWindow(nullptr)
+{}
+
+
+
+//=================================================================================================
+void eve::ogl::SharedContext::init(void)
+{
+	m_pWindow = eve::sys::Window::create_ptr(0, 0, 1, 1, eve::sys::WindowType_Output);
+
+	m_hDC = ::GetDC(m_pWindow->getHandle());
+	if (m_hDC == 0)
+	{
+		EVE_LOG_ERROR("Paint device cannot be null. GetDC() failed %s", eve::mess::get_error_msg().c_str());
+		EVE_ASSERT_FAILURE;
+	}
+	if (::SetPixelFormat(m_hDC, eve::ogl::Context::get_pixel_format_ID(), &eve::ogl::Context::get_pixel_format_descriptor()) == 0)
+	{
+		EVE_LOG_ERROR("Unable to link pixel format to DC, SetPixelFormat() failed %s", eve::mess::get_error_msg().c_str());
+		EVE_ASSERT_FAILURE;
+	}
+
+	m_hGLRC = ::wglCreateContext(m_hDC);
+	if (m_hGLRC == 0)
+	{
+		EVE_LOG_ERROR("Unable to create rendering context, wglCreateContext() failed %s", eve::mess::get_error_msg().c_str());
+		EVE_ASSERT_FAILURE;
+	}
+
+	// Sharing requires master context not to be current anywhere and new context to hold no object yet.
+	eve::ogl::Context::lock();
+	if (::wglShareLists(eve::ogl::Context::get_handle(), m_hGLRC) == FALSE)
+	{
+		EVE_LOG_ERROR("Unable to share rendering context, wglShareLists() failed %s", eve::mess::get_error_msg().c_str());
+		EVE_ASSERT_FAILURE;
+	}
+	eve::ogl::Context::unlock();
+}
+
+//=================================================================================================
+void eve::ogl::SharedContext::release(void)
+{
+	if (m_hGLRC)
+	{
+		::wglDeleteContext(m_hGLRC);
+		m_hGLRC = 0;
+	}
+	if (m_hDC)
+	{
+		::ReleaseDC(m_pWindow->getHandle(), m_hDC);
+		m_hDC = 0;
+	}
+	EVE_RELEASE_PTR_SAFE(m_pWindow);
+}
+
+
+
+//=================================================================================================
+bool eve::ogl::SharedContext::makeCurrent(void)
+{
+	// GLEW entry points are process wide (same pixel format and driver), no initialization required.
+	if (::wglMakeCurrent(m_hDC, m_hGLRC) == FALSE)
+	{
+		EVE_LOG_ERROR("Unable to attach context, wglMakeCurrent() failed %s", eve::mess::get_error_msg().c_str());
+		EVE_ASSERT_FAILURE;
+		return false;
+	}
+	return true;
+}
+
+//=================================================================================================
+bool eve::ogl::SharedContext::doneCurrent(void)
+{
+	if (::wglMakeCurrent(0, 0) == FALSE)
+	{
+		EVE_LOG_ERROR("Unable to detach context, wglMakeCurrent(0, 0) failed %s", eve::mess::get_error_msg().c_str());
+		EVE_ASSERT_FAILURE;
+		return false;
+	}
+	return true;
+}
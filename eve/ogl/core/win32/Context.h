@@ -49,8 +49,13 @@
 #include "eve/ogl/core/win32/PixelFormat.h"
 #endif
 
+#ifndef __EVE_OPENGL_CORE_STATE_CACHE_H__
+#include "eve/ogl/core/StateCache.h"
+#endif
+
 
 namespace eve { namespace ocl { class Context; } }
+namespace eve { namespace sys { class Window; } }
 namespace eve { namespace thr { class SpinLock; } }
 
 
@@ -87,7 +92,8 @@ namespace eve
 			int32_t							m_pixelFormatId;		//!< Pixel format ID.
 
 		private:
-			eve::ocl::Context *				m_pContextOpenCL;		//!< OpenCL context (read only).
+			eve::ocl::Context *				m_pContextOpenCL;		//!< OpenCL context (read only, nullptr when selected device has no OpenGL sharing).
+			eve::ogl::StateCache *			m_pStateCache;			//!< Rendering context state shadow.
 
 
 			//////////////////////////////////////
@@ -158,9 +164,68 @@ namespace eve
 			static eve::ogl::Context * get_instance(void);
 			/** \brief Get fence (SpinLock). */
 			static eve::thr::SpinLock * get_fence(void);
+			/** \brief Get rendering context state cache, only used while context is current. */
+			static eve::ogl::StateCache * get_state_cache(void);
 
 		}; // class Context
 
+
+		/**
+		* \class eve::ogl::SharedContext
+		*
+		* \brief OpenGL worker context, owning its rendering context shared with master context (aka eve::ogl::Context).
+		* Objects created by a shared context (programs, buffers, textures) are usable by master context, containers (VAO,
+		* FBO, program pipelines) are not. Shared context is made current on its own thread without locking master context,
+		* so background work (shader compilation, uploads) does not stall rendering.
+		*
+		* \note extends mem::Pointer
+		*/
+		class SharedContext final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			HGLRC								m_hGLRC;					//!< OpenGL rendering context handle.
+			HDC									m_hDC;						//!< Draw context (linked to hidden window) handle.
+			eve::sys::Window *					m_pWindow;					//!< Hidden window providing a DC matching master pixel format.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(SharedContext);
+			EVE_PUBLIC_DESTRUCTOR(SharedContext);
+
+		public:
+			/** \brief Create and return new pointer, MUST be called from thread using the context (hidden window is owned by calling thread). */
+			static eve::ogl::SharedContext * create_ptr(void);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit SharedContext(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Make context current on calling thread. */
+			bool makeCurrent(void);
+			/** \brief Release context activation. */
+			bool doneCurrent(void);
+
+		}; // class SharedContext
+
 	} // namespace ogl
 
 } // namespace eve
@@ -171,6 +236,11 @@ namespace eve
 * \brief Convenience macro to access OpenGL context instance. 
 */
 #define EveContextGL	eve::ogl::Context::get_instance()
+/** 
+* \def EveStateGL
+* \brief Convenience macro to access OpenGL context state cache. 
+*/
+#define EveStateGL		eve::ogl::Context::get_state_cache()
 
 
 //=================================================================================================
@@ -181,6 +251,7 @@ EVE_FORCE_INLINE void eve::ogl::Context::unlock(void)	{ EVE_ASSERT(m_p_fence);	m
 //=================================================================================================
 EVE_FORCE_INLINE eve::ogl::Context *	eve::ogl::Context::get_instance(void)	{ EVE_ASSERT(m_p_instance);		return m_p_instance; }
 EVE_FORCE_INLINE eve::thr::SpinLock *	eve::ogl::Context::get_fence(void)		{ EVE_ASSERT(m_p_fence);		return m_p_fence; }
+EVE_FORCE_INLINE eve::ogl::StateCache *	eve::ogl::Context::get_state_cache(void) { EVE_ASSERT(m_p_instance);	return m_p_instance->m_pStateCache; }
 
 //=================================================================================================
 EVE_FORCE_INLINE const HGLRC			eve::ogl::Context::get_handle(void)		{ EVE_ASSERT(m_p_instance);		return m_p_instance->m_hGLRC; }
@@ -200,6 +271,8 @@ namespace eve
 		* \class eve::ogl::SubContext
 		*
 		* \brief OpenGL window binded context linked to master context (aka eve::ogl::Context).
+		* Created with a null window handle, context is headless: it owns a hidden 1x1 window, is never presented and renders
+		* to framebuffer objects only (offscreen frames, benchmarks, software rasterizer drivers on machines without GPU).
 		*
 		* \note extends mem::Pointer
 		*/
@@ -217,6 +290,7 @@ namespace eve
 		private:
 			HDC									m_hDC;						//!< Draw context (linked to window) handle.
 			HWND								m_hWnd;						//!< Window handle.
+			eve::sys::Window *					m_pWindowHeadless;			//!< Hidden window owned by headless context (nullptr otherwise).
 
 
 			//////////////////////////////////////
@@ -229,7 +303,7 @@ namespace eve
 		public:
 			/**
 			* \brief Create and return new pointer.
-			* \param p_hWnd linked window handle.
+			* \param p_hWnd linked window handle, nullptr creates a headless context.
 			*/
 			static eve::ogl::SubContext * create_ptr(HWND p_hWnd);
 
@@ -267,9 +341,14 @@ namespace eve
 			bool makeCurrent(void);
 			/** \brief Release context activation. */
 			bool doneCurrent(void);
-			/** \brief Terminate OpenGL operations and swap buffers if multiple buffers are in use.	*/
+			/** \brief Terminate OpenGL operations and swap buffers if multiple buffers are in use (flush only when headless). */
 			void swapBuffers(void);
 
+
+		public:
+			/** \brief Get whether context is headless (no presented window). */
+			const bool isHeadless(void) const;
+
 		}; // class SubContext
 
 	} // namespace ogl
@@ -278,5 +357,6 @@ namespace eve
 
 //=================================================================================================
 EVE_FORCE_INLINE const eve::ogl::SubContext * eve::ogl::SubContext::get_current_context(void) { return m_p_context_current; }
+EVE_FORCE_INLINE const bool eve::ogl::SubContext::isHeadless(void) const { return m_pWindowHeadless != nullptr; }
 
 #endif // __EVE_OPENGL_CORE_CONTEXT_H__
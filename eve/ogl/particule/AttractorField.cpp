@@ -0,0 +1,324 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/ogl/particule/AttractorField.h"
+
+
+//=================================================================================================
+eve::ogl::AttractorField * eve::ogl::AttractorField::create_ptr(void)
+{
+	eve::ogl::AttractorField * ptr = new eve::ogl::AttractorField();
+	ptr->init();
+	return ptr;
+}
+
+
+
+//=================================================================================================
+eve::ogl::AttractorField::AttractorField(void)
+	// Inheritance
+	: eve::mem::Pointer()
+
+	// Members init
+	, m_pSources(nullptr)
+	, m_pSorted(nullptr)
+	, m_pCells(nullptr)
+	, m_origin(0.0f, 0.0f, 0.0f, 1.0f)
+	, m_bDirty(true)
+	, m_pPacked(nullptr)
+	, m_bufferId(0)
+	, m_bufferSize(0)
+	, m_cellsOffset(0)
+	, m_alignment(0)
+	, m_bUpload(true)
+{
+	m_dims[0] = m_dims[1] = m_dims[2] = 1;
+	m_dims[3] = 0;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::AttractorField::init(void)
+{
+	m_pSources	= new std::vector<eve::ogl::AttractorSource>();
+	m_pSorted	= new std::vector<eve::ogl::AttractorSource>();
+	m_pCells	= new std::vector<uint32_t>();
+	m_pPacked	= new std::vector<uint8_t>();
+}
+
+//=================================================================================================
+void eve::ogl::AttractorField::release(void)
+{
+	EVE_ASSERT(m_bufferId == 0);
+
+	EVE_RELEASE_PTR_CPP(m_pSources);
+	EVE_RELEASE_PTR_CPP(m_pSorted);
+	EVE_RELEASE_PTR_CPP(m_pCells);
+	EVE_RELEASE_PTR_CPP(m_pPacked);
+}
+
+
+
+//=================================================================================================
+void eve::ogl::AttractorField::clear(void)
+{
+	m_pSources->clear();
+	m_bDirty = true;
+}
+
+//=================================================================================================
+size_t eve::ogl::AttractorField::add(const eve::vec3f & p_position, float p_radius, float p_strength)
+{
+	EVE_ASSERT(p_radius > 0.0f);
+
+	eve::ogl::AttractorSource source;
+	source.position = eve::vec4f(p_position.x, p_position.y, p_position.z, p_radius);
+	source.params	= eve::vec4f(p_strength, 0.0f, 0.0f, 0.0f);
+	m_pSources->push_back(source);
+
+	m_bDirty = true;
+	return m_pSources->size() - 1;
+}
+
+//=================================================================================================
+void eve::ogl::AttractorField::setPosition(size_t p_index, const eve::vec3f & p_position)
+{
+	eve::vec4f & pos = (*m_pSources)[p_index].position;
+	pos.x = p_position.x;
+	pos.y = p_position.y;
+	pos.z = p_position.z;
+	m_bDirty = true;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::AttractorField::build(void)
+{
+	if (!m_bDirty) return;
+	m_bDirty  = false;
+	m_bUpload = true;
+
+	const size_t numSources = m_pSources->size();
+	m_pSorted->resize(numSources);
+
+	if (numSources == 0)
+	{
+		m_origin = eve::vec4f(0.0f, 0.0f, 0.0f, 1.0f);
+		m_dims[0] = m_dims[1] = m_dims[2] = 1;
+		m_dims[3] = 0;
+		m_pCells->assign(2, 0);
+		return;
+	}
+
+	// Sources bounds and largest influence radius.
+	eve::vec3f bmin(FLT_MAX, FLT_MAX, FLT_MAX);
+	eve::vec3f bmax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	float cellSize = 1e-3f;
+	for (const eve::ogl::AttractorSource & src : *m_pSources)
+	{
+		bmin.x = std::min(bmin.x, src.position.x);	bmax.x = std::max(bmax.x, src.position.x);
+		bmin.y = std::min(bmin.y, src.position.y);	bmax.y = std::max(bmax.y, src.position.y);
+		bmin.z = std::min(bmin.z, src.position.z);	bmax.z = std::max(bmax.z, src.position.z);
+		cellSize = std::max(cellSize, src.position.w);
+	}
+
+	// Cells at least as large as any radius so neighbour cells cover every influence sphere.
+	const eve::vec3f extent = bmax - bmin;
+	const float extentMax = std::max(extent.x, std::max(extent.y, extent.z));
+	cellSize = std::max(cellSize, extentMax / static_cast<float>(EVE_ATTRACTOR_FIELD_MAX_DIM - 1));
+
+	m_origin  = eve::vec4f(bmin.x, bmin.y, bmin.z, cellSize);
+	m_dims[0] = std::min(static_cast<uint32_t>(extent.x / cellSize) + 1, uint32_t(EVE_ATTRACTOR_FIELD_MAX_DIM));
+	m_dims[1] = std::min(static_cast<uint32_t>(extent.y / cellSize) + 1, uint32_t(EVE_ATTRACTOR_FIELD_MAX_DIM));
+	m_dims[2] = std::min(static_cast<uint32_t>(extent.z / cellSize) + 1, uint32_t(EVE_ATTRACTOR_FIELD_MAX_DIM));
+	m_dims[3] = static_cast<uint32_t>(numSources);
+
+	const size_t numCells = m_dims[0] * m_dims[1] * m_dims[2];
+	m_pCells->assign(numCells + 1, 0);
+
+	// Counting sort by cell.
+	std::vector<uint32_t> cellOf(numSources);
+	for (size_t i = 0; i < numSources; i++)
+	{
+		const eve::vec4f & pos = (*m_pSources)[i].position;
+		const uint32_t cx = std::min(static_cast<uint32_t>((pos.x - bmin.x) / cellSize), m_dims[0] - 1);
+		const uint32_t cy = std::min(static_cast<uint32_t>((pos.y - bmin.y) / cellSize), m_dims[1] - 1);
+		const uint32_t cz = std::min(static_cast<uint32_t>((pos.z - bmin.z) / cellSize), m_dims[2] - 1);
+		cellOf[i] = (cz * m_dims[1] + cy) * m_dims[0] + cx;
+		(*m_pCells)[cellOf[i] + 1]++;
+	}
+	for (size_t c = 0; c < numCells; c++)
+	{
+		(*m_pCells)[c + 1] += (*m_pCells)[c];
+	}
+	std::vector<uint32_t> head(m_pCells->begin(), m_pCells->end() - 1);
+	for (size_t i = 0; i < numSources; i++)
+	{
+		(*m_pSorted)[head[cellOf[i]]++] = (*m_pSources)[i];
+	}
+}
+
+
+
+//=================================================================================================
+eve::vec3f eve::ogl::AttractorField::contribution(const eve::ogl::AttractorSource & p_source, const eve::vec3f & p_position)
+{
+	const float dx = p_source.position.x - p_position.x;
+	const float dy = p_source.position.y - p_position.y;
+	const float dz = p_source.position.z - p_position.z;
+	const float d2 = dx * dx + dy * dy + dz * dz;
+	const float r  = p_source.position.w;
+
+	// Linear falloff reaching 0 at influence radius, keeps grid cut off seamless.
+	if (d2 >= r * r || d2 <= 1e-8f) {
+		return eve::vec3f::zero();
+	}
+	const float d = std::sqrt(d2);
+	const float k = p_source.params.x * (1.0f - d / r) / d;
+	return eve::vec3f(dx * k, dy * k, dz * k);
+}
+
+//=================================================================================================
+eve::vec3f eve::ogl::AttractorField::acceleration(const eve::vec3f & p_position) const
+{
+	eve::vec3f acc = eve::vec3f::zero();
+	if (m_dims[3] == 0) {
+		return acc;
+	}
+
+	// Clamp before integer conversion, far away particles end with an empty neighbour range.
+	int32_t lo[3], hi[3];
+	const float rel[3] = { p_position.x - m_origin.x, p_position.y - m_origin.y, p_position.z - m_origin.z };
+	for (size_t a = 0; a < 3; a++)
+	{
+		const float f = std::max(-2.0f, std::min(std::floor(rel[a] / m_origin.w), static_cast<float>(m_dims[a]) + 1.0f));
+		const int32_t c = static_cast<int32_t>(f);
+		lo[a] = std::max(c - 1, 0);
+		hi[a] = std::min(c + 1, static_cast<int32_t>(m_dims[a]) - 1);
+	}
+
+	for (int32_t z = lo[2]; z <= hi[2]; z++)
+	{
+		for (int32_t y = lo[1]; y <= hi[1]; y++)
+		{
+			for (int32_t x = lo[0]; x <= hi[0]; x++)
+			{
+				const uint32_t cell = (z * m_dims[1] + y) * m_dims[0] + x;
+				for (uint32_t i = (*m_pCells)[cell]; i < (*m_pCells)[cell + 1]; i++)
+				{
+					acc += contribution((*m_pSorted)[i], p_position);
+				}
+			}
+		}
+	}
+
+	return acc;
+}
+
+//=================================================================================================
+eve::vec3f eve::ogl::AttractorField::accelerationReference(const eve::vec3f & p_position) const
+{
+	eve::vec3f acc = eve::vec3f::zero();
+	for (const eve::ogl::AttractorSource & src : *m_pSources)
+	{
+		acc += contribution(src, p_position);
+	}
+	return acc;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::AttractorField::oglBind(void)
+{
+	this->build();
+
+	if (m_alignment == 0)
+	{
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &m_alignment);
+		m_alignment = std::max(m_alignment, GLint(16));
+	}
+
+	if (m_bUpload || m_bufferId == 0)
+	{
+		m_bUpload = false;
+
+		// Pack header, sorted sources and aligned cells in one block.
+		const size_t headerSize	 = sizeof(eve::vec4f) + sizeof(m_dims);
+		const size_t sourcesSize = m_pSorted->size() * sizeof(eve::ogl::AttractorSource);
+		const size_t cellsSize	 = m_pCells->size() * sizeof(uint32_t);
+		m_cellsOffset = static_cast<GLintptr>((headerSize + sourcesSize + m_alignment - 1) / m_alignment * m_alignment);
+
+		m_pPacked->resize(m_cellsOffset + cellsSize);
+		uint8_t * dst = m_pPacked->data();
+		memcpy(dst, &m_origin.x, sizeof(eve::vec4f));
+		memcpy(dst + sizeof(eve::vec4f), m_dims, sizeof(m_dims));
+		if (sourcesSize > 0) {
+			memcpy(dst + headerSize, m_pSorted->data(), sourcesSize);
+		}
+		memcpy(dst + m_cellsOffset, m_pCells->data(), cellsSize);
+
+		const GLsizeiptr size = static_cast<GLsizeiptr>(m_pPacked->size());
+		if (m_bufferId == 0) {
+			glGenBuffers(1, &m_bufferId);
+		}
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferId);
+		if (size > m_bufferSize)
+		{
+			m_bufferSize = size;
+			glBufferData(GL_SHADER_STORAGE_BUFFER, m_bufferSize, m_pPacked->data(), GL_STREAM_DRAW);
+		}
+		else
+		{
+			// Orphan previous storage, GPU may still read last frame grid.
+			glBufferData(GL_SHADER_STORAGE_BUFFER, m_bufferSize, nullptr, GL_STREAM_DRAW);
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, m_pPacked->data());
+		}
+	}
+
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, EVE_ATTRACTOR_FIELD_BINDING_SOURCES, m_bufferId, 0, m_cellsOffset);
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, EVE_ATTRACTOR_FIELD_BINDING_CELLS, m_bufferId, m_cellsOffset, m_pCells->size() * sizeof(uint32_t));
+}
+
+//=================================================================================================
+void eve::ogl::AttractorField::oglRelease(void)
+{
+	if (m_bufferId != 0)
+	{
+		glDeleteBuffers(1, &m_bufferId);
+		m_bufferId	 = 0;
+		m_bufferSize = 0;
+		m_bUpload	 = true;
+	}
+}
@@ -0,0 +1,205 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_OPENGL_PARTICULE_ATTRACTOR_FIELD_H__
+#define __EVE_OPENGL_PARTICULE_ATTRACTOR_FIELD_H__
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MEMORY_INCLUDES_H__
+#include "eve/mem/Includes.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_EXTERNAL_H__
+#include "eve/ogl/core/External.h"
+#endif
+
+#ifndef __EVE_MATH_CORE_TYPES_H__
+#include "eve/math/core/Types.h"
+#endif
+
+
+/**
+* \def EVE_ATTRACTOR_FIELD_MAX_DIM
+* \brief Grid cells amount limit per axis, cell size grows past it.
+*/
+#define EVE_ATTRACTOR_FIELD_MAX_DIM			64
+
+/**
+* \def EVE_ATTRACTOR_FIELD_BINDING_SOURCES
+* \brief Particule.comp shader storage binding point of grid header and sorted sources.
+*/
+#define EVE_ATTRACTOR_FIELD_BINDING_SOURCES	1
+
+/**
+* \def EVE_ATTRACTOR_FIELD_BINDING_CELLS
+* \brief Particule.comp shader storage binding point of grid cells start offsets.
+*/
+#define EVE_ATTRACTOR_FIELD_BINDING_CELLS	2
+
+
+namespace eve
+{
+	namespace ogl
+	{
+		/**
+		* \struct eve::ogl::AttractorSource
+		* \brief Force source, std430 layout shared with Particule.comp.
+		*/
+		struct AttractorSource
+		{
+			eve::vec4f		position;		//!< XYZ position, W influence radius (force is 0 past it).
+			eve::vec4f		params;			//!< X strength (positive attracts, negative repels), YZW unused.
+		};
+
+
+		/**
+		* \class eve::ogl::AttractorField
+		*
+		* \brief Attractors and repellers field shared by CPU and GPU particles backends.
+		* Sources have a bounded influence radius and are binned in a uniform grid whose cell size is at least the
+		* largest radius, so each particle only visits its own cell and direct neighbours (27 cells) whatever the
+		* sources amount. Grid header, sorted sources and cells offsets are packed in one contiguous block and
+		* uploaded in a single shader storage buffer once per frame.
+		*
+		* \note extends mem::Pointer
+		*/
+		class AttractorField final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			std::vector<eve::ogl::AttractorSource> *	m_pSources;			//!< Sources as added.
+			std::vector<eve::ogl::AttractorSource> *	m_pSorted;			//!< Sources sorted by cell.
+			std::vector<uint32_t> *						m_pCells;			//!< Cells start offsets in sorted sources (cells amount + 1).
+			eve::vec4f									m_origin;			//!< Grid origin XYZ, W cell size.
+			uint32_t									m_dims[4];			//!< Grid cells per axis XYZ, W sources amount.
+			bool										m_bDirty;			//!< Specifies whether grid needs rebuild.
+
+		private:
+			std::vector<uint8_t> *						m_pPacked;			//!< Upload block (header and sources, then aligned cells).
+			GLuint										m_bufferId;			//!< OpenGL shader storage buffer ID.
+			GLsizeiptr									m_bufferSize;		//!< OpenGL buffer allocated size.
+			GLintptr									m_cellsOffset;		//!< Cells offset in upload block.
+			GLint										m_alignment;		//!< Shader storage buffer offset alignment (queried on first upload).
+			bool										m_bUpload;			//!< Specifies whether grid changed since last upload.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(AttractorField);
+			EVE_PUBLIC_DESTRUCTOR(AttractorField);
+
+		public:
+			/** \brief Create, init and return new pointer. */
+			static eve::ogl::AttractorField * create_ptr(void);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit AttractorField(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members, OpenGL buffer MUST have been released with oglRelease(). (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Remove all sources. */
+			void clear(void);
+			/** \brief Add source at \a p_position of influence radius \a p_radius and strength \a p_strength (negative repels), return its index. */
+			size_t add(const eve::vec3f & p_position, float p_radius, float p_strength);
+			/** \brief Move source \a p_index to \a p_position. */
+			void setPosition(size_t p_index, const eve::vec3f & p_position);
+			/** \brief Rebuild grid if sources changed since last build. */
+			void build(void);
+
+
+		public:
+			/** \brief Compute field acceleration at \a p_position (grid MUST be built). */
+			eve::vec3f acceleration(const eve::vec3f & p_position) const;
+			/** \brief Compute field acceleration at \a p_position testing every source (reference path). */
+			eve::vec3f accelerationReference(const eve::vec3f & p_position) const;
+			/** \brief Source \a p_source acceleration contribution at \a p_position. */
+			static eve::vec3f contribution(const eve::ogl::AttractorSource & p_source, const eve::vec3f & p_position);
+
+
+		public:
+			/** \brief Build grid, upload packed block and bind it to Particule.comp binding points (rendering context MUST be current). */
+			void oglBind(void);
+			/** \brief Delete OpenGL buffer (rendering context MUST be current). */
+			void oglRelease(void);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get sources amount. */
+			size_t getNumSources(void) const;
+			/** \brief Get source \a p_index. */
+			const eve::ogl::AttractorSource & getSource(size_t p_index) const;
+			/** \brief Get grid cells amount. */
+			size_t getNumCells(void) const;
+			/** \brief Get grid cell size. */
+			float getCellSize(void) const;
+
+		}; // class AttractorField
+
+	} // namespace ogl
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE size_t								eve::ogl::AttractorField::getNumSources(void) const				{ return m_pSources->size();		}
+EVE_FORCE_INLINE const eve::ogl::AttractorSource &	eve::ogl::AttractorField::getSource(size_t p_index) const		{ return (*m_pSources)[p_index];	}
+EVE_FORCE_INLINE size_t								eve::ogl::AttractorField::getNumCells(void) const				{ return m_pCells->empty() ? 0 : m_pCells->size() - 1; }
+EVE_FORCE_INLINE float								eve::ogl::AttractorField::getCellSize(void) const				{ return m_origin.w;				}
+
+#endif // __EVE_OPENGL_PARTICULE_ATTRACTOR_FIELD_H__
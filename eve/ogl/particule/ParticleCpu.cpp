@@ -0,0 +1,369 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/ogl/particule/ParticleCpu.h"
+
+#ifndef __EVE_OPENGL_PARTICULE_PARTICULE_MANAGER_H__
+#include "eve/ogl/particule/ParticleManager.h"
+#endif
+
+#ifndef __EVE_OPENGL_PARTICULE_ATTRACTOR_FIELD_H__
+#include "eve/ogl/particule/AttractorField.h"
+#endif
+
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#include "eve/thr/TaskPool.h"
+#endif
+
+#ifndef __EVE_TIME_UTILS_H__
+#include "eve/time/Utils.h"
+#endif
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#else
+#include <xmmintrin.h>
+#endif
+
+
+namespace
+{
+#if defined(__AVX__)
+	typedef __m256 simd_t;
+	EVE_FORCE_INLINE simd_t simd_load(const float * p)			{ return _mm256_load_ps(p);		}
+	EVE_FORCE_INLINE void	simd_store(float * p, simd_t v)		{ _mm256_store_ps(p, v);		}
+	EVE_FORCE_INLINE simd_t simd_set(float v)					{ return _mm256_set1_ps(v);		}
+	EVE_FORCE_INLINE simd_t simd_add(simd_t a, simd_t b)		{ return _mm256_add_ps(a, b);	}
+	EVE_FORCE_INLINE simd_t simd_sub(simd_t a, simd_t b)		{ return _mm256_sub_ps(a, b);	}
+	EVE_FORCE_INLINE simd_t simd_mul(simd_t a, simd_t b)		{ return _mm256_mul_ps(a, b);	}
+	EVE_FORCE_INLINE simd_t simd_div(simd_t a, simd_t b)		{ return _mm256_div_ps(a, b);	}
+	EVE_FORCE_INLINE simd_t simd_sqrt(simd_t a)					{ return _mm256_sqrt_ps(a);		}
+#else
+	typedef __m128 simd_t;
+	EVE_FORCE_INLINE simd_t simd_load(const float * p)			{ return _mm_load_ps(p);		}
+	EVE_FORCE_INLINE void	simd_store(float * p, simd_t v)		{ _mm_store_ps(p, v);			}
+	EVE_FORCE_INLINE simd_t simd_set(float v)					{ return _mm_set1_ps(v);		}
+	EVE_FORCE_INLINE simd_t simd_add(simd_t a, simd_t b)		{ return _mm_add_ps(a, b);		}
+	EVE_FORCE_INLINE simd_t simd_sub(simd_t a, simd_t b)		{ return _mm_sub_ps(a, b);		}
+	EVE_FORCE_INLINE simd_t simd_mul(simd_t a, simd_t b)		{ return _mm_mul_ps(a, b);		}
+	EVE_FORCE_INLINE simd_t simd_div(simd_t a, simd_t b)		{ return _mm_div_ps(a, b);		}
+	EVE_FORCE_INLINE simd_t simd_sqrt(simd_t a)					{ return _mm_sqrt_ps(a);		}
+#endif
+
+} // namespace
+
+
+
+//=================================================================================================
+eve::ogl::ParticleCpu * eve::ogl::ParticleCpu::create_ptr(size_t p_numParticles)
+{
+	eve::ogl::ParticleCpu * ptr = new eve::ogl::ParticleCpu(p_numParticles);
+	ptr->init();
+	return ptr;
+}
+
+
+
+//=================================================================================================
+eve::ogl::ParticleCpu::ParticleCpu(size_t p_numParticles)
+	// Inheritance
+	: eve::mem::Pointer()
+
+	// Members init
+	, m_numParticles(p_numParticles)
+	, m_capacity(0)
+	, m_pData(nullptr)
+	, m_pOutput(nullptr)
+	, m_bParallel(true)
+	, m_stepMicro(0)
+	, m_particlesPerSecond(0.0)
+{}
+
+
+
+//=================================================================================================
+void eve::ogl::ParticleCpu::init(void)
+{
+	// Whole AVX lanes whatever the build, padding lanes are simulated but never read back.
+	m_capacity = (m_numParticles + 7) & ~size_t(7);
+
+	m_pData = (float*)eve::mem::align_malloc(32, m_capacity * 6 * sizeof(float));
+	memset(m_pData, 0, m_capacity * 6 * sizeof(float));
+
+	m_pOutput = (eve::ogl::Particle*)eve::mem::align_malloc(32, (m_numParticles > 0 ? m_numParticles : 1) * sizeof(eve::ogl::Particle));
+}
+
+//=================================================================================================
+void eve::ogl::ParticleCpu::release(void)
+{
+	eve::mem::align_free(m_pData);
+	m_pData = nullptr;
+	eve::mem::align_free(m_pOutput);
+	m_pOutput = nullptr;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ParticleCpu::load(const eve::ogl::Particle * p_pParticles)
+{
+	EVE_ASSERT(p_pParticles);
+
+	float * cx = m_pData;
+	float * cy = m_pData + m_capacity;
+	float * cz = m_pData + m_capacity * 2;
+	float * px = m_pData + m_capacity * 3;
+	float * py = m_pData + m_capacity * 4;
+	float * pz = m_pData + m_capacity * 5;
+
+	for (size_t i = 0; i < m_numParticles; i++)
+	{
+		cx[i] = p_pParticles[i].m_currPosition.x;	cy[i] = p_pParticles[i].m_currPosition.y;	cz[i] = p_pParticles[i].m_currPosition.z;
+		px[i] = p_pParticles[i].m_prevPosition.x;	py[i] = p_pParticles[i].m_prevPosition.y;	pz[i] = p_pParticles[i].m_prevPosition.z;
+	}
+	this->write(0, m_numParticles);
+}
+
+//=================================================================================================
+void eve::ogl::ParticleCpu::copy(const eve::ogl::ParticleCpu & p_other)
+{
+	EVE_ASSERT(p_other.m_numParticles == m_numParticles);
+	memcpy(m_pData, p_other.m_pData, m_capacity * 6 * sizeof(float));
+	memcpy(m_pOutput, p_other.m_pOutput, m_numParticles * sizeof(eve::ogl::Particle));
+}
+
+//=================================================================================================
+size_t eve::ogl::ParticleCpu::compare(const eve::ogl::ParticleCpu & p_other) const
+{
+	EVE_ASSERT(p_other.m_numParticles == m_numParticles);
+
+	for (size_t i = 0; i < m_numParticles; i++)
+	{
+		for (size_t a = 0; a < 6; a++)
+		{
+			// Bitwise comparison, NaN lanes compare equal when produced identically.
+			if (memcmp(m_pData + a * m_capacity + i, p_other.m_pData + a * m_capacity + i, sizeof(float)) != 0) {
+				return i;
+			}
+		}
+	}
+	return m_numParticles;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ParticleCpu::step(const eve::vec4f & p_attractor, float p_frameTimeDiff, const eve::ogl::AttractorField * p_pField)
+{
+	const int64_t start		= eve::time::current_time_micro();
+	const size_t numBlocks	= m_capacity / EVE_PARTICLE_CPU_LANES;
+
+	auto task = [&](size_t p_begin, size_t p_end)
+	{
+		const size_t begin = p_begin * EVE_PARTICLE_CPU_LANES;
+		const size_t end   = p_end	 * EVE_PARTICLE_CPU_LANES;
+		this->kernel(p_attractor, p_frameTimeDiff, begin, end);
+		if (p_pField) {
+			this->field(p_pField, p_frameTimeDiff, begin, std::min(end, m_numParticles));
+		}
+		// Interleave while chunk is hot in cache.
+		this->write(begin, std::min(end, m_numParticles));
+	};
+
+	if (m_bParallel) {
+		eve::thr::TaskPool::get_instance()->parallel_for(0, numBlocks, EVE_PARTICLE_CPU_GRAIN / EVE_PARTICLE_CPU_LANES, task);
+	}
+	else {
+		task(0, numBlocks);
+	}
+
+	m_stepMicro			 = eve::time::current_time_micro() - start;
+	m_particlesPerSecond = static_cast<double>(m_numParticles) * 1000000.0 / static_cast<double>(std::max(m_stepMicro, int64_t(1)));
+}
+
+//=================================================================================================
+void eve::ogl::ParticleCpu::stepReference(const eve::vec4f & p_attractor, float p_frameTimeDiff, const eve::ogl::AttractorField * p_pField)
+{
+	const int64_t start = eve::time::current_time_micro();
+
+	this->kernelReference(p_attractor, p_frameTimeDiff, 0, m_numParticles);
+	if (p_pField) {
+		this->field(p_pField, p_frameTimeDiff, 0, m_numParticles);
+	}
+	this->write(0, m_numParticles);
+
+	m_stepMicro			 = eve::time::current_time_micro() - start;
+	m_particlesPerSecond = static_cast<double>(m_numParticles) * 1000000.0 / static_cast<double>(std::max(m_stepMicro, int64_t(1)));
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ParticleCpu::kernel(const eve::vec4f & p_attractor, float p_frameTimeDiff, size_t p_begin, size_t p_end)
+{
+	float * cx = m_pData;
+	float * cy = m_pData + m_capacity;
+	float * cz = m_pData + m_capacity * 2;
+	float * px = m_pData + m_capacity * 3;
+	float * py = m_pData + m_capacity * 4;
+	float * pz = m_pData + m_capacity * 5;
+
+	const simd_t dt		 = simd_set(p_frameTimeDiff);
+	const simd_t curr	 = simd_set(1.99f);
+	const simd_t prev	 = simd_set(0.99f);
+	const bool	 gravity = (p_attractor.w == -1.0f);
+
+	const simd_t attX	 = simd_set(p_attractor.x);
+	const simd_t attY	 = simd_set(p_attractor.y);
+	const simd_t attZ	 = simd_set(p_attractor.z);
+	const simd_t one	 = simd_set(1.0f);
+	const simd_t five	 = simd_set(5.0f);
+
+	simd_t ax = simd_set(0.0f);
+	simd_t ay = simd_set(-4.0f);
+	simd_t az = simd_set(0.0f);
+
+	for (size_t i = p_begin; i < p_end; i += EVE_PARTICLE_CPU_LANES)
+	{
+		simd_t x = simd_load(cx + i);
+		simd_t y = simd_load(cy + i);
+		simd_t z = simd_load(cz + i);
+
+		if (!gravity)
+		{
+			// a = normalize(attPos - currPos - vec4(0, -1, 0, 0)) * 5 * length(currPos.xyz)
+			simd_t dx = simd_sub(attX, x);
+			simd_t dy = simd_add(simd_sub(attY, y), one);
+			simd_t dz = simd_sub(attZ, z);
+
+			simd_t la = simd_sqrt(simd_add(simd_add(simd_mul(dx, dx), simd_mul(dy, dy)), simd_mul(dz, dz)));
+			simd_t lp = simd_sqrt(simd_add(simd_add(simd_mul(x, x), simd_mul(y, y)), simd_mul(z, z)));
+
+			ax = simd_mul(simd_mul(simd_div(dx, la), five), lp);
+			ay = simd_mul(simd_mul(simd_div(dy, la), five), lp);
+			az = simd_mul(simd_mul(simd_div(dz, la), five), lp);
+		}
+
+		// Verlet: next = 1.99 * curr - 0.99 * prev + a * dt
+		simd_store(cx + i, simd_add(simd_sub(simd_mul(curr, x), simd_mul(prev, simd_load(px + i))), simd_mul(ax, dt)));
+		simd_store(cy + i, simd_add(simd_sub(simd_mul(curr, y), simd_mul(prev, simd_load(py + i))), simd_mul(ay, dt)));
+		simd_store(cz + i, simd_add(simd_sub(simd_mul(curr, z), simd_mul(prev, simd_load(pz + i))), simd_mul(az, dt)));
+
+		simd_store(px + i, x);
+		simd_store(py + i, y);
+		simd_store(pz + i, z);
+	}
+}
+
+//=================================================================================================
+void eve::ogl::ParticleCpu::kernelReference(const eve::vec4f & p_attractor, float p_frameTimeDiff, size_t p_begin, size_t p_end)
+{
+	float * cx = m_pData;
+	float * cy = m_pData + m_capacity;
+	float * cz = m_pData + m_capacity * 2;
+	float * px = m_pData + m_capacity * 3;
+	float * py = m_pData + m_capacity * 4;
+	float * pz = m_pData + m_capacity * 5;
+
+	const bool gravity = (p_attractor.w == -1.0f);
+
+	float ax = 0.0f;
+	float ay = -4.0f;
+	float az = 0.0f;
+
+	for (size_t i = p_begin; i < p_end; i++)
+	{
+		const float x = cx[i];
+		const float y = cy[i];
+		const float z = cz[i];
+
+		if (!gravity)
+		{
+			const float dx = p_attractor.x - x;
+			const float dy = (p_attractor.y - y) + 1.0f;
+			const float dz = p_attractor.z - z;
+
+			const float la = std::sqrt((dx * dx + dy * dy) + dz * dz);
+			const float lp = std::sqrt((x * x + y * y) + z * z);
+
+			ax = ((dx / la) * 5.0f) * lp;
+			ay = ((dy / la) * 5.0f) * lp;
+			az = ((dz / la) * 5.0f) * lp;
+		}
+
+		cx[i] = (1.99f * x - 0.99f * px[i]) + ax * p_frameTimeDiff;
+		cy[i] = (1.99f * y - 0.99f * py[i]) + ay * p_frameTimeDiff;
+		cz[i] = (1.99f * z - 0.99f * pz[i]) + az * p_frameTimeDiff;
+
+		px[i] = x;
+		py[i] = y;
+		pz[i] = z;
+	}
+}
+
+//=================================================================================================
+void eve::ogl::ParticleCpu::field(const eve::ogl::AttractorField * p_pField, float p_frameTimeDiff, size_t p_begin, size_t p_end)
+{
+	if (p_pField->getNumSources() == 0) return;
+
+	float * cx = m_pData;
+	float * cy = m_pData + m_capacity;
+	float * cz = m_pData + m_capacity * 2;
+	const float * px = m_pData + m_capacity * 3;
+	const float * py = m_pData + m_capacity * 4;
+	const float * pz = m_pData + m_capacity * 5;
+
+	for (size_t i = p_begin; i < p_end; i++)
+	{
+		const eve::vec3f a = p_pField->acceleration(eve::vec3f(px[i], py[i], pz[i]));
+		cx[i] += a.x * p_frameTimeDiff;
+		cy[i] += a.y * p_frameTimeDiff;
+		cz[i] += a.z * p_frameTimeDiff;
+	}
+}
+
+//=================================================================================================
+void eve::ogl::ParticleCpu::write(size_t p_begin, size_t p_end)
+{
+	const float * cx = m_pData;
+	const float * cy = m_pData + m_capacity;
+	const float * cz = m_pData + m_capacity * 2;
+	const float * px = m_pData + m_capacity * 3;
+	const float * py = m_pData + m_capacity * 4;
+	const float * pz = m_pData + m_capacity * 5;
+
+	for (size_t i = p_begin; i < p_end; i++)
+	{
+		m_pOutput[i].m_currPosition = eve::vec4f(cx[i], cy[i], cz[i], 1.0f);
+		m_pOutput[i].m_prevPosition = eve::vec4f(px[i], py[i], pz[i], 1.0f);
+	}
+}
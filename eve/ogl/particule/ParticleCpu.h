@@ -0,0 +1,213 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_OPENGL_PARTICULE_PARTICLE_CPU_H__
+#define __EVE_OPENGL_PARTICULE_PARTICLE_CPU_H__
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MEMORY_INCLUDES_H__
+#include "eve/mem/Includes.h"
+#endif
+
+#ifndef __EVE_MATH_CORE_TYPES_H__
+#include "eve/math/core/Types.h"
+#endif
+
+
+namespace eve { namespace ogl { struct Particle; } }
+namespace eve { namespace ogl { class AttractorField; } }
+
+
+/**
+* \def EVE_PARTICLE_CPU_LANES
+* \brief SIMD lanes processed per kernel iteration (8 with AVX, 4 with SSE), arrays are padded to a multiple of 8.
+*/
+#if defined(__AVX__)
+#define EVE_PARTICLE_CPU_LANES		8
+#else
+#define EVE_PARTICLE_CPU_LANES		4
+#endif
+
+/**
+* \def EVE_PARTICLE_CPU_GRAIN
+* \brief Particles per thread pool task.
+*/
+#define EVE_PARTICLE_CPU_GRAIN		16384
+
+
+namespace eve
+{
+	namespace ogl
+	{
+		/**
+		* \class eve::ogl::ParticleCpu
+		*
+		* \brief CPU particles simulation, mirrors Particule.comp compute shader.
+		* Current and previous positions are stored as SoA arrays, Verlet integration toward the attractor (or gravity)
+		* runs in SIMD kernels chunked over eve::thr::TaskPool workers. Kernels only use IEEE rounded operations
+		* (no reciprocal estimate, no fused multiply-add) in scalar reference order, so step() and stepReference()
+		* results are bit identical as long as build does not enable floating point contraction.
+		* Positions W component is constant (1.0) and is not simulated.
+		*
+		* \note extends mem::Pointer
+		*/
+		class ParticleCpu final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			size_t							m_numParticles;			//!< Particles amount.
+			size_t							m_capacity;				//!< Allocated particles amount (padded to 8).
+			float *							m_pData;				//!< SoA arrays block: current x/y/z then previous x/y/z.
+			eve::ogl::Particle *			m_pOutput;				//!< Interleaved positions, written by step() for upload.
+
+			bool							m_bParallel;			//!< Specifies whether steps run on thread pool.
+			int64_t							m_stepMicro;			//!< Last step duration in microseconds.
+			double							m_particlesPerSecond;	//!< Last step throughput.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(ParticleCpu);
+			EVE_PUBLIC_DESTRUCTOR(ParticleCpu);
+
+		public:
+			/** \brief Create, init and return new pointer holding \a p_numParticles particles. */
+			static eve::ogl::ParticleCpu * create_ptr(size_t p_numParticles);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit ParticleCpu(size_t p_numParticles);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Load positions from interleaved \a p_pParticles array (m_numParticles items). */
+			void load(const eve::ogl::Particle * p_pParticles);
+			/** \brief Copy positions of \a p_other (same particles amount). */
+			void copy(const eve::ogl::ParticleCpu & p_other);
+			/** \brief Compare positions bit by bit with \a p_other, return index of first differing particle or m_numParticles if identical. */
+			size_t compare(const eve::ogl::ParticleCpu & p_other) const;
+
+
+		public:
+			/**
+			* \brief Run one simulation step, SIMD kernels over thread pool, and write interleaved output.
+			* \param p_attractor attractor position, W set to -1 applies gravity instead (as Particule.comp attPos uniform).
+			* \param p_frameTimeDiff integration time step (as Particule.comp frameTimeDiff uniform).
+			* \param p_pField optional attractors field (built), its acceleration is added to integrated positions.
+			*/
+			void step(const eve::vec4f & p_attractor, float p_frameTimeDiff, const eve::ogl::AttractorField * p_pField = nullptr);
+			/** \brief Run one simulation step with scalar reference kernel on calling thread. */
+			void stepReference(const eve::vec4f & p_attractor, float p_frameTimeDiff, const eve::ogl::AttractorField * p_pField = nullptr);
+
+		private:
+			/** \brief SIMD kernel over [p_begin, p_end[ (multiples of EVE_PARTICLE_CPU_LANES). */
+			void kernel(const eve::vec4f & p_attractor, float p_frameTimeDiff, size_t p_begin, size_t p_end);
+			/** \brief Scalar kernel over [p_begin, p_end[. */
+			void kernelReference(const eve::vec4f & p_attractor, float p_frameTimeDiff, size_t p_begin, size_t p_end);
+			/** \brief Add attractors field acceleration over [p_begin, p_end[ (after kernel, previous arrays hold positions it integrated). */
+			void field(const eve::ogl::AttractorField * p_pField, float p_frameTimeDiff, size_t p_begin, size_t p_end);
+			/** \brief Write interleaved output over [p_begin, p_end[. */
+			void write(size_t p_begin, size_t p_end);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get particles amount. */
+			size_t getNumParticles(void) const;
+			/** \brief Get interleaved positions written by last step() (upload source). */
+			const eve::ogl::Particle * getOutput(void) const;
+			/** \brief Get particle \a p_index current position. */
+			eve::vec4f getPosition(size_t p_index) const;
+			/** \brief Get current positions SoA array of axis \a p_axis (0: X, 1: Y, 2: Z), e.g. to build eve::ogl::ParticleGrid. */
+			const float * getCurrent(size_t p_axis) const;
+
+		public:
+			/** \brief Get last step duration in microseconds. */
+			int64_t getStepMicro(void) const;
+			/** \brief Get last step throughput in particles per second. */
+			double getParticlesPerSecond(void) const;
+
+		public:
+			/** \brief Get whether steps run on thread pool. */
+			bool getParallel(void) const;
+			/** \brief Set whether steps run on thread pool. */
+			void setParallel(bool p_bParallel);
+
+		}; // class ParticleCpu
+
+	} // namespace ogl
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE size_t						eve::ogl::ParticleCpu::getNumParticles(void) const			{ return m_numParticles;		}
+EVE_FORCE_INLINE const eve::ogl::Particle *	eve::ogl::ParticleCpu::getOutput(void) const				{ return m_pOutput;				}
+EVE_FORCE_INLINE const float *				eve::ogl::ParticleCpu::getCurrent(size_t p_axis) const		{ return m_pData + m_capacity * p_axis; }
+EVE_FORCE_INLINE int64_t					eve::ogl::ParticleCpu::getStepMicro(void) const				{ return m_stepMicro;			}
+EVE_FORCE_INLINE double						eve::ogl::ParticleCpu::getParticlesPerSecond(void) const	{ return m_particlesPerSecond;	}
+EVE_FORCE_INLINE bool						eve::ogl::ParticleCpu::getParallel(void) const				{ return m_bParallel;			}
+EVE_FORCE_INLINE void						eve::ogl::ParticleCpu::setParallel(bool p_bParallel)		{ m_bParallel = p_bParallel;	}
+
+//=================================================================================================
+EVE_FORCE_INLINE eve::vec4f eve::ogl::ParticleCpu::getPosition(size_t p_index) const
+{
+	EVE_ASSERT(p_index < m_numParticles);
+	return eve::vec4f(m_pData[p_index], m_pData[m_capacity + p_index], m_pData[m_capacity * 2 + p_index], 1.0f);
+}
+
+#endif // __EVE_OPENGL_PARTICULE_PARTICLE_CPU_H__
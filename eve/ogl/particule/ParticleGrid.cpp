@@ -0,0 +1,246 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/ogl/particule/ParticleGrid.h"
+
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#include "eve/thr/TaskPool.h"
+#endif
+
+#ifndef __EVE_TIME_UTILS_H__
+#include "eve/time/Utils.h"
+#endif
+
+
+//=================================================================================================
+eve::ogl::ParticleGrid * eve::ogl::ParticleGrid::create_ptr(float p_cellSize, uint32_t p_tableSize)
+{
+	eve::ogl::ParticleGrid * ptr = new eve::ogl::ParticleGrid(p_cellSize, p_tableSize);
+	ptr->init();
+	return ptr;
+}
+
+
+
+//=================================================================================================
+eve::ogl::ParticleGrid::ParticleGrid(float p_cellSize, uint32_t p_tableSize)
+	// Inheritance
+	: eve::mem::Pointer()
+
+	// Members init
+	, m_cellSize(p_cellSize)
+	, m_invCellSize(1.0f / p_cellSize)
+	, m_tableSize(1)
+	, m_numParticles(0)
+	, m_capacity(0)
+	, m_pBucket(nullptr)
+	, m_pCursor(nullptr)
+	, m_pStart(nullptr)
+	, m_pIndices(nullptr)
+	, m_pSorted(nullptr)
+	, m_bParallel(true)
+	, m_buildMicro(0)
+{
+	EVE_ASSERT(p_cellSize > 0.0f);
+	while (m_tableSize < p_tableSize) m_tableSize <<= 1;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ParticleGrid::init(void)
+{
+	m_pCursor = new std::atomic<uint32_t>[m_tableSize];
+	m_pStart  = new uint32_t[m_tableSize + 1];
+	memset(m_pStart, 0, (m_tableSize + 1) * sizeof(uint32_t));
+}
+
+//=================================================================================================
+void eve::ogl::ParticleGrid::release(void)
+{
+	delete[] m_pCursor;		m_pCursor  = nullptr;
+	delete[] m_pStart;		m_pStart   = nullptr;
+	delete[] m_pBucket;		m_pBucket  = nullptr;
+	delete[] m_pIndices;	m_pIndices = nullptr;
+
+	eve::mem::align_free(m_pSorted);
+	m_pSorted = nullptr;
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ParticleGrid::reserve(size_t p_numParticles)
+{
+	if (p_numParticles <= m_capacity) return;
+
+	m_capacity = std::max(p_numParticles, m_capacity + m_capacity / 2);
+
+	delete[] m_pBucket;
+	delete[] m_pIndices;
+	eve::mem::align_free(m_pSorted);
+
+	m_pBucket  = new uint32_t[m_capacity];
+	m_pIndices = new uint32_t[m_capacity];
+	m_pSorted  = (float*)eve::mem::align_malloc(16, m_capacity * 3 * sizeof(float));
+}
+
+//=================================================================================================
+void eve::ogl::ParticleGrid::run(size_t p_count, const std::function<void(size_t, size_t)> & p_task) const
+{
+	if (m_bParallel && p_count > EVE_PARTICLE_GRID_GRAIN) {
+		eve::thr::TaskPool::get_instance()->parallel_for(0, p_count, EVE_PARTICLE_GRID_GRAIN, p_task);
+	}
+	else if (p_count > 0) {
+		p_task(0, p_count);
+	}
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ParticleGrid::build(const float * p_pX, const float * p_pY, const float * p_pZ, size_t p_numParticles)
+{
+	EVE_ASSERT(p_numParticles < UINT32_MAX);
+
+	const int64_t start = eve::time::current_time_micro();
+
+	this->reserve(p_numParticles);
+	m_numParticles = p_numParticles;
+
+	// Histogram.
+	this->run(m_tableSize, [&](size_t p_begin, size_t p_end)
+	{
+		for (size_t b = p_begin; b < p_end; b++) m_pCursor[b].store(0, std::memory_order_relaxed);
+	});
+	this->run(m_numParticles, [&](size_t p_begin, size_t p_end)
+	{
+		for (size_t i = p_begin; i < p_end; i++)
+		{
+			m_pBucket[i] = this->bucket(p_pX[i], p_pY[i], p_pZ[i]);
+			m_pCursor[m_pBucket[i]].fetch_add(1, std::memory_order_relaxed);
+		}
+	});
+
+	// Exclusive prefix sum by blocks: blocks totals, serial scan of totals, blocks local scans.
+	const size_t numBlocks = (m_tableSize + EVE_PARTICLE_GRID_GRAIN - 1) / EVE_PARTICLE_GRID_GRAIN;
+	std::vector<uint32_t> blockSum(numBlocks + 1, 0);
+	this->run(numBlocks, [&](size_t p_begin, size_t p_end)
+	{
+		for (size_t k = p_begin; k < p_end; k++)
+		{
+			const size_t last = std::min(size_t(m_tableSize), (k + 1) * EVE_PARTICLE_GRID_GRAIN);
+			uint32_t sum = 0;
+			for (size_t b = k * EVE_PARTICLE_GRID_GRAIN; b < last; b++) sum += m_pCursor[b].load(std::memory_order_relaxed);
+			blockSum[k + 1] = sum;
+		}
+	});
+	for (size_t k = 0; k < numBlocks; k++) blockSum[k + 1] += blockSum[k];
+	this->run(numBlocks, [&](size_t p_begin, size_t p_end)
+	{
+		for (size_t k = p_begin; k < p_end; k++)
+		{
+			const size_t last = std::min(size_t(m_tableSize), (k + 1) * EVE_PARTICLE_GRID_GRAIN);
+			uint32_t offset = blockSum[k];
+			for (size_t b = k * EVE_PARTICLE_GRID_GRAIN; b < last; b++)
+			{
+				const uint32_t count = m_pCursor[b].load(std::memory_order_relaxed);
+				m_pStart[b] = offset;
+				m_pCursor[b].store(offset, std::memory_order_relaxed);
+				offset += count;
+			}
+		}
+	});
+	m_pStart[m_tableSize] = static_cast<uint32_t>(m_numParticles);
+
+	// Scatter, slots order inside a bucket depends on scheduling until buckets are sorted below.
+	this->run(m_numParticles, [&](size_t p_begin, size_t p_end)
+	{
+		for (size_t i = p_begin; i < p_end; i++) {
+			m_pIndices[m_pCursor[m_pBucket[i]].fetch_add(1, std::memory_order_relaxed)] = static_cast<uint32_t>(i);
+		}
+	});
+
+	// Deterministic order, then gather positions in bucket order.
+	this->run(m_tableSize, [&](size_t p_begin, size_t p_end)
+	{
+		for (size_t b = p_begin; b < p_end; b++)
+		{
+			if (m_pStart[b + 1] - m_pStart[b] > 1) {
+				std::sort(m_pIndices + m_pStart[b], m_pIndices + m_pStart[b + 1]);
+			}
+		}
+	});
+	float * sx = m_pSorted;
+	float * sy = m_pSorted + m_capacity;
+	float * sz = m_pSorted + m_capacity * 2;
+	this->run(m_numParticles, [&](size_t p_begin, size_t p_end)
+	{
+		for (size_t i = p_begin; i < p_end; i++)
+		{
+			const uint32_t idx = m_pIndices[i];
+			sx[i] = p_pX[idx];
+			sy[i] = p_pY[idx];
+			sz[i] = p_pZ[idx];
+		}
+	});
+
+	m_buildMicro = eve::time::current_time_micro() - start;
+}
+
+
+
+//=================================================================================================
+size_t eve::ogl::ParticleGrid::query(const eve::vec3f & p_position, float p_radius, std::vector<uint32_t> & p_vecResult) const
+{
+	const size_t first = p_vecResult.size();
+	this->forEachNeighbour(p_position, p_radius, [&](uint32_t p_index, float)
+	{
+		p_vecResult.push_back(p_index);
+	});
+	return p_vecResult.size() - first;
+}
+
+//=================================================================================================
+size_t eve::ogl::ParticleGrid::countReference(const float * p_pX, const float * p_pY, const float * p_pZ, const eve::vec3f & p_position, float p_radius) const
+{
+	const float r2 = p_radius * p_radius;
+	size_t count = 0;
+	for (size_t i = 0; i < m_numParticles; i++)
+	{
+		const float dx = p_pX[i] - p_position.x;
+		const float dy = p_pY[i] - p_position.y;
+		const float dz = p_pZ[i] - p_position.z;
+		if (dx * dx + dy * dy + dz * dz <= r2) count++;
+	}
+	return count;
+}
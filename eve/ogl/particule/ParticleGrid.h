@@ -0,0 +1,274 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_OPENGL_PARTICULE_PARTICLE_GRID_H__
+#define __EVE_OPENGL_PARTICULE_PARTICLE_GRID_H__
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MEMORY_INCLUDES_H__
+#include "eve/mem/Includes.h"
+#endif
+
+#ifndef __EVE_MATH_CORE_TYPES_H__
+#include "eve/math/core/Types.h"
+#endif
+
+#include <atomic>
+#include <functional>
+
+
+/**
+* \def EVE_PARTICLE_GRID_GRAIN
+* \brief Particles (or buckets) per thread pool task.
+*/
+#define EVE_PARTICLE_GRID_GRAIN			16384
+
+/**
+* \def EVE_PARTICLE_GRID_MAX_REACH
+* \brief Maximum query reach in cells (query radius <= EVE_PARTICLE_GRID_MAX_REACH * cell size).
+*/
+#define EVE_PARTICLE_GRID_MAX_REACH		2
+
+
+namespace eve
+{
+	namespace ogl
+	{
+		/**
+		* \class eve::ogl::ParticleGrid
+		*
+		* \brief Particles neighbour search, spatial hash grid rebuilt from positions every frame.
+		* Cells of user defined size are hashed in a power of two buckets table (unbounded domain), particles are
+		* counting sorted by bucket: parallel histogram, block prefix sum, parallel scatter, then each bucket is
+		* sorted by particle index so the result does not depend on threads scheduling. Positions are gathered in
+		* bucket order so radius queries read contiguous memory.
+		*
+		* \note extends mem::Pointer
+		*/
+		class ParticleGrid final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			float							m_cellSize;			//!< Cell size.
+			float							m_invCellSize;		//!< Cell size inverse.
+			uint32_t						m_tableSize;		//!< Buckets amount (power of two).
+			size_t							m_numParticles;		//!< Particles amount of last build.
+			size_t							m_capacity;			//!< Allocated particles amount.
+
+		private:
+			uint32_t *						m_pBucket;			//!< Per particle bucket.
+			std::atomic<uint32_t> *			m_pCursor;			//!< Per bucket counter, then scatter cursor.
+			uint32_t *						m_pStart;			//!< Per bucket start in sorted arrays (m_tableSize + 1).
+			uint32_t *						m_pIndices;			//!< Particles indices sorted by bucket.
+			float *							m_pSorted;			//!< Positions sorted by bucket, SoA x/y/z arrays of m_capacity floats.
+
+		private:
+			bool							m_bParallel;		//!< Specifies whether build runs on thread pool.
+			int64_t							m_buildMicro;		//!< Last build duration in microseconds.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(ParticleGrid);
+			EVE_PUBLIC_DESTRUCTOR(ParticleGrid);
+
+		public:
+			/** \brief Create, init and return new pointer of cell size \a p_cellSize and at least \a p_tableSize buckets. */
+			static eve::ogl::ParticleGrid * create_ptr(float p_cellSize, uint32_t p_tableSize = 1 << 18);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit ParticleGrid(float p_cellSize, uint32_t p_tableSize);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Rebuild grid from \a p_numParticles positions given as SoA arrays \a p_pX, \a p_pY, \a p_pZ. */
+			void build(const float * p_pX, const float * p_pY, const float * p_pZ, size_t p_numParticles);
+
+		private:
+			/** \brief Grow particles arrays to hold \a p_numParticles particles. */
+			void reserve(size_t p_numParticles);
+			/** \brief Run \a p_task over [0, p_count[ on thread pool (when enabled) or calling thread. */
+			void run(size_t p_count, const std::function<void(size_t, size_t)> & p_task) const;
+
+
+		public:
+			/** \brief Bucket of cell containing \a p_x, \a p_y, \a p_z. */
+			uint32_t bucket(float p_x, float p_y, float p_z) const;
+			/** \brief Bucket of cell \a p_x, \a p_y, \a p_z. */
+			uint32_t bucketCell(int32_t p_x, int32_t p_y, int32_t p_z) const;
+
+
+		public:
+			/**
+			* \brief Call \a p_function(index, squared distance) for each particle closer than \a p_radius to \a p_position.
+			* \a p_radius MUST not exceed EVE_PARTICLE_GRID_MAX_REACH cells, reported order follows buckets then particles indices.
+			*/
+			template <class Function>
+			void forEachNeighbour(const eve::vec3f & p_position, float p_radius, Function p_function) const;
+			/** \brief Append indices of particles closer than \a p_radius to \a p_position in \a p_vecResult, return found amount. */
+			size_t query(const eve::vec3f & p_position, float p_radius, std::vector<uint32_t> & p_vecResult) const;
+			/** \brief Count particles closer than \a p_radius to \a p_position testing every particle (reference path). */
+			size_t countReference(const float * p_pX, const float * p_pY, const float * p_pZ, const eve::vec3f & p_position, float p_radius) const;
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get cell size. */
+			float getCellSize(void) const;
+			/** \brief Get buckets amount. */
+			uint32_t getTableSize(void) const;
+			/** \brief Get particles amount of last build. */
+			size_t getNumParticles(void) const;
+			/** \brief Get particles indices sorted by bucket. */
+			const uint32_t * getIndices(void) const;
+			/** \brief Get bucket \a p_bucket range [start, end[ in sorted indices. */
+			void getBucketRange(uint32_t p_bucket, uint32_t & p_start, uint32_t & p_end) const;
+
+		public:
+			/** \brief Get last build duration in microseconds. */
+			int64_t getBuildMicro(void) const;
+			/** \brief Get whether build runs on thread pool. */
+			bool getParallel(void) const;
+			/** \brief Set whether build runs on thread pool. */
+			void setParallel(bool p_bParallel);
+
+		}; // class ParticleGrid
+
+	} // namespace ogl
+
+} // namespace eve
+
+
+//=================================================================================================
+EVE_FORCE_INLINE uint32_t eve::ogl::ParticleGrid::bucketCell(int32_t p_x, int32_t p_y, int32_t p_z) const
+{
+	// Large primes hash (Teschner et al.), wraps on unbounded cell coordinates.
+	return ((static_cast<uint32_t>(p_x) * 73856093u) ^ (static_cast<uint32_t>(p_y) * 19349663u) ^ (static_cast<uint32_t>(p_z) * 83492791u)) & (m_tableSize - 1);
+}
+
+//=================================================================================================
+EVE_FORCE_INLINE uint32_t eve::ogl::ParticleGrid::bucket(float p_x, float p_y, float p_z) const
+{
+	return bucketCell(static_cast<int32_t>(std::floor(p_x * m_invCellSize))
+					, static_cast<int32_t>(std::floor(p_y * m_invCellSize))
+					, static_cast<int32_t>(std::floor(p_z * m_invCellSize)));
+}
+
+//=================================================================================================
+template <class Function>
+void eve::ogl::ParticleGrid::forEachNeighbour(const eve::vec3f & p_position, float p_radius, Function p_function) const
+{
+	EVE_ASSERT(p_radius <= m_cellSize * EVE_PARTICLE_GRID_MAX_REACH);
+
+	const int32_t reach = static_cast<int32_t>(std::ceil(p_radius * m_invCellSize));
+	const int32_t cx	= static_cast<int32_t>(std::floor(p_position.x * m_invCellSize));
+	const int32_t cy	= static_cast<int32_t>(std::floor(p_position.y * m_invCellSize));
+	const int32_t cz	= static_cast<int32_t>(std::floor(p_position.z * m_invCellSize));
+	const float	  r2	= p_radius * p_radius;
+
+	const float * sx = m_pSorted;
+	const float * sy = m_pSorted + m_capacity;
+	const float * sz = m_pSorted + m_capacity * 2;
+
+	// Distinct cells may share a bucket, visit each bucket once.
+	uint32_t visited[(2 * EVE_PARTICLE_GRID_MAX_REACH + 1) * (2 * EVE_PARTICLE_GRID_MAX_REACH + 1) * (2 * EVE_PARTICLE_GRID_MAX_REACH + 1)];
+	size_t	 numVisited = 0;
+
+	for (int32_t z = cz - reach; z <= cz + reach; z++)
+	{
+		for (int32_t y = cy - reach; y <= cy + reach; y++)
+		{
+			for (int32_t x = cx - reach; x <= cx + reach; x++)
+			{
+				const uint32_t b = bucketCell(x, y, z);
+				if (std::find(visited, visited + numVisited, b) != visited + numVisited) continue;
+				visited[numVisited++] = b;
+
+				for (uint32_t i = m_pStart[b]; i < m_pStart[b + 1]; i++)
+				{
+					const float dx = sx[i] - p_position.x;
+					const float dy = sy[i] - p_position.y;
+					const float dz = sz[i] - p_position.z;
+					const float d2 = dx * dx + dy * dy + dz * dz;
+					if (d2 <= r2) {
+						p_function(m_pIndices[i], d2);
+					}
+				}
+			}
+		}
+	}
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE float				eve::ogl::ParticleGrid::getCellSize(void) const				{ return m_cellSize;		}
+EVE_FORCE_INLINE uint32_t			eve::ogl::ParticleGrid::getTableSize(void) const			{ return m_tableSize;		}
+EVE_FORCE_INLINE size_t				eve::ogl::ParticleGrid::getNumParticles(void) const			{ return m_numParticles;	}
+EVE_FORCE_INLINE const uint32_t *	eve::ogl::ParticleGrid::getIndices(void) const				{ return m_pIndices;		}
+EVE_FORCE_INLINE int64_t			eve::ogl::ParticleGrid::getBuildMicro(void) const			{ return m_buildMicro;		}
+EVE_FORCE_INLINE bool				eve::ogl::ParticleGrid::getParallel(void) const				{ return m_bParallel;		}
+EVE_FORCE_INLINE void				eve::ogl::ParticleGrid::setParallel(bool p_bParallel)		{ m_bParallel = p_bParallel; }
+
+//=================================================================================================
+EVE_FORCE_INLINE void eve::ogl::ParticleGrid::getBucketRange(uint32_t p_bucket, uint32_t & p_start, uint32_t & p_end) const
+{
+	p_start = m_pStart[p_bucket];
+	p_end	= m_pStart[p_bucket + 1];
+}
+
+#endif // __EVE_OPENGL_PARTICULE_PARTICLE_GRID_H__
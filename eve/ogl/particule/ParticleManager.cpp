@@ -32,12 +32,32 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Main header
 #include "eve/ogl/particule/ParticleManager.h"
 
+#ifndef __EVE_OPENGL_PARTICULE_ATTRACTOR_FIELD_H__
+#include "eve/ogl/particule/AttractorField.h"
+#endif
+
+#ifndef __EVE_OPENGL_PARTICULE_PARTICLE_CPU_H__
+#include "eve/ogl/particule/ParticleCpu.h"
+#endif
+
+#ifndef __EVE_OPENGL_PARTICULE_PARTICLE_SEEDER_H__
+#include "eve/ogl/particule/ParticleSeeder.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_CONTEXT_H__
+#include "eve/ogl/core/win32/Context.h"
+#endif
+
 
 eve::ogl::ParticleManager::ParticleManager()
 	: eve::ogl::Object()
 	, m_bufferData(std::map<std::string, GLuint>())
 	, m_numParticles(0)
 	, m_iniRadius(0)
+	, m_backend(eve::ogl::ParticleBackend_GPU)
+	, m_pCpu(nullptr)
+	, m_pSeeder(nullptr)
+	, m_pField(nullptr)
 {
 }
 
@@ -48,11 +68,9 @@ eve::ogl::ParticleManager::~ParticleManager()
 
 void eve::ogl::ParticleManager::release(void)
 {
-	if (m_particles)
-	{
-		delete m_particles;
-		m_particles = NULL;
-	}
+	EVE_RELEASE_PTR_SAFE(m_pCpu);
+	EVE_RELEASE_PTR_SAFE(m_pSeeder);
+	EVE_RELEASE_PTR_SAFE(m_pField);
 
 	m_bufferData.clear();
 }
@@ -64,6 +82,10 @@ eve::ogl::ParticleManager::ParticleManager(const ParticleManager & p_other)
 , m_numParticles(p_other.m_numParticles)
 , m_bufferData(p_other.m_bufferData)
 , m_iniRadius(p_other.m_iniRadius)
+, m_backend(p_other.m_backend)
+, m_pCpu(nullptr)
+, m_pSeeder(nullptr)
+, m_pField(nullptr)
 {}
 
 //=================================================================================================
@@ -74,6 +96,7 @@ const eve::ogl::ParticleManager & eve::ogl::ParticleManager::operator = (const e
 		this->m_bufferData = p_other.m_bufferData;
 		this->m_numParticles = p_other.m_numParticles;
 		this->m_iniRadius = p_other.m_iniRadius;
+		this->m_backend = p_other.m_backend;
 	}
 	return *this;
 }
@@ -85,6 +108,10 @@ eve::ogl::ParticleManager::ParticleManager(eve::ogl::ParticleManager&& other)
 , m_bufferData(std::map<std::string, GLuint>())
 , m_numParticles(0)
 , m_iniRadius(0)
+, m_backend(eve::ogl::ParticleBackend_GPU)
+, m_pCpu(nullptr)
+, m_pSeeder(nullptr)
+, m_pField(nullptr)
 {
 	std::cout << "In MemoryBlock(MemoryBlock&&). length = "
 		<< other.m_numParticles << ". Moving resource." << std::endl;
@@ -94,12 +121,19 @@ eve::ogl::ParticleManager::ParticleManager(eve::ogl::ParticleManager&& other)
 	m_numParticles = other.m_numParticles;
 	m_iniRadius = other.m_iniRadius;
 	m_bufferData = other.m_bufferData;
+	m_backend = other.m_backend;
+	m_pCpu = other.m_pCpu;
+	m_pSeeder = other.m_pSeeder;
+	m_pField = other.m_pField;
 
 	// Release the data pointer from the source object so that
 	// the destructor does not free the memory multiple times.
 	other.m_bufferData.clear();
 	other.m_numParticles	= 0;
 	other.m_iniRadius = 0;
+	other.m_pCpu = nullptr;
+	other.m_pSeeder = nullptr;
+	other.m_pField = nullptr;
 }
 
 
@@ -113,18 +147,28 @@ eve::ogl::ParticleManager& eve::ogl::ParticleManager::operator=(eve::ogl::Partic
 	{
 		// Free the existing resource.
 		m_bufferData.clear();
+		EVE_RELEASE_PTR_SAFE(m_pCpu);
+		EVE_RELEASE_PTR_SAFE(m_pSeeder);
+		EVE_RELEASE_PTR_SAFE(m_pField);
 
 		// Copy the data pointer and its length from the 
 		// source object.
 		m_numParticles = other.m_numParticles;
 		m_iniRadius = other.m_iniRadius;
 		m_bufferData = other.m_bufferData;
+		m_backend = other.m_backend;
+		m_pCpu = other.m_pCpu;
+		m_pSeeder = other.m_pSeeder;
+		m_pField = other.m_pField;
 
 		// Release the data pointer from the source object so that
 		// the destructor does not free the memory multiple times.
 		other.m_bufferData.clear();
 		other.m_numParticles = 0;
 		other.m_iniRadius = 0;
+		other.m_pCpu = nullptr;
+		other.m_pSeeder = nullptr;
+		other.m_pField = nullptr;
 	}
 	return *this;
 }
@@ -143,6 +187,45 @@ void eve::ogl::ParticleManager::loadParticleBuffer(int numParticles, int iniRadi
 	this->requestOglInit();
 }
 
+//=================================================================================================
+void eve::ogl::ParticleManager::loadParticles(int numParticles, int iniRadius)
+{
+	EVE_ASSERT(m_backend == eve::ogl::ParticleBackend_CPU);
+
+	m_numParticles = numParticles;
+	m_iniRadius = iniRadius;
+
+	m_bufferData = std::map<std::string, GLuint>();
+
+	this->init();
+}
+
+//=================================================================================================
+void eve::ogl::ParticleManager::init(void)
+{
+	if (!m_pSeeder)
+	{
+		const float radius = static_cast<float>(m_iniRadius);
+		m_pSeeder = eve::ogl::ParticleSeeder::create_ptr();
+		m_pSeeder->setBox(eve::vec3f::zero(), eve::vec3f(radius, radius, radius));
+	}
+
+	if (!m_pField) {
+		m_pField = eve::ogl::AttractorField::create_ptr();
+	}
+
+	if (m_backend == eve::ogl::ParticleBackend_CPU)
+	{
+		Particle * particles = new Particle[m_numParticles];
+		m_pSeeder->fill(particles, static_cast<size_t>(m_numParticles));
+
+		m_pCpu = eve::ogl::ParticleCpu::create_ptr(static_cast<size_t>(m_numParticles));
+		m_pCpu->load(particles);
+
+		delete[] particles;
+	}
+}
+
 
 void eve::ogl::ParticleManager::setAttributes(eve::ogl::Format * p_format)
 {
@@ -154,12 +237,34 @@ void eve::ogl::ParticleManager::oglInit(void)
 {
 	GLuint bufferID;
 
-	Particle* m_particles = new Particle[m_numParticles];
-	setParticles(m_particles, m_numParticles, m_iniRadius);
+	const GLsizeiptr size = m_numParticles*sizeof(Particle);
 
 	glGenBuffers(1, &bufferID);
 	glBindBuffer(GL_SHADER_STORAGE_BUFFER, bufferID);
-	glBufferData(GL_SHADER_STORAGE_BUFFER, m_numParticles*sizeof(Particle), m_particles, GL_STATIC_DRAW);
+
+	if (m_backend == eve::ogl::ParticleBackend_CPU)
+	{
+		glBufferData(GL_SHADER_STORAGE_BUFFER, size, m_pCpu->getOutput(), GL_STREAM_DRAW);
+	}
+	else
+	{
+		// Seed straight into driver memory, no intermediate particles array.
+		glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_STATIC_DRAW);
+		Particle * mapped = reinterpret_cast<Particle*>(glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+		if (mapped)
+		{
+			m_pSeeder->fill(mapped, static_cast<size_t>(m_numParticles));
+			glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+		}
+		else
+		{
+			Particle * particles = new Particle[m_numParticles];
+			m_pSeeder->fill(particles, static_cast<size_t>(m_numParticles));
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, particles);
+			delete[] particles;
+		}
+	}
+
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, bufferID);
 
 	if (glGetError() != GL_NO_ERROR){
@@ -174,21 +279,69 @@ void eve::ogl::ParticleManager::oglRelease(void)
 {
 	GLuint ID = getId();
 	glDeleteBuffers(1, &ID);
+
+	if (m_pField) {
+		m_pField->oglRelease();
+	}
 }
 
-void eve::ogl::ParticleManager::setParticles(struct Particle* particles, int numParticles, int iniRadius)
+//=================================================================================================
+void eve::ogl::ParticleManager::simulate(const eve::vec4f & p_attractor, float p_frameTimeDiff, GLuint p_computeProgram)
 {
-	float rndX, rndY, rndZ;
-	std::mt19937 eng;
-	std::uniform_real_distribution<float> dist(static_cast<float>(iniRadius)*(-1.0f), static_cast<float>(iniRadius));
-
-	for(int i = 0; i < numParticles; ++i){
-		rndX = dist(eng);
-		rndY = dist(eng);
-		rndZ = dist(eng);
-		particles[i].m_currPosition = eve::math::TVec4<float>(rndX, rndY, rndZ, 1.0f);
-		particles[i].m_prevPosition = eve::math::TVec4<float>(rndX, rndY, rndZ, 1.0f);
+	m_pField->build();
+
+	if (m_backend == eve::ogl::ParticleBackend_CPU)
+	{
+		m_pCpu->step(p_attractor, p_frameTimeDiff, m_pField);
+
+		GLuint id = getId();
+		if (id != 0)
+		{
+			EveStateGL->bindBuffer(GL_ARRAY_BUFFER, id);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, m_numParticles*sizeof(Particle), m_pCpu->getOutput());
+			EveStateGL->bindBuffer(GL_ARRAY_BUFFER, 0);
+		}
 	}
+	else
+	{
+		m_pField->oglBind();
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getId());
+		EveStateGL->useProgram(p_computeProgram);
+
+		loadFloatUniform(p_computeProgram, "frameTimeDiff", p_frameTimeDiff);
+		loadVec4Uniform(p_computeProgram, "attPos", p_attractor.x, p_attractor.y, p_attractor.z, p_attractor.w);
+		loadUintUniform(p_computeProgram, "maxParticles", static_cast<GLuint>(m_numParticles));
+
+		glDispatchCompute((m_numParticles / EVE_OGL_PARTICLE_WORK_GROUP_SIZE) + 1, 1, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+		// Bound program takes precedence over program pipelines, give them back.
+		EveStateGL->useProgram(0);
+	}
+}
+
+//=================================================================================================
+void eve::ogl::ParticleManager::setBackend(eve::ogl::ParticleBackend p_backend)
+{
+	EVE_ASSERT(m_pCpu == nullptr && getId() == 0);
+	m_backend = p_backend;
+}
+
+//=================================================================================================
+void eve::ogl::ParticleManager::setSeeder(eve::ogl::ParticleSeeder * p_pSeeder)
+{
+	EVE_ASSERT(m_pCpu == nullptr && getId() == 0);
+	if (m_pSeeder != p_pSeeder)
+	{
+		EVE_RELEASE_PTR_SAFE(m_pSeeder);
+		m_pSeeder = p_pSeeder;
+	}
+}
+
+//=================================================================================================
+double eve::ogl::ParticleManager::getParticlesPerSecond(void) const
+{
+	return (m_pCpu) ? m_pCpu->getParticlesPerSecond() : 0.0;
 }
 
 
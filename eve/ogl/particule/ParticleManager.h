@@ -44,14 +44,39 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "eve/ogl/core/Object.h"
 #endif
 
-#ifndef __EVE_MATH_CORE_TVECTOR_H__
-#include "eve/math/core/TVector.h"
+#ifndef __EVE_MATH_CORE_TYPES_H__
+#include "eve/math/core/Types.h"
 #endif
 
+/** \def EVE_OGL_PARTICLE_WORK_GROUP_SIZE
+* \brief Particule.comp local work group size.
+*/
+#define EVE_OGL_PARTICLE_WORK_GROUP_SIZE		256
+
+
+namespace eve { namespace ogl { class AttractorField; } }
+namespace eve { namespace ogl { class ParticleCpu; } }
+namespace eve { namespace ogl { class ParticleSeeder; } }
+
+
 namespace eve
 {
 	namespace ogl
 	{
+		/**
+		* \enum eve::ogl::ParticleBackend
+		* \brief Particles simulation backends.
+		*/
+		enum ParticleBackend
+		{
+			ParticleBackend_GPU = 0,		//!< Particule.comp compute shader over shader storage buffer.
+			ParticleBackend_CPU,			//!< eve::ogl::ParticleCpu SIMD kernels over thread pool, uploaded to buffer each step.
+
+			//! This value is not used. It is just there to force the compiler to map this enum to a 32 Bit integer.
+			_ParticleBackend_Force32Bit = INT_MAX
+
+		}; // enum ParticleBackend
+
 
 		struct Particle
 		{
@@ -65,9 +90,11 @@ namespace eve
 		private:
 			std::map<std::string, GLuint> 		m_bufferData;
 			int m_numParticles, m_iniRadius;
-			Particle* m_particles;
 
-			void setParticles(struct Particle* particles, int numParticles, int iniRadius);
+			eve::ogl::ParticleBackend			m_backend;			//!< Simulation backend, set before loading particles.
+			eve::ogl::ParticleCpu *				m_pCpu;				//!< CPU simulation (CPU backend only).
+			eve::ogl::ParticleSeeder *			m_pSeeder;			//!< Initial positions generator (owned).
+			eve::ogl::AttractorField *			m_pField;			//!< Attractors and repellers field, shared by both backends.
 
 		public:
 
@@ -94,14 +121,14 @@ namespace eve
 			virtual void setAttributes(eve::ogl::Format * p_format);
 
 		public:
-			/** \brief Alloc and init non OpenGL class members. (pure virtual) */
-			virtual void init(void){};
+			/** \brief Alloc and init non OpenGL class members, seed CPU backend particles. (pure virtual) */
+			virtual void init(void);
 			/** \brief Release and delete non OpenGL class members. (pure virtual) */
 			virtual void release(void);
 
 
 		protected:
-			/** \brief Init OpenGL components. */
+			/** \brief Init OpenGL components, GPU backend particles are seeded straight into mapped buffer. */
 			virtual void oglInit(void);
 			/** \brief Update OpenGL components. (only FBO size can be updated here) */
 			virtual void oglUpdate(void){};
@@ -113,6 +140,17 @@ namespace eve
 		public:
 
 			void loadParticleBuffer(int numParticles, int iniRadius, eve::ogl::Renderer * p_pRenderer);
+			/** \brief Seed particles without OpenGL buffer (CPU backend only), for runs and measures without GPU. */
+			void loadParticles(int numParticles, int iniRadius);
+
+			/**
+			* \brief Run one simulation step.
+			* GPU backend uploads attractors field and dispatches compute program \a p_computeProgram (Particule.comp), CPU backend
+			* runs eve::ogl::ParticleCpu and uploads positions to particles buffer (if any). Rendering context MUST be current unless particles have no buffer.
+			* \param p_attractor attractor position, W set to -1 applies gravity instead.
+			* \param p_frameTimeDiff integration time step.
+			*/
+			void simulate(const eve::vec4f & p_attractor, float p_frameTimeDiff, GLuint p_computeProgram = 0);
 
 			void loadUintUniform(GLuint shaderProgramID, std::string name, GLuint value);
 			void loadFloatUniform(GLuint shaderProgramID, std::string name, GLfloat value);
@@ -127,10 +165,44 @@ namespace eve
 			/** \brief Get OpenGL shader unique id. (pure virtual) */
 			virtual const GLuint getId(void) const override;
 
+		public:
+			/** \brief Get simulation backend. */
+			eve::ogl::ParticleBackend getBackend(void) const;
+			/** \brief Set simulation backend, MUST be called before loading particles. */
+			void setBackend(eve::ogl::ParticleBackend p_backend);
+			/** \brief Get initial positions generator (nullptr until set or loaded). */
+			eve::ogl::ParticleSeeder * getSeeder(void) const;
+			/**
+			* \brief Set initial positions generator (ownership is taken, previous one is released), MUST be called before loading particles.
+			* When none is set, loading creates a box seeder of half size iniRadius.
+			*/
+			void setSeeder(eve::ogl::ParticleSeeder * p_pSeeder);
+
+		public:
+			/** \brief Get attractors and repellers field (created on load), sources may be edited each frame before simulate(). */
+			eve::ogl::AttractorField * getField(void) const;
+
+		public:
+			/** \brief Get CPU simulation (nullptr with GPU backend). */
+			eve::ogl::ParticleCpu * getCpu(void) const;
+			/** \brief Get last CPU step throughput in particles per second (0 with GPU backend). */
+			double getParticlesPerSecond(void) const;
+
 		};
 
 	} // namespace ogl
 
 } // namespace eve
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE eve::ogl::ParticleBackend	eve::ogl::ParticleManager::getBackend(void) const	{ return m_backend; }
+EVE_FORCE_INLINE eve::ogl::ParticleSeeder * eve::ogl::ParticleManager::getSeeder(void) const	{ return m_pSeeder; }
+EVE_FORCE_INLINE eve::ogl::AttractorField * eve::ogl::ParticleManager::getField(void) const	{ return m_pField;	}
+EVE_FORCE_INLINE eve::ogl::ParticleCpu *	eve::ogl::ParticleManager::getCpu(void) const		{ return m_pCpu;	}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,228 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/ogl/particule/ParticleSeeder.h"
+
+#ifndef __EVE_OPENGL_PARTICULE_PARTICULE_MANAGER_H__
+#include "eve/ogl/particule/ParticleManager.h"
+#endif
+
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#include "eve/thr/TaskPool.h"
+#endif
+
+
+namespace
+{
+	/** \brief Random values drawn per particle (counter stride). */
+	static const uint64_t	SEED_STRIDE	= 4;
+	/** \brief Two pi. */
+	static const float		TWO_PI		= 6.28318530717958647692f;
+
+} // namespace
+
+
+
+//=================================================================================================
+eve::ogl::ParticleSeeder * eve::ogl::ParticleSeeder::create_ptr(void)
+{
+	eve::ogl::ParticleSeeder * ptr = new eve::ogl::ParticleSeeder();
+	ptr->init();
+	return ptr;
+}
+
+
+
+//=================================================================================================
+eve::ogl::ParticleSeeder::ParticleSeeder(void)
+	// Inheritance
+	: eve::mem::Pointer()
+
+	// Members init
+	, m_shape(eve::ogl::ParticleSeedShape_Box)
+	, m_seed(0)
+	, m_center(eve::vec3f::zero())
+	, m_extent(eve::vec3f::one())
+	, m_pVertices(nullptr)
+	, m_pAreas(nullptr)
+	, m_bParallel(true)
+{}
+
+
+
+//=================================================================================================
+void eve::ogl::ParticleSeeder::init(void)
+{
+	m_pVertices = new std::vector<eve::vec3f>();
+	m_pAreas	= new std::vector<float>();
+}
+
+//=================================================================================================
+void eve::ogl::ParticleSeeder::release(void)
+{
+	EVE_RELEASE_PTR_CPP(m_pVertices);
+	EVE_RELEASE_PTR_CPP(m_pAreas);
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ParticleSeeder::setBox(const eve::vec3f & p_center, const eve::vec3f & p_halfSize)
+{
+	m_shape  = eve::ogl::ParticleSeedShape_Box;
+	m_center = p_center;
+	m_extent = p_halfSize;
+}
+
+//=================================================================================================
+void eve::ogl::ParticleSeeder::setSphere(const eve::vec3f & p_center, float p_radius)
+{
+	m_shape  = eve::ogl::ParticleSeedShape_Sphere;
+	m_center = p_center;
+	m_extent = eve::vec3f(p_radius, p_radius, p_radius);
+}
+
+//=================================================================================================
+void eve::ogl::ParticleSeeder::setSurface(const float * p_pPositions, const uint32_t * p_pIndices, size_t p_numIndices)
+{
+	EVE_ASSERT(p_pPositions);
+	EVE_ASSERT((p_numIndices % 3) == 0);
+
+	m_shape = eve::ogl::ParticleSeedShape_Surface;
+
+	m_pVertices->clear();
+	m_pAreas->clear();
+	m_pVertices->reserve(p_numIndices);
+	m_pAreas->reserve(p_numIndices / 3);
+
+	// Cumulated areas, triangles are picked by binary search so particles density is uniform on surface.
+	float total = 0.0f;
+	for (size_t i = 0; i < p_numIndices; i += 3)
+	{
+		eve::vec3f v[3];
+		for (size_t k = 0; k < 3; k++)
+		{
+			const size_t idx = (p_pIndices) ? p_pIndices[i + k] : (i + k);
+			v[k] = eve::vec3f(p_pPositions[idx * 3], p_pPositions[idx * 3 + 1], p_pPositions[idx * 3 + 2]);
+			m_pVertices->push_back(v[k]);
+		}
+		total += 0.5f * (v[1] - v[0]).cross(v[2] - v[0]).length();
+		m_pAreas->push_back(total);
+	}
+}
+
+
+
+//=================================================================================================
+float eve::ogl::ParticleSeeder::uniform(uint64_t p_seed, uint64_t p_counter)
+{
+	uint64_t z = p_seed + (p_counter + 1) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z =  z ^ (z >> 31);
+
+	// Top 24 bits, exactly representable.
+	return static_cast<float>(z >> 40) * (1.0f / 16777216.0f);
+}
+
+//=================================================================================================
+eve::vec3f eve::ogl::ParticleSeeder::position(size_t p_index) const
+{
+	const uint64_t counter = static_cast<uint64_t>(p_index) * SEED_STRIDE;
+	const float u0 = uniform(m_seed, counter);
+	const float u1 = uniform(m_seed, counter + 1);
+	const float u2 = uniform(m_seed, counter + 2);
+
+	switch (m_shape)
+	{
+	case eve::ogl::ParticleSeedShape_Sphere:
+	{
+		const float z	= u0 * 2.0f - 1.0f;
+		const float phi = u1 * TWO_PI;
+		const float r	= m_extent.x * std::cbrt(u2);
+		const float s	= std::sqrt(std::max(0.0f, 1.0f - z * z));
+		return m_center + eve::vec3f(r * s * std::cos(phi), r * s * std::sin(phi), r * z);
+	}
+
+	case eve::ogl::ParticleSeedShape_Surface:
+	{
+		if (m_pAreas->empty()) {
+			return m_center;
+		}
+		const float target = u0 * m_pAreas->back();
+		size_t tri = static_cast<size_t>(std::upper_bound(m_pAreas->begin(), m_pAreas->end(), target) - m_pAreas->begin());
+		tri = std::min(tri, m_pAreas->size() - 1);
+
+		const eve::vec3f * v = m_pVertices->data() + tri * 3;
+		const float su = std::sqrt(u1);
+		const float b0 = 1.0f - su;
+		const float b1 = u2 * su;
+		return v[0] * b0 + v[1] * b1 + v[2] * (1.0f - b0 - b1);
+	}
+
+	default:
+		return m_center + eve::vec3f((u0 * 2.0f - 1.0f) * m_extent.x
+								   , (u1 * 2.0f - 1.0f) * m_extent.y
+								   , (u2 * 2.0f - 1.0f) * m_extent.z);
+	}
+}
+
+
+
+//=================================================================================================
+void eve::ogl::ParticleSeeder::fillRange(eve::ogl::Particle * p_pDst, size_t p_begin, size_t p_end) const
+{
+	for (size_t i = p_begin; i < p_end; i++)
+	{
+		const eve::vec3f pos = this->position(i);
+		p_pDst[i].m_currPosition = eve::vec4f(pos.x, pos.y, pos.z, 1.0f);
+		p_pDst[i].m_prevPosition = p_pDst[i].m_currPosition;
+	}
+}
+
+//=================================================================================================
+void eve::ogl::ParticleSeeder::fill(eve::ogl::Particle * p_pDst, size_t p_count) const
+{
+	EVE_ASSERT(p_pDst);
+
+	if (m_bParallel && p_count > EVE_PARTICLE_SEEDER_GRAIN)
+	{
+		eve::thr::TaskPool::get_instance()->parallel_for(0, p_count, EVE_PARTICLE_SEEDER_GRAIN, [&](size_t p_begin, size_t p_end)
+		{
+			this->fillRange(p_pDst, p_begin, p_end);
+		});
+	}
+	else
+	{
+		this->fillRange(p_pDst, 0, p_count);
+	}
+}
@@ -0,0 +1,201 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_OPENGL_PARTICULE_PARTICLE_SEEDER_H__
+#define __EVE_OPENGL_PARTICULE_PARTICLE_SEEDER_H__
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MEMORY_INCLUDES_H__
+#include "eve/mem/Includes.h"
+#endif
+
+#ifndef __EVE_MATH_CORE_TYPES_H__
+#include "eve/math/core/Types.h"
+#endif
+
+
+namespace eve { namespace ogl { struct Particle; } }
+
+
+/**
+* \def EVE_PARTICLE_SEEDER_GRAIN
+* \brief Particles per thread pool task.
+*/
+#define EVE_PARTICLE_SEEDER_GRAIN		16384
+
+
+namespace eve
+{
+	namespace ogl
+	{
+		/**
+		* \enum eve::ogl::ParticleSeedShape
+		* \brief Particles initial distribution shapes.
+		*/
+		enum ParticleSeedShape
+		{
+			ParticleSeedShape_Box = 0,		//!< Uniform in axis aligned box.
+			ParticleSeedShape_Sphere,		//!< Uniform in ball volume.
+			ParticleSeedShape_Surface,		//!< Uniform on triangle mesh surface (area weighted).
+
+			//! This value is not used. It is just there to force the compiler to map this enum to a 32 Bit integer.
+			_ParticleSeedShape_Force32Bit = INT_MAX
+
+		}; // enum ParticleSeedShape
+
+
+		/**
+		* \class eve::ogl::ParticleSeeder
+		*
+		* \brief Particles initial positions generator.
+		* Random values come from a counter based generator (splitmix64 of seed and particle index), each particle
+		* only depends on its own index so ranges can be filled in any order on any thread with identical results.
+		* fill() writes interleaved eve::ogl::Particle items straight into destination memory (mapped buffer or array).
+		*
+		* \note extends mem::Pointer
+		*/
+		class ParticleSeeder final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			eve::ogl::ParticleSeedShape		m_shape;			//!< Distribution shape.
+			uint64_t						m_seed;				//!< Generator seed.
+			eve::vec3f						m_center;			//!< Box or sphere center.
+			eve::vec3f						m_extent;			//!< Box half size, sphere radius in X.
+
+		private:
+			std::vector<eve::vec3f> *		m_pVertices;		//!< Surface triangles vertices (3 per triangle).
+			std::vector<float> *			m_pAreas;			//!< Surface triangles cumulated areas.
+
+		private:
+			bool							m_bParallel;		//!< Specifies whether fill runs on thread pool.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(ParticleSeeder);
+			EVE_PUBLIC_DESTRUCTOR(ParticleSeeder);
+
+		public:
+			/** \brief Create, init and return new pointer. */
+			static eve::ogl::ParticleSeeder * create_ptr(void);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit ParticleSeeder(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Distribute particles in box centered on \a p_center of half size \a p_halfSize. */
+			void setBox(const eve::vec3f & p_center, const eve::vec3f & p_halfSize);
+			/** \brief Distribute particles in ball centered on \a p_center of radius \a p_radius. */
+			void setSphere(const eve::vec3f & p_center, float p_radius);
+			/** 
+			* \brief Distribute particles on triangle mesh surface.
+			* \param p_pPositions vertices positions (3 floats per vertex).
+			* \param p_pIndices triangles indices (3 per triangle), nullptr for non indexed triangles.
+			* \param p_numIndices indices amount (or vertices amount for non indexed triangles).
+			*/
+			void setSurface(const float * p_pPositions, const uint32_t * p_pIndices, size_t p_numIndices);
+
+
+		public:
+			/** \brief Fill \a p_count particles in \a p_pDst, on thread pool when enabled. */
+			void fill(eve::ogl::Particle * p_pDst, size_t p_count) const;
+			/** \brief Fill particles [p_begin, p_end[ in \a p_pDst (indexed from 0) on calling thread. */
+			void fillRange(eve::ogl::Particle * p_pDst, size_t p_begin, size_t p_end) const;
+			/** \brief Compute particle \a p_index position. */
+			eve::vec3f position(size_t p_index) const;
+
+
+		public:
+			/** \brief Counter based uniform random value in [0, 1[ for stream \a p_seed and counter \a p_counter (splitmix64). */
+			static float uniform(uint64_t p_seed, uint64_t p_counter);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get distribution shape. */
+			eve::ogl::ParticleSeedShape getShape(void) const;
+
+		public:
+			/** \brief Get generator seed. */
+			uint64_t getSeed(void) const;
+			/** \brief Set generator seed. */
+			void setSeed(uint64_t p_seed);
+
+		public:
+			/** \brief Get whether fill runs on thread pool. */
+			bool getParallel(void) const;
+			/** \brief Set whether fill runs on thread pool. */
+			void setParallel(bool p_bParallel);
+
+		}; // class ParticleSeeder
+
+	} // namespace ogl
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE eve::ogl::ParticleSeedShape	eve::ogl::ParticleSeeder::getShape(void) const			{ return m_shape;				}
+EVE_FORCE_INLINE uint64_t						eve::ogl::ParticleSeeder::getSeed(void) const			{ return m_seed;				}
+EVE_FORCE_INLINE void							eve::ogl::ParticleSeeder::setSeed(uint64_t p_seed)		{ m_seed = p_seed;				}
+EVE_FORCE_INLINE bool							eve::ogl::ParticleSeeder::getParallel(void) const		{ return m_bParallel;			}
+EVE_FORCE_INLINE void							eve::ogl::ParticleSeeder::setParallel(bool p_bParallel)	{ m_bParallel = p_bParallel;	}
+
+#endif // __EVE_OPENGL_PARTICULE_PARTICLE_SEEDER_H__
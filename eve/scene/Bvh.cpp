@@ -0,0 +1,926 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/scene/Bvh.h"
+
+#ifndef __EVE_SCENE_MESH_H__
+#include "eve/scene/Mesh.h"
+#endif
+
+
+namespace eve
+{
+	namespace __scene_internal
+	{
+		static const uint32_t	BVH_BINS			= 12;		//!< SAH bins amount per axis.
+		static const uint32_t	BVH_LEAF_MIN		= 2;		//!< Ranges up to this size always become leaves.
+		static const uint32_t	BVH_LEAF_MAX		= 8;		//!< Ranges above this size are always split when possible.
+		static const uint32_t	BVH_PARALLEL_MIN	= 4096;		//!< Ranges above this size build their left subtree as a task.
+		static const float		BVH_TRAVERSAL_COST	= 1.0f;		//!< SAH node traversal cost relative to primitive test.
+		static const size_t		BVH_STACK_SIZE		= 128;		//!< Traversal stack size.
+		static const uint32_t	BVH_DEPTH_MAX		= static_cast<uint32_t>(BVH_STACK_SIZE) - 1;	//!< Nodes at this depth always become leaves, traversal stack never holds more than depth + 1 nodes.
+
+		/** \brief Empty bounds. */
+		EVE_FORCE_INLINE void bounds_reset(float * p_min, float * p_max)
+		{
+			p_min[0] = p_min[1] = p_min[2] =  FLT_MAX;
+			p_max[0] = p_max[1] = p_max[2] = -FLT_MAX;
+		}
+
+		/** \brief Grow bounds to include box (min xyz, max xyz). */
+		EVE_FORCE_INLINE void bounds_grow(float * p_min, float * p_max, const float * p_box)
+		{
+			for (size_t i = 0; i < 3; i++)
+			{
+				if (p_box[i]	 < p_min[i]) p_min[i] = p_box[i];
+				if (p_box[i + 3] > p_max[i]) p_max[i] = p_box[i + 3];
+			}
+		}
+
+		/** \brief Bounds half surface area. */
+		EVE_FORCE_INLINE float bounds_area(const float * p_min, const float * p_max)
+		{
+			float dx = p_max[0] - p_min[0];
+			float dy = p_max[1] - p_min[1];
+			float dz = p_max[2] - p_min[2];
+			return (dx < 0.0f) ? 0.0f : (dx * dy + dy * dz + dz * dx);
+		}
+
+		/** \brief SAH bin. */
+		struct BvhBin
+		{
+			float		min[3];
+			float		max[3];
+			uint32_t	count;
+		};
+
+	} // namespace __scene_internal
+
+} // namespace eve
+
+
+
+//=================================================================================================
+eve::scene::BvhRay::BvhRay(const eve::vec3f & p_origin, const eve::vec3f & p_direction)
+{
+	origin[0] = p_origin.x;		origin[1] = p_origin.y;		origin[2] = p_origin.z;
+	dir[0]	  = p_direction.x;	dir[1]	  = p_direction.y;	dir[2]	  = p_direction.z;
+
+	for (size_t i = 0; i < 3; i++)
+	{
+		// Keep slab test NaN free on axis aligned rays.
+		invDir[i] = (dir[i] != 0.0f) ? (1.0f / dir[i]) : ((dir[i] < 0.0f) ? -FLT_MAX : FLT_MAX);
+	}
+}
+
+
+
+//=================================================================================================
+eve::scene::Bvh::Bvh(void)
+	// Inheritance
+	: eve::mem::Pointer()
+	// Members init
+	, m_pNodes(nullptr)
+	, m_pIndices(nullptr)
+	, m_numNodes(0)
+{}
+
+
+
+//=================================================================================================
+void eve::scene::Bvh::init(void)
+{
+	m_pNodes	= new std::vector<eve::scene::BvhNode>();
+	m_pIndices	= new std::vector<uint32_t>();
+}
+
+//=================================================================================================
+void eve::scene::Bvh::release(void)
+{
+	EVE_RELEASE_PTR_CPP(m_pNodes);
+	EVE_RELEASE_PTR_CPP(m_pIndices);
+}
+
+
+
+//=================================================================================================
+void eve::scene::Bvh::build(const float * p_pBoxes, uint32_t p_numPrims)
+{
+	m_pIndices->resize(p_numPrims);
+	for (uint32_t i = 0; i < p_numPrims; i++) {
+		(*m_pIndices)[i] = i;
+	}
+
+	// Worst case nodes amount, children are allocated by pairs.
+	m_pNodes->resize((p_numPrims > 0) ? (2 * p_numPrims - 1) : 1);
+	m_numNodes = 1;
+
+	if (p_numPrims == 0)
+	{
+		eve::scene::BvhNode & root = m_pNodes->front();
+		eve::__scene_internal::bounds_reset(root.min, root.max);
+		root.first = 0;
+		root.count = 0;
+		return;
+	}
+
+	eve::thr::TaskPool * pool = eve::thr::TaskPool::get_instance();
+
+	// Primitives centroids.
+	std::vector<float> centroids(p_numPrims * 3);
+	pool->parallel_for(0, p_numPrims, 4096, [&](size_t p_begin, size_t p_end)
+	{
+		for (size_t i = p_begin; i < p_end; i++)
+		{
+			const float * box = p_pBoxes + i * 6;
+			centroids[i * 3 + 0] = (box[0] + box[3]) * 0.5f;
+			centroids[i * 3 + 1] = (box[1] + box[4]) * 0.5f;
+			centroids[i * 3 + 2] = (box[2] + box[5]) * 0.5f;
+		}
+	});
+
+	eve::thr::TaskCounter counter;
+	this->buildNode(0, 0, 0, p_numPrims, p_pBoxes, centroids.data(), &counter);
+	pool->wait(&counter);
+
+	m_pNodes->resize(m_numNodes);
+}
+
+//=================================================================================================
+void eve::scene::Bvh::buildNode(uint32_t p_node, uint32_t p_depth, uint32_t p_begin, uint32_t p_end, const float * p_pBoxes, const float * p_pCentroids, eve::thr::TaskCounter * p_pCounter)
+{
+	using namespace eve::__scene_internal;
+
+	// Nodes array is sized once, references are stable while sub-trees are built concurrently.
+	eve::scene::BvhNode & node = (*m_pNodes)[p_node];
+	uint32_t * indices = m_pIndices->data();
+
+	// Node and centroids bounds.
+	float cmin[3], cmax[3];
+	bounds_reset(node.min, node.max);
+	bounds_reset(cmin, cmax);
+	for (uint32_t i = p_begin; i < p_end; i++)
+	{
+		const float * c = p_pCentroids + indices[i] * 3;
+		float box[6] = { c[0], c[1], c[2], c[0], c[1], c[2] };
+		bounds_grow(node.min, node.max, p_pBoxes + indices[i] * 6);
+		bounds_grow(cmin, cmax, box);
+	}
+
+	const uint32_t count = p_end - p_begin;
+	node.first = p_begin;
+	node.count = count;
+	// Depth is capped so fixed size traversal stacks cannot overflow, degenerate inputs get larger leaves.
+	if (count <= BVH_LEAF_MIN || p_depth >= BVH_DEPTH_MAX) return;
+
+	// Binned SAH, split is between bins [0, bestBin[ and [bestBin, BVH_BINS[.
+	int32_t  bestAxis = -1;
+	uint32_t bestBin  = 0;
+	float	 bestCost = FLT_MAX;
+	for (int32_t axis = 0; axis < 3; axis++)
+	{
+		float extent = cmax[axis] - cmin[axis];
+		if (extent <= 0.0f) continue;
+
+		BvhBin bins[BVH_BINS];
+		for (uint32_t b = 0; b < BVH_BINS; b++)
+		{
+			bounds_reset(bins[b].min, bins[b].max);
+			bins[b].count = 0;
+		}
+
+		float scale = (static_cast<float>(BVH_BINS) * 0.9999f) / extent;
+		for (uint32_t i = p_begin; i < p_end; i++)
+		{
+			uint32_t b = static_cast<uint32_t>((p_pCentroids[indices[i] * 3 + axis] - cmin[axis]) * scale);
+			bins[b].count++;
+			bounds_grow(bins[b].min, bins[b].max, p_pBoxes + indices[i] * 6);
+		}
+
+		// Left sweep.
+		float	 leftArea[BVH_BINS];
+		uint32_t leftCount[BVH_BINS];
+		float	 bmin[3], bmax[3];
+		uint32_t sum = 0;
+		bounds_reset(bmin, bmax);
+		for (uint32_t b = 0; b < BVH_BINS - 1; b++)
+		{
+			float box[6] = { bins[b].min[0], bins[b].min[1], bins[b].min[2], bins[b].max[0], bins[b].max[1], bins[b].max[2] };
+			if (bins[b].count > 0) bounds_grow(bmin, bmax, box);
+			sum			+= bins[b].count;
+			leftCount[b] = sum;
+			leftArea[b]	 = bounds_area(bmin, bmax);
+		}
+
+		// Right sweep and cost evaluation.
+		sum = 0;
+		bounds_reset(bmin, bmax);
+		for (uint32_t b = BVH_BINS - 1; b > 0; b--)
+		{
+			float box[6] = { bins[b].min[0], bins[b].min[1], bins[b].min[2], bins[b].max[0], bins[b].max[1], bins[b].max[2] };
+			if (bins[b].count > 0) bounds_grow(bmin, bmax, box);
+			sum += bins[b].count;
+
+			if (sum == 0 || leftCount[b - 1] == 0) continue;
+
+			float cost = leftArea[b - 1] * leftCount[b - 1] + bounds_area(bmin, bmax) * sum;
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin	 = b;
+			}
+		}
+	}
+
+	uint32_t mid = p_begin;
+	if (bestAxis >= 0)
+	{
+		// Keep leaf when splitting does not pay.
+		float nodeArea = bounds_area(node.min, node.max);
+		if (count <= BVH_LEAF_MAX && bestCost + BVH_TRAVERSAL_COST * nodeArea >= nodeArea * count) return;
+
+		float	 scale = (static_cast<float>(BVH_BINS) * 0.9999f) / (cmax[bestAxis] - cmin[bestAxis]);
+		float	 cminAxis = cmin[bestAxis];
+		uint32_t axis  = static_cast<uint32_t>(bestAxis);
+		uint32_t * itr = std::partition(indices + p_begin, indices + p_end, [=](uint32_t p_index)
+		{
+			return static_cast<uint32_t>((p_pCentroids[p_index * 3 + axis] - cminAxis) * scale) < bestBin;
+		});
+		mid = static_cast<uint32_t>(itr - indices);
+	}
+	else
+	{
+		// All centroids are equal, split in half when range is too large.
+		if (count <= BVH_LEAF_MAX) return;
+		mid = p_begin + count / 2;
+	}
+
+	// Allocate children pair.
+	uint32_t left = static_cast<uint32_t>(::InterlockedExchangeAdd(&m_numNodes, 2));
+	node.first = left;
+	node.count = 0;
+
+	if (count > BVH_PARALLEL_MIN)
+	{
+		eve::thr::TaskPool::get_instance()->push([=](void)
+		{
+			this->buildNode(left, p_depth + 1, p_begin, mid, p_pBoxes, p_pCentroids, p_pCounter);
+		}, p_pCounter);
+	}
+	else
+	{
+		this->buildNode(left, p_depth + 1, p_begin, mid, p_pBoxes, p_pCentroids, p_pCounter);
+	}
+	this->buildNode(left + 1, p_depth + 1, mid, p_end, p_pBoxes, p_pCentroids, p_pCounter);
+}
+
+//=================================================================================================
+void eve::scene::Bvh::refit(const float * p_pBoxes)
+{
+	using namespace eve::__scene_internal;
+
+	// Children are always allocated after their parent, reverse order is bottom-up.
+	for (int32_t n = static_cast<int32_t>(m_numNodes) - 1; n >= 0; n--)
+	{
+		eve::scene::BvhNode & node = (*m_pNodes)[n];
+		bounds_reset(node.min, node.max);
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; i++) {
+				bounds_grow(node.min, node.max, p_pBoxes + (*m_pIndices)[i] * 6);
+			}
+		}
+		else if (node.first > 0)
+		{
+			for (uint32_t c = node.first; c < node.first + 2; c++)
+			{
+				const eve::scene::BvhNode & child = (*m_pNodes)[c];
+				float box[6] = { child.min[0], child.min[1], child.min[2], child.max[0], child.max[1], child.max[2] };
+				bounds_grow(node.min, node.max, box);
+			}
+		}
+	}
+}
+
+
+
+//=================================================================================================
+bool eve::scene::Bvh::intersect_node(const eve::scene::BvhNode & p_node, const eve::scene::BvhRay & p_ray, float p_tmax, float & p_tnear)
+{
+	float t1 = (p_node.min[0] - p_ray.origin[0]) * p_ray.invDir[0];
+	float t2 = (p_node.max[0] - p_ray.origin[0]) * p_ray.invDir[0];
+	float tmin = std::min(t1, t2);
+	float tmax = std::max(t1, t2);
+
+	t1 = (p_node.min[1] - p_ray.origin[1]) * p_ray.invDir[1];
+	t2 = (p_node.max[1] - p_ray.origin[1]) * p_ray.invDir[1];
+	tmin = std::max(tmin, std::min(t1, t2));
+	tmax = std::min(tmax, std::max(t1, t2));
+
+	t1 = (p_node.min[2] - p_ray.origin[2]) * p_ray.invDir[2];
+	t2 = (p_node.max[2] - p_ray.origin[2]) * p_ray.invDir[2];
+	tmin = std::max(tmin, std::min(t1, t2));
+	tmax = std::min(tmax, std::max(t1, t2));
+
+	p_tnear = tmin;
+	return (tmax >= std::max(tmin, 0.0f)) && (tmin < p_tmax);
+}
+
+//=================================================================================================
+bool eve::scene::Bvh::overlap_node(const eve::scene::BvhNode & p_node, const float * p_min, const float * p_max)
+{
+	return (p_node.min[0] <= p_max[0] && p_node.max[0] >= p_min[0])
+		&& (p_node.min[1] <= p_max[1] && p_node.max[1] >= p_min[1])
+		&& (p_node.min[2] <= p_max[2] && p_node.max[2] >= p_min[2]);
+}
+
+//=================================================================================================
+bool eve::scene::Bvh::overlap_node(const eve::scene::BvhNode & p_node, const eve::vec4f * p_pPlanes)
+{
+	for (size_t i = 0; i < 6; i++)
+	{
+		const eve::vec4f & plane = p_pPlanes[i];
+		// Positive vertex, farthest along plane normal.
+		float x = (plane.x >= 0.0f) ? p_node.max[0] : p_node.min[0];
+		float y = (plane.y >= 0.0f) ? p_node.max[1] : p_node.min[1];
+		float z = (plane.z >= 0.0f) ? p_node.max[2] : p_node.min[2];
+		if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+eve::math::Boxf eve::scene::Bvh::getBounds(void) const
+{
+	const eve::scene::BvhNode & root = m_pNodes->front();
+	return eve::math::Boxf(eve::vec3f(root.min[0], root.min[1], root.min[2]), eve::vec3f(root.max[0], root.max[1], root.max[2]));
+}
+
+
+
+//=================================================================================================
+eve::scene::BvhMesh * eve::scene::BvhMesh::create_ptr(const eve::ogl::Vao * p_pVao)
+{
+	EVE_ASSERT(p_pVao);
+
+	eve::scene::BvhMesh * ptr = new eve::scene::BvhMesh(p_pVao);
+	ptr->init();
+	return ptr;
+}
+
+//=================================================================================================
+eve::scene::BvhMesh::BvhMesh(const eve::ogl::Vao * p_pVao)
+	// Inheritance
+	: eve::scene::Bvh()
+	// Members init
+	, m_pVertices(p_pVao->getVertices())
+	, m_pTriangles(p_pVao->getIndices())
+	, m_stride(p_pVao->getPerVertexNumPosition() + p_pVao->getPerVertexNumDiffuse() + p_pVao->getPerVertexNumNormal())
+	, m_numTriangles(static_cast<uint32_t>(p_pVao->getNumIndices() / 3))
+{}
+
+
+
+//=================================================================================================
+void eve::scene::BvhMesh::init(void)
+{
+	// Call parent class.
+	eve::scene::Bvh::init();
+
+	const float *  vertices  = m_pVertices.get();
+	const GLuint * triangles = m_pTriangles.get();
+
+	// Triangles boxes.
+	std::vector<float> boxes(m_numTriangles * 6);
+	eve::thr::TaskPool::get_instance()->parallel_for(0, m_numTriangles, 4096, [&](size_t p_begin, size_t p_end)
+	{
+		for (size_t t = p_begin; t < p_end; t++)
+		{
+			float * box = &boxes[t * 6];
+			eve::__scene_internal::bounds_reset(box, box + 3);
+			for (size_t k = 0; k < 3; k++)
+			{
+				const float * p = vertices + triangles[t * 3 + k] * m_stride;
+				float point[6] = { p[0], p[1], p[2], p[0], p[1], p[2] };
+				eve::__scene_internal::bounds_grow(box, box + 3, point);
+			}
+		}
+	});
+
+	this->build(boxes.data(), m_numTriangles);
+}
+
+//=================================================================================================
+void eve::scene::BvhMesh::release(void)
+{
+	// Do not delete -> shared pointers.
+	m_pVertices.reset();
+	m_pTriangles.reset();
+
+	// Call parent class.
+	eve::scene::Bvh::release();
+}
+
+
+
+//=================================================================================================
+bool eve::scene::BvhMesh::intersectTriangle(uint32_t p_triangle, const eve::scene::BvhRay & p_ray, float p_tmax, float & p_t, float & p_u, float & p_v) const
+{
+	const float *  vertices  = m_pVertices.get();
+	const GLuint * triangles = m_pTriangles.get() + p_triangle * 3;
+
+	const float * v0 = vertices + triangles[0] * m_stride;
+	const float * v1 = vertices + triangles[1] * m_stride;
+	const float * v2 = vertices + triangles[2] * m_stride;
+
+	float e1[3] = { v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2] };
+	float e2[3] = { v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2] };
+
+	// p = dir x e2
+	float p[3] = { p_ray.dir[1] * e2[2] - p_ray.dir[2] * e2[1]
+				 , p_ray.dir[2] * e2[0] - p_ray.dir[0] * e2[2]
+				 , p_ray.dir[0] * e2[1] - p_ray.dir[1] * e2[0] };
+	float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+	// Ray parallel to triangle plane (both faces are hit).
+	if (eve::math::abs(det) < 1e-12f) return false;
+	float invDet = 1.0f / det;
+
+	float s[3] = { p_ray.origin[0] - v0[0], p_ray.origin[1] - v0[1], p_ray.origin[2] - v0[2] };
+	float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * invDet;
+	if (u < 0.0f || u > 1.0f) return false;
+
+	// q = s x e1
+	float q[3] = { s[1] * e1[2] - s[2] * e1[1]
+				 , s[2] * e1[0] - s[0] * e1[2]
+				 , s[0] * e1[1] - s[1] * e1[0] };
+	float v = (p_ray.dir[0] * q[0] + p_ray.dir[1] * q[1] + p_ray.dir[2] * q[2]) * invDet;
+	if (v < 0.0f || u + v > 1.0f) return false;
+
+	float t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * invDet;
+	if (t < 0.0f || t >= p_tmax) return false;
+
+	p_t = t;
+	p_u = u;
+	p_v = v;
+	return true;
+}
+
+//=================================================================================================
+bool eve::scene::BvhMesh::intersect(const eve::scene::BvhRay & p_ray, eve::scene::BvhHit & p_hit, bool p_bAnyHit) const
+{
+	bool ret = false;
+	if (m_numTriangles == 0) return ret;
+
+	uint32_t stack[eve::__scene_internal::BVH_STACK_SIZE];
+	size_t	 top = 0;
+	float	 tnear, tnearLeft, tnearRight;
+	float	 t, u, v;
+
+	const eve::scene::BvhNode * nodes = m_pNodes->data();
+	if (!intersect_node(nodes[0], p_ray, p_hit.t, tnear)) return ret;
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const eve::scene::BvhNode & node = nodes[stack[--top]];
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				uint32_t tri = (*m_pIndices)[i];
+				if (this->intersectTriangle(tri, p_ray, p_hit.t, t, u, v))
+				{
+					p_hit.t		   = t;
+					p_hit.u		   = u;
+					p_hit.v		   = v;
+					p_hit.triangle = tri;
+					ret = true;
+					if (p_bAnyHit) return ret;
+				}
+			}
+			continue;
+		}
+
+		// Visit nearest child first.
+		bool bLeft	= intersect_node(nodes[node.first],		p_ray, p_hit.t, tnearLeft);
+		bool bRight = intersect_node(nodes[node.first + 1], p_ray, p_hit.t, tnearRight);
+		if (bLeft && bRight)
+		{
+			if (tnearLeft <= tnearRight) { stack[top++] = node.first + 1; stack[top++] = node.first;	 }
+			else						 { stack[top++] = node.first;	  stack[top++] = node.first + 1; }
+		}
+		else if (bLeft)  { stack[top++] = node.first;	  }
+		else if (bRight) { stack[top++] = node.first + 1; }
+
+		EVE_ASSERT(top <= eve::__scene_internal::BVH_STACK_SIZE);
+	}
+
+	return ret;
+}
+
+//=================================================================================================
+void eve::scene::BvhMesh::intersect(const eve::scene::BvhRay * p_pRays, size_t p_numRays, eve::scene::BvhHit * p_pHits) const
+{
+	EVE_ASSERT(p_numRays <= EVE_BVH_PACKET_SIZE);
+	if (m_numTriangles == 0 || p_numRays == 0) return;
+
+	uint32_t stack[eve::__scene_internal::BVH_STACK_SIZE];
+	size_t	 top = 0;
+	float	 tnear;
+	float	 t, u, v;
+
+	const eve::scene::BvhNode * nodes = m_pNodes->data();
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const eve::scene::BvhNode & node = nodes[stack[--top]];
+
+		// Rays mask overlapping node, node is skipped when none does.
+		uint32_t mask = 0;
+		for (size_t r = 0; r < p_numRays; r++)
+		{
+			if (intersect_node(node, p_pRays[r], p_pHits[r].t, tnear)) {
+				mask |= (1 << r);
+			}
+		}
+		if (mask == 0) continue;
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				uint32_t tri = (*m_pIndices)[i];
+				for (size_t r = 0; r < p_numRays; r++)
+				{
+					if ((mask & (1 << r)) && this->intersectTriangle(tri, p_pRays[r], p_pHits[r].t, t, u, v))
+					{
+						p_pHits[r].t		= t;
+						p_pHits[r].u		= u;
+						p_pHits[r].v		= v;
+						p_pHits[r].triangle = tri;
+					}
+				}
+			}
+			continue;
+		}
+
+		// Coherent packet, order children using first active ray direction.
+		uint32_t first = 0;
+		while (!(mask & (1 << first))) { first++; }
+		const eve::scene::BvhNode & left  = nodes[node.first];
+		const eve::scene::BvhNode & right = nodes[node.first + 1];
+		float dLeft	 = (left.min[0]  + left.max[0]  - 2.0f * p_pRays[first].origin[0]) * p_pRays[first].dir[0]
+					 + (left.min[1]  + left.max[1]  - 2.0f * p_pRays[first].origin[1]) * p_pRays[first].dir[1]
+					 + (left.min[2]  + left.max[2]  - 2.0f * p_pRays[first].origin[2]) * p_pRays[first].dir[2];
+		float dRight = (right.min[0] + right.max[0] - 2.0f * p_pRays[first].origin[0]) * p_pRays[first].dir[0]
+					 + (right.min[1] + right.max[1] - 2.0f * p_pRays[first].origin[1]) * p_pRays[first].dir[1]
+					 + (right.min[2] + right.max[2] - 2.0f * p_pRays[first].origin[2]) * p_pRays[first].dir[2];
+		if (dLeft <= dRight) { stack[top++] = node.first + 1; stack[top++] = node.first;	 }
+		else				 { stack[top++] = node.first;	  stack[top++] = node.first + 1; }
+
+		EVE_ASSERT(top <= eve::__scene_internal::BVH_STACK_SIZE);
+	}
+}
+
+
+
+//=================================================================================================
+eve::scene::BvhScene::BvhScene(void)
+	// Inheritance
+	: eve::scene::Bvh()
+	// Members init
+	, m_pVecMesh(nullptr)
+	, m_pBoxes(nullptr)
+	, m_pVecInverse(nullptr)
+{}
+
+
+
+//=================================================================================================
+void eve::scene::BvhScene::init(void)
+{
+	// Call parent class.
+	eve::scene::Bvh::init();
+
+	m_pVecMesh		= new std::vector<eve::scene::Mesh*>();
+	m_pBoxes		= new std::vector<float>();
+	m_pVecInverse	= new std::vector<eve::mat44f>();
+}
+
+//=================================================================================================
+void eve::scene::BvhScene::release(void)
+{
+	// Do not delete content -> shared pointers.
+	EVE_RELEASE_PTR_CPP(m_pVecMesh);
+	EVE_RELEASE_PTR_CPP(m_pBoxes);
+	EVE_RELEASE_PTR_CPP(m_pVecInverse);
+
+	// Call parent class.
+	eve::scene::Bvh::release();
+}
+
+
+
+//=================================================================================================
+void eve::scene::BvhScene::updateMesh(size_t p_index)
+{
+	eve::scene::Mesh * mesh = (*m_pVecMesh)[p_index];
+
+	const eve::math::Boxf & box = mesh->getBoxWorld();
+	float * dst = &(*m_pBoxes)[p_index * 6];
+	dst[0] = box.getMin().x;	dst[1] = box.getMin().y;	dst[2] = box.getMin().z;
+	dst[3] = box.getMax().x;	dst[4] = box.getMax().y;	dst[5] = box.getMax().z;
+
+	(*m_pVecInverse)[p_index] = mesh->getMatrixWorld().inverted();
+}
+
+//=================================================================================================
+void eve::scene::BvhScene::build(const std::vector<eve::scene::Mesh*> & p_vecMesh)
+{
+	(*m_pVecMesh) = p_vecMesh;
+	m_pBoxes->resize(m_pVecMesh->size() * 6);
+	m_pVecInverse->resize(m_pVecMesh->size());
+
+	eve::thr::TaskPool::get_instance()->parallel_for(0, m_pVecMesh->size(), 256, [this](size_t p_begin, size_t p_end)
+	{
+		for (size_t i = p_begin; i < p_end; i++) {
+			this->updateMesh(i);
+		}
+	});
+
+	eve::scene::Bvh::build(m_pBoxes->data(), static_cast<uint32_t>(m_pVecMesh->size()));
+}
+
+//=================================================================================================
+void eve::scene::BvhScene::refit(void)
+{
+	eve::thr::TaskPool::get_instance()->parallel_for(0, m_pVecMesh->size(), 256, [this](size_t p_begin, size_t p_end)
+	{
+		for (size_t i = p_begin; i < p_end; i++) {
+			this->updateMesh(i);
+		}
+	});
+
+	eve::scene::Bvh::refit(m_pBoxes->data());
+}
+
+
+
+//=================================================================================================
+bool eve::scene::BvhScene::intersect(const eve::math::Rayf & p_ray, eve::scene::BvhHit * p_pHit, bool p_bAnyHit) const
+{
+	EVE_ASSERT(p_pHit);
+
+	bool ret = false;
+	if (m_pVecMesh->empty()) return ret;
+
+	eve::scene::BvhRay ray(p_ray.getOrigin(), p_ray.getDirection());
+
+	uint32_t stack[eve::__scene_internal::BVH_STACK_SIZE];
+	size_t	 top = 0;
+	float	 tnear;
+
+	const eve::scene::BvhNode * nodes = m_pNodes->data();
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const eve::scene::BvhNode & node = nodes[stack[--top]];
+		if (!intersect_node(node, ray, p_pHit->t, tnear)) continue;
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				uint32_t index = (*m_pIndices)[i];
+				eve::scene::Mesh * mesh = (*m_pVecMesh)[index];
+				if (!mesh->getBvh()) continue;
+
+				// Object space ray, direction is not normalized so distances are kept.
+				const eve::mat44f & inverse = (*m_pVecInverse)[index];
+				eve::scene::BvhRay local(inverse.transformPointAffine(p_ray.getOrigin()), inverse.transformVec(p_ray.getDirection()));
+
+				if (mesh->getBvh()->intersect(local, *p_pHit, p_bAnyHit))
+				{
+					p_pHit->pMesh = mesh;
+					ret = true;
+					if (p_bAnyHit) return ret;
+				}
+			}
+			continue;
+		}
+
+		stack[top++] = node.first + 1;
+		stack[top++] = node.first;
+		EVE_ASSERT(top <= eve::__scene_internal::BVH_STACK_SIZE);
+	}
+
+	return ret;
+}
+
+//=================================================================================================
+void eve::scene::BvhScene::intersectPacket(const eve::scene::BvhRay * p_pRays, size_t p_numRays, eve::scene::BvhHit * p_pHits) const
+{
+	uint32_t stack[eve::__scene_internal::BVH_STACK_SIZE];
+	size_t	 top = 0;
+	float	 tnear;
+
+	eve::scene::BvhRay local[EVE_BVH_PACKET_SIZE];
+	eve::scene::BvhHit hits[EVE_BVH_PACKET_SIZE];
+
+	const eve::scene::BvhNode * nodes = m_pNodes->data();
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const eve::scene::BvhNode & node = nodes[stack[--top]];
+
+		uint32_t mask = 0;
+		for (size_t r = 0; r < p_numRays; r++)
+		{
+			if (intersect_node(node, p_pRays[r], p_pHits[r].t, tnear)) {
+				mask |= (1 << r);
+			}
+		}
+		if (mask == 0) continue;
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				uint32_t index = (*m_pIndices)[i];
+				eve::scene::Mesh * mesh = (*m_pVecMesh)[index];
+				if (!mesh->getBvh()) continue;
+
+				// Object space packet.
+				const eve::mat44f & inverse = (*m_pVecInverse)[index];
+				for (size_t r = 0; r < p_numRays; r++)
+				{
+					const eve::scene::BvhRay & ray = p_pRays[r];
+					local[r] = eve::scene::BvhRay(inverse.transformPointAffine(eve::vec3f(ray.origin[0], ray.origin[1], ray.origin[2]))
+												, inverse.transformVec(eve::vec3f(ray.dir[0], ray.dir[1], ray.dir[2])));
+					hits[r]		= eve::scene::BvhHit();
+					hits[r].t	= p_pHits[r].t;
+				}
+
+				mesh->getBvh()->intersect(local, p_numRays, hits);
+
+				for (size_t r = 0; r < p_numRays; r++)
+				{
+					if (hits[r].hit())
+					{
+						p_pHits[r]		 = hits[r];
+						p_pHits[r].pMesh = mesh;
+					}
+				}
+			}
+			continue;
+		}
+
+		stack[top++] = node.first + 1;
+		stack[top++] = node.first;
+		EVE_ASSERT(top <= eve::__scene_internal::BVH_STACK_SIZE);
+	}
+}
+
+//=================================================================================================
+void eve::scene::BvhScene::intersect(const eve::math::Rayf * p_pRays, size_t p_numRays, eve::scene::BvhHit * p_pHits) const
+{
+	EVE_ASSERT(p_pRays);
+	EVE_ASSERT(p_pHits);
+	if (m_pVecMesh->empty()) return;
+
+	const size_t numPackets = (p_numRays + EVE_BVH_PACKET_SIZE - 1) / EVE_BVH_PACKET_SIZE;
+	eve::thr::TaskPool::get_instance()->parallel_for(0, numPackets, 4, [&](size_t p_begin, size_t p_end)
+	{
+		eve::scene::BvhRay rays[EVE_BVH_PACKET_SIZE];
+		for (size_t p = p_begin; p < p_end; p++)
+		{
+			size_t first = p * EVE_BVH_PACKET_SIZE;
+			size_t count = std::min(static_cast<size_t>(EVE_BVH_PACKET_SIZE), p_numRays - first);
+			for (size_t r = 0; r < count; r++) {
+				rays[r] = eve::scene::BvhRay(p_pRays[first + r].getOrigin(), p_pRays[first + r].getDirection());
+			}
+			this->intersectPacket(rays, count, p_pHits + first);
+		}
+	});
+}
+
+
+
+//=================================================================================================
+void eve::scene::BvhScene::query(const eve::math::Boxf & p_box, std::vector<eve::scene::Mesh*> & p_result) const
+{
+	if (m_pVecMesh->empty()) return;
+
+	float bmin[3] = { p_box.getMin().x, p_box.getMin().y, p_box.getMin().z };
+	float bmax[3] = { p_box.getMax().x, p_box.getMax().y, p_box.getMax().z };
+
+	uint32_t stack[eve::__scene_internal::BVH_STACK_SIZE];
+	size_t	 top = 0;
+
+	const eve::scene::BvhNode * nodes = m_pNodes->data();
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const eve::scene::BvhNode & node = nodes[stack[--top]];
+		if (!overlap_node(node, bmin, bmax)) continue;
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				uint32_t index = (*m_pIndices)[i];
+				const float * box = &(*m_pBoxes)[index * 6];
+				if (box[0] <= bmax[0] && box[3] >= bmin[0] && box[1] <= bmax[1] && box[4] >= bmin[1] && box[2] <= bmax[2] && box[5] >= bmin[2]) {
+					p_result.push_back((*m_pVecMesh)[index]);
+				}
+			}
+			continue;
+		}
+
+		stack[top++] = node.first + 1;
+		stack[top++] = node.first;
+	}
+}
+
+//=================================================================================================
+void eve::scene::BvhScene::query(const eve::vec4f * p_pPlanes, std::vector<eve::scene::Mesh*> & p_result) const
+{
+	EVE_ASSERT(p_pPlanes);
+	if (m_pVecMesh->empty()) return;
+
+	uint32_t stack[eve::__scene_internal::BVH_STACK_SIZE];
+	size_t	 top = 0;
+
+	const eve::scene::BvhNode * nodes = m_pNodes->data();
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const eve::scene::BvhNode & node = nodes[stack[--top]];
+		if (!overlap_node(node, p_pPlanes)) continue;
+
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				uint32_t index = (*m_pIndices)[i];
+				const float * box = &(*m_pBoxes)[index * 6];
+
+				eve::scene::BvhNode leaf;
+				leaf.min[0] = box[0]; leaf.min[1] = box[1]; leaf.min[2] = box[2];
+				leaf.max[0] = box[3]; leaf.max[1] = box[4]; leaf.max[2] = box[5];
+				if (overlap_node(leaf, p_pPlanes)) {
+					p_result.push_back((*m_pVecMesh)[index]);
+				}
+			}
+			continue;
+		}
+
+		stack[top++] = node.first + 1;
+		stack[top++] = node.first;
+	}
+}
@@ -0,0 +1,345 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_SCENE_BVH_H__
+#define __EVE_SCENE_BVH_H__
+
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MATH_INCLUDES_H__
+#include "eve/math/Includes.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_VAO_H__
+#include "eve/ogl/core/Vao.h"
+#endif
+
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#include "eve/thr/TaskPool.h"
+#endif
+
+
+namespace eve { namespace scene { class Mesh; } }
+
+
+/** \def EVE_BVH_PACKET_SIZE \brief Maximum rays amount traversed together in ray packets. */
+#define EVE_BVH_PACKET_SIZE		16
+
+
+namespace eve
+{
+	namespace scene
+	{
+		/** 
+		* \struct eve::scene::BvhNode
+		* \brief Bounding volume hierarchy node, 32 bytes.
+		* Inner node children are stored side by side at index \a first and \a first + 1.
+		*/
+		struct BvhNode
+		{
+			float			min[3];			//!< Bounds min.
+			uint32_t		first;			//!< Leaf: first primitive in indices array, inner node: left child index.
+			float			max[3];			//!< Bounds max.
+			uint32_t		count;			//!< Leaf: primitives amount, inner node: 0.
+		};
+
+
+		/** 
+		* \struct eve::scene::BvhRay
+		* \brief Bounding volume hierarchy traversal ray, origin + direction * t with t in [0, tmax].
+		*/
+		struct BvhRay
+		{
+			float			origin[3];		//!< Ray origin.
+			float			dir[3];			//!< Ray direction (not required to be normalized).
+			float			invDir[3];		//!< Ray inverse direction.
+
+			BvhRay(void) {}
+			BvhRay(const eve::vec3f & p_origin, const eve::vec3f & p_direction);
+		};
+
+
+		/** 
+		* \struct eve::scene::BvhHit
+		* \brief Ray cast hit record.
+		*/
+		struct BvhHit
+		{
+			float					t;			//!< Ray parameter, FLT_MAX if no hit. Used as max distance on query.
+			float					u;			//!< Triangle barycentric coordinate (vertex 1 weight).
+			float					v;			//!< Triangle barycentric coordinate (vertex 2 weight).
+			uint32_t				triangle;	//!< Triangle index in hit mesh full resolution level.
+			eve::scene::Mesh *		pMesh;		//!< Hit mesh (shared pointer), nullptr on mesh level queries.
+
+			BvhHit(void) : t(FLT_MAX), u(0.0f), v(0.0f), triangle(0xFFFFFFFF), pMesh(nullptr) {}
+
+			/** \brief Get hit state. */
+			bool hit(void) const { return triangle != 0xFFFFFFFF; }
+		};
+
+
+
+		/**
+		* \class eve::scene::Bvh
+		*
+		* \brief Bounding volume hierarchy base class, binned surface area heuristic build over primitives boxes.
+		* Large ranges are built in parallel using eve::thr::TaskPool, nodes can be refitted keeping topology.
+		*
+		* \note extends eve::mem::Pointer
+		*/
+		class Bvh
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATAS				//
+			//////////////////////////////////////
+
+		protected:
+			std::vector<eve::scene::BvhNode> *		m_pNodes;			//!< Specifies nodes, root is node 0.
+			std::vector<uint32_t> *					m_pIndices;			//!< Specifies primitives indices, leaves reference contiguous ranges.
+			volatile LONG							m_numNodes;			//!< Specifies used nodes amount (atomic during build).
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(Bvh);
+			EVE_PROTECT_DESTRUCTOR(Bvh);
+
+		protected:
+			/** \brief Class constructor. */
+			explicit Bvh(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		protected:
+			/** \brief Build hierarchy from primitives boxes, 6 floats per primitive (min xyz, max xyz). */
+			void build(const float * p_pBoxes, uint32_t p_numPrims);
+			/** \brief Refit nodes bounds from primitives boxes, hierarchy topology is kept. */
+			void refit(const float * p_pBoxes);
+
+		private:
+			/** \brief Build node \a p_node of depth \a p_depth over indices range [p_begin, p_end[, children subtrees may be pushed as tasks. */
+			void buildNode(uint32_t p_node, uint32_t p_depth, uint32_t p_begin, uint32_t p_end, const float * p_pBoxes, const float * p_pCentroids, eve::thr::TaskCounter * p_pCounter);
+
+
+		public:
+			/** \brief Ray/node slab test, \a p_tnear receives entry distance. */
+			static bool intersect_node(const eve::scene::BvhNode & p_node, const eve::scene::BvhRay & p_ray, float p_tmax, float & p_tnear);
+			/** \brief Box/node overlap test. */
+			static bool overlap_node(const eve::scene::BvhNode & p_node, const float * p_min, const float * p_max);
+			/** \brief Frustum planes (ax + by + cz + d >= 0 inside)/node overlap test, conservative. */
+			static bool overlap_node(const eve::scene::BvhNode & p_node, const eve::vec4f * p_pPlanes);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get nodes amount. */
+			const uint32_t getNumNodes(void) const;
+			/** \brief Get root bounds. */
+			eve::math::Boxf getBounds(void) const;
+
+		}; // class Bvh
+
+
+
+		/**
+		* \class eve::scene::BvhMesh
+		*
+		* \brief Object space triangles bounding volume hierarchy of a mesh, shares VAO vertices/indices memory.
+		*
+		* \note extends eve::scene::Bvh
+		*/
+		class BvhMesh final
+			: public eve::scene::Bvh
+		{
+
+			//////////////////////////////////////
+			//				DATAS				//
+			//////////////////////////////////////
+
+		private:
+			std::shared_ptr<float>		m_pVertices;		//!< Specifies vertices data (shared with VAO).
+			std::shared_ptr<GLuint>		m_pTriangles;		//!< Specifies indices data (shared with VAO).
+			size_t						m_stride;			//!< Specifies per vertex floats amount.
+			uint32_t					m_numTriangles;		//!< Specifies triangles amount.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(BvhMesh);
+			EVE_PUBLIC_DESTRUCTOR(BvhMesh);
+
+		public:
+			/** \brief Create, init and return new pointer based on VAO \a p_pVao data. */
+			static eve::scene::BvhMesh * create_ptr(const eve::ogl::Vao * p_pVao);
+
+		private:
+			/** \brief Class constructor. */
+			explicit BvhMesh(const eve::ogl::Vao * p_pVao);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** 
+			* \brief Cast object space ray, \a p_hit.t is used as max distance and updated on closer hit.
+			* \param p_bAnyHit stop on first hit found (occlusion queries).
+			*/
+			bool intersect(const eve::scene::BvhRay & p_ray, eve::scene::BvhHit & p_hit, bool p_bAnyHit = false) const;
+			/** \brief Cast object space rays packet (at most EVE_BVH_PACKET_SIZE rays) traversing hierarchy once. */
+			void intersect(const eve::scene::BvhRay * p_pRays, size_t p_numRays, eve::scene::BvhHit * p_pHits) const;
+
+
+		private:
+			/** \brief Moller-Trumbore ray/triangle test. */
+			bool intersectTriangle(uint32_t p_triangle, const eve::scene::BvhRay & p_ray, float p_tmax, float & p_t, float & p_u, float & p_v) const;
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get triangles amount. */
+			const uint32_t getNumTriangles(void) const;
+
+		}; // class BvhMesh
+
+
+
+		/**
+		* \class eve::scene::BvhScene
+		*
+		* \brief World space bounding volume hierarchy over scene meshes instances.
+		* Leaves reference meshes, whose own triangles hierarchy is traversed in object space.
+		*
+		* \note extends eve::scene::Bvh
+		*/
+		class BvhScene final
+			: public eve::scene::Bvh
+		{
+
+			//////////////////////////////////////
+			//				DATAS				//
+			//////////////////////////////////////
+
+		private:
+			std::vector<eve::scene::Mesh*> *		m_pVecMesh;			//!< Specifies meshes (shared pointers).
+			std::vector<float> *					m_pBoxes;			//!< Specifies meshes world space boxes.
+			std::vector<eve::mat44f> *				m_pVecInverse;		//!< Specifies meshes world to object space matrices.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(BvhScene);
+			EVE_PUBLIC_DESTRUCTOR(BvhScene);
+
+		public:
+			/** \brief Class constructor. */
+			explicit BvhScene(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Build hierarchy over meshes \a p_vecMesh. */
+			void build(const std::vector<eve::scene::Mesh*> & p_vecMesh);
+			/** \brief Refit hierarchy to meshes current transforms. */
+			void refit(void);
+
+		private:
+			/** \brief Update mesh \a p_index world box and inverse matrix. */
+			void updateMesh(size_t p_index);
+
+
+		public:
+			/** \brief Cast world space ray, return true on hit. \a p_bAnyHit stops on first hit found (occlusion queries). */
+			bool intersect(const eve::math::Rayf & p_ray, eve::scene::BvhHit * p_pHit, bool p_bAnyHit = false) const;
+			/** \brief Cast world space rays, closest hits, coherent rays should be contiguous. Packets are dispatched in parallel. */
+			void intersect(const eve::math::Rayf * p_pRays, size_t p_numRays, eve::scene::BvhHit * p_pHits) const;
+
+		private:
+			/** \brief Cast world space rays packet (at most EVE_BVH_PACKET_SIZE rays). */
+			void intersectPacket(const eve::scene::BvhRay * p_pRays, size_t p_numRays, eve::scene::BvhHit * p_pHits) const;
+
+
+		public:
+			/** \brief Gather meshes whose world box overlaps \a p_box. */
+			void query(const eve::math::Boxf & p_box, std::vector<eve::scene::Mesh*> & p_result) const;
+			/** \brief Gather meshes whose world box overlaps frustum \a p_pPlanes (6 planes, ax + by + cz + d >= 0 inside). */
+			void query(const eve::vec4f * p_pPlanes, std::vector<eve::scene::Mesh*> & p_result) const;
+
+		}; // class BvhScene
+
+	} // namespace scene
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const uint32_t eve::scene::Bvh::getNumNodes(void) const			{ return static_cast<uint32_t>(m_numNodes); }
+EVE_FORCE_INLINE const uint32_t eve::scene::BvhMesh::getNumTriangles(void) const	{ return m_numTriangles; }
+
+#endif // __EVE_SCENE_BVH_H__
@@ -240,6 +240,19 @@ void eve::scene::Camera::cb_evtSceneCamera(eve::scene::EventArgsSceneCamera & p_
 
 
 
+//=================================================================================================
+void eve::scene::Camera::capture(eve::scene::CameraFrame * p_pFrame) const
+{
+	EVE_ASSERT(p_pFrame);
+
+	p_pFrame->modelView	 = this->getMatrixModelView();
+	p_pFrame->projection = this->getMatrixProjection();
+	p_pFrame->width		 = this->getDisplayWidth();
+	p_pFrame->height	 = this->getDisplayHeight();
+}
+
+
+
 //=================================================================================================
 void eve::scene::Camera::oglBind(void)
 {
@@ -55,6 +55,20 @@ namespace eve
 {
 	namespace scene
 	{
+		/**
+		* \struct eve::scene::CameraFrame
+		* \brief Camera matrices and display size captured with a draw list, bound when this draw list is displayed.
+		*/
+		struct CameraFrame
+		{
+			eve::mat44f		modelView;		//!< Model view matrix.
+			eve::mat44f		projection;		//!< Projection matrix.
+			float			width;			//!< Display width.
+			float			height;			//!< Display height.
+
+			CameraFrame(void) : modelView(), projection(), width(0.0f), height(0.0f) {}
+		};
+
 
 		/** 
 		* \class eve::scene::Camera
@@ -125,6 +139,11 @@ namespace eve
 			virtual void cb_evtSceneCamera(eve::scene::EventArgsSceneCamera & p_args) override;
 
 
+		public:
+			/** \brief Copy current matrices and display size to \a p_pFrame. */
+			void capture(eve::scene::CameraFrame * p_pFrame) const;
+
+
 		public:
 			/** \brief Bind matrices buffer. */
 			void oglBind(void);
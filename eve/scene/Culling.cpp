@@ -0,0 +1,205 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/scene/Culling.h"
+
+#ifndef __EVE_SCENE_MESH_H__
+#include "eve/scene/Mesh.h"
+#endif
+
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#include "eve/thr/TaskPool.h"
+#endif
+
+#include <xmmintrin.h>
+
+
+//=================================================================================================
+eve::scene::Culling::Culling(void)
+	// Inheritance
+	: eve::mem::Pointer()
+	// Members init
+	, m_pBounds(nullptr)
+	, m_capacity(0)
+	, m_pVisible(nullptr)
+	, m_bParallel(true)
+	, m_parallelMin(4096)
+	, m_stats()
+	, m_statsTotal()
+{}
+
+
+
+//=================================================================================================
+void eve::scene::Culling::init(void)
+{
+	m_pVisible = new std::vector<uint8_t>();
+	this->reserve(64);
+}
+
+//=================================================================================================
+void eve::scene::Culling::release(void)
+{
+	eve::mem::align_free(m_pBounds);
+	m_pBounds  = nullptr;
+	m_capacity = 0;
+
+	EVE_RELEASE_PTR_CPP(m_pVisible);
+}
+
+
+
+//=================================================================================================
+void eve::scene::Culling::reserve(size_t p_numBoxes)
+{
+	if (p_numBoxes <= m_capacity) return;
+
+	// Whole SIMD lanes, tail lanes are never read back.
+	size_t capacity = (p_numBoxes + 3) & ~size_t(3);
+
+	eve::mem::align_free(m_pBounds);
+	m_pBounds  = (float*)eve::mem::align_malloc(16, capacity * 6 * sizeof(float));
+	m_capacity = capacity;
+
+	// Tail lanes hold empty boxes.
+	for (size_t i = 0; i < 6 * capacity; i++) {
+		m_pBounds[i] = (i < 3 * capacity) ? FLT_MAX : -FLT_MAX;
+	}
+}
+
+//=================================================================================================
+void eve::scene::Culling::cullRange(const std::vector<eve::scene::Mesh*> & p_vecMesh, const eve::vec4f * p_pPlanes, size_t p_begin, size_t p_end)
+{
+	float * minX = m_pBounds;
+	float * minY = m_pBounds + m_capacity;
+	float * minZ = m_pBounds + m_capacity * 2;
+	float * maxX = m_pBounds + m_capacity * 3;
+	float * maxY = m_pBounds + m_capacity * 4;
+	float * maxZ = m_pBounds + m_capacity * 5;
+
+	// Gather world boxes in SoA layout.
+	for (size_t i = p_begin; i < p_end; i++)
+	{
+		const eve::math::TBox<float> & box = p_vecMesh[i]->getBoxWorld();
+		minX[i] = box.getMin().x;	minY[i] = box.getMin().y;	minZ[i] = box.getMin().z;
+		maxX[i] = box.getMax().x;	maxY[i] = box.getMax().y;	maxZ[i] = box.getMax().z;
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+	uint8_t * visible = m_pVisible->data();
+
+	for (size_t i = p_begin; i < p_end; i += 4)
+	{
+		__m128 inside = _mm_cmpeq_ps(zero, zero);
+
+		for (size_t p = 0; p < 6; p++)
+		{
+			const eve::vec4f & plane = p_pPlanes[p];
+
+			// Positive vertex lanes, farthest along plane normal (same selection as TBox::getPositive()).
+			__m128 px = _mm_load_ps((plane.x > 0.0f) ? (maxX + i) : (minX + i));
+			__m128 py = _mm_load_ps((plane.y > 0.0f) ? (maxY + i) : (minY + i));
+			__m128 pz = _mm_load_ps((plane.z > 0.0f) ? (maxZ + i) : (minZ + i));
+
+			__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(plane.x)), _mm_mul_ps(py, _mm_set1_ps(plane.y)))
+								   , _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, zero));
+		}
+
+		int32_t mask = _mm_movemask_ps(inside);
+		size_t	last = std::min(i + 4, p_end);
+		for (size_t j = i; j < last; j++) {
+			visible[j] = static_cast<uint8_t>((mask >> (j - i)) & 1);
+		}
+	}
+}
+
+//=================================================================================================
+void eve::scene::Culling::cull(const std::vector<eve::scene::Mesh*> & p_vecMesh, const eve::math::TCamera<float> * p_pCamera, std::vector<eve::scene::Mesh*> & p_vecVisible)
+{
+	EVE_ASSERT(p_pCamera);
+
+	const size_t numBoxes = p_vecMesh.size();
+	this->reserve(numBoxes);
+	m_pVisible->resize(numBoxes);
+
+	eve::vec4f planes[6];
+	p_pCamera->getFrustumPlanes(planes);
+
+	if (m_bParallel && numBoxes >= m_parallelMin)
+	{
+		// Chunks are rounded to whole SIMD lanes.
+		const size_t numBlocks = (numBoxes + 3) / 4;
+		eve::thr::TaskPool::get_instance()->parallel_for(0, numBlocks, 256, [&](size_t p_begin, size_t p_end)
+		{
+			this->cullRange(p_vecMesh, planes, p_begin * 4, std::min(p_end * 4, numBoxes));
+		});
+	}
+	else
+	{
+		this->cullRange(p_vecMesh, planes, 0, numBoxes);
+	}
+
+	// Draw list.
+	p_vecVisible.clear();
+	for (size_t i = 0; i < numBoxes; i++)
+	{
+		if ((*m_pVisible)[i]) {
+			p_vecVisible.push_back(p_vecMesh[i]);
+		}
+	}
+
+	// Counters.
+	m_stats.numTested	= numBoxes;
+	m_stats.numVisible	= p_vecVisible.size();
+	m_stats.numCulled	= numBoxes - p_vecVisible.size();
+
+	m_statsTotal.numTested	+= m_stats.numTested;
+	m_statsTotal.numVisible += m_stats.numVisible;
+	m_statsTotal.numCulled	+= m_stats.numCulled;
+}
+
+
+
+//=================================================================================================
+bool eve::scene::Culling::is_visible(const eve::math::TBox<float> & p_box, const eve::vec4f * p_pPlanes)
+{
+	for (size_t p = 0; p < 6; p++)
+	{
+		eve::vec3f normal(p_pPlanes[p].x, p_pPlanes[p].y, p_pPlanes[p].z);
+		if (normal.dot(p_box.getPositive(normal)) + p_pPlanes[p].w < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,171 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_SCENE_CULLING_H__
+#define __EVE_SCENE_CULLING_H__
+
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MATH_INCLUDES_H__
+#include "eve/math/Includes.h"
+#endif
+
+
+namespace eve { namespace scene { class Mesh; } }
+
+
+namespace eve
+{
+	namespace scene
+	{
+		/** 
+		* \struct eve::scene::CullStats
+		* \brief Frustum culling counters.
+		*/
+		struct CullStats
+		{
+			uint64_t		numTested;			//!< Tested meshes amount.
+			uint64_t		numVisible;			//!< Visible meshes amount.
+			uint64_t		numCulled;			//!< Culled meshes amount.
+
+			CullStats(void) : numTested(0), numVisible(0), numCulled(0) {}
+		};
+
+
+		/**
+		* \class eve::scene::Culling
+		*
+		* \brief Frustum culling stage, tests meshes world boxes against camera frustum planes.
+		* Boxes are stored as structure of arrays and tested 4 at a time using SSE, large sets are split on eve::thr::TaskPool.
+		*
+		* \note extends eve::mem::Pointer
+		*/
+		class Culling final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATAS				//
+			//////////////////////////////////////
+
+		private:
+			float *						m_pBounds;			//!< Specifies SoA boxes (min x, min y, min z, max x, max y, max z arrays of m_capacity floats, 16 bytes aligned).
+			size_t						m_capacity;			//!< Specifies allocated boxes amount (multiple of 4).
+			std::vector<uint8_t> *		m_pVisible;			//!< Specifies per box visibility result.
+
+		private:
+			bool						m_bParallel;		//!< Specifies whether culling may run on tasks pool.
+			size_t						m_parallelMin;		//!< Specifies boxes amount from which culling runs on tasks pool.
+
+		private:
+			eve::scene::CullStats		m_stats;			//!< Specifies last pass counters.
+			eve::scene::CullStats		m_statsTotal;		//!< Specifies accumulated counters since last reset.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(Culling);
+			EVE_PUBLIC_DESTRUCTOR(Culling);
+
+		public:
+			/** \brief Class constructor. */
+			explicit Culling(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Cull \a p_vecMesh against \a p_pCamera frustum, visible meshes are appended to \a p_vecVisible (cleared first). */
+			void cull(const std::vector<eve::scene::Mesh*> & p_vecMesh, const eve::math::TCamera<float> * p_pCamera, std::vector<eve::scene::Mesh*> & p_vecVisible);
+
+		private:
+			/** \brief Grow SoA storage to hold at least \a p_numBoxes boxes. */
+			void reserve(size_t p_numBoxes);
+			/** \brief Fill and test boxes range [p_begin, p_end[, p_begin being a multiple of 4. */
+			void cullRange(const std::vector<eve::scene::Mesh*> & p_vecMesh, const eve::vec4f * p_pPlanes, size_t p_begin, size_t p_end);
+
+
+		public:
+			/** \brief Test world box \a p_box against frustum \a p_pPlanes (scalar reference path). */
+			static bool is_visible(const eve::math::TBox<float> & p_box, const eve::vec4f * p_pPlanes);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get last pass counters. */
+			const eve::scene::CullStats & getStats(void) const;
+			/** \brief Get accumulated counters since last reset. */
+			const eve::scene::CullStats & getStatsTotal(void) const;
+			/** \brief Reset accumulated counters. */
+			void resetStats(void);
+
+
+		public:
+			/** \brief Get whether culling may run on tasks pool. */
+			const bool getParallel(void) const;
+			/** \brief Set whether culling may run on tasks pool, \a p_minBoxes boxes amount from which parallel culling is used. */
+			void setParallel(bool p_bParallel, size_t p_minBoxes = 4096);
+
+		}; // class Culling
+
+	} // namespace scene
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const eve::scene::CullStats & eve::scene::Culling::getStats(void) const		{ return m_stats;			}
+EVE_FORCE_INLINE const eve::scene::CullStats & eve::scene::Culling::getStatsTotal(void) const	{ return m_statsTotal;		}
+EVE_FORCE_INLINE void eve::scene::Culling::resetStats(void)										{ m_statsTotal = eve::scene::CullStats(); }
+
+//=================================================================================================
+EVE_FORCE_INLINE const bool eve::scene::Culling::getParallel(void) const						{ return m_bParallel;		}
+EVE_FORCE_INLINE void eve::scene::Culling::setParallel(bool p_bParallel, size_t p_minBoxes)	{ m_bParallel = p_bParallel; m_parallelMin = p_minBoxes; }
+
+#endif // __EVE_SCENE_CULLING_H__
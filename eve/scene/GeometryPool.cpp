@@ -0,0 +1,269 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/scene/GeometryPool.h"
+
+#ifndef __EVE_OPENGL_CORE_RENDER_H__
+#include "eve/ogl/core/Renderer.h"
+#endif
+
+#ifndef __EVE_SCENE_MESH_H__
+#include "eve/scene/Mesh.h"
+#endif
+
+
+//=================================================================================================
+eve::scene::GeometryPool * eve::scene::GeometryPool::create_ptr(eve::ogl::Renderer * p_pRenderer)
+{
+	EVE_ASSERT(p_pRenderer);
+
+	eve::scene::GeometryPool * ptr = new eve::scene::GeometryPool(p_pRenderer);
+	ptr->init();
+	return ptr;
+}
+
+//=================================================================================================
+eve::scene::GeometryPool::GeometryPool(eve::ogl::Renderer * p_pRenderer)
+	// Inheritance
+	: eve::mem::Pointer()
+	// Members init
+	, m_pRenderer(p_pRenderer)
+	, m_pVecVao(nullptr)
+	, m_pMapRange(nullptr)
+	, m_pMapWaiting(nullptr)
+	, m_pVecSource(nullptr)
+	, m_bSweep(false)
+	, m_numBytes(0)
+	, m_numBytesFreed(0)
+{}
+
+
+
+//=================================================================================================
+void eve::scene::GeometryPool::init(void)
+{
+	m_pVecVao	= new std::vector<eve::ogl::Vao*>();
+	m_pMapRange = new std::map<GeometryKey, eve::scene::GeometryRange>();
+
+	m_pMapWaiting = new std::map<uint32_t, std::vector<const eve::ogl::Vao*>>();
+	m_pVecSource  = new std::vector<eve::ogl::Vao*>();
+	m_bSweep	  = false;
+}
+
+//=================================================================================================
+void eve::scene::GeometryPool::release(void)
+{
+	for (auto && itr : (*m_pVecVao))
+	{
+		itr->requestRelease();
+	}
+	EVE_RELEASE_PTR_CPP(m_pVecVao);
+	EVE_RELEASE_PTR_CPP(m_pMapRange);
+
+	// Do not delete -> shared pointers.
+	EVE_RELEASE_PTR_CPP(m_pMapWaiting);
+	EVE_RELEASE_PTR_CPP(m_pVecSource);
+
+	m_pRenderer = nullptr;
+}
+
+
+
+//=================================================================================================
+void eve::scene::GeometryPool::append(const std::vector<eve::scene::Mesh*> & p_vecMesh)
+{
+	// Unique geometries not pooled yet grouped by vertex layout (position, diffuse and normal values amounts), lone ones waiting first.
+	std::map<uint32_t, std::vector<const eve::ogl::Vao*>> layouts;
+	std::set<GeometryKey> known;
+	layouts.swap(*m_pMapWaiting);
+	for (auto && itr : layouts)
+	{
+		for (auto && vao : itr.second) {
+			known.insert(GeometryKey(vao->getVertices().get(), vao->getIndices().get()));
+		}
+	}
+
+	for (auto && mesh : p_vecMesh)
+	{
+		for (size_t l = 0; l < mesh->getLodCount(); l++)
+		{
+			eve::ogl::Vao * vao = mesh->getVaoLod(l);
+			m_pVecSource->push_back(vao);
+
+			GeometryKey key(vao->getVertices().get(), vao->getIndices().get());
+			if (m_pMapRange->find(key) == m_pMapRange->end() && known.insert(key).second)
+			{
+				uint32_t layout = static_cast<uint32_t>(vao->getPerVertexNumPosition())
+								| static_cast<uint32_t>(vao->getPerVertexNumDiffuse() << 8)
+								| static_cast<uint32_t>(vao->getPerVertexNumNormal()  << 16);
+				layouts[layout].push_back(vao);
+			}
+		}
+	}
+
+	for (auto && itr : layouts)
+	{
+		const std::vector<const eve::ogl::Vao*> & sources = itr.second;
+		// Nothing to gain, instancing already batches a lone geometry.
+		if (sources.size() < 2)
+		{
+			(*m_pMapWaiting)[itr.first] = sources;
+			continue;
+		}
+
+		const size_t strideUnit = static_cast<size_t>(sources[0]->getPerVertexNumPosition() + sources[0]->getPerVertexNumDiffuse() + sources[0]->getPerVertexNumNormal());
+
+		// Levels of detail may share vertices, each vertices array is copied once.
+		std::map<const float*, GLint>		baseVertices;
+		std::vector<const eve::ogl::Vao*>	vertexSources;
+		size_t numVertices = 0;
+		size_t numIndices  = 0;
+		for (auto && vao : sources)
+		{
+			if (baseVertices.find(vao->getVertices().get()) == baseVertices.end())
+			{
+				baseVertices[vao->getVertices().get()] = static_cast<GLint>(numVertices);
+				vertexSources.push_back(vao);
+				numVertices += static_cast<size_t>(vao->getNumVertices());
+			}
+			numIndices += static_cast<size_t>(vao->getNumIndices());
+		}
+
+		if (numVertices > static_cast<size_t>(INT_MAX) || numIndices > static_cast<size_t>(INT_MAX))
+		{
+			EVE_LOG_ERROR("Geometry pool layout too large to be merged (%llu vertices, %llu indices).", static_cast<unsigned long long>(numVertices), static_cast<unsigned long long>(numIndices));
+			continue;
+		}
+
+		float *  vertices = reinterpret_cast<float*>(eve::mem::malloc(numVertices * strideUnit * sizeof(float)));
+		GLuint * indices  = reinterpret_cast<GLuint*>(eve::mem::malloc(numIndices * sizeof(GLuint)));
+
+		for (auto && vao : vertexSources)
+		{
+			const float * src = vao->getVertices().get();
+			eve::mem::memcpy(vertices + baseVertices[src] * strideUnit, src, vao->getNumVertices() * strideUnit * sizeof(float));
+		}
+
+		// Ranges are filled once merged VAO exists.
+		std::vector<eve::scene::GeometryRange> ranges;
+		GLuint firstIndex = 0;
+		for (auto && vao : sources)
+		{
+			eve::mem::memcpy(indices + firstIndex, vao->getIndices().get(), vao->getNumIndices() * sizeof(GLuint));
+
+			eve::scene::GeometryRange range;
+			range.pVao		 = nullptr;
+			range.firstIndex = firstIndex;
+			range.numIndices = static_cast<GLuint>(vao->getNumIndices());
+			range.baseVertex = baseVertices[vao->getVertices().get()];
+			ranges.push_back(range);
+
+			firstIndex += range.numIndices;
+		}
+
+		eve::ogl::FormatVao format;
+		format.numVertices			= static_cast<GLint>(numVertices);
+		format.numIndices			= static_cast<GLint>(numIndices);
+		format.perVertexNumPosition = sources[0]->getPerVertexNumPosition();
+		format.perVertexNumDiffuse	= sources[0]->getPerVertexNumDiffuse();
+		format.perVertexNumNormal	= sources[0]->getPerVertexNumNormal();
+		format.vertices.reset(vertices, &eve::mem::free);
+		format.indices.reset(indices, &eve::mem::free);
+
+		eve::ogl::Vao * merged = m_pRenderer->create(format);
+		m_pVecVao->push_back(merged);
+		m_numBytes += merged->getOglCost();
+
+		for (size_t i = 0; i < sources.size(); i++)
+		{
+			ranges[i].pVao = merged;
+			(*m_pMapRange)[GeometryKey(sources[i]->getVertices().get(), sources[i]->getIndices().get())] = ranges[i];
+		}
+	}
+
+	m_bSweep = !m_pVecSource->empty();
+}
+
+//=================================================================================================
+void eve::scene::GeometryPool::update(void)
+{
+	if (!m_bSweep) {
+		return;
+	}
+
+	// Sources are drawn until every page is uploaded.
+	for (auto && itr : (*m_pVecVao))
+	{
+		if (itr->getId() == 0) {
+			return;
+		}
+	}
+
+	bool   bRetry = false;
+	size_t kept	  = 0;
+	for (auto && vao : (*m_pVecSource))
+	{
+		// Lone geometry still waiting for a page.
+		if (m_pMapRange->find(GeometryKey(vao->getVertices().get(), vao->getIndices().get())) == m_pMapRange->end())
+		{
+			(*m_pVecSource)[kept++] = vao;
+			continue;
+		}
+		// Source upload still queued, released next frame.
+		if (vao->getId() == 0)
+		{
+			(*m_pVecSource)[kept++] = vao;
+			bRetry = true;
+			continue;
+		}
+
+		m_numBytesFreed += vao->getOglCost();
+		vao->oglReleaseStorage();
+	}
+	m_pVecSource->resize(kept);
+
+	m_bSweep = bRetry;
+}
+
+//=================================================================================================
+const eve::scene::GeometryRange * eve::scene::GeometryPool::find(const eve::ogl::Vao * p_pVao) const
+{
+	auto itr = m_pMapRange->find(GeometryKey(p_pVao->getVertices().get(), p_pVao->getIndices().get()));
+	if (itr == m_pMapRange->end()) {
+		return nullptr;
+	}
+	// Merged VAO is uploaded by renderer queues, source VAO is used meanwhile.
+	if (itr->second.pVao->getId() == 0) {
+		return nullptr;
+	}
+	return &itr->second;
+}
@@ -0,0 +1,166 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_SCENE_GEOMETRY_POOL_H__
+#define __EVE_SCENE_GEOMETRY_POOL_H__
+
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_VAO_H__
+#include "eve/ogl/core/Vao.h"
+#endif
+
+
+namespace eve { namespace ogl { class Renderer; } }
+namespace eve { namespace scene { class Mesh; } }
+
+
+namespace eve
+{
+	namespace scene
+	{
+		/** 
+		* \struct eve::scene::GeometryRange
+		* \brief Location of a source geometry inside a merged VAO.
+		*/
+		struct GeometryRange
+		{
+			eve::ogl::Vao *				pVao;			//!< Merged VAO holding geometry.
+			GLuint						firstIndex;		//!< First index in merged element buffer.
+			GLuint						numIndices;		//!< Indices amount.
+			GLint						baseVertex;		//!< Source vertices offset in merged array buffer.
+		};
+
+
+		/**
+		* \class eve::scene::GeometryPool
+		*
+		* \brief Merges meshes geometry into shared large vertex/index buffers, one VAO per vertex layout.
+		* Geometry is identified by its vertices and indices data addresses, so copies sharing eve::scene::MeshCache data are stored once.
+		* Source indices are kept untouched, each geometry is drawn with its base vertex, allowing heterogeneous meshes to be
+		* submitted by a single multi draw indirect call.
+		* Pool grows by pages: each append() merges only geometries not pooled yet into one new VAO per layout, so every geometry
+		* is uploaded once. Once a page is uploaded, OpenGL storage of its source VAOs is released (CPU data is kept), merged
+		* geometry then serves every draw (see find()). A lone geometry of a layout waits for a second one before being merged.
+		*
+		* \note extends eve::mem::Pointer
+		*/
+		class GeometryPool final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATAS				//
+			//////////////////////////////////////
+
+		private:
+			typedef std::pair<const float*, const GLuint*>	GeometryKey;
+
+		private:
+			eve::ogl::Renderer *								m_pRenderer;		//!< Specifies renderer creating merged VAOs.
+			std::vector<eve::ogl::Vao*> *						m_pVecVao;			//!< Specifies merged VAOs.
+			std::map<GeometryKey, eve::scene::GeometryRange> *	m_pMapRange;		//!< Specifies source geometry to merged range map.
+			std::map<uint32_t, std::vector<const eve::ogl::Vao*>> * m_pMapWaiting;	//!< Specifies per layout lone geometries waiting to be merged.
+			std::vector<eve::ogl::Vao*> *						m_pVecSource;		//!< Specifies source VAOs whose storage is not released yet.
+			bool												m_bSweep;			//!< Specifies whether source VAOs storage may be released.
+			size_t												m_numBytes;			//!< Specifies merged data size in bytes.
+			size_t												m_numBytesFreed;	//!< Specifies released source VAOs data size in bytes.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(GeometryPool);
+			EVE_PUBLIC_DESTRUCTOR(GeometryPool);
+
+		public:
+			/** \brief Create, init and return new pointer, merged VAOs are created through \a p_pRenderer. */
+			static eve::scene::GeometryPool * create_ptr(eve::ogl::Renderer * p_pRenderer);
+
+
+		private:
+			/** \brief Class constructor. */
+			explicit GeometryPool(eve::ogl::Renderer * p_pRenderer);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Merge every level of detail of \a p_vecMesh not pooled yet into new pages (render thread only). */
+			void append(const std::vector<eve::scene::Mesh*> & p_vecMesh);
+			/** \brief Release OpenGL storage of merged source VAOs once their page is uploaded (render thread, context current). */
+			void update(void);
+			/** \brief Get \a p_pVao geometry range, nullptr if it is not merged or merged VAO is not initialized yet (render thread only). */
+			const eve::scene::GeometryRange * find(const eve::ogl::Vao * p_pVao) const;
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get merged VAOs amount. */
+			const size_t getNumVao(void) const;
+			/** \brief Get merged geometries amount. */
+			const size_t getNumGeometries(void) const;
+			/** \brief Get merged data size in bytes. */
+			const size_t getNumBytes(void) const;
+			/** \brief Get released source VAOs data size in bytes. */
+			const size_t getNumBytesFreed(void) const;
+
+		}; // class GeometryPool
+
+	} // namespace scene
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const size_t eve::scene::GeometryPool::getNumVao(void) const			{ return m_pVecVao->size();		}
+EVE_FORCE_INLINE const size_t eve::scene::GeometryPool::getNumGeometries(void) const	{ return m_pMapRange->size();	}
+EVE_FORCE_INLINE const size_t eve::scene::GeometryPool::getNumBytes(void) const		{ return m_numBytes;			}
+EVE_FORCE_INLINE const size_t eve::scene::GeometryPool::getNumBytesFreed(void) const	{ return m_numBytesFreed;		}
+
+#endif // __EVE_SCENE_GEOMETRY_POOL_H__
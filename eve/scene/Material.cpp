@@ -44,6 +44,10 @@
 #include "eve/io/Image.h"
 #endif
 
+#ifndef __EVE_IO_IMAGE_SERVICE_H__
+#include "eve/io/ImageService.h"
+#endif
+
 
 //=================================================================================================
 eve::scene::Material * eve::scene::Material::create_ptr(eve::scene::Scene *		p_pParentScene
@@ -88,79 +92,25 @@ void eve::scene::Material::init(const aiMaterial * p_pMaterial, const std::strin
 	{
 		m_pAiMaterial = p_pMaterial;
 
-		aiString path;
-		std::string folderPath = eve::files::remove_file_name(p_fullPath);
-		std::string fullPath;
-
-		// Diffuse.
-		if (m_pAiMaterial->GetTexture(aiTextureType_DIFFUSE, 0, &path) == AI_SUCCESS)
-		{
-			fullPath = folderPath + path.data;
-			eve::ogl::FormatTex fmtTexDif;
-			if (eve::io::load_image(fullPath, &fmtTexDif))
-			{
-				m_pTexDiffuse = m_pScene->create(fmtTexDif);
-			}
-			else
-			{
-				EVE_LOG_ERROR("Unable to load file %s", eve::str::to_wstring(fullPath).c_str());
-				EVE_ASSERT_FAILURE;
-			}
-		}
-
-		// Normals.
-		if (m_pAiMaterial->GetTexture(aiTextureType_NORMALS, 0, &path) == AI_SUCCESS)
-		{
-			fullPath = folderPath + path.data;
-			eve::ogl::FormatTex fmtTexNor;
-			if (eve::io::load_image(fullPath, &fmtTexNor))
-			{
-				m_pTexNormal = m_pScene->create(fmtTexNor);
-			}
-			else
-			{
-				EVE_LOG_ERROR("Unable to load file %s", eve::str::to_wstring(fullPath).c_str());
-				EVE_ASSERT_FAILURE;
-			}
-		}
-
-		// Emissive.
-		if (m_pAiMaterial->GetTexture(aiTextureType_EMISSIVE, 0, &path) == AI_SUCCESS)
-		{
-			fullPath = folderPath + path.data;
-			eve::ogl::FormatTex fmtTexEmi;
-			if (eve::io::load_image(fullPath, &fmtTexEmi))
-			{
-				m_pTexEmissive = m_pScene->create(fmtTexEmi);
-			}
-			else
-			{
-				EVE_LOG_ERROR("Unable to load file %s", eve::str::to_wstring(fullPath).c_str());
-				EVE_ASSERT_FAILURE;
-			}
-		}
-
-		// Opacity
-		if (m_pAiMaterial->GetTexture(aiTextureType_OPACITY, 0, &path) == AI_SUCCESS)
-		{
-			fullPath = folderPath + path.data;
-			eve::ogl::FormatTex fmtTexOpa;
-			if (eve::io::load_image(fullPath, &fmtTexOpa))
-			{
-				m_pTexOpacity = m_pScene->create(fmtTexOpa);
-			}
-			else
-			{
-				EVE_LOG_ERROR("Unable to load file %s", eve::str::to_wstring(fullPath).c_str());
-				EVE_ASSERT_FAILURE;
-			}
-		}
-
-
 		aiGetMaterialFloat(m_pAiMaterial, AI_MATKEY_SHININESS, &m_shininess); // AI_MATKEY_SHININESS_STRENGTH
 		//aiGetMaterialFloat(m_pAiMaterial, AI_MATKEY_OPACITY, &m_o);
 	}
+
+	// Default textures are drawn until material maps are streamed in.
 	this->init();
+
+	if (p_pMaterial)
+	{
+		aiString path;
+		std::string folderPath = eve::files::remove_file_name(p_fullPath);
+		eve::io::ImageService * service = eve::io::ImageService::get_instance();
+
+		// Maps are decoded in parallel straight into renderer PBO pool slots.
+		if (m_pAiMaterial->GetTexture(aiTextureType_DIFFUSE, 0, &path) == AI_SUCCESS)	{ m_streams.push_back(service->stream(folderPath + path.data, m_pTexDiffuse)); }
+		if (m_pAiMaterial->GetTexture(aiTextureType_NORMALS, 0, &path) == AI_SUCCESS)	{ m_streams.push_back(service->stream(folderPath + path.data, m_pTexNormal)); }
+		if (m_pAiMaterial->GetTexture(aiTextureType_EMISSIVE, 0, &path) == AI_SUCCESS)	{ m_streams.push_back(service->stream(folderPath + path.data, m_pTexEmissive)); }
+		if (m_pAiMaterial->GetTexture(aiTextureType_OPACITY, 0, &path) == AI_SUCCESS)	{ m_streams.push_back(service->stream(folderPath + path.data, m_pTexOpacity)); }
+	}
 }
 
 
@@ -242,6 +192,12 @@ void eve::scene::Material::init(void)
 //=================================================================================================
 void eve::scene::Material::release(void)
 {
+	// Textures must outlive pending decode and slot submission.
+	for (auto & stream : m_streams) {
+		stream.wait();
+	}
+	m_streams.clear();
+
 	m_pTexDiffuse->requestRelease();
 	m_pTexDiffuse = nullptr;
 	m_pTexNormal->requestRelease();
@@ -295,6 +251,15 @@ void eve::scene::Material::unbind(void)
 	m_pTexDiffuse->unbind_diffuse();
 }
 
+//=================================================================================================
+bool eve::scene::Material::isInitialized(void) const
+{
+	return m_pTexDiffuse->isInitialized()
+		&& m_pTexNormal->isInitialized()
+		&& m_pTexEmissive->isInitialized()
+		&& m_pTexOpacity->isInitialized();
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //		GET / SET
@@ -46,6 +46,9 @@
 #include "eve/math/Includes.h"
 #endif
 
+#include <future>
+#include <vector>
+
 
 namespace eve { namespace ogl { class Texture; } }
 
@@ -82,6 +85,8 @@ namespace eve
 
 			const aiMaterial *		m_pAiMaterial;			//!< Specifies Assimp material (shared pointer).
 
+			std::vector<std::shared_future<bool>>	m_streams;	//!< Specifies pending maps streaming into textures.
+
 
 			//////////////////////////////////////
 			//				METHOD				//
@@ -130,6 +135,8 @@ namespace eve
 			void bind(void);
 			/** \brief Unbind (deactivate) textures. */
 			void unbind(void);
+			/** \brief Get whether every texture OpenGL init has been processed. Render thread only. */
+			bool isInitialized(void) const;
 
 
 			///////////////////////////////////////////////////////////////////////////////////////////
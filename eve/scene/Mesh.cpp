@@ -36,6 +36,22 @@
 #include "eve/scene/Scene.h"
 #endif
 
+#ifndef __EVE_SCENE_BVH_H__
+#include "eve/scene/Bvh.h"
+#endif
+
+#ifndef __EVE_SCENE_GEOMETRY_POOL_H__
+#include "eve/scene/GeometryPool.h"
+#endif
+
+#ifndef __EVE_SCENE_CAMERA_H__
+#include "eve/scene/Camera.h"
+#endif
+
+#ifndef __EVE_SCENE_MESH_CACHE_H__
+#include "eve/scene/MeshCache.h"
+#endif
+
 #ifndef __EVE_SCENE_SKELETON_H__
 #include "eve/scene/Skeleton.h"
 #endif
@@ -52,6 +68,10 @@
 #include "eve/ogl/core/Vao.h"
 #endif
 
+#ifndef __EVE_GEOMETRY_SIMPLIFY_H__
+#include "eve/geom/Simplify.h"
+#endif
+
 
 //=================================================================================================
 eve::scene::Mesh * eve::scene::Mesh::create_ptr(eve::scene::Scene *		p_pParentScene
@@ -89,6 +109,14 @@ eve::scene::Mesh::Mesh(eve::scene::Scene * p_pParentScene, eve::scene::Object *
 	, m_pMaterial(nullptr)
 	, m_pSkeleton(nullptr)
 	, m_pUniformMatrix(nullptr)
+	, m_pVecLodVao(nullptr)
+	, m_pVecLodError(nullptr)
+	, m_lodCurrent(0)
+	, m_box()
+	, m_boxWorld()
+	, m_pBvh(nullptr)
+	, m_transformId(EVE_TRANSFORM_NONE)
+	, m_matrixWorld(eve::mat44f::identity())
 {}
 
 
@@ -138,86 +166,136 @@ bool eve::scene::Mesh::init(const aiMesh * p_pMesh, const aiScene * p_pScene, ev
 		/////////////////////////////////////////
 		//	MESH
 		/////////////////////////////////////////
-		EVE_LOG_PROGRESS("Loading Mesh %s vertices.", wname.c_str());
-
-		// Mesh base data.
-		int32_t	numVertices = m_pAiMesh->mNumVertices;
-		int32_t numFaces	= m_pAiMesh->mNumFaces;
-		int32_t numIndices	= numFaces * 3;
-
-		// Allocate arrays memory.
-		float *  pVertices = (float*)eve::mem::malloc(numVertices * 8 * sizeof(float));
-		GLuint * pIndices  = (GLuint*)eve::mem::malloc(numIndices * sizeof(GLuint));
-
-		float min_x = 0.0f;
-		float min_y = 0.0f;
-		float min_z = 0.0f;
-
-		float max_x = 0.0f;
-		float max_y = 0.0f;
-		float max_z = 0.0f;
 
-		float cur_x = 0.0f;
-		float cur_y = 0.0f;
-		float cur_z = 0.0f;
-
-		// Denver style.
-		aiVector3D * ai_vert = m_pAiMesh->mVertices - 1;
-		aiVector3D * ai_texc = m_pAiMesh->mTextureCoords[0] - 1;
-		aiVector3D * ai_norm = m_pAiMesh->mNormals - 1;
-
-		// Run threw vertices and copy data.
-		float * vert = pVertices - 1;
-		for (int32_t j = 0; j < numVertices; j++)
+		// Level of detail chain import parameters.
+		size_t lodLevels	= static_cast<size_t>(::atoi(eve::scene::Scene::get_import_param(SceneImportParam_Lod_Levels).c_str()));
+		float  lodReduction = static_cast<float>(::atof(eve::scene::Scene::get_import_param(SceneImportParam_Lod_Reduction).c_str()));
+		if (lodLevels < 1) { lodLevels = 1; }
+		lodReduction = eve::math::clamp(lodReduction, 0.05f, 0.95f);
+
+		// Cache key, chains depend on source mesh and import parameters.
+		size_t meshIndex = 0;
+		while (meshIndex < p_pScene->mNumMeshes && p_pScene->mMeshes[meshIndex] != m_pAiMesh) { meshIndex++; }
+
+		std::stringstream key;
+		key << p_fullPath << "|" << meshIndex
+			<< "|" << eve::scene::Scene::get_import_param(SceneImportParam_Flip_UV)
+			<< "|" << eve::scene::Scene::get_import_param(SceneImportParam_Generate_Normals)
+			<< "|" << eve::scene::Scene::get_import_param(SceneImportParam_Normals_Max_Angle)
+			<< "|" << lodLevels << "|" << lodReduction;
+
+		const eve::scene::MeshLodChain * pChain = eve::scene::MeshCache::get_instance()->find(key.str());
+		if (!pChain)
 		{
-			cur_x = (*++ai_vert).x;
-			cur_y =   (*ai_vert).y;
-			cur_z =   (*ai_vert).z;
-
-			// Positions
-			*++vert = cur_x;
-			*++vert = cur_y;
-			*++vert = cur_z;
-			// Bounding box
-			if (cur_x < min_x)		{ min_x = cur_x; }
-			else if (cur_x > max_x)	{ max_x = cur_x; }
-			if (cur_y < min_y)		{ min_y = cur_y; }
-			else if (cur_y > max_y)	{ max_y = cur_y; }
-			if (cur_z < min_z)		{ min_z = cur_z; }
-			else if (cur_z > max_z)	{ max_z = cur_z; }
-
-			// Texture coordinates
-			*++vert = (*++ai_texc).x;
-			*++vert =   (*ai_texc).y;
-			// Normals
-			*++vert = (*++ai_norm).x;
-			*++vert =   (*ai_norm).y;
-			*++vert =   (*ai_norm).z;
+			EVE_LOG_PROGRESS("Loading Mesh %s vertices.", wname.c_str());
+
+			// Mesh base data.
+			int32_t	numVertices = m_pAiMesh->mNumVertices;
+			int32_t numFaces	= m_pAiMesh->mNumFaces;
+			int32_t numIndices	= numFaces * 3;
+
+			// Allocate arrays memory.
+			float *  pVertices = (float*)eve::mem::malloc(numVertices * 8 * sizeof(float));
+			GLuint * pIndices  = (GLuint*)eve::mem::malloc(numIndices * sizeof(GLuint));
+
+			float min_x = FLT_MAX;
+			float min_y = FLT_MAX;
+			float min_z = FLT_MAX;
+
+			float max_x = -FLT_MAX;
+			float max_y = -FLT_MAX;
+			float max_z = -FLT_MAX;
+
+			float cur_x = 0.0f;
+			float cur_y = 0.0f;
+			float cur_z = 0.0f;
+
+			// Denver style.
+			aiVector3D * ai_vert = m_pAiMesh->mVertices - 1;
+			aiVector3D * ai_texc = m_pAiMesh->mTextureCoords[0] - 1;
+			aiVector3D * ai_norm = m_pAiMesh->mNormals - 1;
+
+			// Run threw vertices and copy data.
+			float * vert = pVertices - 1;
+			for (int32_t j = 0; j < numVertices; j++)
+			{
+				cur_x = (*++ai_vert).x;
+				cur_y =   (*ai_vert).y;
+				cur_z =   (*ai_vert).z;
+
+				// Positions
+				*++vert = cur_x;
+				*++vert = cur_y;
+				*++vert = cur_z;
+				// Bounding box
+				if (cur_x < min_x) { min_x = cur_x; }
+				if (cur_x > max_x) { max_x = cur_x; }
+				if (cur_y < min_y) { min_y = cur_y; }
+				if (cur_y > max_y) { max_y = cur_y; }
+				if (cur_z < min_z) { min_z = cur_z; }
+				if (cur_z > max_z) { max_z = cur_z; }
+
+				// Texture coordinates
+				*++vert = (*++ai_texc).x;
+				*++vert =   (*ai_texc).y;
+				// Normals
+				*++vert = (*++ai_norm).x;
+				*++vert =   (*ai_norm).y;
+				*++vert =   (*ai_norm).z;
+			}
+
+			// Run threw indices and copy data.
+			GLuint * ind	 = pIndices - 1;
+			aiFace * ai_face = m_pAiMesh->mFaces - 1;
+			for (int32_t j = 0; j < numFaces; j++)
+			{
+				*++ind = (*++ai_face).mIndices[0];
+				*++ind =   (*ai_face).mIndices[1];
+				*++ind =   (*ai_face).mIndices[2];
+			}
+		
+			// Create VAO format.
+			eve::ogl::FormatVao format;
+			format.numVertices			= numVertices;
+			format.numIndices			= numIndices;
+			format.perVertexNumPosition = 3;
+			format.perVertexNumDiffuse	= 2;
+			format.perVertexNumNormal	= 3;
+			format.vertices.reset(pVertices, &eve::mem::free);
+			format.indices.reset(pIndices, &eve::mem::free);
+
+			// Level of detail chain.
+			EVE_LOG_PROGRESS("Generating Mesh %s levels of detail.", wname.c_str());
+			eve::scene::MeshLodChain * pNewChain = new eve::scene::MeshLodChain();
+			pNewChain->box.set(eve::vec3f(min_x, min_y, min_z), eve::vec3f(max_x, max_y, max_z));
+			if (lodLevels > 1)
+			{
+				pNewChain->formats = eve::geom::create_lod_chain(format, lodLevels, lodReduction, &pNewChain->errors);
+			}
+			else
+			{
+				pNewChain->formats.push_back(format);
+				pNewChain->errors.push_back(0.0f);
+			}
+
+			pChain = eve::scene::MeshCache::get_instance()->insert(key.str(), pNewChain);
 		}
-		// Bounding box
-		//m_pBox = gl::Box3DCornered::create_ptr(Vec3f(min_x, min_y, min_z), Vec3f(max_x, max_y, max_z), UILayoutConfigColor::STAGE_BOUNDING_BOX);
 
-		// Run threw indices and copy data.
-		GLuint * ind	 = pIndices - 1;
-		aiFace * ai_face = m_pAiMesh->mFaces - 1;
-		for (int32_t j = 0; j < numFaces; j++)
+		// Create VAOs, vertices and indices memory is shared with cached chain.
+		m_box = pChain->box;
+		m_pVecLodVao   = new std::vector<eve::ogl::Vao*>();
+		m_pVecLodError = new std::vector<float>(pChain->errors);
+		for (auto && itr : pChain->formats)
 		{
-			*++ind = (*++ai_face).mIndices[0];
-			*++ind =   (*ai_face).mIndices[1];
-			*++ind =   (*ai_face).mIndices[2];
+			eve::ogl::FormatVao format(itr);
+			m_pVecLodVao->push_back(m_pScene->create(format));
 		}
-		
-		// Create VAO format.
-		eve::ogl::FormatVao format;
-		format.numVertices			= numVertices;
-		format.numIndices			= numIndices;
-		format.perVertexNumPosition = 3;
-		format.perVertexNumDiffuse	= 2;
-		format.perVertexNumNormal	= 3;
-		format.vertices.reset(pVertices);
-		format.indices.reset(pIndices);
-		// Create VAO.
-		m_pVao = m_pScene->create(format);
+		m_pVao		 = m_pVecLodVao->front();
+		m_lodCurrent = 0;
+
+		// Triangles hierarchy, used in ray picking.
+		EVE_LOG_PROGRESS("Building Mesh %s bounding volume hierarchy.", wname.c_str());
+		m_pBvh = eve::scene::BvhMesh::create_ptr(m_pVao);
 
 
 		/////////////////////////////////////////
@@ -225,18 +303,29 @@ bool eve::scene::Mesh::init(const aiMesh * p_pMesh, const aiScene * p_pScene, ev
 		/////////////////////////////////////////
 		EVE_LOG_PROGRESS("Loading Mesh %s matrices.", wname.c_str());
 
+		// Matrix is local to parent mesh node when parented, world otherwise.
+		const aiNode * pStop = pRoot;
+		if (m_pParent && m_pParent->getType() == eve::scene::SceneObject_Mesh)
+		{
+			const aiNode * pParentNode = pRoot->FindNode(m_pParent->getName().c_str());
+			EVE_ASSERT(pParentNode);
+			if (pParentNode) { pStop = pParentNode; }
+		}
+
 		aiMatrix4x4 mat;
-		while (pNode != pRoot)
+		while (pNode != pStop && pNode != pRoot)
 		{
 			mat = pNode->mTransformation * mat;
 			pNode = pNode->mParent;
 		}
+		// Parent node MUST be an ancestor.
+		EVE_ASSERT(pNode == pStop);
 		eve::math::TMatrix44<float> matrix(mat.a1, mat.b1, mat.c1, mat.d1
 										 , mat.a2, mat.b2, mat.c2, mat.d2
 										 , mat.a3, mat.b3, mat.c3, mat.d3
 										 , mat.a4, mat.b4, mat.c4, mat.d4);
-		// Correct Up Axis if needed.
-		if (p_upAxis == eve::Axis_Z)
+		// Correct Up Axis if needed, parent world matrix already holds the correction.
+		if (p_upAxis == eve::Axis_Z && pStop == pRoot)
 		{
 			matrix.fromZupToYup();
 		}
@@ -296,8 +385,11 @@ void eve::scene::Mesh::init(void)
 	eve::ogl::FormatUniform fmtUniform;
 	fmtUniform.blockSize = EVE_OGL_SIZEOF_MAT4;
 	fmtUniform.dynamic	 = false;
+	fmtUniform.streamed	 = true;
 	m_pUniformMatrix	 = m_pScene->create(fmtUniform);
-	m_pUniformMatrix->pushData(m_matrixModelView, 0);
+
+	// Root until added to scene transforms hierarchy.
+	this->updateMatrixWorld(m_matrixModelView);
 }
 
 //=================================================================================================
@@ -305,9 +397,21 @@ void eve::scene::Mesh::release(void)
 {
 	m_pUniformMatrix->requestRelease();
 	m_pUniformMatrix = nullptr;
-	m_pVao->requestRelease();
+	m_transformId	 = EVE_TRANSFORM_NONE;
+	// Level 0 is m_pVao.
+	eve::ogl::Vao * vao = nullptr;
+	while (!m_pVecLodVao->empty())
+	{
+		vao = m_pVecLodVao->back();
+		m_pVecLodVao->pop_back();
+		vao->requestRelease();
+	}
+	EVE_RELEASE_PTR_CPP(m_pVecLodVao);
+	EVE_RELEASE_PTR_CPP(m_pVecLodError);
 	m_pVao = nullptr;
 
+	EVE_RELEASE_PTR_SAFE(m_pBvh);
+
 	// Do not delete -> shared pointer.
 	m_pAiMesh = nullptr;
 
@@ -363,22 +467,120 @@ void eve::scene::Mesh::updateMatrixModelView(void)
 {
 	// Call parent class.
 	eve::math::Mesh::updateMatrixModelView();
-	// Update uniform buffer.
-	m_pUniformMatrix->pushData(m_matrixModelView, 0);
+
+	// World matrix is resolved by scene transforms hierarchy update pass.
+	if (m_transformId != EVE_TRANSFORM_NONE) {
+		m_pScene->getTransforms()->setLocal(m_transformId, m_matrixModelView);
+	}
+	else {
+		this->updateMatrixWorld(m_matrixModelView);
+	}
+}
+
+//=================================================================================================
+void eve::scene::Mesh::updateMatrixWorld(const eve::mat44f & p_matrix)
+{
+	m_matrixWorld = p_matrix;
+	// Uniform buffer is filled at draw time from captured matrix, frame in flight may still stream it.
+	// Update world space bounding box.
+	m_boxWorld = m_box.transformed(m_matrixWorld);
 }
 
 
 
 //=================================================================================================
-void eve::scene::Mesh::oglDraw(void)
+void eve::scene::Mesh::updateLod(const eve::scene::Camera * p_pCamera, float p_pixelError, float p_hysteresis)
 {
-	m_pUniformMatrix->bindModel();
+	m_lodCurrent = this->selectLod(p_pCamera, p_pixelError, p_hysteresis, m_lodCurrent);
+}
+
+//=================================================================================================
+size_t eve::scene::Mesh::selectLod(const eve::scene::Camera * p_pCamera, float p_pixelError, float p_hysteresis, size_t p_current) const
+{
+	EVE_ASSERT(p_pCamera);
+
+	const size_t numLevels = m_pVecLodVao->size();
+	if (numLevels < 2) return 0;
+
+	// Closest distance from eye to world space bounding sphere.
+	float radius   = m_boxWorld.getSize().length() * 0.5f;
+	float distance = (m_boxWorld.getCenter() - p_pCamera->getEyePoint()).length() - radius;
+	if (distance < p_pCamera->getNearClip()) { distance = p_pCamera->getNearClip(); }
+
+	// Object space error to pixels factor.
+	float scale		= eve::math::max(eve::math::abs(m_scale.x), eve::math::max(eve::math::abs(m_scale.y), eve::math::abs(m_scale.z)));
+	float pixels	= p_pCamera->getDisplayHeight() / (2.0f * eve::math::tan(eve::math::toRadians(p_pCamera->getFov()) * 0.5f));
+	float toPixels	= scale * pixels / distance;
+
+	const float refine  = p_pixelError * (1.0f + p_hysteresis);
+	const float coarsen = p_pixelError * (1.0f - p_hysteresis);
+
+	size_t lod = std::min(p_current, numLevels - 1);
+	// Refine while current level error is noticeable.
+	while (lod > 0 && (*m_pVecLodError)[lod] * toPixels > refine) { lod--; }
+	// Coarsen while next level error stays unnoticeable.
+	while (lod + 1 < numLevels && (*m_pVecLodError)[lod + 1] * toPixels <= coarsen) { lod++; }
 
+	return lod;
+}
+
+
+
+//=================================================================================================
+void eve::scene::Mesh::oglDraw(void)
+{
+	// Bindings are left in place, next mesh overrides them and state cache skips identical ones.
+	// Caller unbinds once the whole pass is drawn.
+	if (!this->isInitialized(m_lodCurrent)) return;
 	m_pMaterial->bind();
-	m_pVao->draw();
-	m_pMaterial->unbind();
+	this->oglDrawGeometry();
+}
 
-	m_pUniformMatrix->unbind_model();
+//=================================================================================================
+bool eve::scene::Mesh::isInitialized(size_t p_level) const
+{
+	return (*m_pVecLodVao)[p_level]->isInitialized()
+		&& m_pUniformMatrix->isInitialized()
+		&& (!m_pMaterial || m_pMaterial->isInitialized());
+}
+
+//=================================================================================================
+void eve::scene::Mesh::oglDrawGeometry(void)
+{
+	this->oglDrawGeometry(m_lodCurrent, m_matrixWorld);
+}
+
+//=================================================================================================
+void eve::scene::Mesh::oglDrawGeometry(size_t p_level, const eve::mat44f & p_matrix)
+{
+	eve::ogl::Vao * vao = (*m_pVecLodVao)[p_level];
+
+	// Model uniform for legacy shaders, current instance attribute for instanced ones.
+	// Captured matrix is copied on render thread, workers may already update world matrix for next frame.
+	m_pUniformMatrix->pushData(p_matrix, 0);
+	m_pUniformMatrix->bindModel();
+
+	// Merged geometry storage replaces own VAO one once uploaded.
+	const eve::scene::GeometryRange * range = m_pScene->getGeometry()->find(vao);
+	if (range)
+	{
+		eve::ogl::DrawElementsCommand cmd;
+		cmd.count		  = range->numIndices;
+		cmd.instanceCount = 1;
+		cmd.firstIndex	  = range->firstIndex;
+		cmd.baseVertex	  = range->baseVertex;
+		cmd.baseInstance  = 0;
+
+		range->pVao->unbindInstances();
+		eve::ogl::Vao::set_instance(p_matrix);
+		range->pVao->drawCommand(cmd);
+	}
+	else
+	{
+		vao->unbindInstances();
+		eve::ogl::Vao::set_instance(p_matrix);
+		vao->draw();
+	}
 }
 
 
@@ -46,7 +46,13 @@
 #include "eve/math/Includes.h"
 #endif
 
+#ifndef __EVE_SCENE_TRANSFORM_HIERARCHY_H__
+#include "eve/scene/TransformHierarchy.h"
+#endif
+
 
+namespace eve { namespace scene { class BvhMesh; } }
+namespace eve { namespace scene { class Camera; } }
 namespace eve { namespace scene { class Material; } }
 namespace eve { namespace scene { class Skeleton; } }
 
@@ -75,12 +81,24 @@ namespace eve
 			//////////////////////////////////////
 
 		protected:
-			eve::ogl::Vao *			m_pVao;					//!< Specifies OpenGL vertex array object.
+			eve::ogl::Vao *			m_pVao;					//!< Specifies OpenGL vertex array object (full resolution).
 			const aiMesh *			m_pAiMesh;				//!< Specifies Assimp mesh (shared pointer).
 			eve::scene::Material *	m_pMaterial;			//!< Specifies material.
 			eve::scene::Skeleton *	m_pSkeleton;			//!< Specifies bones rigging skeleton used in mesh animation.
 
-			eve::ogl::Uniform *		m_pUniformMatrix;		//!< Specifies uniform buffer containing model view matrix.
+			eve::ogl::Uniform *		m_pUniformMatrix;		//!< Specifies uniform buffer containing world matrix (filled on render thread at draw time).
+
+		protected:
+			std::vector<eve::ogl::Vao*> *	m_pVecLodVao;		//!< Specifies level of detail VAOs, level 0 is m_pVao.
+			std::vector<float> *			m_pVecLodError;		//!< Specifies per level geometric error (object space distance).
+			size_t							m_lodCurrent;		//!< Specifies currently drawn level of detail.
+			eve::math::TBox<float>			m_box;				//!< Specifies object space bounding box.
+			eve::math::TBox<float>			m_boxWorld;			//!< Specifies world space bounding box (updated with model view matrix).
+			eve::scene::BvhMesh *			m_pBvh;				//!< Specifies object space triangles hierarchy (full resolution level).
+
+		protected:
+			uint32_t						m_transformId;		//!< Specifies scene transforms hierarchy node ID (EVE_TRANSFORM_NONE until added to scene).
+			eve::mat44f						m_matrixWorld;		//!< Specifies world matrix (parent world matrix * model view matrix).
 
 
 			//////////////////////////////////////
@@ -125,11 +143,29 @@ namespace eve
 		public:
 			/** \brief Update model view matrix based on rot/trans/scale matrices concatenation. */
 			virtual void updateMatrixModelView(void) override;
+			/** \brief Update world matrix and world space bounding box (called by scene transforms hierarchy update, may run on workers, no OpenGL data touched). */
+			void updateMatrixWorld(const eve::mat44f & p_matrix);
 
 
 		public:
-			/** \brief OpenGL VAO draw. */
+			/** 
+			* \brief Select drawn level of detail from its projected screen space error on camera \a p_pCamera.
+			* Coarsest level whose error stays under \a p_pixelError is kept, switches are delayed by \a p_hysteresis band to avoid popping.
+			*/
+			void updateLod(const eve::scene::Camera * p_pCamera, float p_pixelError, float p_hysteresis);
+			/** \brief Return level of detail selected on camera \a p_pCamera starting from level \a p_current, mesh is left untouched (concurrent views). */
+			size_t selectLod(const eve::scene::Camera * p_pCamera, float p_pixelError, float p_hysteresis, size_t p_current) const;
+
+
+		public:
+			/** \brief OpenGL VAO draw (current level of detail), bindings are left in place for next mesh. */
 			void oglDraw(void);
+			/** \brief OpenGL VAO draw (current level of detail) without binding material, world matrix is sent as model uniform and instance attribute value. */
+			void oglDrawGeometry(void);
+			/** \brief Get whether level \a p_level VAO, matrix uniform and material OpenGL init have been processed (budgeted by renderer queues). Render thread only. */
+			bool isInitialized(size_t p_level) const;
+			/** \brief OpenGL VAO draw of level \a p_level with world matrix \a p_matrix as model uniform and instance attribute value (render queue captured state). */
+			void oglDrawGeometry(size_t p_level, const eve::mat44f & p_matrix);
 
 
 			///////////////////////////////////////////////////////////////////////////////////////
@@ -139,6 +175,32 @@ namespace eve
 		public:
 			/** \brief Get OpenGL VAO. */
 			eve::ogl::Vao * getVao(void) const;
+			/** \brief Get current level of detail OpenGL VAO. */
+			eve::ogl::Vao * getVaoCurrent(void) const;
+			/** \brief Get level of detail \a p_level OpenGL VAO. */
+			eve::ogl::Vao * getVaoLod(size_t p_level) const;
+
+
+		public:
+			/** \brief Get level of detail levels amount. */
+			size_t getLodCount(void) const;
+			/** \brief Get currently drawn level of detail. */
+			size_t getLodCurrent(void) const;
+			/** \brief Get object space bounding box. */
+			const eve::math::TBox<float> & getBox(void) const;
+			/** \brief Get world space bounding box. */
+			const eve::math::TBox<float> & getBoxWorld(void) const;
+			/** \brief Get object space triangles hierarchy. */
+			eve::scene::BvhMesh * getBvh(void) const;
+
+
+		public:
+			/** \brief Get scene transforms hierarchy node ID. */
+			uint32_t getTransformId(void) const;
+			/** \brief Set scene transforms hierarchy node ID. */
+			void setTransformId(uint32_t p_id);
+			/** \brief Get world matrix. */
+			const eve::mat44f & getMatrixWorld(void) const;
 
 
 		public:
@@ -167,6 +229,16 @@ namespace eve
 
 //=================================================================================================
 EVE_FORCE_INLINE eve::ogl::Vao *		eve::scene::Mesh::getVao(void) const		{ return m_pVao;		}
+EVE_FORCE_INLINE eve::ogl::Vao *		eve::scene::Mesh::getVaoCurrent(void) const	{ return (*m_pVecLodVao)[m_lodCurrent]; }
+EVE_FORCE_INLINE eve::ogl::Vao *		eve::scene::Mesh::getVaoLod(size_t p_level) const { return (*m_pVecLodVao)[p_level]; }
+EVE_FORCE_INLINE size_t					eve::scene::Mesh::getLodCount(void) const	{ return m_pVecLodVao->size(); }
+EVE_FORCE_INLINE size_t					eve::scene::Mesh::getLodCurrent(void) const	{ return m_lodCurrent;	}
+EVE_FORCE_INLINE const eve::math::TBox<float> & eve::scene::Mesh::getBox(void) const { return m_box;	}
+EVE_FORCE_INLINE const eve::math::TBox<float> & eve::scene::Mesh::getBoxWorld(void) const { return m_boxWorld; }
+EVE_FORCE_INLINE eve::scene::BvhMesh *	eve::scene::Mesh::getBvh(void) const		{ return m_pBvh;		}
+EVE_FORCE_INLINE uint32_t				eve::scene::Mesh::getTransformId(void) const { return m_transformId;	}
+EVE_FORCE_INLINE void					eve::scene::Mesh::setTransformId(uint32_t p_id) { m_transformId = p_id;	}
+EVE_FORCE_INLINE const eve::mat44f &	eve::scene::Mesh::getMatrixWorld(void) const { return m_matrixWorld;	}
 EVE_FORCE_INLINE eve::scene::Material * eve::scene::Mesh::getMaterial(void) const	{ return m_pMaterial;	}
 EVE_FORCE_INLINE eve::scene::Skeleton * eve::scene::Mesh::getSkeleton(void) const	{ return m_pSkeleton;	}
 
@@ -0,0 +1,145 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/scene/MeshCache.h"
+
+
+//=================================================================================================
+eve::scene::MeshCache * eve::scene::MeshCache::m_p_instance = nullptr;
+
+//=================================================================================================
+eve::scene::MeshCache * eve::scene::MeshCache::create_instance(void)
+{
+	EVE_ASSERT(!m_p_instance);
+	m_p_instance = EVE_CREATE_PTR(eve::scene::MeshCache);
+	return m_p_instance;
+}
+
+//=================================================================================================
+eve::scene::MeshCache * eve::scene::MeshCache::get_instance(void)
+{
+	EVE_ASSERT(m_p_instance);
+	return m_p_instance;
+}
+
+//=================================================================================================
+void eve::scene::MeshCache::release_instance(void)
+{
+	EVE_ASSERT(m_p_instance);
+	EVE_RELEASE_PTR(m_p_instance);
+}
+
+
+
+//=================================================================================================
+eve::scene::MeshCache::MeshCache(void)
+	// Inheritance
+	: eve::mem::Pointer()
+
+	// Members init
+	, m_pMapChains(nullptr)
+	, m_pFence(nullptr)
+{}
+
+
+
+//=================================================================================================
+void eve::scene::MeshCache::init(void)
+{
+	m_pMapChains = new std::map<std::string, eve::scene::MeshLodChain*>();
+	m_pFence	 = EVE_CREATE_PTR(eve::thr::SpinLock);
+}
+
+//=================================================================================================
+void eve::scene::MeshCache::release(void)
+{
+	this->clear();
+
+	EVE_RELEASE_PTR_CPP(m_pMapChains);
+	EVE_RELEASE_PTR(m_pFence);
+}
+
+
+
+//=================================================================================================
+const eve::scene::MeshLodChain * eve::scene::MeshCache::find(const std::string & p_key)
+{
+	const eve::scene::MeshLodChain * ret = nullptr;
+	m_pFence->lock();
+
+	auto itr = m_pMapChains->find(p_key);
+	if (itr != m_pMapChains->end())
+	{
+		ret = itr->second;
+	}
+
+	m_pFence->unlock();
+	return ret;
+}
+
+//=================================================================================================
+const eve::scene::MeshLodChain * eve::scene::MeshCache::insert(const std::string & p_key, eve::scene::MeshLodChain * p_pChain)
+{
+	EVE_ASSERT(p_pChain);
+
+	const eve::scene::MeshLodChain * ret = p_pChain;
+	m_pFence->lock();
+
+	auto itr = m_pMapChains->find(p_key);
+	if (itr != m_pMapChains->end())
+	{
+		// Another thread computed the same chain first, keep registered one.
+		ret = itr->second;
+		EVE_RELEASE_PTR_CPP(p_pChain);
+	}
+	else
+	{
+		(*m_pMapChains)[p_key] = p_pChain;
+	}
+
+	m_pFence->unlock();
+	return ret;
+}
+
+//=================================================================================================
+void eve::scene::MeshCache::clear(void)
+{
+	m_pFence->lock();
+
+	for (auto && itr : (*m_pMapChains))
+	{
+		EVE_RELEASE_PTR_CPP(itr.second);
+	}
+	m_pMapChains->clear();
+
+	m_pFence->unlock();
+}
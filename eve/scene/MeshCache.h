@@ -0,0 +1,142 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_SCENE_MESH_CACHE_H__
+#define __EVE_SCENE_MESH_CACHE_H__
+
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MATH_INCLUDES_H__
+#include "eve/math/Includes.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_VAO_H__
+#include "eve/ogl/core/Vao.h"
+#endif
+
+#ifndef __EVE_THREADING_SPIN_LOCK_H__
+#include "eve/thr/SpinLock.h"
+#endif
+
+
+namespace eve { namespace app { class App; } }
+
+
+namespace eve
+{
+	namespace scene
+	{
+		/** 
+		* \struct eve::scene::MeshLodChain
+		* \brief Mesh level of detail chain, level 0 being the full resolution mesh.
+		*/
+		struct MeshLodChain
+		{
+			std::vector<eve::ogl::FormatVao>	formats;		//!< Per level VAO format, sharing vertices/indices memory.
+			std::vector<float>					errors;			//!< Per level geometric error (object space distance).
+			eve::math::TBox<float>				box;			//!< Object space bounding box.
+		};
+
+
+		/**
+		* \class eve::scene::MeshCache
+		*
+		* \brief Holds imported meshes level of detail chains, so they are computed only once per mesh source.
+		* Chains are keyed by source file path, mesh index and import parameters.
+		*
+		* \note extends mem::Pointer
+		*/
+		class MeshCache final
+			: public eve::mem::Pointer
+		{
+			friend class eve::app::App;
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			static MeshCache *								m_p_instance;		//!< Unique instance.
+
+		private:
+			std::map<std::string, eve::scene::MeshLodChain*> *	m_pMapChains;		//!< Level of detail chains map.
+			eve::thr::SpinLock *							m_pFence;			//!< Map protection fence.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(MeshCache)
+			EVE_PUBLIC_DESTRUCTOR(MeshCache)
+
+		private:
+			/** \brief Create unique instance. */
+			static MeshCache * create_instance(void);
+		public:
+			/** \brief Get unique instance. */
+			static MeshCache * get_instance(void);
+		private:
+			/** \brief Release unique instance */
+			static void release_instance(void);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit MeshCache(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Get chain registered under \a p_key, return nullptr if not found. */
+			const eve::scene::MeshLodChain * find(const std::string & p_key);
+			/** \brief Register chain \a p_pChain under \a p_key, take ownership. If key is already used, \a p_pChain is released and registered chain is returned. */
+			const eve::scene::MeshLodChain * insert(const std::string & p_key, eve::scene::MeshLodChain * p_pChain);
+			/** \brief Release all registered chains. */
+			void clear(void);
+
+		}; // class MeshCache
+
+	} // namespace scene
+
+} // namespace eve
+
+#endif // __EVE_SCENE_MESH_CACHE_H__
@@ -0,0 +1,224 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/scene/MultiView.h"
+
+#ifndef __EVE_SCENE_CAMERA_H__
+#include "eve/scene/Camera.h"
+#endif
+
+#ifndef __EVE_SCENE_CULLING_H__
+#include "eve/scene/Culling.h"
+#endif
+
+#ifndef __EVE_SCENE_RENDER_QUEUE_H__
+#include "eve/scene/RenderQueue.h"
+#endif
+
+#ifndef __EVE_TIME_UTILS_H__
+#include "eve/time/Utils.h"
+#endif
+
+
+//=================================================================================================
+eve::scene::MultiView::MultiView(void)
+	// Inheritance
+	: eve::mem::Pointer()
+	// Members init
+	, m_pVecCamera(nullptr)
+	, m_pVecCulling(nullptr)
+	, m_pVecVisible(nullptr)
+	, m_pVecFrame(nullptr)
+	, m_pLatest(nullptr)
+	, m_generation(0)
+	, m_pFence(nullptr)
+	, m_counter()
+	, m_updateMicro(0)
+{}
+
+
+
+//=================================================================================================
+void eve::scene::MultiView::init(void)
+{
+	m_pVecCamera  = new std::vector<eve::scene::Camera*>();
+	m_pVecCulling = new std::vector<eve::scene::Culling*>();
+	m_pVecVisible = new std::vector<std::vector<eve::scene::Mesh*>*>();
+
+	m_pVecFrame	  = new std::vector<eve::scene::MultiViewFrame*>();
+	m_pLatest	  = nullptr;
+	m_generation  = 0;
+	m_pFence	  = EVE_CREATE_PTR(eve::thr::SpinLock);
+}
+
+//=================================================================================================
+void eve::scene::MultiView::release(void)
+{
+	// Displays release their frames before scene is released.
+	eve::scene::RenderQueue * queue = nullptr;
+	for (auto && frame : (*m_pVecFrame))
+	{
+		EVE_ASSERT(frame->refs == 0);
+		for (auto && itr : frame->queues)
+		{
+			queue = itr;
+			EVE_RELEASE_PTR(queue);
+		}
+		for (auto && itr : frame->cameras) {
+			delete itr;
+		}
+		delete frame;
+	}
+	EVE_RELEASE_PTR_CPP(m_pVecFrame);
+	m_pLatest = nullptr;
+
+	EVE_RELEASE_PTR(m_pFence);
+
+	eve::scene::Culling * culling = nullptr;
+	for (auto && itr : (*m_pVecCulling))
+	{
+		culling = itr;
+		EVE_RELEASE_PTR(culling);
+	}
+	EVE_RELEASE_PTR_CPP(m_pVecCulling);
+
+	for (auto && itr : (*m_pVecVisible))
+	{
+		delete itr;
+	}
+	EVE_RELEASE_PTR_CPP(m_pVecVisible);
+
+	// Do not delete -> shared pointers.
+	EVE_RELEASE_PTR_CPP(m_pVecCamera);
+}
+
+
+
+//=================================================================================================
+uint32_t eve::scene::MultiView::addView(eve::scene::Camera * p_pCamera)
+{
+	EVE_ASSERT(p_pCamera);
+
+	m_pVecCamera->push_back(p_pCamera);
+	m_pVecCulling->push_back(EVE_CREATE_PTR(eve::scene::Culling));
+	m_pVecVisible->push_back(new std::vector<eve::scene::Mesh*>());
+
+	return static_cast<uint32_t>(m_pVecCamera->size() - 1);
+}
+
+//=================================================================================================
+void eve::scene::MultiView::update(const std::vector<eve::scene::Mesh*> & p_vecMesh, float p_pixelError, float p_hysteresis)
+{
+	const int64_t start	   = eve::time::current_time_micro();
+	const size_t  numViews = m_pVecCamera->size();
+
+	// Latest frame may be acquired at any time, others are free once no display holds them.
+	eve::scene::MultiViewFrame * frame = nullptr;
+	m_pFence->lock();
+	for (auto && itr : (*m_pVecFrame))
+	{
+		if (itr != m_pLatest && itr->refs == 0)
+		{
+			frame = itr;
+			break;
+		}
+	}
+	if (!frame)
+	{
+		frame = new eve::scene::MultiViewFrame();
+		m_pVecFrame->push_back(frame);
+	}
+	m_pFence->unlock();
+
+	while (frame->queues.size() < numViews) {
+		frame->queues.push_back(EVE_CREATE_PTR(eve::scene::RenderQueue));
+		frame->cameras.push_back(new eve::scene::CameraFrame());
+	}
+
+	// One task per view, views share meshes so level of detail is selected without being stored.
+	eve::thr::TaskPool * pool = eve::thr::TaskPool::get_instance();
+	for (size_t v = 0; v < numViews; v++)
+	{
+		eve::scene::Camera *			 camera	 = (*m_pVecCamera)[v];
+		eve::scene::Culling *			 culling = (*m_pVecCulling)[v];
+		std::vector<eve::scene::Mesh*> * visible = (*m_pVecVisible)[v];
+		eve::scene::RenderQueue *		 queue	 = frame->queues[v];
+
+		// Displays bind camera as culled, cameras may move or be added once frame is published.
+		camera->capture(frame->cameras[v]);
+
+		pool->push([&p_vecMesh, camera, culling, visible, queue, p_pixelError, p_hysteresis](void)
+		{
+			culling->cull(p_vecMesh, camera, *visible);
+
+			queue->clear();
+			queue->add(*visible, camera, 0, 0, p_pixelError, p_hysteresis, false);
+			queue->sort();
+		}, &m_counter);
+	}
+	pool->wait(&m_counter);
+
+	m_pFence->lock();
+	frame->generation = ++m_generation;
+	m_pLatest		  = frame;
+	m_pFence->unlock();
+
+	m_updateMicro = eve::time::current_time_micro() - start;
+}
+
+
+
+//=================================================================================================
+eve::scene::MultiViewFrame * eve::scene::MultiView::acquireFrame(void)
+{
+	m_pFence->lock();
+	eve::scene::MultiViewFrame * frame = m_pLatest;
+	if (frame) {
+		frame->refs++;
+	}
+	m_pFence->unlock();
+
+	return frame;
+}
+
+//=================================================================================================
+void eve::scene::MultiView::releaseFrame(eve::scene::MultiViewFrame * p_pFrame)
+{
+	if (!p_pFrame) {
+		return;
+	}
+
+	m_pFence->lock();
+	EVE_ASSERT(p_pFrame->refs > 0);
+	p_pFrame->refs--;
+	m_pFence->unlock();
+}
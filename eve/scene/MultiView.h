@@ -0,0 +1,179 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_SCENE_MULTI_VIEW_H__
+#define __EVE_SCENE_MULTI_VIEW_H__
+
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_THREADING_INCLUDES_H__
+#include "eve/thr/Includes.h"
+#endif
+
+
+namespace eve { namespace scene { class Camera; } }
+namespace eve { namespace scene { struct CameraFrame; } }
+namespace eve { namespace scene { class Culling; } }
+namespace eve { namespace scene { class Mesh; } }
+namespace eve { namespace scene { class RenderQueue; } }
+
+
+namespace eve
+{
+	namespace scene
+	{
+		/** 
+		* \struct eve::scene::MultiViewFrame
+		* \brief Published views draw lists of one scene frame, one sorted queue and the camera state it was culled from per view.
+		* Frame is recycled once no display holds it anymore (see eve::scene::MultiView::acquireFrame()).
+		*/
+		struct MultiViewFrame
+		{
+			uint64_t								generation;		//!< Scene frame number.
+			std::vector<eve::scene::RenderQueue*>	queues;			//!< Per view sorted draw lists.
+			std::vector<eve::scene::CameraFrame*>	cameras;		//!< Per view camera state captured at culling.
+			uint32_t								refs;			//!< Displays holding frame.
+
+			MultiViewFrame(void) : generation(0), queues(), cameras(), refs(0) {}
+		};
+
+
+		/** 
+		* \class eve::scene::MultiView
+		*
+		* \brief Shared scene views, several cameras drawn by several displays from a single scene update.
+		* Each scene frame culls and queues every view in parallel on eve::thr::TaskPool, then publishes them as latest frame.
+		* Displays render threads acquire latest frame at their own pace and submit their view queue, so scene update and
+		* culling happen once per frame whatever the displays amount. Frames are pooled, a new one is only allocated when
+		* every pooled frame is still held by a display.
+		*
+		* \note extends eve::mem::Pointer
+		*/
+		class MultiView final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATAS				//
+			//////////////////////////////////////
+
+		private:
+			std::vector<eve::scene::Camera*> *					m_pVecCamera;		//!< Specifies views cameras (shared pointers).
+			std::vector<eve::scene::Culling*> *					m_pVecCulling;		//!< Specifies per view culling stage.
+			std::vector<std::vector<eve::scene::Mesh*>*> *		m_pVecVisible;		//!< Specifies per view visible meshes.
+
+		private:
+			std::vector<eve::scene::MultiViewFrame*> *			m_pVecFrame;		//!< Specifies frames pool.
+			eve::scene::MultiViewFrame *						m_pLatest;			//!< Specifies last published frame.
+			uint64_t											m_generation;		//!< Specifies published frames amount.
+			eve::thr::SpinLock *								m_pFence;			//!< Specifies frames fence (publication and displays references).
+			eve::thr::TaskCounter								m_counter;			//!< Specifies pending views tasks.
+			int64_t												m_updateMicro;		//!< Specifies last update time in microseconds.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(MultiView);
+			EVE_PUBLIC_DESTRUCTOR(MultiView);
+
+		public:
+			/** \brief Class constructor. */
+			explicit MultiView(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Add view drawn from camera \a p_pCamera, return view index. Caller holds scene objects fence. */
+			uint32_t addView(eve::scene::Camera * p_pCamera);
+			/** 
+			* \brief Cull and queue every view of \a p_vecMesh on tasks pool then publish frame. 
+			* Called once per scene frame with scene objects fence held and world matrices up to date, no OpenGL call.
+			*/
+			void update(const std::vector<eve::scene::Mesh*> & p_vecMesh, float p_pixelError, float p_hysteresis);
+
+
+		public:
+			/** \brief Acquire last published frame (nullptr if none), MUST be released by caller. */
+			eve::scene::MultiViewFrame * acquireFrame(void);
+			/** \brief Release frame \a p_pFrame, acquired with acquireFrame(). */
+			void releaseFrame(eve::scene::MultiViewFrame * p_pFrame);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get views amount. */
+			const size_t getNumViews(void) const;
+			/** \brief Get view \a p_view camera, caller holds scene objects fence (displays read published frame cameras). */
+			eve::scene::Camera * getCamera(uint32_t p_view) const;
+			/** \brief Get view \a p_view culling stage (counters and settings). */
+			eve::scene::Culling * getCulling(uint32_t p_view) const;
+			/** \brief Get published frames amount. */
+			const uint64_t getGeneration(void) const;
+			/** \brief Get last update time in microseconds. */
+			const int64_t getUpdateMicro(void) const;
+			/** \brief Get pooled frames amount. */
+			const size_t getNumFrames(void) const;
+
+		}; // class MultiView
+
+	} // namespace scene
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const size_t eve::scene::MultiView::getNumViews(void) const						{ return m_pVecCamera->size();		}
+EVE_FORCE_INLINE eve::scene::Camera * eve::scene::MultiView::getCamera(uint32_t p_view) const		{ return (*m_pVecCamera)[p_view];	}
+EVE_FORCE_INLINE eve::scene::Culling * eve::scene::MultiView::getCulling(uint32_t p_view) const	{ return (*m_pVecCulling)[p_view];	}
+EVE_FORCE_INLINE const uint64_t eve::scene::MultiView::getGeneration(void) const					{ return m_generation;				}
+EVE_FORCE_INLINE const int64_t eve::scene::MultiView::getUpdateMicro(void) const					{ return m_updateMicro;				}
+EVE_FORCE_INLINE const size_t eve::scene::MultiView::getNumFrames(void) const						{ return m_pVecFrame->size();		}
+
+#endif // __EVE_SCENE_MULTI_VIEW_H__
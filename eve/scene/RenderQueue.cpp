@@ -0,0 +1,425 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/scene/RenderQueue.h"
+
+#ifndef __EVE_SCENE_CAMERA_H__
+#include "eve/scene/Camera.h"
+#endif
+
+#ifndef __EVE_SCENE_GEOMETRY_POOL_H__
+#include "eve/scene/GeometryPool.h"
+#endif
+
+#ifndef __EVE_SCENE_MATERIAL_H__
+#include "eve/scene/Material.h"
+#endif
+
+#ifndef __EVE_SCENE_MESH_H__
+#include "eve/scene/Mesh.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_RING_BUFFER_H__
+#include "eve/ogl/core/RingBuffer.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_VAO_H__
+#include "eve/ogl/core/Vao.h"
+#endif
+
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#include "eve/thr/TaskPool.h"
+#endif
+
+#ifndef __EVE_TIME_UTILS_H__
+#include "eve/time/Utils.h"
+#endif
+
+
+//=================================================================================================
+eve::scene::RenderQueue::RenderQueue(void)
+	// Inheritance
+	: eve::mem::Pointer()
+	// Members init
+	, m_pItems(nullptr)
+	, m_pScratch(nullptr)
+	, m_pMatrices(nullptr)
+	, m_pCommands(nullptr)
+	, m_bParallel(true)
+	, m_parallelMin(4096)
+	, m_stats()
+{}
+
+
+
+//=================================================================================================
+void eve::scene::RenderQueue::init(void)
+{
+	m_pItems	= new std::vector<eve::scene::RenderItem>();
+	m_pScratch	= new std::vector<eve::scene::RenderItem>();
+	m_pMatrices = new std::vector<eve::mat44f>();
+	m_pCommands = new std::vector<eve::ogl::DrawElementsCommand>();
+}
+
+//=================================================================================================
+void eve::scene::RenderQueue::release(void)
+{
+	EVE_RELEASE_PTR_CPP(m_pItems);
+	EVE_RELEASE_PTR_CPP(m_pScratch);
+	EVE_RELEASE_PTR_CPP(m_pMatrices);
+	EVE_RELEASE_PTR_CPP(m_pCommands);
+}
+
+
+
+//=================================================================================================
+uint64_t eve::scene::RenderQueue::make_key(uint32_t p_pass, uint32_t p_shader, uint32_t p_material, uint32_t p_geometry, float p_depth)
+{
+	float	 depth	= std::min(std::max(p_depth, 0.0f), 1.0f);
+	uint64_t qdepth = static_cast<uint64_t>(depth * 65535.0f);
+
+	return (static_cast<uint64_t>(p_pass	 & 0xF)	   << 60)
+		 | (static_cast<uint64_t>(p_shader	 & 0xFFF)  << 48)
+		 | (static_cast<uint64_t>(p_material & 0xFFFF) << 32)
+		 | (static_cast<uint64_t>(p_geometry & 0xFFFF) << 16)
+		 | qdepth;
+}
+
+
+
+//=================================================================================================
+void eve::scene::RenderQueue::clear(void)
+{
+	m_pItems->clear();
+	m_pMatrices->clear();
+	m_stats = eve::scene::RenderQueueStats();
+}
+
+//=================================================================================================
+void eve::scene::RenderQueue::add(const std::vector<eve::scene::Mesh*> & p_vecMesh
+								, const eve::scene::Camera * p_pCamera
+								, uint32_t p_pass
+								, uint32_t p_shader
+								, float p_pixelError
+								, float p_hysteresis
+								, bool p_bUpdateLod)
+{
+	EVE_ASSERT(p_pCamera);
+
+	const int64_t start = eve::time::current_time_micro();
+
+	// Each mesh writes its own slot, no synchronization required.
+	const size_t first	 = m_pItems->size();
+	const size_t numMesh = p_vecMesh.size();
+	m_pItems->resize(first + numMesh);
+	m_pMatrices->resize(first + numMesh);
+
+	eve::scene::RenderItem * items	  = m_pItems->data() + first;
+	eve::mat44f *			 matrices = m_pMatrices->data() + first;
+	const float				 invFar = 1.0f / p_pCamera->getFarClip();
+
+	auto emit = [&](size_t p_begin, size_t p_end)
+	{
+		for (size_t i = p_begin; i < p_end; i++)
+		{
+			eve::scene::Mesh * mesh = p_vecMesh[i];
+			size_t			   lod	= mesh->getLodCurrent();
+			if (p_bUpdateLod)
+			{
+				mesh->updateLod(p_pCamera, p_pixelError, p_hysteresis);
+				lod = mesh->getLodCurrent();
+			}
+			else
+			{
+				lod = mesh->selectLod(p_pCamera, p_pixelError, p_hysteresis, lod);
+			}
+
+			// Material address groups identical materials, collisions only cost extra binds.
+			uintptr_t addr	   = reinterpret_cast<uintptr_t>(mesh->getMaterial());
+			uint32_t  material = static_cast<uint32_t>((addr >> 4) ^ (addr >> 20));
+			// Geometry data addresses group meshes sharing cached geometry (distinct VAOs), collisions only split batches.
+			const eve::ogl::Vao * vao = mesh->getVaoLod(lod);
+			uintptr_t vtx	   = reinterpret_cast<uintptr_t>(vao->getVertices().get());
+			uintptr_t idx	   = reinterpret_cast<uintptr_t>(vao->getIndices().get());
+			uint32_t  geometry = static_cast<uint32_t>((vtx >> 4) ^ (idx >> 4) ^ (idx >> 20));
+			float	  depth	   = -p_pCamera->worldToEyeDepth(mesh->getBoxWorld().getCenter()) * invFar;
+
+			items[i].key	= eve::scene::RenderQueue::make_key(p_pass, p_shader, material, geometry, depth);
+			items[i].pMesh	= mesh;
+			items[i].lod	= static_cast<uint32_t>(lod);
+			items[i].matrix = static_cast<uint32_t>(first + i);
+			matrices[i]		= mesh->getMatrixWorld();
+		}
+	};
+
+	if (m_bParallel && numMesh >= m_parallelMin)
+	{
+		eve::thr::TaskPool::get_instance()->parallel_for(0, numMesh, 1024, emit);
+	}
+	else
+	{
+		emit(0, numMesh);
+	}
+
+	m_stats.buildMicro += eve::time::current_time_micro() - start;
+}
+
+//=================================================================================================
+void eve::scene::RenderQueue::sort(void)
+{
+	const int64_t start = eve::time::current_time_micro();
+
+	const size_t numItems = m_pItems->size();
+	m_pScratch->resize(numItems);
+
+	// All digits histograms in a single sweep.
+	size_t histo[8][256];
+	eve::mem::memset(histo, 0, sizeof(histo));
+	for (auto && item : (*m_pItems))
+	{
+		for (uint32_t d = 0; d < 8; d++) {
+			histo[d][(item.key >> (d * 8)) & 0xFF]++;
+		}
+	}
+
+	eve::scene::RenderItem * src = m_pItems->data();
+	eve::scene::RenderItem * dst = m_pScratch->data();
+
+	for (uint32_t d = 0; d < 8; d++)
+	{
+		// Digit shared by every key, pass would not move anything.
+		const uint64_t digit = (numItems > 0) ? ((src[0].key >> (d * 8)) & 0xFF) : 0;
+		if (histo[d][digit] == numItems) {
+			continue;
+		}
+
+		size_t offsets[256];
+		size_t sum = 0;
+		for (uint32_t b = 0; b < 256; b++)
+		{
+			offsets[b] = sum;
+			sum		  += histo[d][b];
+		}
+
+		for (size_t i = 0; i < numItems; i++) {
+			dst[offsets[(src[i].key >> (d * 8)) & 0xFF]++] = src[i];
+		}
+
+		std::swap(src, dst);
+		m_stats.numSortPasses++;
+	}
+
+	// Odd passes amount leaves result in scratch buffer.
+	if (src != m_pItems->data()) {
+		std::swap(m_pItems, m_pScratch);
+	}
+
+	m_stats.sortMicro += eve::time::current_time_micro() - start;
+}
+
+//=================================================================================================
+void eve::scene::RenderQueue::submit(eve::ogl::RingBuffer * p_pRing, const eve::scene::GeometryPool * p_pGeometry, const std::function<void(uint32_t, uint32_t)> & p_onShader)
+{
+	eve::scene::RenderItem * items	  = m_pItems->data();
+	const size_t			 numItems = m_pItems->size();
+	const eve::mat44f *		 matrices = m_pMatrices->data();
+
+	// Per instance world matrices in sorted order, item i reads instance i.
+	float *	 instances = nullptr;
+	GLintptr offset	   = -1;
+	if (p_pRing && numItems > 0) {
+		offset = p_pRing->allocate(static_cast<GLsizeiptr>(numItems * 16 * sizeof(float)), reinterpret_cast<void**>(&instances));
+	}
+	const bool batched = (offset >= 0);
+
+	if (batched)
+	{
+		auto write = [&](size_t p_begin, size_t p_end)
+		{
+			for (size_t i = p_begin; i < p_end; i++) {
+				eve::mem::memcpy(instances + i * 16, static_cast<const float*>(matrices[items[i].matrix]), 16 * sizeof(float));
+			}
+		};
+
+		if (m_bParallel && numItems >= m_parallelMin) {
+			eve::thr::TaskPool::get_instance()->parallel_for(0, numItems, 1024, write);
+		}
+		else {
+			write(0, numItems);
+		}
+	}
+
+	uint64_t				 shaderBits	   = ~uint64_t(0);
+	eve::scene::Material *	 material	   = nullptr;
+	eve::ogl::Vao *			 indirectVao   = nullptr;
+	bool					 indirectBound = false;
+	m_pCommands->clear();
+
+	// Issue commands gathered on merged VAO, single multi draw indirect call when supported.
+	auto flush = [&](void)
+	{
+		if (m_pCommands->empty()) {
+			return;
+		}
+
+		const GLsizei numCommands = static_cast<GLsizei>(m_pCommands->size());
+		indirectVao->bindInstances(p_pRing->getId(), offset);
+
+		GLintptr commands = -1;
+		if (numCommands > 1 && GLEW_ARB_multi_draw_indirect) {
+			commands = p_pRing->push(m_pCommands->data(), static_cast<GLsizeiptr>(numCommands * sizeof(eve::ogl::DrawElementsCommand)));
+		}
+
+		if (commands >= 0)
+		{
+			if (!indirectBound)
+			{
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, p_pRing->getId());
+				indirectBound = true;
+			}
+			indirectVao->drawIndirect(commands, numCommands);
+			m_stats.numDrawCalls++;
+			m_stats.numIndirectCommands += numCommands;
+		}
+		else
+		{
+			for (auto && cmd : (*m_pCommands))
+			{
+				indirectVao->drawCommand(cmd);
+				m_stats.numDrawCalls++;
+				if (cmd.instanceCount > 1) { m_stats.numInstancedDraws++; }
+			}
+		}
+
+		m_pCommands->clear();
+	};
+
+	size_t i = 0;
+	while (i < numItems)
+	{
+		eve::scene::Mesh * mesh = items[i].pMesh;
+
+		// OpenGL init is budgeted by renderer queues, mesh is drawn once its objects exist.
+		if (!mesh->isInitialized(items[i].lod))
+		{
+			m_stats.numSkipped++;
+			i++;
+			continue;
+		}
+
+		uint64_t bits = items[i].key >> 48;
+		if (bits != shaderBits)
+		{
+			flush();
+			shaderBits = bits;
+			if (p_onShader) {
+				p_onShader(static_cast<uint32_t>(bits >> 12), static_cast<uint32_t>(bits & 0xFFF));
+			}
+			// Shader switch may reset bindings.
+			material = nullptr;
+			m_stats.numShaderChanges++;
+		}
+
+		eve::scene::Material * mat = mesh->getMaterial();
+		if (mat != material && mat)
+		{
+			flush();
+			mat->bind();
+			material = mat;
+			m_stats.numMaterialChanges++;
+		}
+
+		// Ring region full, draw one by one.
+		if (!batched)
+		{
+			mesh->oglDrawGeometry(items[i].lod, matrices[items[i].matrix]);
+			m_stats.numDrawCalls++;
+			i++;
+			continue;
+		}
+
+		// Run of items sharing shader, material and geometry, key equality alone may hide hash collisions.
+		eve::ogl::Vao * vao = mesh->getVaoLod(items[i].lod);
+		const float *	vtx = vao->getVertices().get();
+		const GLuint *	idx = vao->getIndices().get();
+
+		size_t end = i + 1;
+		while (end < numItems)
+		{
+			const eve::scene::Mesh * next	 = items[end].pMesh;
+			const eve::ogl::Vao *	 nextVao = next->getVaoLod(items[end].lod);
+			if ((items[end].key >> 16) != (items[i].key >> 16)
+			 || !next->isInitialized(items[end].lod)
+			 || next->getMaterial() != mat
+			 || (nextVao != vao && (nextVao->getVertices().get() != vtx || nextVao->getIndices().get() != idx))) {
+				break;
+			}
+			end++;
+		}
+		const GLuint numInstances = static_cast<GLuint>(end - i);
+
+		const eve::scene::GeometryRange * range = p_pGeometry ? p_pGeometry->find(vao) : nullptr;
+		if (range)
+		{
+			if (range->pVao != indirectVao)
+			{
+				flush();
+				indirectVao = range->pVao;
+			}
+
+			eve::ogl::DrawElementsCommand cmd;
+			cmd.count		  = range->numIndices;
+			cmd.instanceCount = numInstances;
+			cmd.firstIndex	  = range->firstIndex;
+			cmd.baseVertex	  = range->baseVertex;
+			cmd.baseInstance  = static_cast<GLuint>(i);
+			m_pCommands->push_back(cmd);
+		}
+		else
+		{
+			flush();
+			vao->bindInstances(p_pRing->getId(), offset);
+			vao->drawInstanced(static_cast<GLsizei>(numInstances), static_cast<GLuint>(i));
+			m_stats.numDrawCalls++;
+			if (numInstances > 1) { m_stats.numInstancedDraws++; }
+		}
+
+		i = end;
+	}
+	flush();
+
+	if (indirectBound) {
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+	m_stats.numItems = numItems;
+}
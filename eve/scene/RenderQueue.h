@@ -0,0 +1,218 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_SCENE_RENDER_QUEUE_H__
+#define __EVE_SCENE_RENDER_QUEUE_H__
+
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MATH_INCLUDES_H__
+#include "eve/math/Includes.h"
+#endif
+
+#include <functional>
+
+
+namespace eve { namespace ogl { class RingBuffer; } }
+namespace eve { namespace ogl { struct DrawElementsCommand; } }
+namespace eve { namespace scene { class Camera; } }
+namespace eve { namespace scene { class GeometryPool; } }
+namespace eve { namespace scene { class Mesh; } }
+
+
+namespace eve
+{
+	namespace scene
+	{
+		/** 
+		* \struct eve::scene::RenderItem
+		* \brief Render queue entry, 64 bits sort key and drawn mesh.
+		* Level of detail and world matrix are captured when added, so mesh may be updated for next frame while queue is submitted.
+		*/
+		struct RenderItem
+		{
+			uint64_t					key;			//!< Sort key (pass, shader, material, geometry, depth from most to least significant bits).
+			eve::scene::Mesh *			pMesh;			//!< Drawn mesh.
+			uint32_t					lod;			//!< Drawn level of detail.
+			uint32_t					matrix;			//!< World matrix index in queue matrices.
+		};
+
+
+		/** 
+		* \struct eve::scene::RenderQueueStats
+		* \brief Render queue last frame counters.
+		*/
+		struct RenderQueueStats
+		{
+			uint64_t		numItems;			//!< Submitted items amount.
+			uint64_t		numShaderChanges;	//!< Pass/shader changes amount.
+			uint64_t		numMaterialChanges;	//!< Material binds amount.
+			uint64_t		numDrawCalls;		//!< OpenGL draw calls amount (a multi draw indirect call counts once).
+			uint64_t		numInstancedDraws;	//!< Instanced draws amount (single geometry, several meshes).
+			uint64_t		numIndirectCommands;//!< Commands submitted through multi draw indirect calls.
+			uint64_t		numSortPasses;		//!< Radix passes actually run (constant bytes are skipped).
+			uint64_t		numSkipped;			//!< Items skipped since their OpenGL init is still pending.
+			int64_t			buildMicro;			//!< Keys generation time in microseconds.
+			int64_t			sortMicro;			//!< Sort time in microseconds.
+
+			RenderQueueStats(void) : numItems(0), numShaderChanges(0), numMaterialChanges(0), numDrawCalls(0), numInstancedDraws(0), numIndirectCommands(0), numSortPasses(0), numSkipped(0), buildMicro(0), sortMicro(0) {}
+		};
+
+
+		/**
+		* \class eve::scene::RenderQueue
+		*
+		* \brief Per frame sorted draw list.
+		* Visible meshes emit a 64 bits key packing pass (4 bits), shader (12 bits), material (16 bits), geometry (16 bits) and depth (16 bits),
+		* keys are generated on eve::thr::TaskPool for large sets, radix sorted and submitted binding material only when it changes.
+		* Opaque passes sort front to back, depth is quantized view distance over camera far clip.
+		* Geometry is identified by VAO vertices/indices data, so meshes sharing eve::scene::MeshCache data batch together:
+		* world matrices are streamed per instance, runs of one geometry are drawn instanced and runs of several geometries
+		* merged in a eve::scene::GeometryPool VAO are drawn by a single multi draw indirect call.
+		*
+		* \note extends eve::mem::Pointer
+		*/
+		class RenderQueue final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATAS				//
+			//////////////////////////////////////
+
+		private:
+			std::vector<eve::scene::RenderItem> *			m_pItems;		//!< Specifies frame items.
+			std::vector<eve::scene::RenderItem> *			m_pScratch;		//!< Specifies radix sort ping-pong buffer.
+			std::vector<eve::mat44f> *						m_pMatrices;	//!< Specifies items world matrices, in add() order.
+			std::vector<eve::ogl::DrawElementsCommand> *	m_pCommands;	//!< Specifies pending indirect commands (merged geometry batch).
+
+		private:
+			bool									m_bParallel;		//!< Specifies whether keys generation may run on tasks pool.
+			size_t									m_parallelMin;		//!< Specifies items amount from which keys generation runs on tasks pool.
+
+		private:
+			eve::scene::RenderQueueStats			m_stats;			//!< Specifies last frame counters.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(RenderQueue);
+			EVE_PUBLIC_DESTRUCTOR(RenderQueue);
+
+		public:
+			/** \brief Class constructor. */
+			explicit RenderQueue(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Pack sort key, \a p_depth in [0, 1] range (clamped). */
+			static uint64_t make_key(uint32_t p_pass, uint32_t p_shader, uint32_t p_material, uint32_t p_geometry, float p_depth);
+
+
+		public:
+			/** \brief Remove every item, to be called once per frame before add(). */
+			void clear(void);
+			/** 
+			* \brief Append \a p_vecMesh to queue for pass \a p_pass and shader \a p_shader.
+			* Each mesh selects its level of detail on \a p_pCamera (see eve::scene::Mesh::updateLod()) then emits its key,
+			* level and world matrix are captured. No OpenGL call, may run on a worker thread.
+			* When \a p_bUpdateLod is false level is selected without being stored on mesh (several views queued concurrently).
+			*/
+			void add(const std::vector<eve::scene::Mesh*> & p_vecMesh
+				   , const eve::scene::Camera * p_pCamera
+				   , uint32_t p_pass
+				   , uint32_t p_shader
+				   , float p_pixelError
+				   , float p_hysteresis
+				   , bool p_bUpdateLod = true);
+			/** \brief Sort items by key (LSD radix sort, 8 bits digits, stable). */
+			void sort(void);
+			/** 
+			* \brief Draw items in key order, binding material only when it changes.
+			* Items are batched when \a p_pRing is valid (shader must read world matrix from EVE_OGL_ATTRIBUTE_INSTANCE), 
+			* drawn one by one otherwise or when ring region is full.
+			* \param p_pRing draw ring buffer receiving instance matrices and indirect commands (may be nullptr).
+			* \param p_pGeometry merged geometry used by multi draw indirect (may be nullptr).
+			* \param p_onShader called with pass and shader ids before first item and each time they change (may be empty).
+			*/
+			void submit(eve::ogl::RingBuffer * p_pRing, const eve::scene::GeometryPool * p_pGeometry, const std::function<void(uint32_t, uint32_t)> & p_onShader);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get items (sorted after sort()). */
+			const std::vector<eve::scene::RenderItem> & getItems(void) const;
+			/** \brief Get last frame counters. */
+			const eve::scene::RenderQueueStats & getStats(void) const;
+
+
+		public:
+			/** \brief Get whether keys generation may run on tasks pool. */
+			const bool getParallel(void) const;
+			/** \brief Set whether keys generation may run on tasks pool, \a p_minItems items amount from which it is used. */
+			void setParallel(bool p_bParallel, size_t p_minItems = 4096);
+
+		}; // class RenderQueue
+
+	} // namespace scene
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const std::vector<eve::scene::RenderItem> & eve::scene::RenderQueue::getItems(void) const	{ return *m_pItems;	}
+EVE_FORCE_INLINE const eve::scene::RenderQueueStats & eve::scene::RenderQueue::getStats(void) const			{ return m_stats;	}
+
+//=================================================================================================
+EVE_FORCE_INLINE const bool eve::scene::RenderQueue::getParallel(void) const						{ return m_bParallel;		}
+EVE_FORCE_INLINE void eve::scene::RenderQueue::setParallel(bool p_bParallel, size_t p_minItems)	{ m_bParallel = p_bParallel; m_parallelMin = p_minItems; }
+
+#endif // __EVE_SCENE_RENDER_QUEUE_H__
@@ -2,6 +2,10 @@
 // Main header
 #include "eve/scene/Scene.h"
 
+#ifndef __EVE_SCENE_BVH_H__
+#include "eve/scene/Bvh.h"
+#endif
+
 #ifndef __EVE_SCENE_MESH_H__
 #include "eve/scene/Mesh.h"
 #endif
@@ -10,6 +14,34 @@
 #include "eve/scene/Camera.h"
 #endif
 
+#ifndef __EVE_SCENE_CULLING_H__
+#include "eve/scene/Culling.h"
+#endif
+
+#ifndef __EVE_SCENE_GEOMETRY_POOL_H__
+#include "eve/scene/GeometryPool.h"
+#endif
+
+#ifndef __EVE_SCENE_MULTI_VIEW_H__
+#include "eve/scene/MultiView.h"
+#endif
+
+#ifndef __EVE_SCENE_RENDER_QUEUE_H__
+#include "eve/scene/RenderQueue.h"
+#endif
+
+#ifndef __EVE_SCENE_TRANSFORM_HIERARCHY_H__
+#include "eve/scene/TransformHierarchy.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_PROGRAM_CACHE_H__
+#include "eve/ogl/core/ProgramCache.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_SHADER_RELOADER_H__
+#include "eve/ogl/core/ShaderReloader.h"
+#endif
+
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 
@@ -25,6 +57,23 @@ eve::scene::Scene::Scene(void)
 	, m_pVecCamera(nullptr)
 	, m_pCameraActive(nullptr)
 	, m_pVecMesh(nullptr)
+	, m_pTransforms(nullptr)
+	, m_pFenceObjects(nullptr)
+	, m_pBvh(nullptr)
+	, m_bBvhDirty(false)
+	, m_pCulling(nullptr)
+	, m_pVecVisible()
+	, m_pRenderQueue()
+	, m_pCameraFrame()
+	, m_bCameraFrame()
+	, m_pUniformCamera(nullptr)
+	, m_pGeometry(nullptr)
+	, m_pVecGeometryPending(nullptr)
+	, m_numGeometryPending(0)
+	, m_bGeometryDirty(false)
+	, m_pMultiView(nullptr)
+	, m_lodPixelError(1.0f)
+	, m_lodHysteresis(0.25f)
 	, m_pShaderMesh(nullptr)
 {}
 
@@ -44,6 +93,8 @@ void eve::scene::Scene::init(void)
 		m_map_import_params[SceneImportParam_Flip_UV]			= "N";
 		m_map_import_params[SceneImportParam_Generate_Normals]	= "Y";
 		m_map_import_params[SceneImportParam_Normals_Max_Angle]	= "80.0";
+		m_map_import_params[SceneImportParam_Lod_Levels]		= "4";
+		m_map_import_params[SceneImportParam_Lod_Reduction]		= "0.5";
 		bImportParamsInitialized = true;
 	}
 
@@ -51,11 +102,52 @@ void eve::scene::Scene::init(void)
 	m_pVecCamera = new std::vector<eve::scene::Camera*>();
 	m_pVecMesh	 = new std::vector<eve::scene::Mesh*>();
 
+	// Transforms hierarchy.
+	m_pTransforms = EVE_CREATE_PTR(eve::scene::TransformHierarchy);
+	// Display holds renderer fence while next frame is prepared, objects get their own.
+	m_pFenceObjects = EVE_CREATE_PTR(eve::thr::Mutex);
+
+	// Meshes hierarchy.
+	m_pBvh		= EVE_CREATE_PTR(eve::scene::BvhScene);
+	m_bBvhDirty = false;
+
+	// Frustum culling.
+	m_pCulling	  = EVE_CREATE_PTR(eve::scene::Culling);
+	for (uint32_t i = 0; i < EVE_RENDERER_NUM_SLOTS; i++)
+	{
+		m_pVecVisible[i]  = new std::vector<eve::scene::Mesh*>();
+		m_pRenderQueue[i] = EVE_CREATE_PTR(eve::scene::RenderQueue);
+		m_pCameraFrame[i] = new eve::scene::CameraFrame();
+		m_bCameraFrame[i] = false;
+	}
+
+	// Camera matrices, written to uniform ring buffer at bind time.
+	eve::ogl::FormatUniform fmtUniform;
+	fmtUniform.blockSize = EVE_OGL_SIZEOF_MAT4 * 2;
+	fmtUniform.dynamic	 = false;
+	fmtUniform.streamed	 = true;
+	m_pUniformCamera	 = this->create(fmtUniform);
+
+	// Merged geometry, grown by pages once meshes are loaded.
+	m_pGeometry			  = eve::scene::GeometryPool::create_ptr(this);
+	m_pVecGeometryPending = new std::vector<eve::scene::Mesh*>();
+	m_numGeometryPending  = 0;
+	m_bGeometryDirty	  = false;
+
 	// Mesh shader.
+	eve::ogl::ProgramCache * pCache = eve::ogl::ProgramCache::get_instance();
+	std::vector<std::string> paths;
+	paths.push_back(eve::io::resource_path_glsl("SceneGBuffer.vert"));
+	paths.push_back(eve::io::resource_path_glsl("SceneGBuffer.frag"));
+	pCache->preload(paths);
+
 	eve::ogl::FormatShader fmtShader;
-	fmtShader.vert = eve::io::load_program(eve::io::resource_path_glsl("SceneGBuffer.vert"));
-	fmtShader.frag = eve::io::load_program(eve::io::resource_path_glsl("SceneGBuffer.frag"));
+	fmtShader.vert = pCache->source(paths[0]);
+	fmtShader.frag = pCache->source(paths[1]);
 	m_pShaderMesh  = this->create(fmtShader);
+
+	eve::ogl::ShaderReloader::get_instance()->watch(m_pShaderMesh, eve::ogl::prgm_Vertex,	paths[0]);
+	eve::ogl::ShaderReloader::get_instance()->watch(m_pShaderMesh, eve::ogl::prgm_Fragment, paths[1]);
 }
 
 //=================================================================================================
@@ -67,6 +159,22 @@ void eve::scene::Scene::release(void)
 	// Shader.
 	m_pShaderMesh->requestRelease();
 	m_pShaderMesh = nullptr;
+	m_pUniformCamera->requestRelease();
+	m_pUniformCamera = nullptr;
+
+	// Meshes hierarchy.
+	EVE_RELEASE_PTR(m_pBvh);
+	EVE_RELEASE_PTR(m_pCulling);
+	for (uint32_t i = 0; i < EVE_RENDERER_NUM_SLOTS; i++)
+	{
+		EVE_RELEASE_PTR_CPP(m_pVecVisible[i]);
+		EVE_RELEASE_PTR(m_pRenderQueue[i]);
+		EVE_RELEASE_PTR_CPP(m_pCameraFrame[i]);
+	}
+	EVE_RELEASE_PTR(m_pGeometry);
+	// Do not delete -> shared pointers.
+	EVE_RELEASE_PTR_CPP(m_pVecGeometryPending);
+	EVE_RELEASE_PTR_SAFE(m_pMultiView);
 
 	// Meshes.
 	eve::scene::Mesh * mesh = nullptr;
@@ -78,6 +186,10 @@ void eve::scene::Scene::release(void)
 	}
 	EVE_RELEASE_PTR_CPP(m_pVecMesh);
 
+	// Transforms hierarchy.
+	EVE_RELEASE_PTR(m_pTransforms);
+	EVE_RELEASE_PTR(m_pFenceObjects);
+
 	// Cameras.
 	eve::scene::Camera * cam = nullptr;
 	while (!m_pVecCamera->empty())
@@ -171,12 +283,39 @@ bool eve::scene::Scene::load(const std::wstring & p_filePath)
 		else if (axis == "Y") { upAxis = eve::Axis_Y; }
 		else if (axis == "Z") { upAxis = eve::Axis_Z; }
 
-		// Run threw scene meshes.
+		// Run threw scene meshes, shallowest nodes first so parent meshes exist before their children.
 		if (pAiScene->HasMeshes())
 		{
-			for (size_t i = 0; i < pAiScene->mNumMeshes; i++)
+			const aiNode * pRoot = pAiScene->mRootNode;
+
+			std::vector<std::pair<uint32_t, uint32_t>> order;
+			for (uint32_t i = 0; i < pAiScene->mNumMeshes; i++)
 			{
-				this->add(pAiScene->mMeshes[i], pAiScene, upAxis, path);
+				uint32_t depth = 0;
+				for (const aiNode * node = pRoot->FindNode(pAiScene->mMeshes[i]->mName); node && node != pRoot; node = node->mParent) { depth++; }
+				order.push_back(std::make_pair(depth, i));
+			}
+			std::stable_sort(order.begin(), order.end(), [](const std::pair<uint32_t, uint32_t> & a, const std::pair<uint32_t, uint32_t> & b) { return a.first < b.first; });
+
+			// Scene node to first mesh loaded on it, same node lookup as eve::scene::Mesh::init().
+			std::map<const aiNode*, eve::scene::Mesh*> nodeMeshes;
+			for (auto && itr : order)
+			{
+				const aiMesh * pMesh = pAiScene->mMeshes[itr.second];
+				const aiNode * pNode = pRoot->FindNode(pMesh->mName);
+
+				// Closest ancestor node owning a mesh.
+				eve::scene::Mesh * parent = nullptr;
+				for (const aiNode * node = pNode ? pNode->mParent : nullptr; node && !parent; node = node->mParent)
+				{
+					auto found = nodeMeshes.find(node);
+					if (found != nodeMeshes.end()) { parent = found->second; }
+				}
+
+				eve::scene::Mesh * mesh = this->addMesh(pMesh, pAiScene, upAxis, path, parent);
+				if (mesh && pNode && nodeMeshes.find(pNode) == nodeMeshes.end()) {
+					nodeMeshes[pNode] = mesh;
+				}
 			}
 		}
 
@@ -229,20 +368,36 @@ bool eve::scene::Scene::load(const std::wstring & p_filePath)
 
 
 //=================================================================================================
-bool eve::scene::Scene::add(const aiMesh * p_pMesh, const aiScene * p_pScene, eve::Axis p_upAxis, const std::string & p_fullPath)
+bool eve::scene::Scene::add(const aiMesh * p_pMesh, const aiScene * p_pScene, eve::Axis p_upAxis, const std::string & p_fullPath, eve::scene::Mesh * p_pParent)
+{
+	return this->addMesh(p_pMesh, p_pScene, p_upAxis, p_fullPath, p_pParent) != nullptr;
+}
+
+//=================================================================================================
+eve::scene::Mesh * eve::scene::Scene::addMesh(const aiMesh * p_pMesh, const aiScene * p_pScene, eve::Axis p_upAxis, const std::string & p_fullPath, eve::scene::Mesh * p_pParent)
 {
-	bool ret = false;
 	m_pFence->lock();
+	m_pFenceObjects->lock();
 
-	eve::scene::Mesh * mesh = eve::scene::Mesh::create_ptr(this, nullptr, p_pMesh, p_pScene, p_upAxis, p_fullPath);
+	// Local matrix is relative to parent mesh node (see eve::scene::Mesh::init()).
+	eve::scene::Mesh * mesh = eve::scene::Mesh::create_ptr(this, p_pParent, p_pMesh, p_pScene, p_upAxis, p_fullPath);
 	if (mesh) 
 	{
+		uint32_t parent = EVE_TRANSFORM_NONE;
+		if (mesh->getParent() && mesh->getParent()->getType() == eve::scene::SceneObject_Mesh) {
+			parent = static_cast<eve::scene::Mesh*>(mesh->getParent())->getTransformId();
+		}
+		mesh->setTransformId(m_pTransforms->add(mesh, mesh->getMatrixModelView(), parent));
+
 		m_pVecMesh->push_back(mesh);
-		ret = true;
+		m_pVecGeometryPending->push_back(mesh);
+		m_bBvhDirty		 = true;
+		m_bGeometryDirty = true;
 	}
 
+	m_pFenceObjects->unlock();
 	m_pFence->unlock();
-	return ret;
+	return mesh;
 }
 
 //=================================================================================================
@@ -250,6 +405,7 @@ bool eve::scene::Scene::add(const aiCamera * p_pCamera, const aiScene * p_pScene
 {
 	bool ret = false;
 	m_pFence->lock();
+	m_pFenceObjects->lock();
 
 	eve::scene::Camera * cam = eve::scene::Camera::create_ptr(this, nullptr, p_pCamera, p_pScene, p_upAxis);
 	if (cam)
@@ -259,6 +415,7 @@ bool eve::scene::Scene::add(const aiCamera * p_pCamera, const aiScene * p_pScene
 		ret = true;
 	}
 
+	m_pFenceObjects->unlock();
 	m_pFence->unlock();
 	return ret;
 }
@@ -266,49 +423,183 @@ bool eve::scene::Scene::add(const aiCamera * p_pCamera, const aiScene * p_pScene
 
 
 //=================================================================================================
-void eve::scene::Scene::cb_display(void)
+void eve::scene::Scene::updateBvh(void)
 {
+	m_pFence->lock();
+	m_pFenceObjects->lock();
+
+	// World boxes and matrices MUST be resolved, picking may run before next prepare pass.
+	m_pTransforms->update();
+
+	if (m_bBvhDirty)
+	{
+		m_pBvh->build(*m_pVecMesh);
+		m_bBvhDirty = false;
+	}
+	else
+	{
+		m_pBvh->refit();
+	}
+
+	m_pFenceObjects->unlock();
+	m_pFence->unlock();
+}
+
+//=================================================================================================
+bool eve::scene::Scene::pick(const eve::math::TRay<float> & p_ray, eve::scene::BvhHit * p_pHit)
+{
+	this->updateBvh();
+	return m_pBvh->intersect(p_ray, p_pHit);
+}
+
+
+
+//=================================================================================================
+uint32_t eve::scene::Scene::addView(eve::scene::Camera * p_pCamera)
+{
+	EVE_ASSERT(p_pCamera);
+
+	m_pFenceObjects->lock();
+
+	EVE_ASSERT(std::find(m_pVecCamera->begin(), m_pVecCamera->end(), p_pCamera) != m_pVecCamera->end());
+	if (!m_pMultiView) {
+		m_pMultiView = EVE_CREATE_PTR(eve::scene::MultiView);
+	}
+	uint32_t view = m_pMultiView->addView(p_pCamera);
+
+	m_pFenceObjects->unlock();
+
+	return view;
+}
+
+
+
+//=================================================================================================
+void eve::scene::Scene::cb_prepare(uint32_t p_slot)
+{
+	std::vector<eve::scene::Mesh*> * visible = m_pVecVisible[p_slot];
+	eve::scene::RenderQueue *		 queue	 = m_pRenderQueue[p_slot];
+
+	m_pFenceObjects->lock();
+
+	// Resolve world matrices of changed subtrees before culling, once for every view.
+	m_pTransforms->update();
+
+	queue->clear();
+	visible->clear();
+	m_bCameraFrame[p_slot] = (m_pCameraActive != nullptr);
 	if (m_pCameraActive)
 	{
-		glViewport(0
-				 , 0
-				 , static_cast<GLsizei>(m_pCameraActive->getDisplayWidth())
-				 , static_cast<GLsizei>(m_pCameraActive->getDisplayHeight()));
+		// Display binds camera as culled, not as moved since.
+		m_pCameraActive->capture(m_pCameraFrame[p_slot]);
 
-		// Enable depth read/write.
-		glEnable(GL_DEPTH_TEST);
-		glDepthMask(GL_TRUE);
-		// Cull triangles which normal is not towards the camera.
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_BACK);
+		// Draw list holds meshes whose world box intersects camera frustum.
+		m_pCulling->cull(*m_pVecMesh, m_pCameraActive, *visible);
 
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		// Sorted by shader, material, geometry then front to back depth.
+		queue->add(*visible, m_pCameraActive, 0, 0, m_lodPixelError, m_lodHysteresis);
+		queue->sort();
+	}
+
+	// Shared views are published for displays render threads.
+	if (m_pMultiView) {
+		m_pMultiView->update(*m_pVecMesh, m_lodPixelError, m_lodHysteresis);
+	}
 
-		m_pCameraActive->oglBind();
-		m_pShaderMesh->bind();
+	m_pFenceObjects->unlock();
+}
 
-		for (auto && itr : (*(m_pVecMesh)))
+//=================================================================================================
+void eve::scene::Scene::cb_display(void)
+{
+	// Meshes are merged once no mesh was added during a whole frame, so a loading burst becomes a single page
+	// and each geometry is uploaded to the pool once (pages are uploaded by renderer queues).
+	if (m_bGeometryDirty)
+	{
+		m_pFenceObjects->lock();
+		const size_t numPending = m_pVecGeometryPending->size();
+		if (numPending == m_numGeometryPending)
 		{
-			itr->oglDraw();
+			m_pGeometry->append(*m_pVecGeometryPending);
+			m_pVecGeometryPending->clear();
+			m_numGeometryPending = 0;
+			m_bGeometryDirty	 = false;
 		}
+		else
+		{
+			m_numGeometryPending = numPending;
+		}
+		m_pFenceObjects->unlock();
+	}
+	// Merged meshes own VAOs storage is freed once their page is uploaded.
+	m_pGeometry->update();
 
-		m_pCameraActive->oglUnbind();
-		m_pShaderMesh->unbind();
-
-		// Disable culling
-		glDisable(GL_CULL_FACE);
-		// Disable depth read/write
-		glDepthMask(GL_FALSE);
-		glDisable(GL_DEPTH_TEST);
+	if (m_bCameraFrame[m_slotDisplay])
+	{
+		// Draw list prepared on workers (see cb_prepare()).
+		this->oglDrawQueue(*m_pCameraFrame[m_slotDisplay], m_pUniformCamera, m_pRenderQueue[m_slotDisplay], m_pRingDraw);
 	}
 }
 
+//=================================================================================================
+void eve::scene::Scene::oglDrawQueue(const eve::scene::CameraFrame & p_camera, eve::ogl::Uniform * p_pUniformCamera, eve::scene::RenderQueue * p_pQueue, eve::ogl::RingBuffer * p_pRing)
+{
+	eve::ogl::StateCache * state = EveStateGL;
+
+	state->viewport(0
+				  , 0
+				  , static_cast<GLsizei>(p_camera.width)
+				  , static_cast<GLsizei>(p_camera.height));
+
+	// Enable depth read/write.
+	state->enable(GL_DEPTH_TEST);
+	state->depthMask(GL_TRUE);
+	// Cull triangles which normal is not towards the camera.
+	state->enable(GL_CULL_FACE);
+	state->cullFace(GL_BACK);
+
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	// Captured state is copied on render thread, streamed uniform data is written at bind time.
+	p_pUniformCamera->pushData(p_camera.modelView, 0);
+	p_pUniformCamera->pushData(p_camera.projection, EVE_OGL_PADDING_MAT4);
+	p_pUniformCamera->bindCamera();
+	m_pShaderMesh->bind();
+
+	// Single mesh shader, already bound.
+	p_pQueue->submit(p_pRing, m_pGeometry, nullptr);
+
+	// Meshes leave their bindings in place.
+	eve::ogl::Texture::unbind_opacity();
+	eve::ogl::Texture::unbind_emissive();
+	eve::ogl::Texture::unbind_normal();
+	eve::ogl::Texture::unbind_diffuse();
+	eve::ogl::Uniform::unbind_model();
+	state->bindVertexArray(0);
+
+	eve::ogl::Uniform::unbind_camera();
+	m_pShaderMesh->unbind();
+
+	// Disable culling
+	state->disable(GL_CULL_FACE);
+	// Disable depth read/write
+	state->depthMask(GL_FALSE);
+	state->disable(GL_DEPTH_TEST);
+}
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //		GET / SET
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+//=================================================================================================
+const std::string & eve::scene::Scene::get_import_param(eve::scene::SceneImportParam p_param)
+{
+	auto itr = m_map_import_params.find(p_param);
+	EVE_ASSERT(itr != m_map_import_params.end());
+	return itr->second;
+}
+
 //=================================================================================================
 void eve::scene::Scene::set_import_param(eve::scene::SceneImportParam p_param, const std::string & p_value)
 {
@@ -48,9 +48,19 @@ struct aiLight;
 struct aiMesh;
 struct aiScene;
 
+namespace eve { namespace scene { class BvhScene; } }
+namespace eve { namespace scene { struct BvhHit; } }
 namespace eve { namespace scene { class Camera; } }
+namespace eve { namespace scene { struct CameraFrame; } }
+namespace eve { namespace scene { class Culling; } }
+namespace eve { namespace scene { class GeometryPool; } }
+namespace eve { namespace scene { class MultiView; } }
+namespace eve { namespace scene { class RenderQueue; } }
 namespace eve { namespace scene { class Mesh; } }
 namespace eve { namespace scene { class Scene; } }
+namespace eve { namespace scene { class TransformHierarchy; } }
+
+namespace eve { namespace ogl { class RingBuffer; } }
 
 
 namespace eve
@@ -72,6 +82,9 @@ namespace eve
 			SceneImportParam_Generate_Normals,
 			SceneImportParam_Normals_Max_Angle,
 
+			SceneImportParam_Lod_Levels,
+			SceneImportParam_Lod_Reduction,
+
 			//! This value is not used. It is just there to force the compiler to map this enum to a 32 Bit integer.
 			_SceneImportParam_Force32Bit	= INT_MAX
 
@@ -99,6 +112,8 @@ namespace eve
 			//<!	SceneImportParam_Flip_UV				"Y" / "N"
 			//<!	SceneImportParam_Generate_Normals		"Y" / "N"
 			//<!	SceneImportParam_Normals_Max_Angle		"0.0... 175.0"		Used only when Generate_Normals is set to "Y"
+			//<!	SceneImportParam_Lod_Levels				"1... N"			Level of detail chain max length, "1" disables simplification
+			//<!	SceneImportParam_Lod_Reduction			"0.05... 0.95"		Per level indices reduction ratio
 			static std::map<SceneImportParam, std::string>	m_map_import_params;
 
 		protected:
@@ -106,6 +121,29 @@ namespace eve
 			eve::scene::Camera *							m_pCameraActive;	//!< Specifies active camera (shared pointer).
 
 			std::vector<eve::scene::Mesh*> *				m_pVecMesh;			//!< Specifies Mesh objects vector.
+			eve::scene::TransformHierarchy *				m_pTransforms;		//!< Specifies objects transforms hierarchy.
+			eve::thr::Fence *								m_pFenceObjects;	//!< Specifies objects (cameras, meshes, transforms) fence, held by cb_prepare() on worker thread.
+
+		protected:
+			eve::scene::BvhScene *							m_pBvh;				//!< Specifies meshes bounding volume hierarchy.
+			bool											m_bBvhDirty;		//!< Specifies whether hierarchy must be rebuilt (meshes added).
+
+		protected:
+			eve::scene::Culling *							m_pCulling;			//!< Specifies frustum culling stage.
+			std::vector<eve::scene::Mesh*> *				m_pVecVisible[EVE_RENDERER_NUM_SLOTS];	//!< Specifies per slot meshes draw list (visible meshes only), rebuilt each frame.
+			eve::scene::RenderQueue *						m_pRenderQueue[EVE_RENDERER_NUM_SLOTS];	//!< Specifies per slot sorted draw list built from visible meshes.
+			eve::scene::CameraFrame *						m_pCameraFrame[EVE_RENDERER_NUM_SLOTS];	//!< Specifies per slot active camera state captured with draw list.
+			bool											m_bCameraFrame[EVE_RENDERER_NUM_SLOTS];	//!< Specifies whether slot draw list was built from an active camera.
+			eve::ogl::Uniform *								m_pUniformCamera;	//!< Specifies camera matrices buffer, slot camera state is streamed at display.
+			eve::scene::GeometryPool *						m_pGeometry;		//!< Specifies meshes merged geometry, drawn by multi draw indirect.
+			std::vector<eve::scene::Mesh*> *				m_pVecGeometryPending;	//!< Specifies meshes added since last geometry merge.
+			size_t											m_numGeometryPending;	//!< Specifies pending meshes amount seen by last display.
+			bool											m_bGeometryDirty;	//!< Specifies whether meshes wait to be merged.
+			eve::scene::MultiView *							m_pMultiView;		//!< Specifies shared views drawn by displays (nullptr until a view is added).
+
+		protected:
+			float											m_lodPixelError;	//!< Specifies meshes level of detail max screen space error (pixels).
+			float											m_lodHysteresis;	//!< Specifies meshes level of detail switch hysteresis band (ratio of m_lodPixelError).
 
 		protected:
 			eve::ogl::Shader *								m_pShaderMesh;		//!< Specifies mesh render shader.
@@ -141,15 +179,41 @@ namespace eve
 
 
 		public:
-			/** \brief Add new mesh item based on ASSIMP aiMesh pointer \a p_pMesh. */
-			virtual bool add(const aiMesh * p_pMesh, const aiScene * p_pScene, eve::Axis p_upAxis, const std::string & p_fullPath);
+			/** \brief Add new mesh item based on ASSIMP aiMesh pointer \a p_pMesh, child of \a p_pParent mesh (owning an ancestor scene node) if any. */
+			virtual bool add(const aiMesh * p_pMesh, const aiScene * p_pScene, eve::Axis p_upAxis, const std::string & p_fullPath, eve::scene::Mesh * p_pParent = nullptr);
 			/** \brief Add new mesh item based on ASSIMP aiCamera pointer \a p_pCamera. */
 			virtual bool add(const aiCamera * p_pCamera, const aiScene * p_pScene, eve::Axis p_upAxis);
 
+		private:
+			/** \brief Create mesh from \a p_pMesh as child of \a p_pParent, register it in transforms hierarchy and return it (nullptr on failure). */
+			eve::scene::Mesh * addMesh(const aiMesh * p_pMesh, const aiScene * p_pScene, eve::Axis p_upAxis, const std::string & p_fullPath, eve::scene::Mesh * p_pParent);
+
+
+		public:
+			/** \brief Resolve transforms, then rebuild meshes hierarchy if meshes were added or refit it otherwise. */
+			void updateBvh(void);
+			/** \brief Cast world space ray against scene meshes, return true on hit. */
+			bool pick(const eve::math::TRay<float> & p_ray, eve::scene::BvhHit * p_pHit);
+
 
 		public:
-			/** \brief Draw on screen callback. (pure virtual) */
+			/** 
+			* \brief Add shared view drawn from camera \a p_pCamera (scene camera), return view index.
+			* Views are culled and queued once per scene frame on tasks pool, see eve::scene::MultiView and eve::scene::ViewRenderer.
+			*/
+			uint32_t addView(eve::scene::Camera * p_pCamera);
+
+
+		public:
+			/** \brief Update transforms, cull and build sorted draw lists of slot \a p_slot and shared views (worker thread, no OpenGL call). */
+			virtual void cb_prepare(uint32_t p_slot) override;
+			/** \brief Draw on screen callback, uploads scene resources and submits display slot draw list. (pure virtual) */
 			virtual void cb_display(void) override;
+			/**
+			* \brief Draw \a p_pQueue from camera state \a p_camera captured with it, instances streamed through \a p_pRing (calling renderer ring, may be nullptr).
+			* Camera state is streamed through \a p_pUniformCamera, created by calling renderer.
+			*/
+			void oglDrawQueue(const eve::scene::CameraFrame & p_camera, eve::ogl::Uniform * p_pUniformCamera, eve::scene::RenderQueue * p_pQueue, eve::ogl::RingBuffer * p_pRing);
 
 
 			///////////////////////////////////////////////////////////////////////////////////////
@@ -157,13 +221,74 @@ namespace eve
 			///////////////////////////////////////////////////////////////////////////////////////
 
 		public:
+			/** \brief Get target import parameter value. */
+			static const std::string & get_import_param(eve::scene::SceneImportParam p_param);
 			/** \brief Assign value to target import parameter. */
 			static void set_import_param(eve::scene::SceneImportParam p_param, const std::string & p_value);
 
+
+		public:
+			/** \brief Get meshes bounding volume hierarchy, call updateBvh() first to take last changes into account. */
+			eve::scene::BvhScene * getBvh(void) const;
+			/** \brief Get objects transforms hierarchy. */
+			eve::scene::TransformHierarchy * getTransforms(void) const;
+			/** \brief Get frustum culling stage (counters and settings). */
+			eve::scene::Culling * getCulling(void) const;
+			/** \brief Get meshes merged geometry. */
+			eve::scene::GeometryPool * getGeometry(void) const;
+			/** \brief Get displayed sorted draw list. */
+			eve::scene::RenderQueue * getRenderQueue(void) const;
+			/** \brief Get shared views (nullptr until a view is added). */
+			eve::scene::MultiView * getMultiView(void) const;
+
+
+		public:
+			/** \brief Get cameras amount. */
+			const size_t getNumCameras(void) const;
+			/** \brief Get camera \a p_index. */
+			eve::scene::Camera * getCamera(size_t p_index) const;
+
+
+		public:
+			/** \brief Get meshes level of detail max screen space error (pixels). */
+			const float getLodPixelError(void) const;
+			/** \brief Set meshes level of detail max screen space error (pixels). */
+			void setLodPixelError(float p_value);
+
+			/** \brief Get meshes level of detail switch hysteresis band (ratio of pixel error). */
+			const float getLodHysteresis(void) const;
+			/** \brief Set meshes level of detail switch hysteresis band (ratio of pixel error), in range [0.0, 1.0[. */
+			void setLodHysteresis(float p_value);
+
 		}; // class Scene
 
 	} // namespace scene
 
 } // namespace eve
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE eve::scene::BvhScene * eve::scene::Scene::getBvh(void) const		{ return m_pBvh;			}
+EVE_FORCE_INLINE eve::scene::TransformHierarchy * eve::scene::Scene::getTransforms(void) const { return m_pTransforms; }
+EVE_FORCE_INLINE eve::scene::Culling * eve::scene::Scene::getCulling(void) const		{ return m_pCulling;		}
+EVE_FORCE_INLINE eve::scene::GeometryPool * eve::scene::Scene::getGeometry(void) const	{ return m_pGeometry;		}
+EVE_FORCE_INLINE eve::scene::RenderQueue * eve::scene::Scene::getRenderQueue(void) const { return m_pRenderQueue[m_slotDisplay]; }
+EVE_FORCE_INLINE eve::scene::MultiView * eve::scene::Scene::getMultiView(void) const	{ return m_pMultiView;		}
+
+//=================================================================================================
+EVE_FORCE_INLINE const size_t eve::scene::Scene::getNumCameras(void) const			{ return m_pVecCamera->size();	}
+EVE_FORCE_INLINE eve::scene::Camera * eve::scene::Scene::getCamera(size_t p_index) const { return (*m_pVecCamera)[p_index]; }
+
+//=================================================================================================
+EVE_FORCE_INLINE const float eve::scene::Scene::getLodPixelError(void) const		{ return m_lodPixelError;	}
+EVE_FORCE_INLINE void eve::scene::Scene::setLodPixelError(float p_value)			{ m_lodPixelError = p_value;	}
+
+//=================================================================================================
+EVE_FORCE_INLINE const float eve::scene::Scene::getLodHysteresis(void) const		{ return m_lodHysteresis;	}
+EVE_FORCE_INLINE void eve::scene::Scene::setLodHysteresis(float p_value)			{ EVE_ASSERT(p_value >= 0.0f && p_value < 1.0f); m_lodHysteresis = p_value; }
+
 #endif // __EVE_SCENE_SCENE_H__
@@ -0,0 +1,350 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/scene/TransformHierarchy.h"
+
+#ifndef __EVE_SCENE_MESH_H__
+#include "eve/scene/Mesh.h"
+#endif
+
+#ifndef __EVE_THREADING_SPIN_LOCK_H__
+#include "eve/thr/SpinLock.h"
+#endif
+
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#include "eve/thr/TaskPool.h"
+#endif
+
+
+//=================================================================================================
+eve::scene::TransformHierarchy::TransformHierarchy(void)
+	// Inheritance
+	: eve::mem::Pointer()
+	// Members init
+	, m_pLocal(nullptr)
+	, m_pWorld(nullptr)
+	, m_pParent(nullptr)
+	, m_pDepth(nullptr)
+	, m_pDirty(nullptr)
+	, m_pOwner(nullptr)
+	, m_pSlotOf(nullptr)
+	, m_pIdOf(nullptr)
+	, m_pParentId(nullptr)
+	, m_pLevels(nullptr)
+	, m_pChanged(nullptr)
+	, m_bSorted(true)
+	, m_bDirty(false)
+	, m_pFence(nullptr)
+	, m_parallelMin(1024)
+{}
+
+
+
+//=================================================================================================
+void eve::scene::TransformHierarchy::init(void)
+{
+	m_pLocal	= new std::vector<eve::mat44f>();
+	m_pWorld	= new std::vector<eve::mat44f>();
+	m_pParent	= new std::vector<uint32_t>();
+	m_pDepth	= new std::vector<uint32_t>();
+	m_pDirty	= new std::vector<uint8_t>();
+	m_pOwner	= new std::vector<eve::scene::Mesh*>();
+
+	m_pSlotOf	= new std::vector<uint32_t>();
+	m_pIdOf		= new std::vector<uint32_t>();
+	m_pParentId	= new std::vector<uint32_t>();
+	m_pLevels	= new std::vector<uint32_t>();
+	m_pChanged	= new std::vector<uint32_t>();
+
+	m_bSorted	= true;
+	m_bDirty	= false;
+
+	m_pFence	= EVE_CREATE_PTR(eve::thr::SpinLock);
+}
+
+//=================================================================================================
+void eve::scene::TransformHierarchy::release(void)
+{
+	EVE_RELEASE_PTR(m_pFence);
+
+	EVE_RELEASE_PTR_CPP(m_pChanged);
+	EVE_RELEASE_PTR_CPP(m_pLevels);
+	EVE_RELEASE_PTR_CPP(m_pParentId);
+	EVE_RELEASE_PTR_CPP(m_pIdOf);
+	EVE_RELEASE_PTR_CPP(m_pSlotOf);
+
+	// Do not delete -> shared pointers.
+	EVE_RELEASE_PTR_CPP(m_pOwner);
+	EVE_RELEASE_PTR_CPP(m_pDirty);
+	EVE_RELEASE_PTR_CPP(m_pDepth);
+	EVE_RELEASE_PTR_CPP(m_pParent);
+	EVE_RELEASE_PTR_CPP(m_pWorld);
+	EVE_RELEASE_PTR_CPP(m_pLocal);
+}
+
+
+
+//=================================================================================================
+uint32_t eve::scene::TransformHierarchy::add(eve::scene::Mesh * p_pOwner, const eve::mat44f & p_local, uint32_t p_parent)
+{
+	m_pFence->lock();
+
+	EVE_ASSERT(p_parent == EVE_TRANSFORM_NONE || p_parent < m_pSlotOf->size());
+
+	uint32_t id   = static_cast<uint32_t>(m_pSlotOf->size());
+	uint32_t slot = static_cast<uint32_t>(m_pLocal->size());
+
+	m_pLocal->push_back(p_local);
+	m_pWorld->push_back(p_local);
+	m_pParent->push_back((p_parent == EVE_TRANSFORM_NONE) ? EVE_TRANSFORM_NONE : (*m_pSlotOf)[p_parent]);
+	m_pDepth->push_back(0);
+	m_pDirty->push_back(1);
+	m_pOwner->push_back(p_pOwner);
+
+	m_pSlotOf->push_back(slot);
+	m_pIdOf->push_back(id);
+	m_pParentId->push_back(p_parent);
+
+	// Slots and depth levels are rebuilt on next update.
+	m_bSorted = false;
+	m_bDirty  = true;
+
+	m_pFence->unlock();
+	return id;
+}
+
+//=================================================================================================
+void eve::scene::TransformHierarchy::setParent(uint32_t p_id, uint32_t p_parent)
+{
+	m_pFence->lock();
+
+	// Reject cycles: new parent must not belong to node subtree.
+	uint32_t itr = p_parent;
+	while (itr != EVE_TRANSFORM_NONE && itr != p_id) {
+		itr = (*m_pParentId)[itr];
+	}
+
+	if (itr == EVE_TRANSFORM_NONE)
+	{
+		(*m_pParentId)[p_id] = p_parent;
+		(*m_pDirty)[(*m_pSlotOf)[p_id]] = 1;
+		m_bSorted = false;
+		m_bDirty  = true;
+	}
+	else
+	{
+		EVE_LOG_ERROR("Transform node %d can not be parented to its own subtree.", p_id);
+	}
+
+	m_pFence->unlock();
+}
+
+//=================================================================================================
+void eve::scene::TransformHierarchy::setLocal(uint32_t p_id, const eve::mat44f & p_local)
+{
+	m_pFence->lock();
+
+	uint32_t slot = (*m_pSlotOf)[p_id];
+	(*m_pLocal)[slot] = p_local;
+	(*m_pDirty)[slot] = 1;
+	m_bDirty = true;
+
+	m_pFence->unlock();
+}
+
+
+
+//=================================================================================================
+void eve::scene::TransformHierarchy::sort(void)
+{
+	const uint32_t numNodes = static_cast<uint32_t>(m_pSlotOf->size());
+
+	// Per ID depth, parents chains are walked once thanks to memoization.
+	std::vector<uint32_t> depth(numNodes, EVE_TRANSFORM_NONE);
+	std::vector<uint32_t> chain;
+	for (uint32_t id = 0; id < numNodes; id++)
+	{
+		uint32_t itr = id;
+		while (itr != EVE_TRANSFORM_NONE && depth[itr] == EVE_TRANSFORM_NONE)
+		{
+			chain.push_back(itr);
+			itr = (*m_pParentId)[itr];
+		}
+
+		uint32_t d = (itr == EVE_TRANSFORM_NONE) ? 0 : depth[itr] + 1;
+		while (!chain.empty())
+		{
+			depth[chain.back()] = d++;
+			chain.pop_back();
+		}
+	}
+
+	// Counting sort by depth, stable on current slot order.
+	uint32_t maxDepth = 0;
+	for (uint32_t id = 0; id < numNodes; id++) {
+		maxDepth = std::max(maxDepth, depth[id]);
+	}
+
+	m_pLevels->assign(maxDepth + 2, 0);
+	for (uint32_t id = 0; id < numNodes; id++) {
+		(*m_pLevels)[depth[id] + 1]++;
+	}
+	for (uint32_t d = 1; d < m_pLevels->size(); d++) {
+		(*m_pLevels)[d] += (*m_pLevels)[d - 1];
+	}
+
+	std::vector<uint32_t> cursor(m_pLevels->begin(), m_pLevels->end() - 1);
+	std::vector<uint32_t> newSlotOf(numNodes);
+	for (uint32_t slot = 0; slot < numNodes; slot++)
+	{
+		uint32_t id = (*m_pIdOf)[slot];
+		newSlotOf[id] = cursor[depth[id]]++;
+	}
+
+	// Permute SoA arrays.
+	std::vector<eve::mat44f>		local(numNodes);
+	std::vector<eve::mat44f>		world(numNodes);
+	std::vector<uint8_t>			dirty(numNodes);
+	std::vector<eve::scene::Mesh*>	owner(numNodes);
+
+	for (uint32_t id = 0; id < numNodes; id++)
+	{
+		uint32_t src = (*m_pSlotOf)[id];
+		uint32_t dst = newSlotOf[id];
+
+		local[dst] = (*m_pLocal)[src];
+		world[dst] = (*m_pWorld)[src];
+		dirty[dst] = (*m_pDirty)[src];
+		owner[dst] = (*m_pOwner)[src];
+
+		(*m_pIdOf)[dst] = id;
+	}
+
+	m_pLocal->swap(local);
+	m_pWorld->swap(world);
+	m_pDirty->swap(dirty);
+	m_pOwner->swap(owner);
+	m_pSlotOf->swap(newSlotOf);
+
+	for (uint32_t slot = 0; slot < numNodes; slot++)
+	{
+		uint32_t parentId = (*m_pParentId)[(*m_pIdOf)[slot]];
+		(*m_pParent)[slot] = (parentId == EVE_TRANSFORM_NONE) ? EVE_TRANSFORM_NONE : (*m_pSlotOf)[parentId];
+		(*m_pDepth)[slot]  = depth[(*m_pIdOf)[slot]];
+	}
+
+	m_bSorted = true;
+}
+
+//=================================================================================================
+void eve::scene::TransformHierarchy::updateRange(uint32_t p_begin, uint32_t p_end)
+{
+	const uint32_t *	parent = m_pParent->data();
+	const eve::mat44f *	local  = m_pLocal->data();
+	eve::mat44f *		world  = m_pWorld->data();
+	uint8_t *			dirty  = m_pDirty->data();
+
+	for (uint32_t slot = p_begin; slot < p_end; slot++)
+	{
+		uint32_t p = parent[slot];
+		if (p == EVE_TRANSFORM_NONE)
+		{
+			if (dirty[slot]) {
+				world[slot] = local[slot];
+			}
+		}
+		// Parent level is already resolved, its dirty flag propagates down.
+		else if (dirty[slot] || dirty[p])
+		{
+			dirty[slot] = 1;
+			world[slot] = world[p] * local[slot];
+		}
+	}
+}
+
+//=================================================================================================
+size_t eve::scene::TransformHierarchy::update(void)
+{
+	m_pFence->lock();
+
+	if (!m_bSorted) {
+		this->sort();
+	}
+
+	m_pChanged->clear();
+	if (m_bDirty)
+	{
+		eve::thr::TaskPool * pool = eve::thr::TaskPool::get_instance();
+
+		for (size_t d = 0; d + 1 < m_pLevels->size(); d++)
+		{
+			uint32_t begin = (*m_pLevels)[d];
+			uint32_t end   = (*m_pLevels)[d + 1];
+
+			if ((end - begin) >= m_parallelMin)
+			{
+				pool->parallel_for(begin, end, m_parallelMin / 4, [this](size_t p_begin, size_t p_end)
+				{
+					this->updateRange(static_cast<uint32_t>(p_begin), static_cast<uint32_t>(p_end));
+				});
+			}
+			else
+			{
+				this->updateRange(begin, end);
+			}
+		}
+
+		// Gather changed nodes and clear flags.
+		for (uint32_t slot = 0; slot < m_pDirty->size(); slot++)
+		{
+			if ((*m_pDirty)[slot])
+			{
+				m_pChanged->push_back(slot);
+				(*m_pDirty)[slot] = 0;
+			}
+		}
+		m_bDirty = false;
+	}
+
+	// Batched owners update (world matrices and boxes).
+	for (auto && slot : (*m_pChanged))
+	{
+		eve::scene::Mesh * owner = (*m_pOwner)[slot];
+		if (owner) {
+			owner->updateMatrixWorld((*m_pWorld)[slot]);
+		}
+	}
+
+	size_t ret = m_pChanged->size();
+	m_pFence->unlock();
+	return ret;
+}
@@ -0,0 +1,177 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_SCENE_TRANSFORM_HIERARCHY_H__
+#define __EVE_SCENE_TRANSFORM_HIERARCHY_H__
+
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MATH_INCLUDES_H__
+#include "eve/math/Includes.h"
+#endif
+
+
+namespace eve { namespace scene { class Mesh; } }
+namespace eve { namespace thr { class SpinLock; } }
+
+
+/** \def EVE_TRANSFORM_NONE Invalid transform node ID (no node / root parent). */
+#define EVE_TRANSFORM_NONE		0xFFFFFFFF
+
+
+namespace eve
+{
+	namespace scene
+	{
+		/**
+		* \class eve::scene::TransformHierarchy
+		*
+		* \brief Data oriented scene transforms hierarchy.
+		* Local and world matrices are stored in contiguous arrays sorted by depth, parents always precede their children.
+		* Local matrix changes only flag nodes dirty, update() recomputes changed subtrees in a single linear pass
+		* (one parallel pass per depth level on large hierarchies) and pushes resulting world matrices to meshes in one batch.
+		* Nodes are addressed by stable IDs, array slots change on re-sort.
+		*
+		* \note extends eve::mem::Pointer
+		*/
+		class TransformHierarchy final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATAS				//
+			//////////////////////////////////////
+
+		private:
+			std::vector<eve::mat44f> *				m_pLocal;			//!< Specifies per slot local matrix.
+			std::vector<eve::mat44f> *				m_pWorld;			//!< Specifies per slot world matrix.
+			std::vector<uint32_t> *					m_pParent;			//!< Specifies per slot parent slot (EVE_TRANSFORM_NONE for roots).
+			std::vector<uint32_t> *					m_pDepth;			//!< Specifies per slot depth (0 for roots).
+			std::vector<uint8_t> *					m_pDirty;			//!< Specifies per slot dirty flag.
+			std::vector<eve::scene::Mesh*> *		m_pOwner;			//!< Specifies per slot owner mesh (shared pointer).
+
+		private:
+			std::vector<uint32_t> *					m_pSlotOf;			//!< Specifies ID to slot map.
+			std::vector<uint32_t> *					m_pIdOf;			//!< Specifies slot to ID map.
+			std::vector<uint32_t> *					m_pParentId;		//!< Specifies per ID parent ID, source of truth for re-sort.
+			std::vector<uint32_t> *					m_pLevels;			//!< Specifies depth levels first slot, last entry is nodes amount.
+			std::vector<uint32_t> *					m_pChanged;			//!< Specifies slots updated by last pass.
+			bool									m_bSorted;			//!< Specifies whether arrays are sorted by depth.
+			bool									m_bDirty;			//!< Specifies whether at least one node is dirty.
+
+		private:
+			eve::thr::SpinLock *					m_pFence;			//!< Specifies hierarchy edition fence.
+			size_t									m_parallelMin;		//!< Specifies level nodes amount from which level update runs on tasks pool.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(TransformHierarchy);
+			EVE_PUBLIC_DESTRUCTOR(TransformHierarchy);
+
+		public:
+			/** \brief Class constructor. */
+			explicit TransformHierarchy(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Add node owned by \a p_pOwner (may be nullptr) with \a p_local matrix under \a p_parent node, return new node ID. */
+			uint32_t add(eve::scene::Mesh * p_pOwner, const eve::mat44f & p_local, uint32_t p_parent = EVE_TRANSFORM_NONE);
+			/** \brief Move node \a p_id under \a p_parent node (EVE_TRANSFORM_NONE for root), flag its subtree dirty. */
+			void setParent(uint32_t p_id, uint32_t p_parent);
+			/** \brief Set node \a p_id local matrix, flag its subtree dirty. */
+			void setLocal(uint32_t p_id, const eve::mat44f & p_local);
+
+
+		public:
+			/** \brief Recompute dirty subtrees world matrices and push them to owner meshes, return updated nodes amount. */
+			size_t update(void);
+
+		private:
+			/** \brief Sort arrays by depth and rebuild levels. */
+			void sort(void);
+			/** \brief Update slots range [p_begin, p_end[ of a single depth level. */
+			void updateRange(uint32_t p_begin, uint32_t p_end);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get nodes amount. */
+			size_t getNumNodes(void) const;
+			/** \brief Get node \a p_id world matrix (as of last update() call). */
+			const eve::mat44f & getWorld(uint32_t p_id) const;
+			/** \brief Get node \a p_id local matrix. */
+			const eve::mat44f & getLocal(uint32_t p_id) const;
+			/** \brief Get node \a p_id parent ID. */
+			uint32_t getParent(uint32_t p_id) const;
+
+
+		public:
+			/** \brief Set level nodes amount from which level update runs on tasks pool. */
+			void setParallelMin(size_t p_value);
+
+		}; // class TransformHierarchy
+
+	} // namespace scene
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE size_t eve::scene::TransformHierarchy::getNumNodes(void) const							{ return m_pSlotOf->size(); }
+EVE_FORCE_INLINE const eve::mat44f & eve::scene::TransformHierarchy::getWorld(uint32_t p_id) const		{ return (*m_pWorld)[(*m_pSlotOf)[p_id]]; }
+EVE_FORCE_INLINE const eve::mat44f & eve::scene::TransformHierarchy::getLocal(uint32_t p_id) const		{ return (*m_pLocal)[(*m_pSlotOf)[p_id]]; }
+EVE_FORCE_INLINE uint32_t eve::scene::TransformHierarchy::getParent(uint32_t p_id) const				{ return (*m_pParentId)[p_id]; }
+
+//=================================================================================================
+EVE_FORCE_INLINE void eve::scene::TransformHierarchy::setParallelMin(size_t p_value)					{ m_parallelMin = p_value; }
+
+#endif // __EVE_SCENE_TRANSFORM_HIERARCHY_H__
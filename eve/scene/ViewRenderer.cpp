@@ -0,0 +1,136 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/scene/ViewRenderer.h"
+
+#ifndef __EVE_SCENE_CAMERA_H__
+#include "eve/scene/Camera.h"
+#endif
+
+#ifndef __EVE_SCENE_MULTI_VIEW_H__
+#include "eve/scene/MultiView.h"
+#endif
+
+#ifndef __EVE_SCENE_SCENE_H__
+#include "eve/scene/Scene.h"
+#endif
+
+
+//=================================================================================================
+eve::scene::ViewRenderer * eve::scene::ViewRenderer::create_ptr(eve::scene::Scene * p_pScene, uint32_t p_view)
+{
+	EVE_ASSERT(p_pScene);
+	EVE_ASSERT(p_pScene->getMultiView());
+	EVE_ASSERT(p_view < p_pScene->getMultiView()->getNumViews());
+
+	eve::scene::ViewRenderer * ptr = new eve::scene::ViewRenderer(p_pScene, p_view);
+	ptr->init();
+	return ptr;
+}
+
+
+
+//=================================================================================================
+eve::scene::ViewRenderer::ViewRenderer(eve::scene::Scene * p_pScene, uint32_t p_view)
+	// Inheritance
+	: eve::ogl::Renderer()
+	// Members init
+	, m_pScene(p_pScene)
+	, m_view(p_view)
+	, m_pUniformCamera(nullptr)
+{
+	for (uint32_t i = 0; i < EVE_RENDERER_NUM_SLOTS; i++) {
+		m_pFrames[i] = nullptr;
+	}
+}
+
+
+
+//=================================================================================================
+void eve::scene::ViewRenderer::init(void)
+{
+	// Call parent class.
+	eve::ogl::Renderer::init();
+
+	// Camera matrices, written to own uniform ring buffer at bind time.
+	eve::ogl::FormatUniform fmtUniform;
+	fmtUniform.blockSize = EVE_OGL_SIZEOF_MAT4 * 2;
+	fmtUniform.dynamic	 = false;
+	fmtUniform.streamed	 = true;
+	m_pUniformCamera	 = this->create(fmtUniform);
+}
+
+//=================================================================================================
+void eve::scene::ViewRenderer::release(void)
+{
+	m_pUniformCamera->requestRelease();
+	m_pUniformCamera = nullptr;
+
+	eve::scene::MultiView * multiView = m_pScene->getMultiView();
+	for (uint32_t i = 0; i < EVE_RENDERER_NUM_SLOTS; i++)
+	{
+		if (m_pFrames[i])
+		{
+			multiView->releaseFrame(m_pFrames[i]);
+			m_pFrames[i] = nullptr;
+		}
+	}
+
+	// Call parent class.
+	eve::ogl::Renderer::release();
+}
+
+
+
+//=================================================================================================
+void eve::scene::ViewRenderer::cb_prepare(uint32_t p_slot)
+{
+	eve::scene::MultiView * multiView = m_pScene->getMultiView();
+
+	// Frame displayed two handovers ago is not read anymore, give it back to scene pool.
+	if (m_pFrames[p_slot]) {
+		multiView->releaseFrame(m_pFrames[p_slot]);
+	}
+	m_pFrames[p_slot] = multiView->acquireFrame();
+}
+
+//=================================================================================================
+void eve::scene::ViewRenderer::cb_display(void)
+{
+	eve::scene::MultiViewFrame * frame = m_pFrames[m_slotDisplay];
+
+	// Nothing published yet, or view added after frame publication.
+	if (frame && m_view < frame->queues.size())
+	{
+		m_pScene->oglDrawQueue(*frame->cameras[m_view], m_pUniformCamera, frame->queues[m_view], m_pRingDraw);
+	}
+}
@@ -0,0 +1,130 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_SCENE_VIEW_RENDERER_H__
+#define __EVE_SCENE_VIEW_RENDERER_H__
+
+
+#ifndef __EVE_OPENGL_CORE_RENDER_H__
+#include "eve/ogl/core/Renderer.h"
+#endif
+
+
+namespace eve { namespace scene { class Scene; } }
+namespace eve { namespace scene { struct MultiViewFrame; } }
+
+
+namespace eve
+{
+	namespace scene
+	{
+		/** 
+		* \class eve::scene::ViewRenderer
+		*
+		* \brief Draws one shared scene view (see eve::scene::Scene::addView()) in a display render thread.
+		* Prepare stage acquires scene latest published frame, display stage submits view queue through scene resources,
+		* OpenGL objects being shared by rendering contexts. Scene itself is updated and uploaded by its own renderer.
+		*
+		* \note extends eve::ogl::Renderer
+		*/
+		class ViewRenderer final
+			: public eve::ogl::Renderer
+		{
+
+			//////////////////////////////////////
+			//				DATAS				//
+			//////////////////////////////////////
+
+		private:
+			eve::scene::Scene *					m_pScene;								//!< Specifies drawn scene (shared pointer).
+			uint32_t							m_view;									//!< Specifies drawn view index.
+			eve::scene::MultiViewFrame *		m_pFrames[EVE_RENDERER_NUM_SLOTS];		//!< Specifies per slot acquired frame.
+			eve::ogl::Uniform *					m_pUniformCamera;						//!< Specifies view camera matrices buffer, streamed through own uniform ring.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(ViewRenderer);
+			EVE_PUBLIC_DESTRUCTOR(ViewRenderer);
+
+		public:
+			/** \brief Create, init and return new pointer drawing view \a p_view of scene \a p_pScene. */
+			static eve::scene::ViewRenderer * create_ptr(eve::scene::Scene * p_pScene, uint32_t p_view);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit ViewRenderer(eve::scene::Scene * p_pScene, uint32_t p_view);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Swap slot \a p_slot frame for scene latest published one (worker thread, no OpenGL call). */
+			virtual void cb_prepare(uint32_t p_slot) override;
+			/** \brief Draw on screen callback, submits display slot frame view queue. (pure virtual) */
+			virtual void cb_display(void) override;
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get drawn scene. */
+			eve::scene::Scene * getScene(void) const;
+			/** \brief Get drawn view index. */
+			const uint32_t getView(void) const;
+
+		}; // class ViewRenderer
+
+	} // namespace scene
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE eve::scene::Scene * eve::scene::ViewRenderer::getScene(void) const	{ return m_pScene;	}
+EVE_FORCE_INLINE const uint32_t eve::scene::ViewRenderer::getView(void) const		{ return m_view;	}
+
+#endif // __EVE_SCENE_VIEW_RENDERER_H__
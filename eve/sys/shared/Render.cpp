@@ -40,6 +40,18 @@
 #include "eve/ogl/core/win32/Context.h"
 #endif
 
+#ifndef __EVE_OPENGL_CORE_DISPATCH_H__
+#include "eve/ogl/core/Dispatch.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_SHADER_RELOADER_H__
+#include "eve/ogl/core/ShaderReloader.h"
+#endif
+
+#ifndef __EVE_TIME_UTILS_H__
+#include "eve/time/Utils.h"
+#endif
+
 
 //=================================================================================================
 eve::sys::Render * eve::sys::Render::create_ptr(HWND p_handle)
@@ -60,12 +72,23 @@ eve::sys::Render::Render(HWND p_handle)
 	, m_handle(p_handle)
 	, m_pContext(nullptr)
 	, m_pVecRenderers(nullptr)
-
-	, m_baseWait(0)
-	, m_bufWait(0)
-	, m_fps(30)
-	, m_elapsed(0)
-	, m_pTimerRender(nullptr)
+	, m_pVecFrame(nullptr)
+	, m_pVecRelease(nullptr)
+	, m_bRenderersDirty(false)
+
+	, m_bPipelined(true)
+	, m_slotPrepare(0)
+	, m_counterPrepare()
+	, m_numHandovers(0)
+	, m_bLooping(false)
+	, m_pHandoverMutex(nullptr)
+	, m_pHandoverCondition(nullptr)
+
+	, m_pPacer(nullptr)
+	, m_frameMicro(0)
+	, m_numFrames(0)
+	, m_stallMicro(0)
+	, m_handoverMicro(0)
 {}
 
 
@@ -76,28 +99,40 @@ void eve::sys::Render::init(void)
 	// Call parent class
 	eve::thr::Thread::init();
 
-	// Create OpenGL context for target window handle.
+	// Create OpenGL context for target window handle (headless if none).
 	m_pContext = eve::ogl::SubContext::create_ptr(m_handle);
 
 	// Render engines.
 	m_pVecRenderers = new std::list<eve::core::Renderer*>();
+	m_pVecFrame		= new std::vector<eve::core::Renderer*>();
+	m_pVecRelease	= new std::vector<eve::core::Renderer*>();
+	m_bRenderersDirty = false;
+	m_slotPrepare	= 0;
 
-	// Timer.
-	m_pTimerRender  = eve::time::Timer::create_ptr(false);
+	// Handover signal.
+	m_pHandoverMutex	 = new std::mutex();
+	m_pHandoverCondition = new std::condition_variable();
 
-	// Compute run wait based on target FPS.
-	m_baseWait = 1000 / m_fps;
+	// Frame pacing.
+	m_pPacer = eve::time::Pacer::create_ptr(60.0);
 }
 
 //=================================================================================================
 void eve::sys::Render::release(void)
 {
-	// Timer.
-	EVE_RELEASE_PTR(m_pTimerRender);
+	// Frame pacing.
+	EVE_RELEASE_PTR(m_pPacer);
 
 	// Render engines.
 	m_pContext->makeCurrent();
 	eve::core::Renderer * rdr = nullptr;
+	for (auto && itr : (*m_pVecRelease))
+	{
+		rdr = itr;
+		EVE_RELEASE_PTR(rdr);
+	}
+	EVE_RELEASE_PTR_CPP(m_pVecRelease);
+	EVE_RELEASE_PTR_CPP(m_pVecFrame);
 	while (!m_pVecRenderers->empty())
 	{
 		rdr = m_pVecRenderers->back();
@@ -112,6 +147,10 @@ void eve::sys::Render::release(void)
 	// Release context.
 	EVE_RELEASE_PTR_SAFE(m_pContext);
 
+	// Handover signal.
+	EVE_RELEASE_PTR_CPP(m_pHandoverCondition);
+	EVE_RELEASE_PTR_CPP(m_pHandoverMutex);
+
 	// Call parent class
 	eve::thr::Thread::release();
 }
@@ -135,40 +174,163 @@ void eve::sys::Render::releaseThreadedData(void)
 //=================================================================================================
 void eve::sys::Render::run(void)
 {
-	m_pTimerRender->start();
-	int64_t targetWait	= 0;
+	m_pPacer->reset();
+
+	{
+		std::lock_guard<std::mutex> lock(*m_pHandoverMutex);
+		m_bLooping = true;
+	}
+
+	// Nothing to display yet, registered renderers prepare their first frame.
+	this->handover();
 
 	do
 	{
-		m_pFence->lock();
+		// Frame N+1 preparation on workers while frame N is submitted.
+		this->prepareFrame(m_bPipelined);
+		this->renderFrame();
+		this->handover();
 
+		// Fence is released, registry changes may go on while waiting for next deadline.
+		m_pPacer->wait();
 
-		// Render engines display.
-		m_pContext->makeCurrent();
+	} while (this->running());
+
+	// No frame in flight anymore, release unregisterRenderer() waiters.
+	std::lock_guard<std::mutex> lock(*m_pHandoverMutex);
+	m_bLooping = false;
+	m_pHandoverCondition->notify_all();
+}
+
+
+
+//=================================================================================================
+void eve::sys::Render::prepareFrame(bool p_bAsync)
+{
+	const uint32_t slot = m_slotPrepare;
+
+	if (p_bAsync)
+	{
+		eve::thr::TaskPool * pool = eve::thr::TaskPool::get_instance();
+		for (auto && itr : (*m_pVecFrame))
+		{
+			eve::core::Renderer * rdr = itr;
+			pool->push([rdr, slot](void) { rdr->cb_prepare(slot); }, &m_counterPrepare);
+		}
+	}
+	else
+	{
+		for (auto && itr : (*m_pVecFrame))
+		{
+			itr->cb_prepare(slot);
+		}
+	}
+}
+
+//=================================================================================================
+void eve::sys::Render::renderFrame(void)
+{
+	const int64_t start = eve::time::current_time_micro();
+
+	m_pContext->makeCurrent();
+	EveStateGL->beginFrame();
+	eve::ogl::Dispatch::begin_frame();
+	// Hot reloaded shader programs are swapped at frame boundary.
+	eve::ogl::ShaderReloader::get_instance()->apply();
+
+	for (auto && itr : (*m_pVecFrame))
+	{
+		itr->cb_beforeDisplay();
+		itr->cb_display();
+		itr->cb_afterDisplay();
+	}
+
+	m_pContext->swapBuffers();
+	m_pContext->doneCurrent();
 
+	m_frameMicro = eve::time::current_time_micro() - start;
+	m_numFrames++;
+}
+
+//=================================================================================================
+void eve::sys::Render::handover(void)
+{
+	// Render thread helps with remaining preparation tasks.
+	const int64_t start = eve::time::current_time_micro();
+	eve::thr::TaskPool::get_instance()->wait(&m_counterPrepare);
+	m_stallMicro = eve::time::current_time_micro() - start;
+
+	std::vector<eve::core::Renderer*> added;
+	std::vector<eve::core::Renderer*> released;
+
+	m_pFence->lock();
+	const int64_t lock = eve::time::current_time_micro();
+
+	// Registry changes, renderers missing from frame container have no prepared slot yet.
+	if (m_bRenderersDirty)
+	{
 		for (auto && itr : (*m_pVecRenderers))
 		{
-			itr->cb_beforeDisplay();
-			itr->cb_display();
-			itr->cb_afterDisplay();
+			if (std::find(m_pVecFrame->begin(), m_pVecFrame->end(), itr) == m_pVecFrame->end()) {
+				added.push_back(itr);
+			}
 		}
+		m_pVecFrame->assign(m_pVecRenderers->begin(), m_pVecRenderers->end());
+		released.swap(*m_pVecRelease);
+		m_bRenderersDirty = false;
+	}
 
-		m_pContext->swapBuffers();
-		m_pContext->doneCurrent();
+	// Prepared slot is displayed next, other one is prepared.
+	const uint32_t display = m_slotPrepare;
+	m_slotPrepare = (m_slotPrepare + 1) % EVE_RENDERER_NUM_SLOTS;
+	for (auto && itr : (*m_pVecFrame))
+	{
+		itr->setSlotDisplay(display);
+	}
+	m_numHandovers.fetch_add(1);
 
-		// Update wait time.
-		m_elapsed	= m_pTimerRender->getElapsedTime();
-		targetWait	= (m_baseWait + m_bufWait) - m_elapsed;
-		m_bufWait	= targetWait;
-		
-		m_pTimerRender->restart();
-		//EVE_LOG_INFO("FPS: %f", 1000.0f / static_cast<float>(m_elapsed > 1 ? m_elapsed : 1));
-		eve::thr::sleep_micro(static_cast<uint32_t>(targetWait > 0 ? targetWait : 0) * 1000);
+	m_handoverMicro = eve::time::current_time_micro() - lock;
+	m_pFence->unlock();
 
+	// Wake unregisterRenderer() callers waiting for this handover.
+	{
+		std::lock_guard<std::mutex> signal(*m_pHandoverMutex);
+		m_pHandoverCondition->notify_all();
+	}
 
-		m_pFence->unlock();
+	// Added renderers display slot was never prepared.
+	for (auto && itr : added)
+	{
+		itr->cb_prepare(display);
+	}
 
-	} while (this->running());
+	// Delete pointers in active OpenGL context, no frame uses them anymore.
+	if (!released.empty())
+	{
+		m_pContext->makeCurrent();
+		eve::core::Renderer * rdr = nullptr;
+		for (auto && itr : released)
+		{
+			rdr = itr;
+			EVE_RELEASE_PTR(rdr);
+		}
+		m_pContext->doneCurrent();
+	}
+}
+
+//=================================================================================================
+void eve::sys::Render::step(uint32_t p_numFrames)
+{
+	// Render loop thread would compete for context.
+	EVE_ASSERT(!this->started());
+
+	// Serial frames, each one displays what it just prepared.
+	for (uint32_t i = 0; i < p_numFrames; i++)
+	{
+		this->prepareFrame(false);
+		this->handover();
+		this->renderFrame();
+	}
 }
 
 
@@ -183,6 +345,7 @@ bool eve::sys::Render::registerRendererBack(eve::core::Renderer * p_pRenderer)
 	if (breturn)
 	{
 		m_pVecRenderers->push_back(p_pRenderer);
+		m_bRenderersDirty = true;
 	}
 
 	m_pFence->unlock();
@@ -200,6 +363,7 @@ bool eve::sys::Render::registerRendererFront(eve::core::Renderer * p_pRenderer)
 	if (breturn)
 	{
 		m_pVecRenderers->push_front(p_pRenderer);
+		m_bRenderersDirty = true;
 	}
 
 	m_pFence->unlock();
@@ -217,10 +381,23 @@ bool eve::sys::Render::unregisterRenderer(eve::core::Renderer * p_pRenderer)
 	if (breturn)
 	{
 		m_pVecRenderers->erase(itr);
+		m_bRenderersDirty = true;
+		// No frame in flight, caller may delete renderer on return.
+		if (!this->started()) {
+			m_pVecFrame->erase(std::remove(m_pVecFrame->begin(), m_pVecFrame->end(), p_pRenderer), m_pVecFrame->end());
+		}
 	}
+	const uint64_t handover = m_numHandovers.load();
 
 	m_pFence->unlock();
 
+	// Frame in flight may still use renderer, wait until next handover drops it (render thread itself would deadlock).
+	if (breturn && this->started() && !eve::thr::equal_ID(eve::thr::current_thread_ID(), m_threadID))
+	{
+		std::unique_lock<std::mutex> lock(*m_pHandoverMutex);
+		m_pHandoverCondition->wait(lock, [this, handover] { return m_numHandovers.load() != handover || !m_bLooping; });
+	}
+
 	return breturn;
 }
 
@@ -235,15 +412,25 @@ bool eve::sys::Render::releaseRenderer(eve::core::Renderer * p_pRenderer)
 	{
 		eve::core::Renderer * rder = (*itr);
 		m_pVecRenderers->erase(itr);
+		m_bRenderersDirty = true;
 
+		// Frame in flight may still use renderer, next handover deletes it.
+		if (this->started())
+		{
+			m_pVecRelease->push_back(rder);
+		}
+		else
+		{
+			m_pVecFrame->erase(std::remove(m_pVecFrame->begin(), m_pVecFrame->end(), rder), m_pVecFrame->end());
 
-		// Delete pointer in active OpenGL context.
-		m_pContext->makeCurrent();
-		
-		EVE_RELEASE_PTR(rder);
+			// Delete pointer in active OpenGL context.
+			m_pContext->makeCurrent();
 
-		m_pContext->swapBuffers();
-		m_pContext->doneCurrent();
+			EVE_RELEASE_PTR(rder);
+
+			m_pContext->swapBuffers();
+			m_pContext->doneCurrent();
+		}
 	}
 
 	m_pFence->unlock();
@@ -257,10 +444,7 @@ bool eve::sys::Render::releaseRenderer(eve::core::Renderer * p_pRenderer)
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 //=================================================================================================
-void eve::sys::Render::setFPS(int64_t p_fps)
+void eve::sys::Render::setFPS(double p_fps)
 {
-	m_pFence->lock();
-	m_fps		= p_fps;
-	m_baseWait	= 1000 / m_fps;
-	m_pFence->unlock();
+	m_pPacer->setRate(p_fps);
 }
@@ -37,10 +37,18 @@
 #include "eve/thr/Thread.h"
 #endif 
 
-#ifndef __EVE_TIME_TIMER_H__
-#include "eve/time/Timer.h"
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#include "eve/thr/TaskPool.h"
 #endif
 
+#ifndef __EVE_TIME_PACER_H__
+#include "eve/time/Pacer.h"
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 namespace eve { namespace core	{ class Renderer; } }
 namespace eve { namespace ogl	{ class SubContext; } }
 
@@ -54,6 +62,10 @@ namespace eve
 		*
 		* \brief Render engines threaded manager.
 		* Stock and manage threaded render manager.
+		* Frames are pipelined: renderers prepare frame N+1 (eve::core::Renderer::cb_prepare()) on eve::thr::TaskPool workers
+		* while frame N is submitted on render thread, then slots are swapped at a handover point, the only place fence is held.
+		* Renderers registry changes made while running are applied at next handover.
+		* Frames are paced by eve::time::Pacer outside fence, late frames drop missed deadlines instead of rendering a burst.
 		*
 		* \note extends eve::thr::Thread
 		*/
@@ -70,13 +82,25 @@ namespace eve
 			eve::ogl::SubContext *					m_pContext;			//!< Specifies OpenGL context pointer.
 
 			std::list<eve::core::Renderer*> *		m_pVecRenderers;	//!< Specifies render Engine(s) container.
+			std::vector<eve::core::Renderer*> *		m_pVecFrame;		//!< Specifies render Engine(s) used by frame pipeline, rebuilt at handover.
+			std::vector<eve::core::Renderer*> *		m_pVecRelease;		//!< Specifies render Engine(s) to release at next handover.
+			bool									m_bRenderersDirty;	//!< Specifies whether container changed since last handover.
+
+		private:
+			bool									m_bPipelined;		//!< Specifies whether preparation overlaps submission (default to true).
+			uint32_t								m_slotPrepare;		//!< Specifies render state slot prepared for next frame.
+			eve::thr::TaskCounter					m_counterPrepare;	//!< Specifies pending preparation tasks.
+			std::atomic<uint64_t>					m_numHandovers;		//!< Specifies handovers amount (incremented under fence).
+			bool									m_bLooping;			//!< Specifies whether run loop is active (handover mutex protected).
+			std::mutex *							m_pHandoverMutex;	//!< Specifies handover signal protection.
+			std::condition_variable *				m_pHandoverCondition;	//!< Specifies handover signal, waited by unregisterRenderer().
 
 		protected:
-			int64_t									m_baseWait;			//!< Specifies base wait time based on FPS.
-			int64_t									m_bufWait;			//!< Specifies calculated wait time.
-			int64_t									m_fps;				//!< Specifies target FPS (default to 30).
-			int64_t									m_elapsed;			//!< Specifies render elapsed time in milliseconds.
-			eve::time::Timer *						m_pTimerRender;		//!< Specifies timer used to compute FPS.
+			eve::time::Pacer *						m_pPacer;			//!< Specifies frame pacing (default to 60 FPS).
+			int64_t									m_frameMicro;		//!< Specifies last frame CPU time in microseconds (renderers callbacks and buffers swap).
+			uint64_t								m_numFrames;		//!< Specifies rendered frames amount.
+			int64_t									m_stallMicro;		//!< Specifies last frame render thread wait for preparation in microseconds.
+			int64_t									m_handoverMicro;	//!< Specifies last handover fence hold time in microseconds.
 
 
 			//////////////////////////////////////
@@ -89,7 +113,7 @@ namespace eve
 		public:
 			/**
 			* \brief Create and return new pointer.
-			* \param p_handle linked system window handle.
+			* \param p_handle linked system window handle, nullptr renders offscreen on a headless context.
 			*/
 			static eve::sys::Render * create_ptr(HWND p_handle);
 
@@ -119,6 +143,26 @@ namespace eve
 			virtual void run(void) override;
 
 
+		private:
+			/** \brief Prepare next frame slot with every frame renderer, on tasks pool if \a p_bAsync (see wait in handover()). */
+			void prepareFrame(bool p_bAsync);
+			/** \brief Render a frame with every frame renderer from display slot, fence is not held. */
+			void renderFrame(void);
+			/**
+			* \brief Wait for preparation then swap render state slots under fence.
+			* Registry changes are applied, released renderers are deleted and added ones prepare their display slot (both outside fence).
+			*/
+			void handover(void);
+
+
+		public:
+			/** 
+			* \brief Render \a p_numFrames frames from calling thread, no wait between frames.
+			* Used by benchmarks and tests on a non started instance, typically headless.
+			*/
+			void step(uint32_t p_numFrames = 1);
+
+
 		public:
 			/**
 			* \brief Register a renderer pointer at the back of the container.
@@ -133,12 +177,12 @@ namespace eve
 			*/
 			bool registerRendererFront(eve::core::Renderer * p_pRenderer);
 			/**
-			* \brief Unregister a renderer pointer.
+			* \brief Unregister a renderer pointer, when running wait for next handover (renderer is no longer used on return).
 			* Return false if renderer is not registered.
 			*/
 			bool unregisterRenderer(eve::core::Renderer * p_pRenderer);
 			/**
-			* \brief Unregister and release a renderer pointer.
+			* \brief Unregister and release a renderer pointer, when running release is deferred to next handover.
 			* Return false if renderer is not registered.
 			*/
 			bool releaseRenderer(eve::core::Renderer * p_pRenderer);
@@ -149,10 +193,28 @@ namespace eve
 			///////////////////////////////////////////////////////////////////////////////////////
 
 		public:
-			/** \brief Get FPS based on rendering elapsed time. */
+			/** \brief Get FPS based on last frame interval. */
 			const float getFPS(void) const;
-			/** \brief Set target FPS. */
-			void setFPS(int64_t p_fps);
+			/** \brief Set target FPS (60 by default, fractional rates allowed), 0 renders without waiting. */
+			void setFPS(double p_fps);
+			/** \brief Get frame pacing (target rate, frame intervals percentiles, missed deadlines). */
+			eve::time::Pacer * getPacer(void) const;
+			/** \brief Get last frame CPU time in microseconds. */
+			const int64_t getFrameMicro(void) const;
+			/** \brief Get rendered frames amount. */
+			const uint64_t getNumFrames(void) const;
+			/** \brief Get whether rendering is headless (no presented window). */
+			const bool isHeadless(void) const;
+
+		public:
+			/** \brief Get whether preparation overlaps submission. */
+			const bool isPipelined(void) const;
+			/** \brief Set whether preparation overlaps submission, serial frames prepare then render on render thread. */
+			void setPipelined(bool p_bPipelined);
+			/** \brief Get last frame render thread wait for preparation in microseconds. */
+			const int64_t getStallMicro(void) const;
+			/** \brief Get last handover fence hold time in microseconds. */
+			const int64_t getHandoverMicro(void) const;
 
 		}; // class Node
 
@@ -166,6 +228,14 @@ namespace eve
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 //=================================================================================================
-EVE_FORCE_INLINE const float eve::sys::Render::getFPS(void) const { return 1000.0f / static_cast<float>(m_elapsed > 1 ? m_elapsed : 1); }
+EVE_FORCE_INLINE const float eve::sys::Render::getFPS(void) const { return 1000000.0f / static_cast<float>(m_pPacer->getLastFrameMicro() > 1 ? m_pPacer->getLastFrameMicro() : 1); }
+EVE_FORCE_INLINE eve::time::Pacer * eve::sys::Render::getPacer(void) const	{ return m_pPacer;		}
+EVE_FORCE_INLINE const int64_t eve::sys::Render::getFrameMicro(void) const	{ return m_frameMicro;	}
+EVE_FORCE_INLINE const uint64_t eve::sys::Render::getNumFrames(void) const	{ return m_numFrames;	}
+EVE_FORCE_INLINE const bool eve::sys::Render::isHeadless(void) const		{ return m_handle == nullptr; }
+EVE_FORCE_INLINE const bool eve::sys::Render::isPipelined(void) const		{ return m_bPipelined;	}
+EVE_FORCE_INLINE void eve::sys::Render::setPipelined(bool p_bPipelined)		{ m_bPipelined = p_bPipelined; }
+EVE_FORCE_INLINE const int64_t eve::sys::Render::getStallMicro(void) const	{ return m_stallMicro;	}
+EVE_FORCE_INLINE const int64_t eve::sys::Render::getHandoverMicro(void) const { return m_handoverMicro; }
 
 #endif // __EVE_SYSTEM_RENDER_H__
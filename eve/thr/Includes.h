@@ -54,6 +54,10 @@
 #include "eve/thr/SpinLock.h"
 #endif 
 
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#include "eve/thr/TaskPool.h"
+#endif 
+
 #ifndef __EVE_THREADING_THREAD_H__
 #include "eve/thr/Thread.h"
 #endif 
@@ -0,0 +1,257 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/thr/TaskPool.h"
+
+#ifndef __EVE_SYSTEM_INFO_H__
+#include "eve/sys/win32/Info.h"
+#endif
+
+
+//=================================================================================================
+eve::thr::TaskThread * eve::thr::TaskThread::create_ptr(eve::thr::TaskPool * p_pPool)
+{
+	EVE_ASSERT(p_pPool);
+
+	eve::thr::TaskThread * ptr = new eve::thr::TaskThread(p_pPool);
+	ptr->init();
+	return ptr;
+}
+
+//=================================================================================================
+eve::thr::TaskThread::TaskThread(eve::thr::TaskPool * p_pPool)
+	// Inheritance
+	: eve::thr::Thread()
+	// Members init
+	, m_pPool(p_pPool)
+{}
+
+//=================================================================================================
+void eve::thr::TaskThread::initThreadedData(void)	{}
+void eve::thr::TaskThread::releaseThreadedData(void){}
+
+//=================================================================================================
+void eve::thr::TaskThread::run(void)
+{
+	HANDLE handles[2] = { m_hShutdownEvent, m_pPool->m_hSemaphore };
+
+	while (true)
+	{
+		DWORD ret = ::WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+		if (ret != WAIT_OBJECT_0 + 1) break;
+
+		// Queue may have been emptied by a waiting thread.
+		m_pPool->runOne();
+	}
+}
+
+
+
+//=================================================================================================
+eve::thr::TaskPool * eve::thr::TaskPool::m_p_instance = nullptr;
+
+//=================================================================================================
+eve::thr::TaskPool * eve::thr::TaskPool::create_instance(size_t p_numThreads)
+{
+	EVE_ASSERT(!m_p_instance);
+
+	if (p_numThreads == 0)
+	{
+		uint32_t numProc = eve::sys::get_logical_processor_num();
+		p_numThreads = (numProc > 1) ? static_cast<size_t>(numProc - 1) : 1;
+	}
+
+	m_p_instance = new eve::thr::TaskPool(p_numThreads);
+	m_p_instance->init();
+	return m_p_instance;
+}
+
+//=================================================================================================
+eve::thr::TaskPool * eve::thr::TaskPool::get_instance(void)
+{
+	EVE_ASSERT(m_p_instance);
+	return m_p_instance;
+}
+
+//=================================================================================================
+void eve::thr::TaskPool::release_instance(void)
+{
+	EVE_ASSERT(m_p_instance);
+	EVE_RELEASE_PTR(m_p_instance);
+}
+
+
+
+//=================================================================================================
+eve::thr::TaskPool::TaskPool(size_t p_numThreads)
+	// Inheritance
+	: eve::mem::Pointer()
+
+	// Members init
+	, m_numThreads(p_numThreads)
+	, m_pVecThreads(nullptr)
+	, m_pQueue(nullptr)
+	, m_pFence(nullptr)
+	, m_hSemaphore(0)
+{}
+
+
+
+//=================================================================================================
+void eve::thr::TaskPool::init(void)
+{
+	m_pQueue	 = new std::deque<Entry>();
+	m_pFence	 = EVE_CREATE_PTR(eve::thr::SpinLock);
+	m_hSemaphore = ::CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+	EVE_ASSERT(m_hSemaphore);
+
+	m_pVecThreads = new std::vector<eve::thr::TaskThread*>();
+	for (size_t i = 0; i < m_numThreads; i++)
+	{
+		eve::thr::TaskThread * thread = eve::thr::TaskThread::create_ptr(this);
+		thread->start();
+		m_pVecThreads->push_back(thread);
+	}
+}
+
+//=================================================================================================
+void eve::thr::TaskPool::release(void)
+{
+	// Stop and join worker threads.
+	eve::thr::TaskThread * thread = nullptr;
+	while (!m_pVecThreads->empty())
+	{
+		thread = m_pVecThreads->back();
+		m_pVecThreads->pop_back();
+		EVE_RELEASE_PTR(thread);
+	}
+	EVE_RELEASE_PTR_CPP(m_pVecThreads);
+
+	// Run remaining tasks so counters are released.
+	while (this->runOne());
+
+	::CloseHandle(m_hSemaphore);
+	m_hSemaphore = 0;
+
+	EVE_RELEASE_PTR(m_pFence);
+	EVE_RELEASE_PTR_CPP(m_pQueue);
+}
+
+
+
+//=================================================================================================
+void eve::thr::TaskPool::push(const Task & p_task, eve::thr::TaskCounter * p_pCounter)
+{
+	if (p_pCounter) {
+		::InterlockedIncrement(&p_pCounter->m_pending);
+	}
+
+	Entry entry;
+	entry.task	   = p_task;
+	entry.pCounter = p_pCounter;
+
+	m_pFence->lock();
+	m_pQueue->push_back(entry);
+	m_pFence->unlock();
+
+	::ReleaseSemaphore(m_hSemaphore, 1, NULL);
+}
+
+//=================================================================================================
+bool eve::thr::TaskPool::runOne(void)
+{
+	Entry entry;
+
+	m_pFence->lock();
+	bool ret = !m_pQueue->empty();
+	if (ret)
+	{
+		entry = m_pQueue->front();
+		m_pQueue->pop_front();
+	}
+	m_pFence->unlock();
+
+	if (ret)
+	{
+		entry.task();
+		if (entry.pCounter) {
+			::InterlockedDecrement(&entry.pCounter->m_pending);
+		}
+	}
+
+	return ret;
+}
+
+//=================================================================================================
+void eve::thr::TaskPool::wait(eve::thr::TaskCounter * p_pCounter)
+{
+	EVE_ASSERT(p_pCounter);
+
+	while (!p_pCounter->done())
+	{
+		// Help instead of blocking, tasks being run elsewhere may still be pending.
+		if (!this->runOne()) {
+			::SwitchToThread();
+		}
+	}
+}
+
+//=================================================================================================
+void eve::thr::TaskPool::parallel_for(size_t p_begin, size_t p_end, size_t p_grain, const RangeTask & p_task)
+{
+	if (p_end <= p_begin) return;
+
+	const size_t count	   = p_end - p_begin;
+	const size_t numChunks = std::min(count / std::max(p_grain, size_t(1)), (m_numThreads + 1) * 4);
+
+	// Not worth splitting.
+	if (numChunks < 2)
+	{
+		p_task(p_begin, p_end);
+		return;
+	}
+
+	const size_t chunk = (count + numChunks - 1) / numChunks;
+
+	eve::thr::TaskCounter counter;
+	size_t begin = p_begin + chunk;
+	while (begin < p_end)
+	{
+		size_t end = std::min(begin + chunk, p_end);
+		this->push([&p_task, begin, end](void) { p_task(begin, end); }, &counter);
+		begin = end;
+	}
+
+	// Calling thread runs first chunk.
+	p_task(p_begin, std::min(p_begin + chunk, p_end));
+	this->wait(&counter);
+}
@@ -0,0 +1,244 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_THREADING_TASK_POOL_H__
+#define __EVE_THREADING_TASK_POOL_H__
+
+#include <functional>
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_THREADING_SPIN_LOCK_H__
+#include "eve/thr/SpinLock.h"
+#endif
+
+#ifndef __EVE_THREADING_THREAD_H__
+#include "eve/thr/Thread.h"
+#endif
+
+
+namespace eve { namespace app { class App; } }
+namespace eve { namespace thr { class TaskPool; } }
+
+
+namespace eve
+{
+	namespace thr
+	{
+		/**
+		* \class eve::thr::TaskCounter
+		*
+		* \brief Pending tasks counter, used to wait for a group of tasks completion.
+		*/
+		class TaskCounter final
+		{
+			friend class eve::thr::TaskPool;
+
+		private:
+			volatile LONG		m_pending;			//!< Pending tasks amount.
+
+		public:
+			/** \brief Class constructor. */
+			TaskCounter(void) : m_pending(0) {}
+
+		public:
+			/** \brief Get completion state. */
+			bool done(void) const { return m_pending == 0; }
+
+		}; // class TaskCounter
+
+
+		/**
+		* \class eve::thr::TaskThread
+		*
+		* \brief Task pool worker thread, runs queued tasks until stopped.
+		*
+		* \note extends eve::thr::Thread
+		*/
+		class TaskThread final
+			: public eve::thr::Thread
+		{
+			friend class eve::thr::TaskPool;
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			eve::thr::TaskPool *		m_pPool;				//!< Owner pool (shared pointer).
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(TaskThread);
+			EVE_PUBLIC_DESTRUCTOR(TaskThread);
+
+		public:
+			/** \brief Create, init and return new pointer. */
+			static eve::thr::TaskThread * create_ptr(eve::thr::TaskPool * p_pPool);
+
+		private:
+			/** \brief Class constructor. */
+			explicit TaskThread(eve::thr::TaskPool * p_pPool);
+
+
+		protected:
+			/** \brief Alloc and init threaded data. (pure virtual) */
+			virtual void initThreadedData(void) override;
+			/** \brief Release and delete threaded data. (pure virtual) */
+			virtual void releaseThreadedData(void) override;
+
+			/** \brief Run is the main loop for this thread. (pure virtual) */
+			virtual void run(void) override;
+
+		}; // class TaskThread
+
+
+		/**
+		* \class eve::thr::TaskPool
+		*
+		* \brief Fixed size worker threads pool running queued tasks.
+		* Waiting threads help running queued tasks, so tasks may push and wait for sub-tasks (recursive jobs).
+		*
+		* \note extends eve::mem::Pointer
+		*/
+		class TaskPool final
+			: public eve::mem::Pointer
+		{
+			friend class eve::app::App;
+			friend class eve::thr::TaskThread;
+
+			//////////////////////////////////////
+			//				TYPE				//
+			//////////////////////////////////////
+
+		public:
+			/** \brief Task function type. */
+			typedef std::function<void(void)>				Task;
+			/** \brief Range task function type, called with [begin, end[ sub range. */
+			typedef std::function<void(size_t, size_t)>		RangeTask;
+
+		private:
+			/** \brief Queued task and its counter. */
+			struct Entry
+			{
+				Task							task;
+				eve::thr::TaskCounter *			pCounter;
+			};
+
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			static TaskPool *								m_p_instance;		//!< Unique instance.
+
+		private:
+			size_t											m_numThreads;		//!< Worker threads amount.
+			std::vector<eve::thr::TaskThread*> *			m_pVecThreads;		//!< Worker threads.
+			std::deque<Entry> *								m_pQueue;			//!< Queued tasks.
+			eve::thr::SpinLock *							m_pFence;			//!< Queue protection fence.
+			HANDLE											m_hSemaphore;		//!< Queued tasks semaphore, wakes worker threads.
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(TaskPool)
+			EVE_PUBLIC_DESTRUCTOR(TaskPool)
+
+		private:
+			/** \brief Create unique instance, \a p_numThreads 0 uses logical processors amount minus one (calling thread helps). */
+			static TaskPool * create_instance(size_t p_numThreads = 0);
+		public:
+			/** \brief Get unique instance. */
+			static TaskPool * get_instance(void);
+		private:
+			/** \brief Release unique instance */
+			static void release_instance(void);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit TaskPool(size_t p_numThreads);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		public:
+			/** \brief Queue task, \a p_pCounter (may be nullptr) is incremented now and decremented on task completion. */
+			void push(const Task & p_task, eve::thr::TaskCounter * p_pCounter = nullptr);
+			/** \brief Run queued tasks until \a p_pCounter reaches zero. */
+			void wait(eve::thr::TaskCounter * p_pCounter);
+			/** \brief Split [p_begin, p_end[ in chunks of at least \a p_grain items, run them in parallel and wait for completion. */
+			void parallel_for(size_t p_begin, size_t p_end, size_t p_grain, const RangeTask & p_task);
+
+
+		private:
+			/** \brief Pop and run one queued task, return false if queue is empty. */
+			bool runOne(void);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get worker threads amount. */
+			const size_t getNumThreads(void) const;
+
+		}; // class TaskPool
+
+	} // namespace thr
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const size_t eve::thr::TaskPool::getNumThreads(void) const { return m_numThreads; }
+
+#endif // __EVE_THREADING_TASK_POOL_H__
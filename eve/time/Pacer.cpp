@@ -0,0 +1,311 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Main header
+#include "eve/time/Pacer.h"
+
+#ifndef __EVE_THREADING_UTILS_H__
+#include "eve/thr/Utils.h"
+#endif
+
+#ifndef __EVE_TIME_UTILS_H__
+#include "eve/time/Utils.h"
+#endif
+
+#include <algorithm>
+
+
+/** \def CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+* \brief Waitable timer creation flag (Windows 10 1803), missing from older SDK headers.
+*/
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION	0x00000002
+#endif
+
+
+//=================================================================================================
+eve::time::Pacer * eve::time::Pacer::create_ptr(double p_rate)
+{
+	eve::time::Pacer * ptr = new eve::time::Pacer();
+	ptr->init();
+	ptr->setRate(p_rate);
+	return ptr;
+}
+
+
+
+//=================================================================================================
+eve::time::Pacer::Pacer(void)
+	// Inheritance
+	: eve::mem::Pointer()
+	// Members init
+	, m_periodMicro(0)
+	, m_deadline(0)
+	, m_last(0)
+	, m_spinMicro(2000)
+	, m_spinMinMicro(500)
+	, m_bRestart(true)
+	, m_hTimer(nullptr)
+	, m_pSamples(nullptr)
+	, m_sampleNext(0)
+	, m_lastFrameMicro(0)
+	, m_numFrames(0)
+	, m_numMissed(0)
+	, m_numSkipped(0)
+	, m_pFence(nullptr)
+{}
+
+
+
+//=================================================================================================
+void eve::time::Pacer::init(void)
+{
+	m_pSamples = new std::vector<int64_t>();
+	m_pSamples->reserve(EVE_TIME_PACER_NUM_SAMPLES);
+
+	m_pFence = EVE_CREATE_PTR(eve::thr::SpinLock);
+
+	// High resolution timer wakes up within tens of microseconds, older systems fall back to scheduler tick.
+	m_hTimer = ::CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (!m_hTimer) {
+		m_hTimer = ::CreateWaitableTimerW(nullptr, TRUE, nullptr);
+	}
+	m_bRestart = true;
+}
+
+//=================================================================================================
+void eve::time::Pacer::release(void)
+{
+	if (m_hTimer)
+	{
+		::CloseHandle(m_hTimer);
+		m_hTimer = nullptr;
+	}
+
+	EVE_RELEASE_PTR(m_pFence);
+	EVE_RELEASE_PTR_CPP(m_pSamples);
+}
+
+
+
+//=================================================================================================
+void eve::time::Pacer::sleep(int64_t p_micro)
+{
+	if (m_hTimer)
+	{
+		// Relative due time in 100 nanoseconds units.
+		::LARGE_INTEGER due;
+		due.QuadPart = -p_micro * 10;
+		if (::SetWaitableTimer(m_hTimer, &due, 0, nullptr, nullptr, FALSE))
+		{
+			::WaitForSingleObject(m_hTimer, INFINITE);
+			return;
+		}
+	}
+	eve::thr::sleep_milli(static_cast<int32_t>(p_micro / 1000));
+}
+
+
+
+//=================================================================================================
+void eve::time::Pacer::reset(void)
+{
+	m_pFence->lock();
+	m_bRestart = true;
+	m_pFence->unlock();
+}
+
+//=================================================================================================
+uint32_t eve::time::Pacer::wait(void)
+{
+	m_pFence->lock();
+	const int64_t period  = m_periodMicro;
+	const bool	  restart = m_bRestart;
+	m_bRestart = false;
+	m_pFence->unlock();
+
+	// Deadlines and last time are only touched by pacing thread.
+	if (restart)
+	{
+		m_deadline = 0;
+		m_last	   = 0;
+	}
+
+	int64_t  now	 = eve::time::current_time_micro();
+	uint32_t skipped = 0;
+	bool	 missed	 = false;
+
+	if (period > 0)
+	{
+		// First frame (or rate change) starts cadence.
+		if (m_deadline == 0) {
+			m_deadline = now;
+		}
+
+		if (now > m_deadline)
+		{
+			missed = true;
+
+			// Whole periods behind are dropped, deadline stays on cadence grid.
+			const int64_t late = now - m_deadline;
+			skipped	   = static_cast<uint32_t>(late / period);
+			m_deadline += static_cast<int64_t>(skipped) * period;
+		}
+		else
+		{
+			// Coarse sleep up to spin window, OS wakes up late by a variable amount.
+			const int64_t remaining = m_deadline - now;
+			const int64_t request	= remaining - m_spinMicro;
+			if (request > 0)
+			{
+				const int64_t start = now;
+				this->sleep(request);
+				now = eve::time::current_time_micro();
+
+				// Window grows at once on a late wake up, shrinks slowly back towards overshoot otherwise.
+				const int64_t overshoot = (now - start) - request;
+				const int64_t target	= std::max(overshoot + (overshoot >> 2), m_spinMinMicro);
+				if (target > m_spinMicro) {
+					m_spinMicro = std::min(target, period >> 1);
+				}
+				else {
+					m_spinMicro -= (m_spinMicro - target) >> 4;
+				}
+			}
+
+			// Fine wait, yield to other threads until deadline.
+			while (now < m_deadline)
+			{
+				eve::thr::sleep_iter(1);
+				now = eve::time::current_time_micro();
+			}
+		}
+
+		m_deadline += period;
+	}
+
+	const int64_t interval = (m_last != 0) ? now - m_last : 0;
+	m_last = now;
+
+	m_pFence->lock();
+	if (interval > 0)
+	{
+		if (m_pSamples->size() < EVE_TIME_PACER_NUM_SAMPLES) {
+			m_pSamples->push_back(interval);
+		}
+		else {
+			(*m_pSamples)[m_sampleNext] = interval;
+		}
+		m_sampleNext	 = (m_sampleNext + 1) % EVE_TIME_PACER_NUM_SAMPLES;
+		m_lastFrameMicro = interval;
+	}
+	m_numFrames++;
+	if (missed) { m_numMissed++; }
+	m_numSkipped += skipped;
+	m_pFence->unlock();
+
+	return skipped;
+}
+
+
+
+//=================================================================================================
+void eve::time::Pacer::computeStats(eve::time::PacerStats * p_pStats) const
+{
+	EVE_ASSERT(p_pStats);
+
+	m_pFence->lock();
+	std::vector<int64_t> samples(*m_pSamples);
+	p_pStats->numFrames	 = m_numFrames;
+	p_pStats->numMissed	 = m_numMissed;
+	p_pStats->numSkipped = m_numSkipped;
+	m_pFence->unlock();
+
+	const size_t numSamples = samples.size();
+	if (numSamples == 0)
+	{
+		p_pStats->p50Micro	= p_pStats->p95Micro = p_pStats->p99Micro = 0;
+		p_pStats->maxMicro	= p_pStats->meanMicro = 0;
+		return;
+	}
+
+	// Nearest rank, each selection only partially orders samples.
+	auto rank = [&](double p_ratio) -> int64_t
+	{
+		size_t idx = static_cast<size_t>(p_ratio * static_cast<double>(numSamples) + 0.999999);
+		idx = (idx > 0) ? idx - 1 : 0;
+		std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+		return samples[idx];
+	};
+	p_pStats->p50Micro = rank(0.50);
+	p_pStats->p95Micro = rank(0.95);
+	p_pStats->p99Micro = rank(0.99);
+
+	int64_t sum = 0;
+	int64_t max = 0;
+	for (auto && itr : samples)
+	{
+		sum += itr;
+		max  = std::max(max, itr);
+	}
+	p_pStats->maxMicro  = max;
+	p_pStats->meanMicro = sum / static_cast<int64_t>(numSamples);
+}
+
+//=================================================================================================
+void eve::time::Pacer::clearStats(void)
+{
+	m_pFence->lock();
+	m_pSamples->clear();
+	m_sampleNext	 = 0;
+	m_lastFrameMicro = 0;
+	m_numFrames		 = 0;
+	m_numMissed		 = 0;
+	m_numSkipped	 = 0;
+	m_pFence->unlock();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+void eve::time::Pacer::setRate(double p_rate)
+{
+	EVE_ASSERT(p_rate >= 0.0);
+
+	m_pFence->lock();
+	m_periodMicro = (p_rate > 0.0) ? static_cast<int64_t>(1000000.0 / p_rate + 0.5) : 0;
+	m_bRestart	  = true;
+	m_pFence->unlock();
+}
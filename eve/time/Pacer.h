@@ -0,0 +1,216 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+#ifndef __EVE_TIME_PACER_H__
+#define __EVE_TIME_PACER_H__
+
+#ifndef __EVE_CORE_INCLUDES_H__
+#include "eve/core/Includes.h"
+#endif
+
+#ifndef __EVE_MEMORY_INCLUDES_H__
+#include "eve/mem/Includes.h"
+#endif
+
+#ifndef __EVE_THREADING_SPIN_LOCK_H__
+#include "eve/thr/SpinLock.h"
+#endif
+
+
+/** \def EVE_TIME_PACER_NUM_SAMPLES
+* \brief Frame intervals history length used by percentiles.
+*/
+#define EVE_TIME_PACER_NUM_SAMPLES		512
+
+
+namespace eve
+{
+	namespace time
+	{
+		/** 
+		* \struct eve::time::PacerStats
+		* \brief Frame pacing counters, intervals percentiles cover last EVE_TIME_PACER_NUM_SAMPLES frames.
+		*/
+		struct PacerStats
+		{
+			int64_t			p50Micro;			//!< Median frame interval in microseconds.
+			int64_t			p95Micro;			//!< 95th percentile frame interval in microseconds.
+			int64_t			p99Micro;			//!< 99th percentile frame interval in microseconds.
+			int64_t			maxMicro;			//!< Longest frame interval in microseconds.
+			int64_t			meanMicro;			//!< Mean frame interval in microseconds.
+			uint64_t		numFrames;			//!< Paced frames amount.
+			uint64_t		numMissed;			//!< Frames reaching wait() after their deadline.
+			uint64_t		numSkipped;			//!< Deadlines dropped to catch up instead of rendering a burst.
+
+			PacerStats(void) : p50Micro(0), p95Micro(0), p99Micro(0), maxMicro(0), meanMicro(0), numFrames(0), numMissed(0), numSkipped(0) {}
+		};
+
+
+		/** 
+		* \class eve::time::Pacer
+		* 
+		* \brief Frame pacing on high resolution deadlines.
+		* Deadlines advance by one period per frame so rate does not drift with frame cost. wait() sleeps until a spin window 
+		* before deadline (high resolution waitable timer when available) then spins (yielding) to it, window follows observed sleep overshoot. A frame late by whole periods 
+		* drops them and keeps cadence phase, no burst is rendered to catch up.
+		*
+		* \note extends eve::mem::Pointer.
+		*/
+		class Pacer final
+			: public eve::mem::Pointer
+		{
+
+			//////////////////////////////////////
+			//				DATA				//
+			//////////////////////////////////////
+
+		private:
+			int64_t						m_periodMicro;		//!< Specifies target frame period in microseconds, 0 is unpaced.
+			int64_t						m_deadline;			//!< Specifies next frame deadline (eve::time::current_time_micro() clock), 0 until first wait.
+			int64_t						m_last;				//!< Specifies last wait() return time.
+			int64_t						m_spinMicro;		//!< Specifies spin window before deadline in microseconds.
+			int64_t						m_spinMinMicro;		//!< Specifies spin window lower bound in microseconds.
+			bool						m_bRestart;			//!< Specifies whether deadlines restart on next wait().
+			HANDLE						m_hTimer;			//!< Specifies waitable timer used by coarse sleep.
+
+		private:
+			std::vector<int64_t> *		m_pSamples;			//!< Specifies frame intervals ring.
+			size_t						m_sampleNext;		//!< Specifies next written ring sample.
+			int64_t						m_lastFrameMicro;	//!< Specifies last frame interval in microseconds.
+			uint64_t					m_numFrames;		//!< Specifies paced frames amount.
+			uint64_t					m_numMissed;		//!< Specifies missed deadlines amount.
+			uint64_t					m_numSkipped;		//!< Specifies dropped deadlines amount.
+			eve::thr::SpinLock *		m_pFence;			//!< Specifies rate and counters fence (rate is set and stats read from other threads).
+
+
+			//////////////////////////////////////
+			//				METHOD				//
+			//////////////////////////////////////
+
+			EVE_DISABLE_COPY(Pacer);
+			EVE_PUBLIC_DESTRUCTOR(Pacer);
+
+		public:
+			/** \brief Create and return new pointer pacing at \a p_rate frames per second (0 is unpaced). */
+			static eve::time::Pacer * create_ptr(double p_rate);
+
+
+		public:
+			/** \brief Class constructor. */
+			explicit Pacer(void);
+
+
+		public:
+			/** \brief Alloc and init class members. (pure virtual) */
+			virtual void init(void) override;
+			/** \brief Release and delete class members. (pure virtual) */
+			virtual void release(void) override;
+
+
+		private:
+			/** \brief Block calling thread for about \a p_micro microseconds. */
+			void sleep(int64_t p_micro);
+
+
+		public:
+			/** \brief Restart deadlines on next wait() (after a pause). */
+			void reset(void);
+			/** 
+			* \brief Wait for next frame deadline, return dropped deadlines amount.
+			* Called once per frame by pacing thread, returns immediately when deadline is already passed.
+			*/
+			uint32_t wait(void);
+
+
+		public:
+			/** \brief Compute frame intervals percentiles and counters into \a p_pStats. */
+			void computeStats(eve::time::PacerStats * p_pStats) const;
+			/** \brief Clear frame intervals history and counters. */
+			void clearStats(void);
+
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get target rate in frames per second (0 is unpaced). */
+			const double getRate(void) const;
+			/** \brief Set target rate in frames per second, 0 is unpaced, deadlines restart on next wait(). */
+			void setRate(double p_rate);
+			/** \brief Get target frame period in microseconds (0 is unpaced). */
+			const int64_t getPeriodMicro(void) const;
+
+
+		public:
+			/** \brief Get spin window before deadline in microseconds. */
+			const int64_t getSpinMicro(void) const;
+			/** \brief Set spin window lower bound in microseconds (window grows with observed sleep overshoot). */
+			void setSpinMinMicro(int64_t p_micro);
+
+
+		public:
+			/** \brief Get last frame interval in microseconds. */
+			const int64_t getLastFrameMicro(void) const;
+			/** \brief Get paced frames amount. */
+			const uint64_t getNumFrames(void) const;
+			/** \brief Get missed deadlines amount. */
+			const uint64_t getNumMissed(void) const;
+			/** \brief Get dropped deadlines amount. */
+			const uint64_t getNumSkipped(void) const;
+
+		}; // class Pacer
+
+	} // namespace time
+
+} // namespace eve
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE const double	eve::time::Pacer::getRate(void) const			{ return (m_periodMicro > 0) ? 1000000.0 / static_cast<double>(m_periodMicro) : 0.0; }
+EVE_FORCE_INLINE const int64_t	eve::time::Pacer::getPeriodMicro(void) const	{ return m_periodMicro;		}
+
+//=================================================================================================
+EVE_FORCE_INLINE const int64_t	eve::time::Pacer::getSpinMicro(void) const		{ return m_spinMicro;		}
+EVE_FORCE_INLINE void			eve::time::Pacer::setSpinMinMicro(int64_t p_micro) { EVE_ASSERT(p_micro >= 0); m_spinMinMicro = p_micro; }
+
+//=================================================================================================
+EVE_FORCE_INLINE const int64_t	eve::time::Pacer::getLastFrameMicro(void) const	{ return m_lastFrameMicro;	}
+EVE_FORCE_INLINE const uint64_t	eve::time::Pacer::getNumFrames(void) const		{ return m_numFrames;		}
+EVE_FORCE_INLINE const uint64_t	eve::time::Pacer::getNumMissed(void) const		{ return m_numMissed;		}
+EVE_FORCE_INLINE const uint64_t	eve::time::Pacer::getNumSkipped(void) const		{ return m_numSkipped;		}
+
+#endif // __EVE_TIME_PACER_H__
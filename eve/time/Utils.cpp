@@ -58,6 +58,34 @@ int64_t eve::time::current_time_milli(void)
 #endif
 }
 
+//=================================================================================================
+int64_t eve::time::current_time_micro(void)
+{
+#if defined(EVE_OS_WIN)
+	// Performance counter frequency is fixed at system boot.
+	static int64_t s_frequency = 0;
+	if (s_frequency == 0)
+	{
+		::LARGE_INTEGER freq;
+		::QueryPerformanceFrequency(&freq);
+		s_frequency = static_cast<int64_t>(freq.QuadPart);
+	}
+
+	::LARGE_INTEGER counter;
+	::QueryPerformanceCounter(&counter);
+
+	// Split to avoid overflow on long uptimes.
+	int64_t ticks = static_cast<int64_t>(counter.QuadPart);
+	return (ticks / s_frequency) * 1000000 + ((ticks % s_frequency) * 1000000) / s_frequency;
+
+#else
+	timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return static_cast<int64_t>(t.tv_sec) * 1000000 + static_cast<int64_t>(t.tv_nsec / 1000);
+
+#endif
+}
+
 
 
 //=================================================================================================
@@ -48,6 +48,11 @@ namespace eve
 		* Should be accurate to within a few milliseconds, depending on platform, hardware, etc.
 		*/
 		int64_t current_time_milli(void);
+		/**
+		* \brief Returns a monotonic high resolution time stamp in microseconds, from an unspecified origin.
+		* Meant for intervals measurement (frame budgets, profiling), not for calendar time.
+		*/
+		int64_t current_time_micro(void);
 
 
 		/** \brief Convert milliseconds to local time. */
@@ -6,6 +6,14 @@
 #include "eve/ui/Layer.h"
 #endif
 
+#ifndef __EVE_OPENGL_CORE_PROGRAM_CACHE_H__
+#include "eve/ogl/core/ProgramCache.h"
+#endif
+
+#ifndef __EVE_OPENGL_CORE_SHADER_RELOADER_H__
+#include "eve/ogl/core/ShaderReloader.h"
+#endif
+
 
 //=================================================================================================
 eve::ui::Renderer * eve::ui::Renderer::create_ptr(eve::ui::Layer * p_pLayer, int32_t p_width, int32_t p_height)
@@ -69,17 +77,33 @@ void eve::ui::Renderer::init(void)
 	// Call parent class.
 	eve::ogl::Renderer::init();
 
+	// Shader sources, read in parallel.
+	eve::ogl::ProgramCache * pCache = eve::ogl::ProgramCache::get_instance();
+	std::vector<std::string> paths;
+	paths.push_back(eve::io::resource_path_glsl("Colored2D.vert"));
+	paths.push_back(eve::io::resource_path_glsl("Colored2D.frag"));
+	paths.push_back(eve::io::resource_path_glsl("Textured2D.vert"));
+	paths.push_back(eve::io::resource_path_glsl("Textured2D.frag"));
+	pCache->preload(paths);
+
 	// Colored shader.
 	eve::ogl::FormatShader fmtShaderCol;
-	fmtShaderCol.vert = eve::io::load_program(eve::io::resource_path_glsl("Colored2D.vert"));
-	fmtShaderCol.frag = eve::io::load_program(eve::io::resource_path_glsl("Colored2D.frag"));
+	fmtShaderCol.vert = pCache->source(paths[0]);
+	fmtShaderCol.frag = pCache->source(paths[1]);
 	m_pShaderColored = this->create(fmtShaderCol);
 
 	// Textured shader.
 	eve::ogl::FormatShader fmtShaderTex;
-	fmtShaderTex.vert = eve::io::load_program(eve::io::resource_path_glsl("Textured2D.vert"));
-	fmtShaderTex.frag = eve::io::load_program(eve::io::resource_path_glsl("Textured2D.frag"));
+	fmtShaderTex.vert = pCache->source(paths[2]);
+	fmtShaderTex.frag = pCache->source(paths[3]);
 	m_pShaderTextured = this->create(fmtShaderTex);
+
+	// Hot reload.
+	eve::ogl::ShaderReloader * pReloader = eve::ogl::ShaderReloader::get_instance();
+	pReloader->watch(m_pShaderColored,	eve::ogl::prgm_Vertex,	 paths[0]);
+	pReloader->watch(m_pShaderColored,	eve::ogl::prgm_Fragment, paths[1]);
+	pReloader->watch(m_pShaderTextured, eve::ogl::prgm_Vertex,	 paths[2]);
+	pReloader->watch(m_pShaderTextured, eve::ogl::prgm_Fragment, paths[3]);
 	
 	// Uniform buffer.
 	eve::ogl::FormatUniform fmtUniform;
@@ -155,7 +179,7 @@ void eve::ui::Renderer::viewTranslateY(int32_t p_value)
 //=================================================================================================
 void eve::ui::Renderer::cb_display(void)
 {
-	glViewport(m_viewX, m_viewY, m_viewWidth, m_viewHeight);
+	EveStateGL->viewport(m_viewX, m_viewY, m_viewWidth, m_viewHeight);
 	m_pUniformMatrices->bindCamera();
 
 	m_pShaderColored->bind();
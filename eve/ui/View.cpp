@@ -32,6 +32,14 @@
 // Main class header
 #include "eve/ui/View.h"
 
+#ifndef __EVE_SCENE_SCENE_H__
+#include "eve/scene/Scene.h"
+#endif
+
+#ifndef __EVE_SCENE_VIEW_RENDERER_H__
+#include "eve/scene/ViewRenderer.h"
+#endif
+
 
 //=================================================================================================
 eve::ui::View::View(void)
@@ -41,6 +49,7 @@ eve::ui::View::View(void)
 	// Members init
 	, m_pVecFrame(nullptr)
 	, m_pVecDisplay(nullptr)
+	, m_pSceneShared(nullptr)
 {}
 
 
@@ -69,6 +78,7 @@ void eve::ui::View::init(void)
 	// Containers.
 	m_pVecFrame		= new std::vector<eve::ui::Frame*>();
 	m_pVecDisplay	= new std::vector<eve::ui::Display*>();
+	m_pSceneShared	= nullptr;
 
 	// Call parent class
 	eve::sys::View::init();
@@ -99,6 +109,9 @@ void eve::ui::View::release(void)
 	}
 	EVE_RELEASE_PTR_CPP(m_pVecFrame);
 
+	// Shared scene is released by render engine, after displays released their views frames.
+	m_pSceneShared = nullptr;
+
 	// Call parent class
 	eve::sys::View::release();
 }
@@ -197,6 +210,38 @@ bool eve::ui::View::releaseDisplay(eve::ui::Display * p_pDisplay)
 
 
 
+//=================================================================================================
+void eve::ui::View::setSharedScene(eve::scene::Scene * p_pScene)
+{
+	EVE_ASSERT(p_pScene);
+	EVE_ASSERT(!m_pSceneShared);
+
+	m_pSceneShared = p_pScene;
+	this->registerRenderer(m_pSceneShared);
+}
+
+//=================================================================================================
+bool eve::ui::View::linkDisplay(eve::ui::Display * p_pDisplay, eve::scene::Camera * p_pCamera)
+{
+	EVE_ASSERT(p_pDisplay);
+	EVE_ASSERT(p_pCamera);
+
+	m_pFence->lock();
+
+	bool breturn = m_pSceneShared && (std::find(m_pVecDisplay->begin(), m_pVecDisplay->end(), p_pDisplay) != m_pVecDisplay->end());
+	if (breturn)
+	{
+		uint32_t view = m_pSceneShared->addView(p_pCamera);
+		p_pDisplay->registerRenderer(eve::scene::ViewRenderer::create_ptr(m_pSceneShared, view));
+	}
+
+	m_pFence->unlock();
+
+	return breturn;
+}
+
+
+
 //=================================================================================================
 void eve::ui::View::cb_evtWindowResize(eve::evt::ResizeEventArgs & p_arg)
 {
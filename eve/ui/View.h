@@ -46,6 +46,10 @@
 #endif
 
 
+namespace eve { namespace scene { class Camera; } }
+namespace eve { namespace scene { class Scene; } }
+
+
 namespace eve
 {
 	namespace ui
@@ -72,6 +76,7 @@ namespace eve
 		protected:
 			std::vector<eve::ui::Frame*> *		m_pVecFrame;		//!< Specifies frame containing vector.
 			std::vector<eve::ui::Display*> *	m_pVecDisplay;		//!< Specifies display containing vector.
+			eve::scene::Scene *					m_pSceneShared;		//!< Specifies scene shared by displays (nullptr if none).
 
 
 			//////////////////////////////////////
@@ -170,16 +175,47 @@ namespace eve
 			bool releaseDisplay(eve::ui::Display * p_pDisplay);
 
 
+		public:
+			/**
+			* \brief Set scene shared by displays, view takes ownership and registers it as renderer.
+			* Scene is updated, culled for every linked display and uploaded once per frame by this view render thread.
+			*/
+			void setSharedScene(eve::scene::Scene * p_pScene);
+			/**
+			* \brief Draw shared scene from camera \a p_pCamera (shared scene camera) in display \a p_pDisplay, under display widgets.
+			* Return false if display is not registered or no shared scene is set.
+			*/
+			bool linkDisplay(eve::ui::Display * p_pDisplay, eve::scene::Camera * p_pCamera);
+
+
 		public:
 			/** \brief Window resize event handler. */
 			virtual void cb_evtWindowResize(eve::evt::ResizeEventArgs & p_arg);
 
+
+			///////////////////////////////////////////////////////////////////////////////////////
+			//		GET / SET
+			///////////////////////////////////////////////////////////////////////////////////////
+
+		public:
+			/** \brief Get scene shared by displays (nullptr if none). */
+			eve::scene::Scene * getSharedScene(void) const;
+
 		}; // class View
 
 	} // namespace ui
 
 } // namespace eve
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//		GET / SET
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//=================================================================================================
+EVE_FORCE_INLINE eve::scene::Scene * eve::ui::View::getSharedScene(void) const { return m_pSceneShared; }
+
+
 //=================================================================================================
 template<class TFrame>
 TFrame * eve::ui::View::addFrame(int32_t p_x, int32_t p_y, int32_t p_width, int32_t p_height)
@@ -140,12 +140,12 @@ void RenderGL::release(void)
 //=================================================================================================
 void RenderGL::cb_display(void)
 {
-	glEnable(GL_DEPTH_TEST);
-	glDepthMask(GL_TRUE);
+	EveStateGL->enable(GL_DEPTH_TEST);
+	EveStateGL->depthMask(GL_TRUE);
 
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	glViewport(0, 0, m_pCamera->getDisplayWidth(), m_pCamera->getDisplayHeight());
+	EveStateGL->viewport(0, 0, m_pCamera->getDisplayWidth(), m_pCamera->getDisplayHeight());
 
 	m_pShader->bind();
 	m_pUniform->bind(1);
@@ -159,8 +159,8 @@ void RenderGL::cb_display(void)
 	m_pUniform->unbind(1);
 	m_pShader->unbind();
 
-	glDepthMask(GL_FALSE);
-	glDisable(GL_DEPTH_TEST);
+	EveStateGL->depthMask(GL_FALSE);
+	EveStateGL->disable(GL_DEPTH_TEST);
 }
 
 //=================================================================================================
@@ -46,7 +46,6 @@
 #include "eve/ogl/Particule/RayCastAttractorUpdate.h"
 #include "eve/ogl/Particule/IAttractorUpdate.h"
 
-#define WORK_GROUP_SIZE 256
 
 
 struct Vertex{
@@ -209,6 +208,10 @@ void RenderGL::init(void)
 	m_dataSwapper->m_attractor = new eve::ogl::Attractor<eve::math::TMatrix44<float>, eve::math::TVec4<float>, float>(attUpdate);
 	m_dataSwapper->m_attractor->setStrategy(attUpdate);
 
+	// Fall back to CPU simulation when compute shaders are not available.
+	if (!GLEW_ARB_compute_shader) {
+		m_particleManager->setBackend(eve::ogl::ParticleBackend_CPU);
+	}
 	m_particleManager->loadParticleBuffer(m_numParticles, m_iniRadius, this);
 
 	eve::ogl::FormatShaderAdvanced fmtShaderAdv;
@@ -272,7 +275,7 @@ void RenderGL::cb_display(void)
 	m_dataSwapper->m_time = m_dataSwapper->m_timer->getDiffTime();
 
 
-	glViewport(0, 0, 1920.0f, 1080.0f);
+	EveStateGL->viewport(0, 0, 1920, 1080);
 
 	glClearColor(0.0, 0.0, 0.0, 0.0);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -282,30 +285,13 @@ void RenderGL::cb_display(void)
 	m_pTexture->bind(0);
 
 
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_particleManager->getId());
-	m_shaderManager->useProgram("computeProg");
-
-	m_particleManager->loadFloatUniform(
-		m_shaderManager->getShaderProgramID("computeProg"),
-		"frameTimeDiff",
-		static_cast<float>(1 / m_dataSwapper->m_frameTimeDiff));
-
-	m_particleManager->loadVec4Uniform(
-		m_shaderManager->getShaderProgramID("computeProg"),
-		"attPos",
-		m_dataSwapper->m_attractor->getAttractorPos().x ,
-		m_dataSwapper->m_attractor->getAttractorPos().y ,
-		m_dataSwapper->m_attractor->getAttractorPos().z ,
-		m_useGravity ? -1.0f : 1.0f); //Uses the last vector-entry to determine whether the attractor or the gravity is used ?
-
-	m_particleManager->loadUintUniform(
-		m_shaderManager->getShaderProgramID("computeProg"),
-		"maxParticles",
-		(GLuint)m_numParticles
-		);
-
-	glDispatchCompute((m_numParticles / WORK_GROUP_SIZE) + 1, 1, 1);
-	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+	m_particleManager->simulate(
+		eve::vec4f(m_dataSwapper->m_attractor->getAttractorPos().x,
+				   m_dataSwapper->m_attractor->getAttractorPos().y,
+				   m_dataSwapper->m_attractor->getAttractorPos().z,
+				   m_useGravity ? -1.0f : 1.0f), //Uses the last vector-entry to determine whether the attractor or the gravity is used ?
+		static_cast<float>(1 / m_dataSwapper->m_frameTimeDiff),
+		m_shaderManager->getShaderProgramID("computeProg"));
 
 	m_shaderManager->useProgram("shaderProg");
 
@@ -0,0 +1,190 @@
+
+/*
+ Copyright (c) 2014, The eve Project
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the {organization} nor the names of its
+ contributors may be used to endorse or promote products derived from
+ this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "eve/app/App.h"
+
+#include "eve/ogl/particule/ParticleGrid.h"
+#include "eve/ogl/particule/ParticleManager.h"
+#include "eve/ogl/particule/ParticleSeeder.h"
+#include "eve/time/Utils.h"
+
+
+/** \brief Builds per size, timings are averaged. */
+#define BENCH_BUILDS		10
+/** \brief Radius queries per size. */
+#define BENCH_QUERIES		10000
+/** \brief Particles per unit cube, kept constant so neighbours amount does not depend on particles amount. */
+#define BENCH_DENSITY		2.0f
+
+
+class Example final
+	: public eve::ui::View
+{
+
+	EVE_DISABLE_COPY(Example);
+	EVE_PUBLIC_DESTRUCTOR(Example);
+
+public:
+	/** \brief class constructor. */
+	explicit Example(void){};
+
+public:
+	/** \brief Setup format properties. (pure virtual) */
+	virtual void setup(void);
+
+private:
+	/** \brief Alloc and init threaded data. (pure virtual) */
+	virtual void initThreadedData(void) override;
+	/** \brief Release and delete threaded data. (pure virtual) */
+	virtual void releaseThreadedData(void) override;
+
+private:
+	/** \brief Run neighbour grid benchmark on \a p_numParticles particles. */
+	void bench(size_t p_numParticles);
+
+public:
+	virtual void cb_evtKeyDown(eve::evt::KeyEventArgs & p_args) override;
+	virtual void cb_evtWindowClose(eve::evt::EventArgs & p_args) override;
+
+};
+
+void Example::setup(void)
+{
+	// Call parent class.
+	eve::ui::View::setup();
+
+	m_format.x			= 50;
+	m_format.y			= 50;
+	m_format.width		= 800;
+	m_format.height		= 600;
+}
+
+void Example::initThreadedData(void)
+{
+	// Call parent class.
+	eve::ui::View::initThreadedData();
+
+	this->bench(10000);
+	this->bench(100000);
+	this->bench(1000000);
+}
+
+void Example::releaseThreadedData(void)
+{
+
+	// Call parent class.
+	eve::ui::View::releaseThreadedData();
+}
+
+void Example::bench(size_t p_numParticles)
+{
+	// Cube sized for constant density, unit cell size.
+	const float half = 0.5f * std::cbrt(static_cast<float>(p_numParticles) / BENCH_DENSITY);
+
+	eve::ogl::ParticleSeeder * pSeeder = eve::ogl::ParticleSeeder::create_ptr();
+	pSeeder->setBox(eve::vec3f::zero(), eve::vec3f(half, half, half));
+
+	std::vector<eve::ogl::Particle> particles(p_numParticles);
+	pSeeder->fill(particles.data(), p_numParticles);
+
+	std::vector<float> x(p_numParticles), y(p_numParticles), z(p_numParticles);
+	for (size_t i = 0; i < p_numParticles; i++)
+	{
+		x[i] = particles[i].m_currPosition.x;
+		y[i] = particles[i].m_currPosition.y;
+		z[i] = particles[i].m_currPosition.z;
+	}
+
+	eve::ogl::ParticleGrid * pGrid = eve::ogl::ParticleGrid::create_ptr(1.0f, static_cast<uint32_t>(p_numParticles));
+
+	int64_t serial	 = 0;
+	int64_t parallel = 0;
+	for (size_t k = 0; k < BENCH_BUILDS; k++)
+	{
+		pGrid->setParallel(false);
+		pGrid->build(x.data(), y.data(), z.data(), p_numParticles);
+		serial += pGrid->getBuildMicro();
+
+		pGrid->setParallel(true);
+		pGrid->build(x.data(), y.data(), z.data(), p_numParticles);
+		parallel += pGrid->getBuildMicro();
+	}
+
+	// Radius queries around particles, neighbours amount checked against brute force on a few of them.
+	size_t		  neighbours = 0;
+	size_t		  mismatches = 0;
+	const int64_t start		 = eve::time::current_time_micro();
+	for (size_t q = 0; q < BENCH_QUERIES; q++)
+	{
+		const size_t idx = (q * 7919) % p_numParticles;
+		pGrid->forEachNeighbour(eve::vec3f(x[idx], y[idx], z[idx]), 1.0f, [&](uint32_t, float) { neighbours++; });
+	}
+	const int64_t queries = eve::time::current_time_micro() - start;
+
+	for (size_t q = 0; q < 16; q++)
+	{
+		const eve::vec3f pos(x[q], y[q], z[q]);
+		std::vector<uint32_t> result;
+		if (pGrid->query(pos, 1.0f, result) != pGrid->countReference(x.data(), y.data(), z.data(), pos, 1.0f)) {
+			mismatches++;
+		}
+	}
+
+	EVE_LOG_INFO("%d particles: build serial %f ms, parallel %f ms (%f Mparticles/s), %d queries %f ms, %f neighbours avg, %d mismatches."
+		, static_cast<int>(p_numParticles)
+		, static_cast<double>(serial) / (1000.0 * BENCH_BUILDS)
+		, static_cast<double>(parallel) / (1000.0 * BENCH_BUILDS)
+		, static_cast<double>(p_numParticles) * BENCH_BUILDS / static_cast<double>(std::max(parallel, int64_t(1)))
+		, BENCH_QUERIES
+		, static_cast<double>(queries) / 1000.0
+		, static_cast<double>(neighbours) / BENCH_QUERIES
+		, static_cast<int>(mismatches));
+
+	EVE_RELEASE_PTR(pGrid);
+	EVE_RELEASE_PTR(pSeeder);
+}
+
+void Example::cb_evtKeyDown(eve::evt::KeyEventArgs & p_args)
+{
+	if (p_args.key == eve::sys::key_Escape)
+	{
+		eve::evt::notify_application_exit();
+	}
+}
+
+void Example::cb_evtWindowClose(eve::evt::EventArgs & p_args)
+{
+	eve::evt::notify_application_exit();
+}
+
+
+// Launch application for view "Example".
+EVE_APPLICATION(Example);
@@ -4,6 +4,7 @@
 #define ATTRIBUTE_POSITION	0
 #define ATTRIBUTE_DIFFUSE	4
 #define ATTRIBUTE_NORMAL	7
+#define ATTRIBUTE_INSTANCE	8
 
 #define TRANSFORM_CAMERA	1
 #define TRANSFORM_MODEL		2
@@ -16,17 +17,14 @@ layout(binding = TRANSFORM_CAMERA) uniform camera
 	mat4 mat_model_view;
 	mat4 mat_projection;
 } tran_camera;
-// Model matrix.
-layout(binding = TRANSFORM_MODEL) uniform model
-{
-	mat4 matrix;
-} tran_model;
 
 
 // Mesh data.
 layout(location = ATTRIBUTE_POSITION) 	in vec3 attr_position;
 layout(location = ATTRIBUTE_DIFFUSE)  	in vec2 attr_texcoord;
 layout(location = ATTRIBUTE_NORMAL)		in vec3 attr_normal;
+// Per instance world matrix (current attribute value when drawn without instance arrays).
+layout(location = ATTRIBUTE_INSTANCE)	in mat4 attr_instance;
 
 
 // Intrinsic output.
@@ -46,7 +44,7 @@ out block
 // Entry point.
 void main()
 {	
-	mat4 modelMatrix 	= tran_camera.mat_model_view * tran_model.matrix;
+	mat4 modelMatrix 	= tran_camera.mat_model_view * attr_instance;
 
 	out_block.position	= (modelMatrix * vec4(attr_position, 1.0) ).xyz;
 	out_block.texcoord 	= attr_texcoord;